@@ -0,0 +1,217 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "nini.h"
+#include "bench_timer.h"
+#include "bench_decode.h"
+
+#define SECTION_COUNT 256
+#define KEY_COUNT     64
+#define ROUNDS        20
+#define REPEATS       16
+#define TENANTS       16
+
+//------------------------------------------------------------------------------
+static
+char* build_float_document(size_t *size)
+{
+    // A calibration-table-like document which contains float values mostly.
+    nini_root_t root;
+    nini_root_init(&root, NINI_FORMAT_NESTED_INI);
+
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    for(int s = 0; s < SECTION_COUNT; ++s)
+    {
+        for(int k = 0; k < KEY_COUNT; ++k)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            char path[64];
+            snprintf(path, sizeof(path), "table-%d/point-%d", s, k);
+            nini_write_float(&root, path, '/', (double)( seed >> 44 ) / 1000.0);
+        }
+
+        char path[64];
+        snprintf(path, sizeof(path), "table-%d/duration", s);
+        nini_write_float(&root, path, '/', 59.50);
+    }
+
+    char *data = nini_root_encode_to_memory(&root, size, NULL);
+    nini_root_deinit(&root);
+
+    return data;
+}
+//------------------------------------------------------------------------------
+void bench_decode(void)
+{
+    size_t size;
+    char  *data = build_float_document(&size);
+    if( !data )
+    {
+        printf("Failed to build the document!\n");
+        return;
+    }
+
+    nini_root_t root;
+    nini_root_init(&root, NINI_FORMAT_NESTED_INI);
+
+    double start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        if( !nini_root_decode(&root, data, size, NULL) )
+        {
+            printf("Failed to decode the document!\n");
+            break;
+        }
+    }
+    double seconds = bench_now() - start;
+
+    bench_report_throughput("decode: float document", size * ROUNDS, seconds);
+
+    // Reloading the document by applying the differences, which keeps all nodes.
+
+    nini_reloader_t reloader;
+    nini_reloader_init(&reloader, &root, '/');
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_reloader_decode(&reloader, data, size, NULL);
+    bench_report_throughput("reload: diff apply", size * ROUNDS, bench_now() - start);
+
+    nini_reloader_deinit(&reloader);
+
+    // Reading settings through an override layer, by each root in turn or by an overlay.
+
+    nini_root_t override;
+    nini_root_init(&override, NINI_FORMAT_NESTED_INI);
+    nini_write_float(&override, "table-0/duration", '/', 60.0);
+
+    static char paths[SECTION_COUNT][64];
+    for(int s = 0; s < SECTION_COUNT; ++s)
+        snprintf(paths[s], sizeof(paths[s]), "table-%d/duration", s);
+
+    double expected = 0, sum = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int s = 0; s < SECTION_COUNT; ++s)
+        {
+            double value = nini_read_float(&override, paths[s], '/', NAN);
+            expected += isnan(value) ? nini_read_float(&root, paths[s], '/', 0) : value;
+        }
+    }
+    bench_report("layers: read each root", SECTION_COUNT * ROUNDS, bench_now() - start);
+
+    nini_overlay_t overlay;
+    nini_overlay_init(&overlay, '/');
+    nini_overlay_add_layer(&overlay, &override);
+    nini_overlay_add_layer(&overlay, &root);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int s = 0; s < SECTION_COUNT; ++s)
+            sum += nini_overlay_read_float(&overlay, paths[s], 0);
+    }
+    bench_report("layers: read overlay", SECTION_COUNT * ROUNDS, bench_now() - start);
+    if( sum != expected ) printf("layers: unexpected results!\n");
+
+    nini_overlay_deinit(&overlay);
+
+    // Applying the override layer on the root, by decode and write each key or by a merge decode.
+
+    for(int s = 0; s < SECTION_COUNT; ++s)
+        nini_write_float(&override, paths[s], '/', 60.0);
+
+    size_t override_size;
+    char  *override_data = nini_root_encode_to_memory(&override, &override_size, NULL);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        nini_root_decode(&override, override_data, override_size, NULL);
+        for(const nini_node_t *section = nini_root_get_first_child_c(&override);
+            section;
+            section = nini_node_get_next_sibling_c(section))
+        {
+            for(const nini_node_t *key = nini_node_get_first_child_c(section);
+                key;
+                key = nini_node_get_next_sibling_c(key))
+            {
+                char path[64];
+                snprintf(path, sizeof(path), "%s/%s", nini_node_get_name(section), nini_node_get_name(key));
+                nini_write_float(&root, path, '/', nini_node_get_float(key));
+            }
+        }
+    }
+    bench_report_throughput("merge: decode and write", override_size * ROUNDS, bench_now() - start);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_merge(&root, override_data, override_size, NULL);
+    bench_report_throughput("merge: decode merge", override_size * ROUNDS, bench_now() - start);
+
+    if( nini_read_float(&root, "table-9/duration", '/', 0) != 60.0 )
+        printf("merge: unexpected results!\n");
+
+    // Decoding a document which repeats sections, by keeping all items or by the last wins.
+
+    size_t repeated_size = override_size * REPEATS;
+    char  *repeated_data = malloc(repeated_size);
+    for(int i = 0; repeated_data && override_data && i < REPEATS; ++i)
+        memcpy(repeated_data + i * override_size, override_data, override_size);
+
+    nini_root_t repeated;
+    nini_root_init(&repeated, NINI_FORMAT_NESTED_INI);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_decode(&repeated, repeated_data, repeated_size, NULL);
+    bench_report_throughput("duplicates: keep all", repeated_size * ROUNDS, bench_now() - start);
+
+    nini_root_set_duplicates(&repeated, NINI_DUPLICATES_LAST_WINS);
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_decode(&repeated, repeated_data, repeated_size, NULL);
+    bench_report_throughput("duplicates: last wins", repeated_size * ROUNDS, bench_now() - start);
+
+    nini_root_deinit(&repeated);
+    if( repeated_data ) free(repeated_data);
+
+    if( override_data ) free(override_data);
+    nini_root_deinit(&override);
+
+    // Loading the same document for many tenants, by keeping each copy or by sharing sections in a pool.
+
+    static nini_root_t tenants[TENANTS];
+    for(int t = 0; t < TENANTS; ++t)
+        nini_root_init(&tenants[t], NINI_FORMAT_NESTED_INI);
+
+    start = bench_now();
+    for(int t = 0; t < TENANTS; ++t)
+        nini_root_decode(&tenants[t], data, size, NULL);
+    bench_report_throughput("pool: decode tenants", size * TENANTS, bench_now() - start);
+
+    nini_pool_t pool;
+    nini_pool_init(&pool);
+
+    start = bench_now();
+    for(int t = 0; t < TENANTS; ++t)
+    {
+        nini_root_decode(&tenants[t], data, size, NULL);
+        nini_pool_share(&pool, &tenants[t]);
+    }
+    bench_report_throughput("pool: decode and share", size * TENANTS, bench_now() - start);
+
+    if( nini_pool_get_count(&pool) != SECTION_COUNT ) printf("pool: unexpected results!\n");
+
+    nini_pool_deinit(&pool);
+    for(int t = 0; t < TENANTS; ++t)
+        nini_root_deinit(&tenants[t]);
+
+    nini_root_deinit(&root);
+    free(data);
+}
+//------------------------------------------------------------------------------
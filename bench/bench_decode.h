@@ -0,0 +1,14 @@
+#ifndef _BENCH_DECODE_H_
+#define _BENCH_DECODE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bench_decode(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,293 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nini.h"
+#include "bench_timer.h"
+#include "bench_encode.h"
+
+#define SECTION_COUNT 512
+#define KEY_COUNT     512
+#define ROUNDS        5
+
+//------------------------------------------------------------------------------
+static
+void build_mixed_root(nini_root_t *root)
+{
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    for(int s = 0; s < SECTION_COUNT; ++s)
+    {
+        for(int k = 0; k < KEY_COUNT; ++k)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            char path[64];
+            snprintf(path, sizeof(path), "section-%d/key-%d", s, k);
+            switch( k % 4 )
+            {
+            case 0:
+                nini_write_float(root, path, '/', (double)( seed >> 11 ) / (double)( 1ULL << 40 ));
+                break;
+
+            case 1:
+                nini_write_decimal(root, path, '/', (long)( seed >> 20 ));
+                break;
+
+            case 2:
+                nini_write_hexa(root, path, '/', (long)( seed >> 32 ));
+                break;
+
+            default:
+                nini_write_string(root, path, '/', "A string value with \"quotes\" and some text.");
+                break;
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static
+void write_mixed_items(nini_writer_t *writer)
+{
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    for(int s = 0; s < SECTION_COUNT; ++s)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "section-%d", s);
+        nini_writer_begin_section(writer, name);
+
+        for(int k = 0; k < KEY_COUNT; ++k)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            snprintf(name, sizeof(name), "key-%d", k);
+            switch( k % 4 )
+            {
+            case 0:
+                nini_writer_write_float(writer, name, (double)( seed >> 11 ) / (double)( 1ULL << 40 ));
+                break;
+
+            case 1:
+                nini_writer_write_decimal(writer, name, (long)( seed >> 20 ));
+                break;
+
+            case 2:
+                nini_writer_write_hexa(writer, name, (long)( seed >> 32 ));
+                break;
+
+            default:
+                nini_writer_write_string(writer, name, "A string value with \"quotes\" and some text.");
+                break;
+            }
+        }
+
+        nini_writer_end_section(writer);
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool discard_on_write(void *stream, const char *line, size_t len)
+{
+    *(size_t*) stream += len;
+    return true;
+}
+//------------------------------------------------------------------------------
+void bench_encode(void)
+{
+    nini_root_t root;
+    nini_root_init(&root, NINI_FORMAT_NESTED_INI);
+    build_mixed_root(&root);
+
+    size_t total = 0;
+    double start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_encode_to_stream(&root, &total, discard_on_write, NULL);
+    bench_report_throughput("encode: serial", total, bench_now() - start);
+
+    static const unsigned threads[] = { 1, 2, 4, 8, 0 };
+    for(size_t i = 0; i < sizeof(threads)/sizeof(threads[0]); ++i)
+    {
+        total = 0;
+        start = bench_now();
+        for(int r = 0; r < ROUNDS; ++r)
+            nini_root_encode_to_stream_parallel(&root, &total, discard_on_write, threads[i], NULL);
+
+        char name[64];
+        snprintf(name, sizeof(name), "encode: parallel, %u threads", threads[i]);
+        bench_report_throughput(threads[i] ? name : "encode: parallel, all processors", total, bench_now() - start);
+    }
+
+    // Generating data by building a tree first, or by the streaming writer directly.
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        nini_root_t temp;
+        nini_root_init(&temp, NINI_FORMAT_NESTED_INI);
+        build_mixed_root(&temp);
+        nini_root_encode_to_stream(&temp, &total, discard_on_write, NULL);
+        nini_root_deinit(&temp);
+    }
+    bench_report_throughput("generate: build tree and encode", total, bench_now() - start);
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        nini_writer_t writer;
+        nini_writer_init(&writer, NINI_FORMAT_NESTED_INI, &total, discard_on_write, NULL);
+        write_mixed_items(&writer);
+        nini_writer_finish(&writer);
+        nini_writer_deinit(&writer);
+    }
+    bench_report_throughput("generate: streaming writer", total, bench_now() - start);
+
+    // Encoding after one key changed, in the lossless mode or not.
+
+    size_t  text_size;
+    char   *text = nini_root_encode_to_memory(&root, &text_size, NULL);
+
+    nini_root_t edited;
+    nini_root_init(&edited, NINI_FORMAT_NESTED_INI);
+    nini_root_enable_lossless(&edited);
+    nini_root_decode(&edited, text, text_size, NULL);
+    nini_write_decimal(&edited, "section-256/key-1", '/', 0);
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_encode_to_stream(&edited, &total, discard_on_write, NULL);
+    bench_report_throughput("edited: lossless", total, bench_now() - start);
+
+    nini_root_disable_lossless(&edited);
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_encode_to_stream(&edited, &total, discard_on_write, NULL);
+    bench_report_throughput("edited: formatted", total, bench_now() - start);
+
+    // Comparing two trees, by encoded texts or by content hashes.
+
+    int differences = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        size_t  size1, size2;
+        char   *text1 = nini_root_encode_to_memory(&root, &size1, NULL);
+        char   *text2 = nini_root_encode_to_memory(&edited, &size2, NULL);
+        differences += size1 != size2 || memcmp(text1, text2, size1);
+        free(text1);
+        free(text2);
+    }
+    bench_report("compare: encoded texts", ROUNDS, bench_now() - start);
+
+    start = bench_now();
+    differences += nini_root_get_hash(&root) != nini_root_get_hash(&edited);
+    bench_report("compare: hashes, first time", 1, bench_now() - start);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        nini_write_decimal(&edited, "section-256/key-1", '/', r);
+        differences += nini_root_get_hash(&root) != nini_root_get_hash(&edited);
+    }
+    bench_report("compare: hashes, after edit", ROUNDS, bench_now() - start);
+    if( differences != 2 * ROUNDS + 1 ) printf("compare: unexpected results!\n");
+
+    // Shipping the change by a patch.
+
+    nini_patch_t forward, backward;
+    nini_patch_init(&forward);
+    nini_patch_init(&backward);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_patch_diff(&forward, &root, &edited, NULL);
+    char name[64];
+    snprintf(name, sizeof(name), "patch: diff, %lu bytes", (unsigned long) nini_patch_get_size(&forward));
+    bench_report(name, ROUNDS, bench_now() - start);
+
+    nini_patch_diff(&backward, &edited, &root, NULL);
+
+    nini_root_t patched;
+    nini_root_init(&patched, NINI_FORMAT_NESTED_INI);
+    nini_root_decode(&patched, text, text_size, NULL);
+
+    bool applied = true;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        applied &= nini_patch_apply(&forward, &patched, NULL);
+        applied &= nini_patch_apply(&backward, &patched, NULL);
+    }
+    bench_report("patch: apply", 2 * ROUNDS, bench_now() - start);
+    if( !applied ) printf("patch: unexpected results!\n");
+
+    nini_root_deinit(&patched);
+    nini_patch_deinit(&backward);
+    nini_patch_deinit(&forward);
+
+    nini_root_deinit(&edited);
+    free(text);
+
+    // Saving to files, and the file size is the same as the encoded size.
+
+    size_t size = nini_root_encoded_size(&root);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_save_file(&root, "bench-save.ini", NULL);
+    bench_report_throughput("save: nini_root_save_file", size * ROUNDS, bench_now() - start);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_save_file_atomic(&root, "bench-save.ini", 1, NULL);
+    bench_report_throughput("save: atomic, serial", size * ROUNDS, bench_now() - start);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_save_file_atomic(&root, "bench-save.ini", 0, NULL);
+    bench_report_throughput("save: atomic, all processors", size * ROUNDS, bench_now() - start);
+
+    // Persisting small changes, by saving the whole file or by the journal.
+
+    const int changes = 8;
+
+    start = bench_now();
+    for(int i = 0; i < changes; ++i)
+    {
+        nini_write_decimal(&root, "section-0/key-0", '/', i);
+        nini_root_save_file_atomic(&root, "bench-save.ini", 1, NULL);
+    }
+    bench_report("change: atomic save each", changes, bench_now() - start);
+
+    nini_root_t journaled;
+    nini_root_init(&journaled, NINI_FORMAT_NESTED_INI);
+
+    nini_journal_t journal;
+    nini_journal_open(&journal, &journaled, "bench-save.ini", 0, NULL);
+
+    start = bench_now();
+    for(int i = 0; i < changes; ++i)
+    {
+        nini_journal_write_decimal(&journal, "section-0/key-0", '/', i);
+        nini_journal_commit(&journal, NULL);
+    }
+    bench_report("change: journal commit each", changes, bench_now() - start);
+
+    start = bench_now();
+    for(int i = 0; i < changes; ++i)
+        nini_journal_write_decimal(&journal, "section-0/key-0", '/', i);
+    nini_journal_commit(&journal, NULL);
+    bench_report("change: journal commit group", changes, bench_now() - start);
+
+    nini_journal_close(&journal, NULL);
+    nini_root_deinit(&journaled);
+
+    remove("bench-save.ini");
+    remove("bench-save.ini.journal");
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _BENCH_ENCODE_H_
+#define _BENCH_ENCODE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bench_encode(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "nini.h"
+#include "bench_timer.h"
+#include "bench_load.h"
+
+#define FILE_COUNT  2048
+#define KEY_COUNT   32
+#define MAX_THREADS 64
+#define FRAGMENTS   64
+
+//------------------------------------------------------------------------------
+static
+size_t write_files(void)
+{
+    // Many small per-tenant files.
+    if( system("rm -rf bench-files && mkdir bench-files") ) return 0;
+
+    size_t total_size = 0;
+    for(int i = 0; i < FILE_COUNT; ++i)
+    {
+        nini_root_t root;
+        nini_root_init(&root, NINI_FORMAT_NESTED_INI);
+
+        for(int k = 0; k < KEY_COUNT; ++k)
+        {
+            char path[64];
+            snprintf(path, sizeof(path), "tenant/key-%d", k);
+            nini_write_decimal(&root, path, '/', i * k);
+        }
+
+        char filename[64];
+        snprintf(filename, sizeof(filename), "bench-files/tenant-%04d.ini", i);
+        if( !nini_root_save_file(&root, filename, NULL) ) total_size = 0;
+        total_size += nini_root_encoded_size(&root);
+
+        nini_root_deinit(&root);
+    }
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
+void bench_load(void)
+{
+    size_t size = write_files();
+    if( !size )
+    {
+        printf("Failed to write the files!\n");
+        return;
+    }
+
+    nini_loader_t loader;
+    nini_loader_init(&loader);
+    if( FILE_COUNT != nini_loader_add_directory(&loader, "bench-files", "*.ini", NINI_FORMAT_NESTED_INI) )
+        printf("load: unexpected files!\n");
+
+    // Loading the files one by one.
+    double start = bench_now();
+    for(size_t i = 0; i < nini_loader_get_count(&loader); ++i)
+        nini_root_load_file(nini_loader_get_root(&loader, i), nini_loader_get_filename(&loader, i), NULL);
+    bench_report_throughput("load: serial", size, bench_now() - start);
+
+    // Loading the files by the loader, from one thread to the count of processors.
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if( processors > MAX_THREADS ) processors = MAX_THREADS;
+
+    for(unsigned threads = 1; threads <= processors; threads *= 2)
+    {
+        start = bench_now();
+        size_t loaded = nini_loader_load(&loader, threads, NULL, NULL);
+        double seconds = bench_now() - start;
+
+        char name[64];
+        snprintf(name, sizeof(name), "load: loader, %u threads", threads);
+        bench_report_throughput(name, size, seconds);
+
+        if( loaded != FILE_COUNT ) printf("load: unexpected results!\n");
+    }
+
+    nini_loader_deinit(&loader);
+
+    // Resolving includes of many tenants, by parsing shared fragments for each tenant or once.
+    FILE *file = fopen("bench-files/main.ini", "w");
+    for(int f = 0; file && f < FRAGMENTS; ++f)
+        fprintf(file, "[section-%d]\n    include = \"tenant-%04d.ini\"\n", f, f);
+    if( file ) fclose(file);
+
+    nini_includer_t includer;
+    nini_includer_init(&includer, NINI_FORMAT_NESTED_INI, "include", 0);
+
+    nini_root_t root;
+    nini_root_init(&root, NINI_FORMAT_NESTED_INI);
+
+    start = bench_now();
+    for(int t = 0; t < FILE_COUNT / FRAGMENTS; ++t)
+    {
+        nini_includer_clear(&includer);
+        if( !nini_includer_load_file(&includer, &root, "bench-files/main.ini", NULL) )
+            printf("include: unexpected results!\n");
+    }
+    bench_report("include: parse for each tenant", FILE_COUNT / FRAGMENTS, bench_now() - start);
+
+    start = bench_now();
+    for(int t = 0; t < FILE_COUNT / FRAGMENTS; ++t)
+    {
+        if( !nini_includer_load_file(&includer, &root, "bench-files/main.ini", NULL) )
+            printf("include: unexpected results!\n");
+    }
+    bench_report("include: cached fragments", FILE_COUNT / FRAGMENTS, bench_now() - start);
+
+    nini_root_deinit(&root);
+    nini_includer_deinit(&includer);
+
+    if( system("rm -rf bench-files") ) printf("Failed to remove the files!\n");
+}
+//------------------------------------------------------------------------------
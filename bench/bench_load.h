@@ -0,0 +1,14 @@
+#ifndef _BENCH_LOAD_H_
+#define _BENCH_LOAD_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bench_load(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
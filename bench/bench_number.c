@@ -0,0 +1,162 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "nini_number.h"
+#include "bench_timer.h"
+#include "bench_number.h"
+
+#define VALUE_COUNT 4096
+#define ROUNDS      256
+
+static double floats[VALUE_COUNT];
+static long   integers[VALUE_COUNT];
+static char   texts[VALUE_COUNT][NINI_NUMBER_MAX_CHARS];
+
+// Results are accumulated to prevent the formatting from being optimised out.
+static volatile size_t sink;
+
+//------------------------------------------------------------------------------
+static
+uint64_t random_next(uint64_t *state)
+{
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+//------------------------------------------------------------------------------
+static
+void prepare_values(void)
+{
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    for(int i = 0; i < VALUE_COUNT; ++i)
+    {
+        // Mix short configuration-like values and full precision values.
+        uint64_t num = random_next(&seed);
+        floats[i] = i & 1 ?
+                    (double)( num % 100000 ) / 100.0 :
+                    (double)( num >> 11 ) / (double)( 1ULL << 53 ) * 1e6;
+
+        integers[i] = (long) random_next(&seed) >> ( i % 64 );
+
+        nini_number_format_float(texts[i], floats[i]);
+    }
+}
+//------------------------------------------------------------------------------
+static
+void bench_float(void)
+{
+    char   buf[64];
+    size_t total;
+    double start;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += snprintf(buf, sizeof(buf), "%.17g", floats[i]);
+    }
+    bench_report("float: snprintf(\"%.17g\")", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += nini_number_format_float(buf, floats[i]);
+    }
+    bench_report("float: nini_number_format_float", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total;
+}
+//------------------------------------------------------------------------------
+static
+void bench_integer(void)
+{
+    char   buf[64];
+    size_t total;
+    double start;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += snprintf(buf, sizeof(buf), "%ld", integers[i]);
+    }
+    bench_report("decimal: snprintf(\"%ld\")", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += nini_number_format_decimal(buf, integers[i]);
+    }
+    bench_report("decimal: nini_number_format_decimal", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += snprintf(buf, sizeof(buf), "0x%lX", integers[i]);
+    }
+    bench_report("hexa: snprintf(\"0x%lX\")", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += nini_number_format_hexa(buf, integers[i]);
+    }
+    bench_report("hexa: nini_number_format_hexa", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total;
+}
+//------------------------------------------------------------------------------
+static
+void bench_parse(void)
+{
+    double total;
+    double start;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+            total += strtod(texts[i], NULL);
+    }
+    bench_report("parse: strtod", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total != 0;
+
+    total = 0;
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        for(int i = 0; i < VALUE_COUNT; ++i)
+        {
+            double value;
+            nini_number_parse_float(texts[i], &value);
+            total += value;
+        }
+    }
+    bench_report("parse: nini_number_parse_float", VALUE_COUNT * ROUNDS, bench_now() - start);
+    sink += total != 0;
+}
+//------------------------------------------------------------------------------
+void bench_number(void)
+{
+    prepare_values();
+    bench_float();
+    bench_integer();
+    bench_parse();
+}
+//------------------------------------------------------------------------------
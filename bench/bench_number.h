@@ -0,0 +1,14 @@
+#ifndef _BENCH_NUMBER_H_
+#define _BENCH_NUMBER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bench_number(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "nini.h"
+#include "bench_timer.h"
+#include "bench_string.h"
+
+#define KEY_COUNT    8192
+#define VALUE_LENGTH 960
+#define ROUNDS       20
+
+//------------------------------------------------------------------------------
+static
+void build_string_root(nini_root_t *root)
+{
+    // Long base64-like values with rare characters those must be escaped.
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    char     value[ VALUE_LENGTH + 1 ];
+    for(int k = 0; k < KEY_COUNT; ++k)
+    {
+        for(int i = 0; i < VALUE_LENGTH; ++i)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            value[i] = digits[ seed >> 58 ];
+        }
+        value[ VALUE_LENGTH / 2 ] = '\"';
+        value[ VALUE_LENGTH ] = 0;
+
+        char path[64];
+        snprintf(path, sizeof(path), "blobs/blob-%d", k);
+        nini_write_string(root, path, '/', value);
+    }
+}
+//------------------------------------------------------------------------------
+void bench_string(void)
+{
+    nini_root_t root;
+    nini_root_init(&root, NINI_FORMAT_NESTED_INI);
+    build_string_root(&root);
+
+    size_t size = nini_root_encoded_size(&root);
+    char  *data = malloc(size + 1);
+    if( !data )
+    {
+        printf("Failed to allocate the buffer!\n");
+        nini_root_deinit(&root);
+        return;
+    }
+
+    double start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+        nini_root_encode_to_buffer(&root, data, size + 1, NULL);
+    bench_report_throughput("encode: string document", size * ROUNDS, bench_now() - start);
+
+    start = bench_now();
+    for(int r = 0; r < ROUNDS; ++r)
+    {
+        if( !nini_root_decode(&root, data, size, NULL) )
+        {
+            printf("Failed to decode the document!\n");
+            break;
+        }
+    }
+    bench_report_throughput("decode: string document", size * ROUNDS, bench_now() - start);
+
+    free(data);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
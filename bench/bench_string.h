@@ -0,0 +1,14 @@
+#ifndef _BENCH_STRING_H_
+#define _BENCH_STRING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bench_string(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
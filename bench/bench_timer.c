@@ -0,0 +1,31 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <time.h>
+#include "bench_timer.h"
+
+//------------------------------------------------------------------------------
+double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+//------------------------------------------------------------------------------
+void bench_report(const char *name, unsigned long count, double seconds)
+{
+    printf("%-36s %10lu ops %10.3f ms %10.2f ns/op\n",
+           name,
+           count,
+           seconds * 1e3,
+           count ? seconds * 1e9 / count : 0.0);
+}
+//------------------------------------------------------------------------------
+void bench_report_throughput(const char *name, size_t size, double seconds)
+{
+    printf("%-36s %10.2f MB %10.3f ms %10.2f MB/s\n",
+           name,
+           size / 1e6,
+           seconds * 1e3,
+           seconds > 0 ? size / 1e6 / seconds : 0.0);
+}
+//------------------------------------------------------------------------------
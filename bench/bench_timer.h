@@ -0,0 +1,18 @@
+#ifndef _BENCH_TIMER_H_
+#define _BENCH_TIMER_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+double bench_now(void);
+void   bench_report(const char *name, unsigned long count, double seconds);
+void   bench_report_throughput(const char *name, size_t size, double seconds);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
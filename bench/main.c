@@ -0,0 +1,26 @@
+#include <stdio.h>
+#include "bench_number.h"
+#include "bench_decode.h"
+#include "bench_string.h"
+#include "bench_encode.h"
+#include "bench_load.h"
+
+int main(int argc, char *argv[])
+{
+    printf("[number formatting]\n");
+    bench_number();
+
+    printf("[decoding]\n");
+    bench_decode();
+
+    printf("[string values]\n");
+    bench_string();
+
+    printf("[encoding]\n");
+    bench_encode();
+
+    printf("[loading files]\n");
+    bench_load();
+
+    return 0;
+}
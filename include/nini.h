@@ -14,6 +14,19 @@ namespace nini {}
 #endif
 
 #include "nini_root.h"
+#include "nini_writer.h"
+#include "nini_journal.h"
+#include "nini_watcher.h"
+#include "nini_reloader.h"
+#include "nini_patch.h"
+#include "nini_overlay.h"
+#include "nini_pool.h"
+#include "nini_loader.h"
+#include "nini_include.h"
+#include "nini_number.h"
 #include "nini_helper.h"
+#include "nini_query.h"
+#include "nini_bind.h"
+#include "nini_schema.h"
 
 #endif
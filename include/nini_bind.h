@@ -0,0 +1,248 @@
+/**
+ * @file
+ * @brief     Nested INI structure binding.
+ * @details   This module decodes NINI format data directly into user defined structures
+ *            by a descriptor table, and no NINI node will be created during the decoding.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_BIND_H_
+#define _NINI_BIND_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "nini_format.h"
+#include "nini_errmsg.h"
+#include "nini_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Value of a binding entry.
+ */
+typedef union nini_bind_value_t
+{
+    const char *string;     ///< String value, used with NINI_STRING.
+    long        integer;    ///< Integer value, used with NINI_DECIMAL and NINI_HEXA.
+    double      floating;   ///< Floating point value, used with NINI_FLOAT.
+    bool        boolean;    ///< Boolean value, used with NINI_BOOL.
+} nini_bind_value_t;
+
+/**
+ * @brief   User defined field storer.
+ * @details User defined function that will be called to store a value to a field,
+ *          so that fields with types other than the built-in types can be bound.
+ *
+ * @param field Address of the field.
+ * @param type  Type of the value.
+ * @param value The value to be stored,
+ *              and it will be the default value of the entry if the key does not existed.
+ * @return TRUE if the value be stored; and FALSE if the value cannot be stored to the field.
+ */
+typedef bool(*nini_bind_on_store_t)(void *field, nini_type_t type, const nini_bind_value_t *value);
+
+/**
+ * @brief Binding entry.
+ * @details Describe how a key will be stored to a field of the target structure.
+ *          Each type of entry will be stored to a field with the following type,
+ *          and @a size is the size of the field:
+ *          * NINI_STRING                : An array of characters.
+ *          * NINI_DECIMAL and NINI_HEXA : A signed integer of signed char, short, int, long, or long long,
+ *                                         and both key types will be accepted.
+ *          * NINI_FLOAT                 : A float or a double.
+ *          * NINI_BOOL                  : A boolean.
+ *
+ * @remarks Values those are out of the range of the field are mismatched.
+ * @remarks Fields with sizes those do not match any of the types above will never be stored,
+ *          and their keys are reported as mismatched.
+ */
+typedef struct nini_bind_entry_t
+{
+    const char        *path;    ///< Path of the key, see @ref key-path for more details.
+    nini_type_t        type;    ///< Type of the key.
+    size_t             offset;  ///< Offset of the field in the target structure.
+    size_t             size;    ///< Size of the field.
+    nini_bind_value_t  defval;  ///< The value that will be used if the key does not existed.
+
+    nini_bind_on_store_t on_store;  ///< The user defined field storer,
+                                    ///< and can be NULL to use the built-in storer of @a type.
+} nini_bind_entry_t;
+
+/**
+ * @name Binding entry declaration helpers
+ * @{
+ */
+
+/// Declare a binding entry of a string (array of characters) field.
+#define NINI_BIND_STRING(path, type, member, defval) \
+    { (path), NINI_STRING, offsetof(type, member), sizeof(((type*)0)->member), { .string = (defval) } }
+
+/// Declare a binding entry of a signed integer field.
+#define NINI_BIND_INTEGER(path, type, member, defval) \
+    { (path), NINI_DECIMAL, offsetof(type, member), sizeof(((type*)0)->member), { .integer = (defval) } }
+
+/// Declare a binding entry of a float or double field.
+#define NINI_BIND_FLOAT(path, type, member, defval) \
+    { (path), NINI_FLOAT, offsetof(type, member), sizeof(((type*)0)->member), { .floating = (defval) } }
+
+/// Declare a binding entry of a boolean field.
+#define NINI_BIND_BOOL(path, type, member, defval) \
+    { (path), NINI_BOOL, offsetof(type, member), sizeof(((type*)0)->member), { .boolean = (defval) } }
+
+/**
+ * @}
+ */
+
+/**
+ * @brief Binding issues.
+ */
+typedef enum nini_bind_issue_t
+{
+    NINI_BIND_MISSING,  ///< A key described in the table does not existed in the data.
+    NINI_BIND_UNKNOWN,  ///< A key existed in the data is not described in the table.
+    NINI_BIND_MISMATCH, ///< A key existed, but its value cannot be stored to the field.
+} nini_bind_issue_t;
+
+/**
+ * @brief   User defined issue report function.
+ * @details User defined function that will be called for each binding issue.
+ *
+ * @param userarg The user defined argument.
+ * @param issue   The issue type.
+ * @param path    Path of the key,
+ *                and it will be truncated to NINI_MAX_LINE_CHARS characters if it is too long.
+ */
+typedef void(*nini_bind_on_issue_t)(void *userarg, nini_bind_issue_t issue, const char *path);
+
+/**
+ * @brief Binding result report.
+ */
+typedef struct nini_bind_report_t
+{
+    unsigned missing;   ///< Number of keys described in the table but not existed in the data.
+    unsigned unknown;   ///< Number of keys existed in the data but not described in the table.
+    unsigned mismatch;  ///< Number of keys that their values cannot be stored to the fields.
+} nini_bind_report_t;
+
+/**
+ * @class nini_binder_t
+ * @brief Structure decoder.
+ */
+typedef struct nini_binder_t
+{
+    // WARNING: All variables are private!
+
+    nini_format_t format;
+    char          deli;
+
+    const nini_bind_entry_t *table;
+    size_t                   count;
+    struct nini_table_t     *index;     // Hash table of entries by their paths, or NULL.
+
+    void                 *userarg;
+    nini_bind_on_issue_t  on_issue;
+
+} nini_binder_t;
+
+void nini_binder_init(nini_binder_t           *self,
+                      const nini_format_t     *format,
+                      char                     deli,
+                      const nini_bind_entry_t *table,
+                      size_t                   count);
+void nini_binder_deinit(nini_binder_t *self);
+
+void nini_binder_set_on_issue(nini_binder_t *self, void *userarg, nini_bind_on_issue_t on_issue);
+
+bool nini_binder_decode(const nini_binder_t *self,
+                        void                *object,
+                        const void          *data,
+                        size_t               size,
+                        nini_bind_report_t  *report,
+                        nini_errmsg_t       *errmsg);
+
+bool nini_binder_decode_as(const nini_binder_t *self,
+                           const nini_format_t *format,
+                           void                *object,
+                           const void          *data,
+                           size_t               size,
+                           nini_bind_report_t  *report,
+                           nini_errmsg_t       *errmsg);
+
+bool nini_binder_load_file(const nini_binder_t *self,
+                           void                *object,
+                           const char          *filename,
+                           nini_bind_report_t  *report,
+                           nini_errmsg_t       *errmsg);
+
+bool nini_binder_load_file_as(const nini_binder_t *self,
+                              const nini_format_t *format,
+                              void                *object,
+                              const char          *filename,
+                              nini_bind_report_t  *report,
+                              nini_errmsg_t       *errmsg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_bind_entry_t.
+typedef nini_bind_entry_t TBindEntry;
+/// C++ wrapper of nini_bind_report_t.
+typedef nini_bind_report_t TBindReport;
+
+/// C++ wrapper of nini_binder_t.
+class TBinder : protected nini_binder_t
+{
+public:
+    /// Constructor.
+    TBinder(const TFormat *format, char deli, const TBindEntry *table, size_t count)
+    { nini_binder_init(this, format, deli, table, count); }
+    /// Destructor.
+    ~TBinder() { nini_binder_deinit(this); }
+
+private:
+    TBinder(const TBinder &src);                // Not allowed to use!
+    TBinder& operator=(const TBinder &src);     // Not allowed to use!
+
+public:
+    /// The same as nini_binder_set_on_issue.
+    void SetOnIssue(void *userarg, nini_bind_on_issue_t on_issue)
+    { nini_binder_set_on_issue(this, userarg, on_issue); }
+
+    /// The same as nini_binder_decode.
+    bool Decode(void *object, const void *data, size_t size, TBindReport *report=nullptr, TErrMsg *errmsg=nullptr) const
+    { return nini_binder_decode(this, object, data, size, report, errmsg); }
+
+    /// The same as nini_binder_decode_as.
+    bool DecodeAs(const TFormat *format, void *object, const void *data, size_t size, TBindReport *report=nullptr, TErrMsg *errmsg=nullptr) const
+    { return nini_binder_decode_as(this, format, object, data, size, report, errmsg); }
+
+    /// The same as nini_binder_load_file.
+    bool LoadFile(void *object, const std::string &filename, TBindReport *report=nullptr, TErrMsg *errmsg=nullptr) const
+    { return nini_binder_load_file(this, object, filename.c_str(), report, errmsg); }
+
+    /// The same as nini_binder_load_file_as.
+    bool LoadFileAs(const TFormat *format, void *object, const std::string &filename, TBindReport *report=nullptr, TErrMsg *errmsg=nullptr) const
+    { return nini_binder_load_file_as(this, format, object, filename.c_str(), report, errmsg); }
+};
+
+}
+
+#endif
+
+#endif
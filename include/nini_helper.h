@@ -36,8 +36,9 @@ extern "C" {
  * or the path operation will be strange. And user will be responsible for that.
  */
 
-bool        nini_is_existed(const nini_root_t *root, const char *path, char deli);
-nini_type_t nini_get_type  (const nini_root_t *root, const char *path, char deli);
+bool               nini_is_existed(const nini_root_t *root, const char *path, char deli);
+nini_type_t        nini_get_type  (const nini_root_t *root, const char *path, char deli);
+const nini_node_t* nini_find_node (const nini_root_t *root, const char *path, char deli);
 
 const char* nini_read_string (const nini_root_t *root, const char *path, char deli, const char *failval);
 long        nini_read_integer(const nini_root_t *root, const char *path, char deli, long failval);
@@ -81,6 +82,10 @@ public:
     TType GetType(const std::string &path) const
     { return nini_get_type(this, path.c_str(), this->deli); }
 
+    /// The same as nini_find_node.
+    const TNode* FindNode(const std::string &path) const
+    { return (const TNode*) nini_find_node(this, path.c_str(), this->deli); }
+
     /// The same as nini_read_string.
     std::string ReadString(const std::string &path, const std::string &failval="") const
     { return nini_read_string(this, path.c_str(), this->deli, failval.c_str()); }
@@ -124,6 +129,9 @@ public:
     /// The same as nini_remove.
     void Remove(const std::string &path) { nini_remove(this, path.c_str(), this->deli); }
 
+    /// The same as nini_root_freeze, with the delimiter of this object.
+    bool Freeze() { return nini_root_freeze(this, this->deli); }
+
 };
 
 }
@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @brief     Nested INI include directive.
+ * @details   This module grafts contents of other NINI format files to roots by include directives.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_INCLUDE_H_
+#define _NINI_INCLUDE_H_
+
+#include "nini_root.h"
+#include "nini_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @class nini_includer_t
+ * @brief Include resolver.
+ * @details An include directive is a string key with the directive name (for example, "include"),
+ *          and the value is the name of the file to be included,
+ *          which is relative to the directory of the file that contains the directive.
+ *          The directive can be at any level,
+ *          and it will be replaced by the contents of the file in the same section.
+ *          For example:
+ *
+ *              [video]
+ *                  include = "codecs.ini"
+ *                  width = 1920
+ *
+ *          Included files are loaded by a pool of worker threads (see nini_loader_t),
+ *          and they are cached by their inodes, modification times, and sizes,
+ *          so that a file included by many sections or many roots is loaded once,
+ *          and it will be loaded again only after it be changed.
+ *          Contents of the files are cloned to the including sections,
+ *          or they are shared if a pool is specified (see nini_includer_set_pool).
+ *
+ *          A file that includes itself directly or indirectly will be reported as an include cycle.
+ *
+ * @remarks Included files are decoded by the format of the includer, but not the format of roots.
+ * @remarks Shared sections (see nini_pool_t) are not searched for directives.
+ */
+typedef struct nini_includer_t
+{
+    // WARNING: All variables are private!
+
+    nini_format_t  format;
+    char          *directive;
+    unsigned       threads;
+    nini_pool_t   *pool;
+
+    struct nini_table_t *files;     // Hash table of cached files by their identities.
+    unsigned             generation;
+
+} nini_includer_t;
+
+void nini_includer_init  (nini_includer_t     *self,
+                          const nini_format_t *format,
+                          const char          *directive,
+                          unsigned             threads);
+void nini_includer_deinit(nini_includer_t *self);
+
+void   nini_includer_clear    (nini_includer_t *self);
+void   nini_includer_set_pool (nini_includer_t *self, nini_pool_t *pool);
+size_t nini_includer_get_count(const nini_includer_t *self);
+
+bool nini_includer_resolve  (nini_includer_t *self,
+                             nini_root_t     *root,
+                             const char      *filename,
+                             nini_errmsg_t   *errmsg);
+bool nini_includer_load_file(nini_includer_t *self,
+                             nini_root_t     *root,
+                             const char      *filename,
+                             nini_errmsg_t   *errmsg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_includer_t.
+class TIncluder : protected nini_includer_t
+{
+public:
+    /// Constructor.
+    TIncluder(const TFormat *format, const std::string &directive, unsigned threads=0)
+    { nini_includer_init(this, format, directive.c_str(), threads); }
+    /// Destructor.
+    ~TIncluder() { nini_includer_deinit(this); }
+
+private:
+    TIncluder(const TIncluder &src);                // Not allowed to use!
+    TIncluder& operator=(const TIncluder &src);     // Not allowed to use!
+
+public:
+    /// The same as nini_includer_clear.
+    void Clear() { nini_includer_clear(this); }
+    /// The same as nini_includer_set_pool.
+    void SetPool(TPool *pool) { nini_includer_set_pool(this, (nini_pool_t*) pool); }
+    /// The same as nini_includer_get_count.
+    size_t GetCount() const { return nini_includer_get_count(this); }
+
+    /// The same as nini_includer_resolve.
+    bool Resolve(TRoot &root, const std::string &filename, TErrMsg *errmsg=nullptr)
+    { return nini_includer_resolve(this, (nini_root_t*) &root, filename.c_str(), errmsg); }
+    /// The same as nini_includer_load_file.
+    bool LoadFile(TRoot &root, const std::string &filename, TErrMsg *errmsg=nullptr)
+    { return nini_includer_load_file(this, (nini_root_t*) &root, filename.c_str(), errmsg); }
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * @file
+ * @brief     Nested INI change journal.
+ * @details   This module persists changes of a root by appending compact records to a journal file
+ *            beside the NINI format file, instead of rewriting the whole file for each change.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_JOURNAL_H_
+#define _NINI_JOURNAL_H_
+
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @class nini_journal_t
+ * @brief Change journal.
+ * @details The journal file is named by the NINI format file with the suffix ".journal".
+ *          Changes be made through the journal will be applied to the root immediately,
+ *          and their records will be kept in memory until the journal be committed,
+ *          so that a group of changes costs only one write and one flush to the disk.
+ *          The journal will be folded back into the NINI format file by compaction,
+ *          and then the journal file will be cleared.
+ *
+ * For example:
+ *
+ *     nini_journal_t journal;
+ *     nini_journal_open(&journal, &root, "config.ini", 1024*1024, NULL);
+ *
+ *     nini_journal_write_decimal(&journal, "video/width", '/', 1920);
+ *     nini_journal_write_decimal(&journal, "video/height", '/', 1080);
+ *     nini_journal_commit(&journal, NULL);
+ *
+ *     nini_journal_close(&journal, NULL);
+ *
+ * @remarks The root should not be changed by other ways while the journal is opened,
+ *          or those changes will not be persisted until the next compaction.
+ */
+typedef struct nini_journal_t
+{
+    // WARNING: All variables are private!
+
+    nini_root_t *root;
+
+    char *filename;
+    char *jnlname;
+
+    int   fd;       // The journal file on POSIX systems.
+    void *file;     // The journal file (FILE*) on other systems.
+    long  size;     // Size of the journal file.
+
+    char   *buf;    // Records those have not been committed.
+    size_t  buf_size;
+    size_t  buf_capacity;
+
+    size_t compact_size;
+
+} nini_journal_t;
+
+bool nini_journal_open (nini_journal_t *self,
+                        nini_root_t    *root,
+                        const char     *filename,
+                        size_t          compact_size,
+                        nini_errmsg_t  *errmsg);
+bool nini_journal_close(nini_journal_t *self, nini_errmsg_t *errmsg);
+
+bool nini_journal_write_string (nini_journal_t *self, const char *path, char deli, const char *value);
+bool nini_journal_write_decimal(nini_journal_t *self, const char *path, char deli, long value);
+bool nini_journal_write_hexa   (nini_journal_t *self, const char *path, char deli, long value);
+bool nini_journal_write_float  (nini_journal_t *self, const char *path, char deli, double value);
+bool nini_journal_write_bool   (nini_journal_t *self, const char *path, char deli, bool value);
+bool nini_journal_write_null   (nini_journal_t *self, const char *path, char deli);
+bool nini_journal_remove       (nini_journal_t *self, const char *path, char deli);
+
+bool nini_journal_commit (nini_journal_t *self, nini_errmsg_t *errmsg);
+bool nini_journal_compact(nini_journal_t *self, nini_errmsg_t *errmsg);
+
+static inline
+long nini_journal_get_size(const nini_journal_t *self)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Get size of the journal file.
+     *
+     * @param self Object instance.
+     * @return Size of records those have been committed to the journal file.
+     */
+    return self->size;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_journal_t.
+class TJournal : protected nini_journal_t
+{
+private:
+    char deli;
+    bool opened;
+
+public:
+    /// Constructor.
+    TJournal(char delimiter) : deli(delimiter), opened(false) {}
+    /// Destructor, and the journal will be closed if it is opened.
+    ~TJournal() { this->Close(); }
+
+private:
+    TJournal(const TJournal &src);              // Not allowed to use!
+    TJournal& operator=(const TJournal &src);   // Not allowed to use!
+
+public:
+    /// The same as nini_journal_open.
+    bool Open(TRoot &root, const std::string &filename, size_t compact_size, TErrMsg *errmsg=nullptr)
+    {
+        this->Close();
+        return this->opened = nini_journal_open(this, (nini_root_t*) &root, filename.c_str(), compact_size, errmsg);
+    }
+
+    /// The same as nini_journal_close.
+    bool Close(TErrMsg *errmsg=nullptr)
+    {
+        if( !this->opened ) return true;
+
+        this->opened = false;
+        return nini_journal_close(this, errmsg);
+    }
+
+    /// Check if the journal is opened.
+    bool IsOpened() const { return this->opened; }
+
+    /// The same as nini_journal_write_string.
+    bool WriteString(const std::string &path, const std::string &value)
+    { return nini_journal_write_string(this, path.c_str(), this->deli, value.c_str()); }
+
+    /// The same as nini_journal_write_decimal.
+    bool WriteDecimal(const std::string &path, long value)
+    { return nini_journal_write_decimal(this, path.c_str(), this->deli, value); }
+
+    /// The same as nini_journal_write_hexa.
+    bool WriteHexa(const std::string &path, long value)
+    { return nini_journal_write_hexa(this, path.c_str(), this->deli, value); }
+
+    /// The same as nini_journal_write_float.
+    bool WriteFloat(const std::string &path, double value)
+    { return nini_journal_write_float(this, path.c_str(), this->deli, value); }
+
+    /// The same as nini_journal_write_bool.
+    bool WriteBool(const std::string &path, bool value)
+    { return nini_journal_write_bool(this, path.c_str(), this->deli, value); }
+
+    /// The same as nini_journal_write_null.
+    bool WriteNull(const std::string &path)
+    { return nini_journal_write_null(this, path.c_str(), this->deli); }
+
+    /// The same as nini_journal_remove.
+    bool Remove(const std::string &path)
+    { return nini_journal_remove(this, path.c_str(), this->deli); }
+
+    /// The same as nini_journal_commit.
+    bool Commit(TErrMsg *errmsg=nullptr) { return nini_journal_commit(this, errmsg); }
+    /// The same as nini_journal_compact.
+    bool Compact(TErrMsg *errmsg=nullptr) { return nini_journal_compact(this, errmsg); }
+
+    /// The same as nini_journal_get_size.
+    long GetSize() const { return nini_journal_get_size(this); }
+};
+
+}
+
+#endif
+
+#endif
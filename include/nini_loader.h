@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @brief     Nested INI batch loader.
+ * @details   This module loads many NINI format files to their own roots concurrently.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_LOADER_H_
+#define _NINI_LOADER_H_
+
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   User defined load handler.
+ * @details User defined function that will be called after each file be loaded.
+ *
+ * @param arg    The user defined argument.
+ * @param index  Index of the file in the loader.
+ * @param root   The root of the file if the load succeed; or NULL if failed.
+ * @param errmsg The failure information if the load failed.
+ */
+typedef void(*nini_on_load_t)(void *arg, size_t index, nini_root_t *root, const nini_errmsg_t *errmsg);
+
+/**
+ * @class nini_loader_t
+ * @brief Batch loader.
+ * @details The loader keeps a list of files and the roots they will be loaded to,
+ *          and loads them by a pool of worker threads.
+ *          Each worker takes files from its own range of the list,
+ *          and takes the second half of the largest remaining range of other workers when its range is done,
+ *          so that workers are kept busy even if sizes of files are very different.
+ *          Each worker reuses its read buffer for all files it loaded.
+ *
+ * For example:
+ *
+ *     nini_loader_t loader;
+ *     nini_loader_init(&loader);
+ *     nini_loader_add_directory(&loader, "tenants", "*.ini", NINI_FORMAT_NESTED_INI);
+ *     nini_loader_load(&loader, 0, NULL, NULL);
+ *
+ *     for(size_t i = 0; i < nini_loader_get_count(&loader); ++i)
+ *     {
+ *         if( nini_loader_is_loaded(&loader, i) )
+ *             use(nini_loader_get_root(&loader, i));
+ *     }
+ *
+ *     nini_loader_deinit(&loader);
+ *
+ * @remarks The same root must not be added more than once.
+ */
+typedef struct nini_loader_t
+{
+    // WARNING: All variables are private!
+
+    struct nini_loader_file_t *files;
+    size_t                     count;
+    size_t                     capacity;
+
+} nini_loader_t;
+
+void nini_loader_init  (nini_loader_t *self);
+void nini_loader_deinit(nini_loader_t *self);
+
+bool   nini_loader_add_file     (nini_loader_t *self, const char *filename, nini_root_t *root);
+size_t nini_loader_add_directory(nini_loader_t       *self,
+                                 const char          *dirname,
+                                 const char          *pattern,
+                                 const nini_format_t *format);
+
+static inline
+size_t nini_loader_get_count(const nini_loader_t *self)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Get count of files.
+     *
+     * @param self Object instance.
+     * @return Count of files.
+     */
+    return self->count;
+}
+
+const char*  nini_loader_get_filename(const nini_loader_t *self, size_t index);
+nini_root_t* nini_loader_get_root    (const nini_loader_t *self, size_t index);
+bool         nini_loader_is_loaded   (const nini_loader_t *self, size_t index);
+
+size_t nini_loader_load(nini_loader_t *self, unsigned threads, nini_on_load_t on_load, void *arg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_loader_t.
+class TLoader : protected nini_loader_t
+{
+public:
+    /// Constructor.
+    TLoader() { nini_loader_init(this); }
+    /// Destructor.
+    ~TLoader() { nini_loader_deinit(this); }
+
+private:
+    TLoader(const TLoader &src);                // Not allowed to use!
+    TLoader& operator=(const TLoader &src);     // Not allowed to use!
+
+public:
+    /// The same as nini_loader_add_file.
+    bool AddFile(const std::string &filename, TRoot &root)
+    { return nini_loader_add_file(this, filename.c_str(), (nini_root_t*) &root); }
+    /// The same as nini_loader_add_directory.
+    size_t AddDirectory(const std::string &dirname, const std::string &pattern, const TFormat *format)
+    { return nini_loader_add_directory(this, dirname.c_str(), pattern.c_str(), format); }
+
+    /// The same as nini_loader_get_count.
+    size_t GetCount() const { return nini_loader_get_count(this); }
+    /// The same as nini_loader_get_filename.
+    std::string GetFilename(size_t index) const { return nini_loader_get_filename(this, index); }
+    /// The same as nini_loader_get_root.
+    TRoot* GetRoot(size_t index) const { return (TRoot*) nini_loader_get_root(this, index); }
+    /// The same as nini_loader_is_loaded.
+    bool IsLoaded(size_t index) const { return nini_loader_is_loaded(this, index); }
+
+    /// The same as nini_loader_load.
+    size_t Load(unsigned threads=0, nini_on_load_t on_load=nullptr, void *arg=nullptr)
+    { return nini_loader_load(this, threads, on_load, arg); }
+};
+
+}
+
+#endif
+
+#endif
@@ -9,6 +9,7 @@
 #define _NINI_NODE_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 #include <string>
@@ -35,12 +36,21 @@ typedef struct nini_node_t
     char *name;
 
     nini_type_t type;
+    bool        frozen;
+    bool        hashed;
+    uint64_t    hash;
+
+    struct nini_span_t   *span;
+    struct nini_shared_t *shared;
+
     union
     {
         struct
         {
             struct nini_node_t *first;
             struct nini_node_t *last;
+
+            struct nini_node_index_t *index;
         } childs;
 
         union
@@ -62,6 +72,7 @@ nini_node_t* nini_node_create_hexa   (const char *name, long value);
 nini_node_t* nini_node_create_float  (const char *name, double value);
 nini_node_t* nini_node_create_bool   (const char *name, bool value);
 nini_node_t* nini_node_create_null   (const char *name);
+nini_node_t* nini_node_clone        (const nini_node_t *self);
 
 void nini_node_release(nini_node_t *self);
 
@@ -94,6 +105,8 @@ nini_type_t nini_node_get_type(const nini_node_t *self)
 bool nini_node_have_value(const nini_node_t *self);
 bool nini_node_have_child(const nini_node_t *self);
 
+uint64_t nini_node_get_hash(const nini_node_t *self);
+
 static inline
 nini_node_t* nini_node_get_prev_sibling(nini_node_t *self)
 {
@@ -269,7 +282,62 @@ bool nini_node_get_bool(const nini_node_t *self)
 }
 
 bool nini_node_link_child(nini_node_t *self, nini_node_t *node);
-void nini_node_unlink    (nini_node_t *self);
+bool nini_node_unlink    (nini_node_t *self);
+bool nini_node_replace   (nini_node_t *self, nini_node_t *node);
+bool nini_node_copy_value(nini_node_t *self, const nini_node_t *src);
+bool nini_node_move_after(nini_node_t *self, nini_node_t *prev);
+
+static inline
+bool nini_node_is_shared(const nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Check if the section shares its children with sections of other roots.
+     *
+     * @param self Object instance.
+     * @return TRUE if the section is shared; and FALSE if not.
+     *
+     * @see nini_pool_t
+     */
+    return self->shared;
+}
+
+bool nini_node_unshare(nini_node_t *self);
+
+/**
+ * @brief Ordered children iterator.
+ */
+typedef struct nini_node_iter_t
+{
+    // WARNING: All variables are private!
+
+    const struct nini_node_index_t *index;
+    size_t                          pos;
+    size_t                          end;
+
+} nini_node_iter_t;
+
+bool nini_node_enable_index (nini_node_t *self);
+void nini_node_disable_index(nini_node_t *self);
+
+static inline
+bool nini_node_have_index(const nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Check if the ordered children index is enabled.
+     *
+     * @param self Object instance.
+     * @return TRUE if the index is enabled; and FALSE if not.
+     */
+    return ( self->type == NINI_ROOT || self->type == NINI_SECTION ) && self->childs.index;
+}
+
+bool nini_node_lower_bound(nini_node_t *self, const char *name, nini_node_iter_t *iter);
+bool nini_node_scan_prefix(nini_node_t *self, const char *prefix, nini_node_iter_t *iter);
+bool nini_node_scan_range (nini_node_t *self, const char *first, const char *last, nini_node_iter_t *iter);
+
+nini_node_t* nini_node_iter_next(nini_node_iter_t *iter);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -280,6 +348,23 @@ void nini_node_unlink    (nini_node_t *self);
 namespace nini
 {
 
+class TNode;
+
+/// C++ wrapper of nini_node_iter_t.
+class TNodeIter : protected nini_node_iter_t
+{
+    friend class TNode;
+    friend class TRoot;
+
+public:
+    /// Constructor, the iterator will be empty before a scan.
+    TNodeIter() { this->index = 0; this->pos = this->end = 0; }
+
+public:
+    /// The same as nini_node_iter_next.
+    TNode* Next() { return (TNode*) nini_node_iter_next(this); }
+};
+
 /**
  * @brief C++ wrapper of nini_node_t.
  */
@@ -321,6 +406,9 @@ public:
     static TNode* CreateNull(const std::string &name)
     { return (TNode*) nini_node_create_null(name.c_str()); }
 
+    /// The same as nini_node_clone.
+    TNode* Clone() const { return (TNode*) nini_node_clone(this); }
+
     /// Destruct and release object instance, the same as nini_node_release.
     void Release() { nini_node_release(this); }
 
@@ -333,6 +421,8 @@ public:
     bool HaveValue() const { return nini_node_have_value(this); }
     /// The same as nini_node_have_child.
     bool HaveChild() const { return nini_node_have_child(this); }
+    /// The same as nini_node_get_hash.
+    uint64_t GetHash() const { return nini_node_get_hash(this); }
 
     /// The same as nini_node_get_prev_sibling.
     TNode* GetPrevSibling() { return (TNode*) nini_node_get_prev_sibling(this); }
@@ -369,7 +459,35 @@ public:
     /// Ths same as nini_node_link_child.
     bool LinkChild(TNode *node) { return nini_node_link_child(this, node); }
     /// The same as nini_node_unlink.
-    void Unlink() { nini_node_unlink(this); }
+    bool Unlink() { return nini_node_unlink(this); }
+    /// The same as nini_node_replace.
+    bool Replace(TNode *node) { return nini_node_replace(this, node); }
+    /// The same as nini_node_copy_value.
+    bool CopyValue(const TNode *src) { return nini_node_copy_value(this, src); }
+    /// The same as nini_node_move_after.
+    bool MoveAfter(TNode *prev) { return nini_node_move_after(this, prev); }
+
+    /// The same as nini_node_is_shared.
+    bool IsShared() const { return nini_node_is_shared(this); }
+    /// The same as nini_node_unshare.
+    bool Unshare() { return nini_node_unshare(this); }
+
+    /// The same as nini_node_enable_index.
+    bool EnableIndex() { return nini_node_enable_index(this); }
+    /// The same as nini_node_disable_index.
+    void DisableIndex() { nini_node_disable_index(this); }
+    /// The same as nini_node_have_index.
+    bool HaveIndex() const { return nini_node_have_index(this); }
+
+    /// The same as nini_node_lower_bound.
+    bool LowerBound(const std::string &name, TNodeIter &iter)
+    { return nini_node_lower_bound(this, name.c_str(), &iter); }
+    /// The same as nini_node_scan_prefix.
+    bool ScanPrefix(const std::string &prefix, TNodeIter &iter)
+    { return nini_node_scan_prefix(this, prefix.c_str(), &iter); }
+    /// The same as nini_node_scan_range, with both bounds specified.
+    bool ScanRange(const std::string &first, const std::string &last, TNodeIter &iter)
+    { return nini_node_scan_range(this, first.c_str(), last.c_str(), &iter); }
 
 };
 
@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @brief     Nested INI number formatting and parsing.
+ * @details   This module formats numbers to the same text as the NINI encoder does,
+ *            and parses floating point numbers as the NINI decoder does,
+ *            without depending on the C library conversion functions and the locale.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_NUMBER_H_
+#define _NINI_NUMBER_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum characters of a formatted number, including the null terminator.
+ */
+#define NINI_NUMBER_MAX_CHARS 32
+
+size_t nini_number_format_decimal(char *buf, long value);
+size_t nini_number_format_hexa   (char *buf, long value);
+size_t nini_number_format_float  (char *buf, double value);
+
+size_t nini_number_parse_float(const char *str, double *value);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+namespace nini
+{
+
+/// The same as nini_number_format_decimal.
+inline std::string FormatDecimal(long value)
+{
+    char buf[NINI_NUMBER_MAX_CHARS];
+    return std::string(buf, nini_number_format_decimal(buf, value));
+}
+
+/// The same as nini_number_format_hexa.
+inline std::string FormatHexa(long value)
+{
+    char buf[NINI_NUMBER_MAX_CHARS];
+    return std::string(buf, nini_number_format_hexa(buf, value));
+}
+
+/// The same as nini_number_format_float.
+inline std::string FormatFloat(double value)
+{
+    char buf[NINI_NUMBER_MAX_CHARS];
+    return std::string(buf, nini_number_format_float(buf, value));
+}
+
+/// The same as nini_number_parse_float.
+inline size_t ParseFloat(const std::string &str, double &value)
+{
+    return nini_number_parse_float(str.c_str(), &value);
+}
+
+}
+
+#endif
+
+#endif
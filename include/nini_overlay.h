@@ -0,0 +1,178 @@
+/**
+ * @file
+ * @brief     Nested INI layered overlay.
+ * @details   This module reads settings through an ordered list of roots without merging them.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_OVERLAY_H_
+#define _NINI_OVERLAY_H_
+
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum layers of an overlay.
+ */
+#define NINI_MAX_OVERLAY_LAYERS 16
+
+/**
+ * @class nini_overlay_t
+ * @brief Layered overlay.
+ * @details An overlay resolves a @ref key-path to the node of the first layer that has the path,
+ *          so that layers added earlier override layers added later.
+ *          For example, add runtime, host, site, and then default settings.
+ *
+ *          Results of paths are memoized,
+ *          and all results will be dropped when any layer is changed.
+ *          Changes of layers are detected by content hashes (see nini_node_get_hash),
+ *          so that the first lookup after changes of a layer will compute the hashes of the changed nodes.
+ *
+ * @remarks The overlay only refers to the layers, and they must be valid during the life of the overlay.
+ * @remarks Lookups modify the memo, so that an overlay cannot be used by multiple threads at the same time,
+ *          even if all layers are frozen.
+ */
+typedef struct nini_overlay_t
+{
+    // WARNING: All variables are private!
+
+    char deli;
+
+    const nini_root_t *layers[NINI_MAX_OVERLAY_LAYERS];
+    unsigned           count;
+
+    struct nini_table_t *memo;      // Hash table of memoized paths.
+
+} nini_overlay_t;
+
+void nini_overlay_init  (nini_overlay_t *self, char deli);
+void nini_overlay_deinit(nini_overlay_t *self);
+
+bool nini_overlay_add_layer(nini_overlay_t *self, const nini_root_t *root);
+
+static inline
+unsigned nini_overlay_get_layer_count(const nini_overlay_t *self)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Get count of layers.
+     *
+     * @param self Object instance.
+     * @return Count of layers.
+     */
+    return self->count;
+}
+
+const nini_node_t* nini_overlay_find(nini_overlay_t *self, const char *path);
+
+bool        nini_overlay_is_existed(nini_overlay_t *self, const char *path);
+nini_type_t nini_overlay_get_type  (nini_overlay_t *self, const char *path);
+
+const char* nini_overlay_read_string (nini_overlay_t *self, const char *path, const char *failval);
+long        nini_overlay_read_integer(nini_overlay_t *self, const char *path, long failval);
+double      nini_overlay_read_float  (nini_overlay_t *self, const char *path, double failval);
+bool        nini_overlay_read_bool   (nini_overlay_t *self, const char *path, bool failval);
+
+/**
+ * @class nini_overlay_iter_t
+ * @brief Merged children iterator.
+ * @details The iterator walks children of a section in all layers lazily,
+ *          and a child is skipped if a layer before has a child with the same name,
+ *          so that each child is the one that its path resolves to.
+ *          Children with the same name in one layer are all iterated as they are in the layer.
+ *
+ * @remarks The layers must not be changed during the iteration.
+ * @remarks Finding children by names is faster if the ordered children index of sections is enabled,
+ *          see nini_node_enable_index.
+ */
+typedef struct nini_overlay_iter_t
+{
+    // WARNING: All variables are private!
+
+    const nini_node_t *sections[NINI_MAX_OVERLAY_LAYERS];  // The section in each layer, or NULL.
+    unsigned           count;
+    unsigned           layer;
+    const nini_node_t *next;
+
+} nini_overlay_iter_t;
+
+void               nini_overlay_iter_init(nini_overlay_iter_t *self, const nini_overlay_t *overlay, const char *path);
+const nini_node_t* nini_overlay_iter_next(nini_overlay_iter_t *self);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+namespace nini
+{
+
+/// C++ wrapper of nini_overlay_t.
+class TOverlay : protected nini_overlay_t
+{
+    friend class TOverlayIter;
+
+public:
+    /// Constructor.
+    TOverlay(char deli) { nini_overlay_init(this, deli); }
+    /// Destructor.
+    ~TOverlay() { nini_overlay_deinit(this); }
+
+private:
+    TOverlay(const TOverlay &src);              // Not allowed to use!
+    TOverlay& operator=(const TOverlay &src);   // Not allowed to use!
+
+public:
+    /// The same as nini_overlay_add_layer.
+    bool AddLayer(const TRoot &root) { return nini_overlay_add_layer(this, (const nini_root_t*) &root); }
+    /// The same as nini_overlay_get_layer_count.
+    unsigned GetLayerCount() const { return nini_overlay_get_layer_count(this); }
+
+    /// The same as nini_overlay_find.
+    const TNode* Find(const std::string &path)
+    { return (const TNode*) nini_overlay_find(this, path.c_str()); }
+
+    /// The same as nini_overlay_is_existed.
+    bool IsExisted(const std::string &path) { return nini_overlay_is_existed(this, path.c_str()); }
+    /// The same as nini_overlay_get_type.
+    TType GetType(const std::string &path) { return nini_overlay_get_type(this, path.c_str()); }
+
+    /// The same as nini_overlay_read_string.
+    std::string ReadString(const std::string &path, const std::string &failval="")
+    { return nini_overlay_read_string(this, path.c_str(), failval.c_str()); }
+    /// The same as nini_overlay_read_integer.
+    long ReadInteger(const std::string &path, long failval=0)
+    { return nini_overlay_read_integer(this, path.c_str(), failval); }
+    /// The same as nini_overlay_read_float.
+    double ReadFloat(const std::string &path, double failval=0)
+    { return nini_overlay_read_float(this, path.c_str(), failval); }
+    /// The same as nini_overlay_read_bool.
+    bool ReadBool(const std::string &path, bool failval=false)
+    { return nini_overlay_read_bool(this, path.c_str(), failval); }
+};
+
+/// C++ wrapper of nini_overlay_iter_t.
+class TOverlayIter : protected nini_overlay_iter_t
+{
+public:
+    /// Constructor, the same as nini_overlay_iter_init.
+    TOverlayIter(const TOverlay &overlay, const std::string &path)
+    { nini_overlay_iter_init(this, (const nini_overlay_t*) &overlay, path.c_str()); }
+
+public:
+    /// The same as nini_overlay_iter_next.
+    const TNode* Next() { return (const TNode*) nini_overlay_iter_next(this); }
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file
+ * @brief     Nested INI binary patch.
+ * @details   This module computes the structural differences between two roots as a compact binary patch,
+ *            so that changes can be shipped and applied instead of the whole NINI format data.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_PATCH_H_
+#define _NINI_PATCH_H_
+
+#include <stdint.h>
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @class nini_patch_t
+ * @brief Binary patch.
+ * @details A patch records the inserts, deletes, moves, and updates those change a base root to a target root.
+ *          Nodes are addressed by their positions in their parents,
+ *          and sections with the same content hash are skipped,
+ *          so that both the size of the patch and the time to apply it depend on the changes,
+ *          not on the size of the roots.
+ *          The patch carries content hashes of the base and the target (see nini_root_get_hash),
+ *          and it can only be applied to a root that is the same as the base.
+ *
+ * For example:
+ *
+ *     // On the sender.
+ *     nini_patch_t patch;
+ *     nini_patch_init(&patch);
+ *     nini_patch_diff(&patch, &old_root, &new_root, NULL);
+ *     send(nini_patch_get_data(&patch), nini_patch_get_size(&patch));
+ *
+ *     // On the receiver.
+ *     nini_patch_load(&patch, data, size, NULL);
+ *     nini_patch_apply(&patch, &root, NULL);
+ *
+ * @remarks Comments and formatting of the root are not a part of the patch,
+ *          and changed nodes will be formatted as usual if the root is in the lossless mode.
+ */
+typedef struct nini_patch_t
+{
+    // WARNING: All variables are private!
+
+    uint8_t *data;
+    size_t   size;
+    size_t   capacity;
+
+} nini_patch_t;
+
+void nini_patch_init  (nini_patch_t *self);
+void nini_patch_deinit(nini_patch_t *self);
+
+bool nini_patch_diff(nini_patch_t *self, const nini_root_t *base, const nini_root_t *target, nini_errmsg_t *errmsg);
+bool nini_patch_load(nini_patch_t *self, const void *data, size_t size, nini_errmsg_t *errmsg);
+
+static inline
+const void* nini_patch_get_data(const nini_patch_t *self)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Get the patch data.
+     *
+     * @param self Object instance.
+     * @return The patch data, or NULL if the patch is empty.
+     */
+    return self->data;
+}
+
+static inline
+size_t nini_patch_get_size(const nini_patch_t *self)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Get size of the patch data.
+     *
+     * @param self Object instance.
+     * @return Size of the patch data.
+     */
+    return self->size;
+}
+
+uint64_t nini_patch_get_base_hash  (const nini_patch_t *self);
+uint64_t nini_patch_get_target_hash(const nini_patch_t *self);
+
+bool nini_patch_apply(const nini_patch_t *self, nini_root_t *root, nini_errmsg_t *errmsg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_patch_t.
+class TPatch : protected nini_patch_t
+{
+public:
+    /// Constructor.
+    TPatch() { nini_patch_init(this); }
+    /// Destructor.
+    ~TPatch() { nini_patch_deinit(this); }
+
+private:
+    TPatch(const TPatch &src);              // Not allowed to use!
+    TPatch& operator=(const TPatch &src);   // Not allowed to use!
+
+public:
+    /// The same as nini_patch_diff.
+    bool Diff(const TRoot &base, const TRoot &target, TErrMsg *errmsg=nullptr)
+    { return nini_patch_diff(this, (const nini_root_t*) &base, (const nini_root_t*) &target, errmsg); }
+    /// The same as nini_patch_load.
+    bool Load(const void *data, size_t size, TErrMsg *errmsg=nullptr)
+    { return nini_patch_load(this, data, size, errmsg); }
+
+    /// The same as nini_patch_get_data.
+    const void* GetData() const { return nini_patch_get_data(this); }
+    /// The same as nini_patch_get_size.
+    size_t GetSize() const { return nini_patch_get_size(this); }
+    /// The same as nini_patch_get_base_hash.
+    uint64_t GetBaseHash() const { return nini_patch_get_base_hash(this); }
+    /// The same as nini_patch_get_target_hash.
+    uint64_t GetTargetHash() const { return nini_patch_get_target_hash(this); }
+
+    /// The same as nini_patch_apply.
+    bool Apply(TRoot &root, TErrMsg *errmsg=nullptr) const
+    { return nini_patch_apply(this, (nini_root_t*) &root, errmsg); }
+};
+
+}
+
+#endif
+
+#endif
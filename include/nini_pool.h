@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @brief     Nested INI shared sections pool.
+ * @details   This module shares identical sections of many roots.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_POOL_H_
+#define _NINI_POOL_H_
+
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @class nini_pool_t
+ * @brief Shared sections pool.
+ * @details A pool keeps distinct sections,
+ *          and sections of roots with the same content (names, types, values, and children)
+ *          are changed to share the children of one reference counted section,
+ *          so that memory scales with the number of distinct sections instead of the count of roots.
+ *
+ *          A shared section is frozen (see nini_node_is_shared),
+ *          and it is copied on write by the helper functions (such as nini_write_string)
+ *          and nini_root_merge.
+ *          Other changes will fail as they do on frozen nodes until the section is unshared
+ *          by nini_node_unshare.
+ *
+ * @remarks Children of a shared section have the section in the pool as their parent,
+ *          so that the parent of such a child is not the section it was found from.
+ * @remarks Roots and the pool can be released in any order.
+ * @remarks Reference counts are not atomic,
+ *          so that roots sharing sections must not be cloned, changed, or released
+ *          by multiple threads at the same time.
+ */
+typedef struct nini_pool_t
+{
+    // WARNING: All variables are private!
+
+    struct nini_table_t *table;     // Hash table of shared sections by their content hashes.
+
+} nini_pool_t;
+
+void nini_pool_init  (nini_pool_t *self);
+void nini_pool_deinit(nini_pool_t *self);
+
+bool   nini_pool_share    (nini_pool_t *self, nini_root_t *root);
+size_t nini_pool_purge    (nini_pool_t *self);
+size_t nini_pool_get_count(const nini_pool_t *self);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+namespace nini
+{
+
+/// C++ wrapper of nini_pool_t.
+class TPool : protected nini_pool_t
+{
+public:
+    /// Constructor.
+    TPool() { nini_pool_init(this); }
+    /// Destructor.
+    ~TPool() { nini_pool_deinit(this); }
+
+private:
+    TPool(const TPool &src);              // Not allowed to use!
+    TPool& operator=(const TPool &src);   // Not allowed to use!
+
+public:
+    /// The same as nini_pool_share.
+    bool Share(TRoot &root) { return nini_pool_share(this, (nini_root_t*) &root); }
+    /// The same as nini_pool_purge.
+    size_t Purge() { return nini_pool_purge(this); }
+    /// The same as nini_pool_get_count.
+    size_t GetCount() const { return nini_pool_get_count(this); }
+};
+
+}
+
+#endif
+
+#endif
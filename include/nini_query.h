@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @brief     Nested INI path query.
+ * @details   This module finds nodes by path patterns with wildcards.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_QUERY_H_
+#define _NINI_QUERY_H_
+
+#include <stdint.h>
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * @section query-pattern Query Pattern
+ *
+ * A query pattern is a @ref key-path which its names can be replaced by wildcards:
+ * * "*"  matches exactly one node of any name.
+ * * "**" matches zero or more levels of nodes of any names.
+ *
+ * For example, with the delimiter '/',
+ * "servers/ * /port" (without spaces) matches "port" of all direct sub-sections of "servers",
+ * and "record/ ** /enabled" (without spaces) matches all "enabled"
+ * at any level under "record", including "record/enabled".
+ *
+ * Literal names will be resolved the same as the key path lookup,
+ * that is, only the first one of children with the same name will be matched.
+ *
+ * A query visits nodes nested at most NINI_MAX_PARSE_LEVEL levels under the base node,
+ * the same as the decoder accepts,
+ * and deeper nodes of trees built by other ways are skipped (see nini_query_iter_is_truncated).
+ */
+
+/**
+ * @brief Maximum segments of a query pattern.
+ */
+#define NINI_MAX_QUERY_SEGMENTS 63
+
+/**
+ * @class nini_query_t
+ * @brief Compiled query pattern.
+ */
+typedef struct nini_query_t
+{
+    // WARNING: All variables are private!
+
+    char     pattern[NINI_MAX_LINE_CHARS+1];
+    unsigned count;
+
+    struct
+    {
+        unsigned name;  // Offset of the name in the pattern buffer.
+        int      kind;
+    } segments[NINI_MAX_QUERY_SEGMENTS];
+
+} nini_query_t;
+
+bool nini_query_compile(nini_query_t *self, const char *pattern, char deli);
+
+/**
+ * @brief Query iterator frame (private).
+ */
+typedef struct nini_query_frame_t
+{
+    nini_node_t *next;
+    const char  *literal;
+    uint64_t     states;
+} nini_query_frame_t;
+
+/**
+ * @class nini_query_iter_t
+ * @brief Query result iterator.
+ */
+typedef struct nini_query_iter_t
+{
+    // WARNING: All variables are private!
+
+    const nini_query_t *query;
+
+    nini_query_frame_t frames[NINI_MAX_PARSE_LEVEL];
+    unsigned           depth;
+    bool               truncated;
+
+} nini_query_iter_t;
+
+void         nini_query_iter_init(nini_query_iter_t *self, const nini_query_t *query, nini_node_t *base);
+nini_node_t* nini_query_iter_next(nini_query_iter_t *self);
+
+static inline
+void nini_query_iter_init_root(nini_query_iter_t *self, const nini_query_t *query, nini_root_t *root)
+{
+    /**
+     * @memberof nini_query_iter_t
+     * @brief Start a query from the root.
+     *
+     * @param self  Object instance.
+     * @param query The compiled query pattern,
+     *              and it must be valid during the life of the iterator.
+     * @param root  The root node of NINI nodes.
+     */
+    nini_query_iter_init(self, query, &root->super);
+}
+
+static inline
+bool nini_query_iter_is_truncated(const nini_query_iter_t *self)
+{
+    /**
+     * @memberof nini_query_iter_t
+     * @brief Check if any node be skipped for it is nested too deep.
+     *
+     * @param self Object instance.
+     * @return TRUE if some nodes those might be matched were skipped; and FALSE if not.
+     *
+     * @remarks Results of the iteration are incomplete if this function returns TRUE.
+     */
+    return self->truncated;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+namespace nini
+{
+
+/// C++ wrapper of nini_query_t.
+class TQuery : protected nini_query_t
+{
+    friend class TQueryIter;
+
+private:
+    bool valid;
+
+public:
+    /// Constructor, see nini_query_compile for more details.
+    TQuery(const std::string &pattern, char deli)
+    { this->valid = nini_query_compile(this, pattern.c_str(), deli); }
+
+public:
+    /// Check if the pattern be compiled successfully.
+    bool IsValid() const { return this->valid; }
+};
+
+/// C++ wrapper of nini_query_iter_t.
+class TQueryIter : protected nini_query_iter_t
+{
+public:
+    /// Constructor, the same as nini_query_iter_init_root.
+    TQueryIter(const TQuery &query, TRoot &root)
+    { nini_query_iter_init_root(this, (const nini_query_t*)&query, (nini_root_t*)&root); }
+
+    /// Constructor, the same as nini_query_iter_init.
+    TQueryIter(const TQuery &query, TNode *base)
+    { nini_query_iter_init(this, (const nini_query_t*)&query, (nini_node_t*)base); }
+
+public:
+    /// The same as nini_query_iter_next.
+    TNode* Next() { return (TNode*) nini_query_iter_next(this); }
+    /// The same as nini_query_iter_is_truncated.
+    bool IsTruncated() const { return nini_query_iter_is_truncated(this); }
+};
+
+}
+
+#endif
+
+#endif
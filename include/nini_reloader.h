@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief     Nested INI incremental reloader.
+ * @details   This module reloads a root by applying only the differences of the new data,
+ *            and reports the changes to subscribers.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_RELOADER_H_
+#define _NINI_RELOADER_H_
+
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Change types.
+ */
+typedef enum nini_change_type_t
+{
+    NINI_INSERTED,  ///< A node is inserted.
+    NINI_DELETED,   ///< A node is deleted.
+    NINI_UPDATED,   ///< A key has a different type or value, or a node is replaced by another type of node.
+} nini_change_type_t;
+
+/**
+ * @brief Change of a node.
+ */
+typedef struct nini_change_t
+{
+    nini_change_type_t  type;
+    const char         *path;       ///< Path of the node, separated by the reloader delimiter.
+    const nini_node_t  *old_node;   ///< A detached node with the old content, or NULL if inserted.
+    const nini_node_t  *new_node;   ///< The node in the root, or NULL if deleted.
+} nini_change_t;
+
+/**
+ * @brief   User defined change handler.
+ * @details User defined function that will be called with changes of a reload.
+ *
+ * @param arg     The user defined argument.
+ * @param changes Changes those match the subscribed prefix, in the order of the new data,
+ *                except that deletions of children of a section are reported before others.
+ *                The changes and the old nodes are valid only in this function.
+ * @param count   Count of changes.
+ */
+typedef void(*nini_on_change_t)(void *arg, const nini_change_t *changes, size_t count);
+
+/**
+ * @class nini_reloader_t
+ * @brief Incremental reloader.
+ * @details The reloader decodes the new data to a temporary root, compares it with the root,
+ *          and applies only the inserts, deletes, and updates to the root.
+ *          Unchanged nodes, sections those contain changes, and keys those values be updated
+ *          keep their addresses, so that node pointers held by others remain valid.
+ *          Children with the same name are matched in their order.
+ *
+ *          Subscribers are notified with changes under their prefixes after each reload.
+ *          A change of a section is reported once for the whole section,
+ *          and it matches subscribers of the section, its descendants, and its ancestors.
+ *
+ * @remarks Comments and formatting of the new data will be kept
+ *          if the root is in the lossless mode, see nini_root_enable_lossless.
+ */
+typedef struct nini_reloader_t
+{
+    // WARNING: All variables are private!
+
+    nini_root_t *root;
+    char         deli;
+
+    struct nini_subscriber_t *subscribers;
+    size_t                    count;
+    size_t                    capacity;
+
+} nini_reloader_t;
+
+void nini_reloader_init  (nini_reloader_t *self, nini_root_t *root, char deli);
+void nini_reloader_deinit(nini_reloader_t *self);
+
+bool nini_reloader_subscribe  (nini_reloader_t *self, const char *prefix, nini_on_change_t on_change, void *arg);
+void nini_reloader_unsubscribe(nini_reloader_t *self, nini_on_change_t on_change, void *arg);
+
+bool nini_reloader_decode   (nini_reloader_t *self, const void *data, size_t size, nini_errmsg_t *errmsg);
+bool nini_reloader_load_file(nini_reloader_t *self, const char *filename, nini_errmsg_t *errmsg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_change_type_t.
+typedef nini_change_type_t TChangeType;
+/// C++ wrapper of nini_change_t.
+typedef nini_change_t TChange;
+
+/// C++ wrapper of nini_reloader_t.
+class TReloader : protected nini_reloader_t
+{
+public:
+    /// Constructor.
+    TReloader(TRoot &root, char deli) { nini_reloader_init(this, (nini_root_t*) &root, deli); }
+    /// Destructor.
+    ~TReloader() { nini_reloader_deinit(this); }
+
+private:
+    TReloader(const TReloader &src);            // Not allowed to use!
+    TReloader& operator=(const TReloader &src); // Not allowed to use!
+
+public:
+    /// The same as nini_reloader_subscribe.
+    bool Subscribe(const std::string &prefix, nini_on_change_t on_change, void *arg)
+    { return nini_reloader_subscribe(this, prefix.c_str(), on_change, arg); }
+    /// The same as nini_reloader_unsubscribe.
+    void Unsubscribe(nini_on_change_t on_change, void *arg)
+    { nini_reloader_unsubscribe(this, on_change, arg); }
+
+    /// The same as nini_reloader_decode.
+    bool Decode(const void *data, size_t size, TErrMsg *errmsg=nullptr)
+    { return nini_reloader_decode(this, data, size, errmsg); }
+    /// The same as nini_reloader_load_file.
+    bool LoadFile(const std::string &filename, TErrMsg *errmsg=nullptr)
+    { return nini_reloader_load_file(this, filename.c_str(), errmsg); }
+};
+
+}
+
+#endif
+
+#endif
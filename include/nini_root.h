@@ -21,12 +21,26 @@ extern "C" {
  *
  * @param stream The user defined stream object.
  * @param line   The data to be write to the stream,
- *               and that will be one line of the NINI format characters.
+ *               and that will be a block of one or more complete lines of
+ *               the NINI format characters.
  * @param len    Size of the data.
  * @return TRUE if success; and FALSE if not.
  */
 typedef bool(*nini_on_write_t)(void *stream, const char *line, size_t len);
 
+/**
+ * @brief Policy of items with the same name in a section when decoding,
+ *        see nini_root_set_duplicates.
+ */
+typedef enum nini_duplicates_t
+{
+    NINI_DUPLICATES_KEEP_ALL,       ///< Keep all items as they are in the data.
+    NINI_DUPLICATES_MERGE_SECTIONS, ///< Merge sections with the same name, and keep all keys.
+    NINI_DUPLICATES_FIRST_WINS,     ///< Merge sections with the same name, and drop later items.
+    NINI_DUPLICATES_LAST_WINS,      ///< Merge sections with the same name, and later items replace earlier ones.
+    NINI_DUPLICATES_ERROR,          ///< Fail the decode.
+} nini_duplicates_t;
+
 /**
  * @class nini_root_t
  * @brief Root node.
@@ -39,6 +53,13 @@ typedef struct nini_root_t
 
     nini_format_t format;
 
+    struct nini_phash_t *phash;
+
+    struct nini_source_t *source;
+    bool                  lossless;
+
+    nini_duplicates_t duplicates;
+
 } nini_root_t;
 
 void nini_root_init  (nini_root_t *self, const nini_format_t *format);
@@ -148,6 +169,7 @@ bool nini_root_link_child(nini_root_t *self, nini_node_t *node)
      *         * The node is a virtual node.
      *         * Self node is not a section type or root type of node,
      *           and cannot have a child.
+     *         * Self node is frozen.
      *
      * @remarks The child node will be managed by its parent,
      *          and it will be released when its parent be destructed.
@@ -156,20 +178,159 @@ bool nini_root_link_child(nini_root_t *self, nini_node_t *node)
     return nini_node_link_child(&self->super, node);
 }
 
+static inline
+bool nini_root_enable_index(nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Enable the ordered children index, see nini_node_enable_index for more details.
+     *
+     * @param self Object instance.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return nini_node_enable_index(&self->super);
+}
+
+static inline
+void nini_root_disable_index(nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Disable and release the ordered children index.
+     *
+     * @param self Object instance.
+     */
+    nini_node_disable_index(&self->super);
+}
+
+static inline
+bool nini_root_scan_prefix(nini_root_t *self, const char *prefix, nini_node_iter_t *iter)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Iterate children those their names start with the specified prefix,
+     *        see nini_node_scan_prefix for more details.
+     *
+     * @param self   Object instance.
+     * @param prefix The name prefix.
+     * @param iter   The iterator to be initialised.
+     * @return TRUE if succeed; and FALSE if the index is not enabled.
+     */
+    return nini_node_scan_prefix(&self->super, prefix, iter);
+}
+
+static inline
+bool nini_root_scan_range(nini_root_t *self, const char *first, const char *last, nini_node_iter_t *iter)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Iterate children those their names are in a range,
+     *        see nini_node_scan_range for more details.
+     *
+     * @param self  Object instance.
+     * @param first The lower bound (inclusive) of names, or NULL to start from the first child.
+     * @param last  The upper bound (exclusive) of names, or NULL to iterate to the last child.
+     * @param iter  The iterator to be initialised.
+     * @return TRUE if succeed; and FALSE if the index is not enabled.
+     */
+    return nini_node_scan_range(&self->super, first, last, iter);
+}
+
+static inline
+uint64_t nini_root_get_hash(const nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Get the content hash of the whole tree, see nini_node_get_hash for more details.
+     * @details The hash can be used as a fingerprint of the configuration,
+     *          and two roots with the same hash have the same content.
+     *
+     * @param self Object instance.
+     * @return The content hash.
+     */
+    return nini_node_get_hash(&self->super);
+}
+
+bool nini_root_freeze(nini_root_t *self, char deli);
+void nini_root_thaw  (nini_root_t *self);
+
+static inline
+bool nini_root_is_frozen(const nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Check if the root is frozen.
+     *
+     * @param self Object instance.
+     * @return TRUE if the root is frozen; and FALSE if not.
+     */
+    return self->super.frozen;
+}
+
+void nini_root_enable_lossless (nini_root_t *self);
+void nini_root_disable_lossless(nini_root_t *self);
+
+static inline
+bool nini_root_is_lossless(const nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Check if the lossless mode is enabled.
+     *
+     * @param self Object instance.
+     * @return TRUE if the lossless mode is enabled; and FALSE if not.
+     */
+    return self->lossless;
+}
+
+void nini_root_set_duplicates(nini_root_t *self, nini_duplicates_t policy);
+
+static inline
+nini_duplicates_t nini_root_get_duplicates(const nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Get the policy of duplicate names.
+     *
+     * @param self Object instance.
+     * @return The policy, see nini_root_set_duplicates.
+     */
+    return self->duplicates;
+}
+
 bool nini_root_decode(nini_root_t *self, const void *data, size_t size, nini_errmsg_t *errmsg);
+bool nini_root_merge (nini_root_t *self, const void *data, size_t size, nini_errmsg_t *errmsg);
 
 size_t nini_root_encode_to_stream(const nini_root_t *self,
                                   void              *stream,
                                   nini_on_write_t    on_write,
                                   nini_errmsg_t     *errmsg);
 
+size_t nini_root_encode_to_stream_parallel(const nini_root_t *self,
+                                           void              *stream,
+                                           nini_on_write_t    on_write,
+                                           unsigned           threads,
+                                           nini_errmsg_t     *errmsg);
+
 size_t nini_root_encode_to_buffer(const nini_root_t *self,
                                   void              *buf,
                                   size_t             size,
                                   nini_errmsg_t     *errmsg);
 
-bool nini_root_load_file(nini_root_t *self, const char *filename, nini_errmsg_t *errmsg);
+size_t nini_root_encoded_size    (const nini_root_t *self);
+void*  nini_root_encode_to_memory(const nini_root_t *self, size_t *size, nini_errmsg_t *errmsg);
+
+bool nini_root_load_file (nini_root_t *self, const char *filename, nini_errmsg_t *errmsg);
+bool nini_root_merge_file(nini_root_t *self, const char *filename, nini_errmsg_t *errmsg);
 bool nini_root_save_file(const nini_root_t *self, const char *filename, nini_errmsg_t *errmsg);
+bool nini_root_save_file_parallel(const nini_root_t *self,
+                                  const char        *filename,
+                                  unsigned           threads,
+                                  nini_errmsg_t     *errmsg);
+bool nini_root_save_file_atomic(const nini_root_t *self,
+                                const char        *filename,
+                                unsigned           threads,
+                                nini_errmsg_t     *errmsg);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -177,6 +338,9 @@ bool nini_root_save_file(const nini_root_t *self, const char *filename, nini_err
 
 #ifdef __cplusplus
 
+#include <vector>
+#include <streambuf>
+
 #if __cplusplus < 201103L
 #undef nullptr
 #define nullptr NULL
@@ -185,6 +349,9 @@ bool nini_root_save_file(const nini_root_t *self, const char *filename, nini_err
 namespace nini
 {
 
+/// C++ wrapper of nini_duplicates_t.
+typedef nini_duplicates_t TDuplicates;
+
 /// C++ wrapper of nini_root_t.
 class TRoot : protected nini_root_t
 {
@@ -219,25 +386,133 @@ public:
     /// The same as nini_root_link_child.
     bool LinkChild(TNode *node) { return nini_root_link_child(this, (nini_node_t*)node); }
 
+    /// The same as nini_root_enable_index.
+    bool EnableIndex() { return nini_root_enable_index(this); }
+    /// The same as nini_root_disable_index.
+    void DisableIndex() { nini_root_disable_index(this); }
+    /// The same as nini_root_scan_prefix.
+    bool ScanPrefix(const std::string &prefix, TNodeIter &iter)
+    { return nini_root_scan_prefix(this, prefix.c_str(), &iter); }
+    /// The same as nini_root_scan_range, with both bounds specified.
+    bool ScanRange(const std::string &first, const std::string &last, TNodeIter &iter)
+    { return nini_root_scan_range(this, first.c_str(), last.c_str(), &iter); }
+
+    /// The same as nini_root_get_hash.
+    uint64_t GetHash() const { return nini_root_get_hash(this); }
+
+    /// The same as nini_root_freeze.
+    bool Freeze(char deli) { return nini_root_freeze(this, deli); }
+    /// The same as nini_root_thaw.
+    void Thaw() { nini_root_thaw(this); }
+    /// The same as nini_root_is_frozen.
+    bool IsFrozen() const { return nini_root_is_frozen(this); }
+
+    /// The same as nini_root_enable_lossless.
+    void EnableLossless() { nini_root_enable_lossless(this); }
+    /// The same as nini_root_disable_lossless.
+    void DisableLossless() { nini_root_disable_lossless(this); }
+    /// The same as nini_root_is_lossless.
+    bool IsLossless() const { return nini_root_is_lossless(this); }
+
+    /// The same as nini_root_set_duplicates.
+    void SetDuplicates(TDuplicates policy) { nini_root_set_duplicates(this, policy); }
+    /// The same as nini_root_get_duplicates.
+    TDuplicates GetDuplicates() const { return nini_root_get_duplicates(this); }
+
     /// The same as nini_root_decode.
     bool Decode(const void *data, size_t size, TErrMsg *errmsg=nullptr)
     { return nini_root_decode(this, data, size, errmsg); }
+    /// The same as nini_root_merge.
+    bool Merge(const void *data, size_t size, TErrMsg *errmsg=nullptr)
+    { return nini_root_merge(this, data, size, errmsg); }
 
     /// This same as nini_root_encode_to_stream.
     size_t EncodeToStream(void *stream, nini_on_write_t on_write, TErrMsg *errmsg=nullptr)
     { return nini_root_encode_to_stream(this, stream, on_write, errmsg); }
 
+    /// The same as nini_root_encode_to_stream_parallel.
+    size_t EncodeToStreamParallel(void *stream, nini_on_write_t on_write, unsigned threads=0, TErrMsg *errmsg=nullptr) const
+    { return nini_root_encode_to_stream_parallel(this, stream, on_write, threads, errmsg); }
+
     /// This same as nini_root_encode_to_buffer.
     size_t EncodeToBuffer(void *buf, size_t size, TErrMsg *errmsg=nullptr)
     { return nini_root_encode_to_buffer(this, buf, size, errmsg); }
 
+    /// The same as nini_root_encoded_size.
+    size_t EncodedSize() const { return nini_root_encoded_size(this); }
+
+    /// Encode information to a string, and the string will be allocated once with the exact size.
+    bool EncodeToString(std::string &text, TErrMsg *errmsg=nullptr) const
+    {
+        text.clear();
+
+        size_t size = nini_root_encoded_size(this);
+        if( !size ) return this->CheckEmpty(errmsg);
+
+        text.resize(size);
+        if( size == nini_root_encode_to_buffer(this, &text[0], size, errmsg) ) return true;
+
+        text.clear();
+        return false;
+    }
+
+    /// Encode information to a vector, and the vector will be allocated once with the exact size.
+    bool EncodeToVector(std::vector<char> &data, TErrMsg *errmsg=nullptr) const
+    {
+        data.clear();
+
+        size_t size = nini_root_encoded_size(this);
+        if( !size ) return this->CheckEmpty(errmsg);
+
+        data.resize(size);
+        if( size == nini_root_encode_to_buffer(this, &data[0], size, errmsg) ) return true;
+
+        data.clear();
+        return false;
+    }
+
+    /// Encode information to a stream buffer (e.g. the buffer of a std::ostream).
+    size_t EncodeToStreamBuf(std::streambuf &sbuf, TErrMsg *errmsg=nullptr) const
+    {
+        return nini_root_encode_to_stream(this, &sbuf, TSink::WriteStreamBuf, errmsg);
+    }
+
+private:
+    struct TSink
+    {
+        static bool Discard(void *stream, const char *line, size_t len)
+        { return true; }
+
+        static bool WriteStreamBuf(void *stream, const char *line, size_t len)
+        { return (std::streamsize) len == ((std::streambuf*) stream)->sputn(line, len); }
+    };
+
+    bool CheckEmpty(TErrMsg *errmsg) const
+    {
+        // The root cannot be encoded if it is not empty, and encode it again to get the failure detail.
+        nini_root_encode_to_stream(this, nullptr, TSink::Discard, errmsg);
+        return !nini_root_get_first_child_c(this);
+    }
+
+public:
     /// The same as nini_root_load_file.
     bool LoadFile(const std::string &filename, TErrMsg *errmsg=nullptr)
     { return nini_root_load_file(this, filename.c_str(), errmsg); }
+    /// The same as nini_root_merge_file.
+    bool MergeFile(const std::string &filename, TErrMsg *errmsg=nullptr)
+    { return nini_root_merge_file(this, filename.c_str(), errmsg); }
 
     /// The same as nini_root_save_file.
     bool SaveFile(const std::string &filename, TErrMsg *errmsg=nullptr) const
     { return nini_root_save_file(this, filename.c_str(), errmsg); }
+
+    /// The same as nini_root_save_file_parallel.
+    bool SaveFileParallel(const std::string &filename, unsigned threads=0, TErrMsg *errmsg=nullptr) const
+    { return nini_root_save_file_parallel(this, filename.c_str(), threads, errmsg); }
+
+    /// The same as nini_root_save_file_atomic.
+    bool SaveFileAtomic(const std::string &filename, unsigned threads=0, TErrMsg *errmsg=nullptr) const
+    { return nini_root_save_file_atomic(this, filename.c_str(), threads, errmsg); }
 };
 
 }
@@ -0,0 +1,349 @@
+/**
+ * @file
+ * @brief     Nested INI structure schema (C++ only).
+ * @details   This module encodes and decodes user defined structures by their schema,
+ *            and no NINI node will be created during the encoding and decoding.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_SCHEMA_H_
+#define _NINI_SCHEMA_H_
+
+#ifdef __cplusplus
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "nini_root.h"
+#include "nini_writer.h"
+#include "nini_bind.h"
+
+/**
+ * @file
+ * @section schema-def Schema Definition
+ *
+ * A structure declares its schema by a member function template named @a Schema,
+ * and lists its fields by calling the member functions of the visitor.
+ * The visitor is either a nini::TSchemaEncoder or a nini::TSchemaDecoder,
+ * so that each field will be dispatched to a type specific function at compile time.
+ *
+ * For example:
+ *
+ *     struct TVideo
+ *     {
+ *         long width, height;
+ *         bool interlaced;
+ *
+ *         template<class TVisitor>
+ *         void Schema(TVisitor &visitor)
+ *         {
+ *             visitor.Field("width", width);
+ *             visitor.Field("height", height);
+ *             visitor.Field("interlaced", interlaced);
+ *         }
+ *     };
+ *
+ *     struct TRecord
+ *     {
+ *         std::string desc;
+ *         double      duration;
+ *         TVideo      video;
+ *
+ *         template<class TVisitor>
+ *         void Schema(TVisitor &visitor)
+ *         {
+ *             visitor.Field("desc", desc);
+ *             visitor.Field("duration", duration);
+ *             visitor.Section("video", video);
+ *         }
+ *     };
+ *
+ * Supported field types are: long (decimal or hexadecimal by nini::TSchemaEncoder::Hexa),
+ * double, bool, and std::string.
+ */
+
+namespace nini
+{
+
+/**
+ * @brief Structure encoder.
+ * @details Write NINI format lines of the structure fields to a stream directly by a nini::TWriter.
+ */
+class TSchemaEncoder
+{
+private:
+    TWriter writer;
+
+public:
+    /// Constructor.
+    TSchemaEncoder(const TFormat *format, void *stream, nini_on_write_t on_write) :
+        writer(format, stream, on_write)
+    {}
+
+public:
+    /// Write a key with decimal value.
+    void Field(const char *name, const long &value) { this->writer.WriteDecimal(name, value); }
+
+    /// Write a key with floating point value.
+    void Field(const char *name, const double &value) { this->writer.WriteFloat(name, value); }
+
+    /// Write a key with boolean value.
+    void Field(const char *name, const bool &value) { this->writer.WriteBool(name, value); }
+
+    /// Write a key with string value.
+    void Field(const char *name, const std::string &value) { this->writer.WriteString(name, value); }
+
+    /// Write a key with hexadecimal value.
+    void Hexa(const char *name, const long &value) { this->writer.WriteHexa(name, value); }
+
+    /// Write a section and all fields of the sub-structure.
+    template<class TObject>
+    void Section(const char *name, const TObject &object)
+    {
+        if( !this->writer.BeginSection(name) ) return;
+        const_cast<TObject&>(object).Schema(*this);
+        this->writer.EndSection();
+    }
+
+public:
+    /// Check if all fields be written successfully.
+    bool IsSucceed() const { return !this->writer.IsFailed(); }
+    /// Flush all fields to the stream, and return size of data be written, or ZERO if any failure occurred.
+    size_t Finish() { return this->writer.Finish(); }
+
+};
+
+/**
+ * @brief Structure decoder.
+ * @details Build binding entries of the structure fields and a binder of them
+ *          once for each structure type,
+ *          and then decode NINI format data of any format to structures by the binder.
+ *          Each entry stores values by a storer generated for the type of its field,
+ *          and keys are matched to entries by the hash index of the binder.
+ *
+ * @remarks Fields those are missing or mismatched keep their original values.
+ * @remarks The decoder of a structure type is built by the first call of GetDecoder,
+ *          and the initialization of it is not thread safe before C++11.
+ *          Programs those decode a type by multiple threads should call GetDecoder
+ *          once before the threads start.
+ *          Decoding is thread safe after the decoder is built.
+ */
+class TSchemaDecoder
+{
+private:
+    /*
+     * The line feed character cannot be presented in names,
+     * so that it is used as the path delimiter to avoid conflicts.
+     */
+    static const char deli = '\n';
+
+    const char *base;
+
+    std::string              prefix;
+    std::vector<std::string> paths;
+    std::vector<TBindEntry>  entries;
+
+    nini_binder_t binder;
+
+private:
+    template<class TObject>
+    explicit TSchemaDecoder(TObject &object) : base((const char*)&object)
+    {
+        object.Schema(*this);
+
+        for(size_t i = 0; i < this->entries.size(); ++i)
+            this->entries[i].path = this->paths[i].c_str();
+
+        // The format of the binder is not used, data are parsed by the format of each decoding.
+        nini_binder_init(&this->binder, NINI_FORMAT_NESTED_INI, deli, this->GetTable(), this->entries.size());
+    }
+
+    TSchemaDecoder(const TSchemaDecoder &src);              // Not allowed to use!
+    TSchemaDecoder& operator=(const TSchemaDecoder &src);   // Not allowed to use!
+
+public:
+    /// Destructor.
+    ~TSchemaDecoder() { nini_binder_deinit(&this->binder); }
+
+public:
+    /**
+     * @brief Get the decoder of the structure type.
+     * @details The decoder is built at the first time, and the object is only used to build it.
+     *
+     * @remarks The first call of each type is not thread safe before C++11,
+     *          see the remarks of nini::TSchemaDecoder.
+     */
+    template<class TObject>
+    static const TSchemaDecoder& GetDecoder(TObject &object)
+    {
+        // Offsets of fields are the same for all objects of the type.
+        static const TSchemaDecoder decoder(object);
+        return decoder;
+    }
+
+private:
+    const TBindEntry* GetTable() const
+    { return this->entries.empty() ? NULL : &this->entries[0]; }
+
+    static bool Store(long &field, nini_type_t type, const nini_bind_value_t &value)
+    {
+        if( type != NINI_DECIMAL && type != NINI_HEXA ) return false;
+        field = value.integer;
+        return true;
+    }
+
+    static bool Store(double &field, nini_type_t type, const nini_bind_value_t &value)
+    {
+        if( type != NINI_FLOAT ) return false;
+        field = value.floating;
+        return true;
+    }
+
+    static bool Store(bool &field, nini_type_t type, const nini_bind_value_t &value)
+    {
+        if( type != NINI_BOOL ) return false;
+        field = value.boolean;
+        return true;
+    }
+
+    static bool Store(std::string &field, nini_type_t type, const nini_bind_value_t &value)
+    {
+        if( type != NINI_STRING ) return false;
+        field = value.string;
+        return true;
+    }
+
+    template<class TField>
+    static bool OnStore(void *field, nini_type_t type, const nini_bind_value_t *value)
+    {
+        /*
+         * Entries have the type NINI_NULL, and the binder stores defaults by their types,
+         * so that defaults are skipped to keep the original values.
+         */
+        return type == NINI_NULL || Store(*(TField*) field, type, *value);
+    }
+
+    template<class TField>
+    void AddEntry(const char *name, TField &field)
+    {
+        this->paths.push_back(this->prefix + name);
+
+        TBindEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.type     = NINI_NULL;
+        entry.offset   = (const char*)&field - this->base;
+        entry.size     = sizeof(field);
+        entry.on_store = OnStore<TField>;
+
+        this->entries.push_back(entry);
+    }
+
+public:
+    /// Bind a key with integer value.
+    void Field(const char *name, long &value) { this->AddEntry(name, value); }
+
+    /// Bind a key with floating point value.
+    void Field(const char *name, double &value) { this->AddEntry(name, value); }
+
+    /// Bind a key with boolean value.
+    void Field(const char *name, bool &value) { this->AddEntry(name, value); }
+
+    /// Bind a key with string value.
+    void Field(const char *name, std::string &value) { this->AddEntry(name, value); }
+
+    /// Bind a key with integer value.
+    void Hexa(const char *name, long &value) { this->AddEntry(name, value); }
+
+    /// Bind all fields of the sub-structure under a section.
+    template<class TObject>
+    void Section(const char *name, TObject &object)
+    {
+        std::string parent = this->prefix;
+
+        this->prefix += name;
+        this->prefix += deli;
+        object.Schema(*this);
+
+        this->prefix = parent;
+    }
+
+public:
+    /// Decode the NINI format data, see nini_binder_decode for more details.
+    bool Decode(const TFormat *format,
+                void          *object,
+                const void    *data,
+                size_t         size,
+                TBindReport   *report=nullptr,
+                TErrMsg       *errmsg=nullptr) const
+    { return nini_binder_decode_as(&this->binder, format, object, data, size, report, errmsg); }
+
+    /// Load a NINI format file, see nini_binder_load_file for more details.
+    bool LoadFile(const TFormat     *format,
+                  void              *object,
+                  const std::string &filename,
+                  TBindReport       *report=nullptr,
+                  TErrMsg           *errmsg=nullptr) const
+    { return nini_binder_load_file_as(&this->binder, format, object, filename.c_str(), report, errmsg); }
+
+};
+
+/// Encode a structure to a stream, and return size of data be written, or ZERO if failed.
+template<class TObject>
+size_t EncodeSchema(const TObject &object, const TFormat *format, void *stream, nini_on_write_t on_write)
+{
+    TSchemaEncoder encoder(format, stream, on_write);
+    const_cast<TObject&>(object).Schema(encoder);
+    return encoder.Finish();
+}
+
+/// Encode a structure to a string.
+template<class TObject>
+bool EncodeSchema(const TObject &object, const TFormat *format, std::string &text)
+{
+    struct TStringSink
+    {
+        static bool OnWrite(void *stream, const char *line, size_t len)
+        {
+            ((std::string*) stream)->append(line, len);
+            return true;
+        }
+    };
+
+    text.clear();
+    TSchemaEncoder encoder(format, &text, TStringSink::OnWrite);
+    const_cast<TObject&>(object).Schema(encoder);
+    encoder.Finish();
+    return encoder.IsSucceed();
+}
+
+/// Decode NINI format data to a structure, see nini_binder_decode for more details,
+/// and see nini::TSchemaDecoder for the thread safety of the first decoding of each type.
+template<class TObject>
+bool DecodeSchema(TObject       &object,
+                  const TFormat *format,
+                  const void    *data,
+                  size_t         size,
+                  TBindReport   *report=nullptr,
+                  TErrMsg       *errmsg=nullptr)
+{
+    return TSchemaDecoder::GetDecoder(object).Decode(format, &object, data, size, report, errmsg);
+}
+
+/// Load a NINI format file to a structure, see nini_binder_load_file for more details,
+/// and see nini::TSchemaDecoder for the thread safety of the first decoding of each type.
+template<class TObject>
+bool LoadSchemaFile(TObject           &object,
+                    const TFormat     *format,
+                    const std::string &filename,
+                    TBindReport       *report=nullptr,
+                    TErrMsg           *errmsg=nullptr)
+{
+    return TSchemaDecoder::GetDecoder(object).LoadFile(format, &object, filename, report, errmsg);
+}
+
+}
+
+#endif
+
+#endif
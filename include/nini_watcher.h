@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @brief     Nested INI file watcher.
+ * @details   This module reloads a NINI format file when it be changed,
+ *            and replaces the root shared with readers atomically.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_WATCHER_H_
+#define _NINI_WATCHER_H_
+
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   User defined reload handler.
+ * @details User defined function that will be called by the watching thread after each reload.
+ *
+ * @param arg    The user defined argument.
+ * @param root   The new root if the reload succeed; or NULL if failed.
+ *               It can be used in this function without being acquired.
+ * @param errmsg The failure information if the reload failed.
+ */
+typedef void(*nini_on_reload_t)(void *arg, const nini_root_t *root, const nini_errmsg_t *errmsg);
+
+/**
+ * @class nini_watcher_t
+ * @brief File watcher.
+ * @details The watcher keeps the current root of a file, and readers acquire it for reading.
+ *          A reload decodes the file to a new root, and the new root replaces the current one
+ *          only if the decode succeed, so that readers never see a partial or an empty root.
+ *          The old root will be released after all of its readers released it.
+ *
+ *          The watching thread reloads the file after it be changed and then be quiet
+ *          for a period of time, so that a burst of writes causes only one reload.
+ *
+ * For example:
+ *
+ *     nini_watcher_t watcher;
+ *     nini_watcher_init(&watcher, "config.ini", NINI_FORMAT_NESTED_INI, '/', 100, NULL);
+ *     nini_watcher_start(&watcher, NULL, NULL);
+ *
+ *     const nini_root_t *root = nini_watcher_acquire(&watcher);
+ *     long width = nini_read_integer(root, "video/width", '/', 640);
+ *     nini_watcher_release(&watcher, root);
+ *
+ *     nini_watcher_deinit(&watcher);
+ *
+ * @remarks Roots of the watcher are frozen, see nini_root_freeze.
+ */
+typedef struct nini_watcher_t
+{
+    // WARNING: All variables are private!
+
+    char          *filename;
+    nini_format_t  format;
+    char           deli;
+    unsigned       debounce;
+
+    struct nini_watch_t *watch;     // The current root and the watching thread.
+
+} nini_watcher_t;
+
+bool nini_watcher_init  (nini_watcher_t      *self,
+                         const char          *filename,
+                         const nini_format_t *format,
+                         char                 deli,
+                         unsigned             debounce,
+                         nini_errmsg_t       *errmsg);
+void nini_watcher_deinit(nini_watcher_t *self);
+
+bool nini_watcher_reload(nini_watcher_t *self, nini_errmsg_t *errmsg);
+
+bool nini_watcher_start(nini_watcher_t *self, nini_on_reload_t on_reload, void *arg);
+void nini_watcher_stop (nini_watcher_t *self);
+
+const nini_root_t* nini_watcher_acquire(nini_watcher_t *self);
+void               nini_watcher_release(nini_watcher_t *self, const nini_root_t *root);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_watcher_t.
+class TWatcher : protected nini_watcher_t
+{
+public:
+    /// Constructor.
+    TWatcher(const std::string &filename,
+             const TFormat     *format,
+             char               deli,
+             unsigned           debounce,
+             TErrMsg           *errmsg=nullptr)
+    { nini_watcher_init(this, filename.c_str(), format, deli, debounce, errmsg); }
+    /// Destructor.
+    ~TWatcher() { nini_watcher_deinit(this); }
+
+private:
+    TWatcher(const TWatcher &src);              // Not allowed to use!
+    TWatcher& operator=(const TWatcher &src);   // Not allowed to use!
+
+public:
+    /// The same as nini_watcher_reload.
+    bool Reload(TErrMsg *errmsg=nullptr) { return nini_watcher_reload(this, errmsg); }
+
+    /// The same as nini_watcher_start.
+    bool Start(nini_on_reload_t on_reload=nullptr, void *arg=nullptr)
+    { return nini_watcher_start(this, on_reload, arg); }
+    /// The same as nini_watcher_stop.
+    void Stop() { nini_watcher_stop(this); }
+
+    /// The same as nini_watcher_acquire.
+    const TRoot* Acquire() { return (const TRoot*) nini_watcher_acquire(this); }
+    /// The same as nini_watcher_release.
+    void Release(const TRoot *root) { nini_watcher_release(this, (const nini_root_t*) root); }
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief     Nested INI streaming writer.
+ * @details   This module writes NINI format data to a stream item by item,
+ *            without building the node tree first,
+ *            so that the memory usage is constant for any size of output.
+ * @author    王文佑
+ * @date      2026/10/19
+ * @copyright ZLib Licence
+ */
+#ifndef _NINI_WRITER_H_
+#define _NINI_WRITER_H_
+
+#include "nini_errmsg.h"
+#include "nini_node.h"
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @class nini_writer_t
+ * @brief Streaming writer.
+ * @details The writer formats lines into an internal buffer,
+ *          and flushes the buffer to the stream writer in blocks of complete lines,
+ *          that is the same as what nini_root_encode_to_stream does.
+ *
+ * For example:
+ *
+ *     nini_writer_t writer;
+ *     nini_writer_init(&writer, NINI_FORMAT_NESTED_INI, stream, on_write, NULL);
+ *
+ *     nini_writer_begin_section(&writer, "video");
+ *     nini_writer_write_decimal(&writer, "width", 1920);
+ *     nini_writer_write_decimal(&writer, "height", 1080);
+ *     nini_writer_end_section(&writer);
+ *
+ *     size_t size = nini_writer_finish(&writer);
+ *     nini_writer_deinit(&writer);
+ */
+typedef struct nini_writer_t
+{
+    // WARNING: All variables are private!
+
+    struct nini_encoder_t *encoder;
+
+    int  level;
+    bool finished;
+
+} nini_writer_t;
+
+bool nini_writer_init  (nini_writer_t       *self,
+                        const nini_format_t *format,
+                        void                *stream,
+                        nini_on_write_t      on_write,
+                        nini_errmsg_t       *errmsg);
+void nini_writer_deinit(nini_writer_t *self);
+
+bool nini_writer_begin_section(nini_writer_t *self, const char *name);
+bool nini_writer_end_section  (nini_writer_t *self);
+
+bool nini_writer_write_string (nini_writer_t *self, const char *name, const char *value);
+bool nini_writer_write_decimal(nini_writer_t *self, const char *name, long value);
+bool nini_writer_write_hexa   (nini_writer_t *self, const char *name, long value);
+bool nini_writer_write_float  (nini_writer_t *self, const char *name, double value);
+bool nini_writer_write_bool   (nini_writer_t *self, const char *name, bool value);
+bool nini_writer_write_null   (nini_writer_t *self, const char *name);
+bool nini_writer_write_node   (nini_writer_t *self, const nini_node_t *node);
+
+bool   nini_writer_is_failed(const nini_writer_t *self);
+size_t nini_writer_finish   (nini_writer_t *self);
+
+static inline
+int nini_writer_get_level(const nini_writer_t *self)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Get the current nested level.
+     *
+     * @param self Object instance.
+     * @return The number of sections those have begun but not ended.
+     */
+    return self->level;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#ifdef __cplusplus
+
+#include <string>
+
+#if __cplusplus < 201103L
+#undef nullptr
+#define nullptr NULL
+#endif
+
+namespace nini
+{
+
+/// C++ wrapper of nini_writer_t.
+class TWriter : protected nini_writer_t
+{
+public:
+    /// Constructor.
+    TWriter(const TFormat *format, void *stream, nini_on_write_t on_write, TErrMsg *errmsg=nullptr)
+    { nini_writer_init(this, format, stream, on_write, errmsg); }
+    /// Destructor.
+    ~TWriter() { nini_writer_deinit(this); }
+
+private:
+    TWriter(const TWriter &src);            // Not allowed to use!
+    TWriter& operator=(const TWriter &src); // Not allowed to use!
+
+public:
+    /// The same as nini_writer_begin_section.
+    bool BeginSection(const std::string &name) { return nini_writer_begin_section(this, name.c_str()); }
+    /// The same as nini_writer_end_section.
+    bool EndSection() { return nini_writer_end_section(this); }
+
+    /// The same as nini_writer_write_string.
+    bool WriteString(const std::string &name, const std::string &value)
+    { return nini_writer_write_string(this, name.c_str(), value.c_str()); }
+    /// The same as nini_writer_write_decimal.
+    bool WriteDecimal(const std::string &name, long value)
+    { return nini_writer_write_decimal(this, name.c_str(), value); }
+    /// The same as nini_writer_write_hexa.
+    bool WriteHexa(const std::string &name, long value)
+    { return nini_writer_write_hexa(this, name.c_str(), value); }
+    /// The same as nini_writer_write_float.
+    bool WriteFloat(const std::string &name, double value)
+    { return nini_writer_write_float(this, name.c_str(), value); }
+    /// The same as nini_writer_write_bool.
+    bool WriteBool(const std::string &name, bool value)
+    { return nini_writer_write_bool(this, name.c_str(), value); }
+    /// The same as nini_writer_write_null.
+    bool WriteNull(const std::string &name)
+    { return nini_writer_write_null(this, name.c_str()); }
+    /// The same as nini_writer_write_node.
+    bool WriteNode(const TNode &node)
+    { return nini_writer_write_node(this, (const nini_node_t*) &node); }
+
+    /// The same as nini_writer_get_level.
+    int GetLevel() const { return nini_writer_get_level(this); }
+    /// The same as nini_writer_is_failed.
+    bool IsFailed() const { return nini_writer_is_failed(this); }
+    /// The same as nini_writer_finish.
+    size_t Finish() { return nini_writer_finish(this); }
+};
+
+}
+
+#endif
+
+#endif
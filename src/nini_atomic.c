@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "nini_atomic.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#else
+#include <stdint.h>
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#endif
+
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+static
+void release_names(nini_atomic_file_t *self)
+{
+    if( self->filename ) free(self->filename);
+    if( self->tmpname  ) free(self->tmpname);
+
+    self->filename = NULL;
+    self->tmpname  = NULL;
+}
+//------------------------------------------------------------------------------
+bool nini_atomic_file_open(nini_atomic_file_t *self, const char *filename)
+{
+    // Create a temporary file beside the target file,
+    // and the serial number is taken atomically to give each thread a distinct name.
+    static unsigned serial = 0;
+
+    self->fd       = -1;
+    self->file     = NULL;
+    self->filename = NULL;
+    self->tmpname  = NULL;
+
+    size_t len = strlen(filename);
+    if( !( self->filename = malloc(len + 1) ) ) return false;
+    if( !( self->tmpname  = malloc(len + 64) ) )
+    {
+        release_names(self);
+        return false;
+    }
+    memcpy(self->filename, filename, len + 1);
+
+    for(int retry = 0; retry < 100 && self->fd < 0; ++retry)
+    {
+        unsigned number = __atomic_fetch_add(&serial, 1, __ATOMIC_RELAXED);
+        snprintf(self->tmpname, len + 64, "%s.%ld.%u.tmp", filename, (long) getpid(), number);
+        self->fd = open(self->tmpname, O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if( self->fd < 0 && errno != EEXIST ) break;
+    }
+
+    if( self->fd < 0 )
+    {
+        release_names(self);
+        return false;
+    }
+
+    // Keep permissions of the target file if it is existed.
+    struct stat st;
+    if( 0 == stat(filename, &st) )
+        fchmod(self->fd, st.st_mode & 07777);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_atomic_file_write(void *stream, const char *data, size_t size)
+{
+    nini_atomic_file_t *self = stream;
+
+    while( size )
+    {
+        ssize_t res = write(self->fd, data, size);
+        if( res < 0 )
+        {
+            if( errno == EINTR ) continue;
+            return false;
+        }
+
+        data += res;
+        size -= res;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_atomic_sync_directory(const char *filename)
+{
+    // Flush the directory entry of a renamed or created file, and errors are ignored
+    // because some file systems do not support it.
+    const char *slash = strrchr(filename, '/');
+    size_t      len   = slash ? (size_t)( slash - filename ) : 0;
+
+    char *dirname = malloc(len + 2);
+    if( !dirname ) return;
+
+    if( !slash )
+    {
+        strcpy(dirname, ".");
+    }
+    else if( !len )
+    {
+        strcpy(dirname, "/");
+    }
+    else
+    {
+        memcpy(dirname, filename, len);
+        dirname[len] = 0;
+    }
+
+    int fd = open(dirname, O_RDONLY);
+    if( fd >= 0 )
+    {
+        fsync(fd);
+        close(fd);
+    }
+
+    free(dirname);
+}
+//------------------------------------------------------------------------------
+bool nini_atomic_file_commit(nini_atomic_file_t *self)
+{
+    // Flush data to the disk, and replace the target file by the temporary file.
+    bool succ = 0 == fsync(self->fd);
+    succ = 0 == close(self->fd) && succ;
+    self->fd = -1;
+
+    if( succ && 0 == rename(self->tmpname, self->filename) )
+    {
+        nini_atomic_sync_directory(self->filename);
+        release_names(self);
+        return true;
+    }
+
+    unlink(self->tmpname);
+    release_names(self);
+    return false;
+}
+//------------------------------------------------------------------------------
+void nini_atomic_file_abort(nini_atomic_file_t *self)
+{
+    if( self->fd >= 0 ) close(self->fd);
+    self->fd = -1;
+
+    if( self->tmpname ) unlink(self->tmpname);
+    release_names(self);
+}
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+static
+void release_names(nini_atomic_file_t *self)
+{
+    if( self->filename ) free(self->filename);
+    if( self->tmpname  ) free(self->tmpname);
+
+    self->filename = NULL;
+    self->tmpname  = NULL;
+}
+//------------------------------------------------------------------------------
+bool nini_atomic_file_open(nini_atomic_file_t *self, const char *filename)
+{
+    // Create a temporary file beside the target file exclusively,
+    // and it will be written by the standard library.
+    static volatile LONG serial = 0;
+
+    self->fd       = -1;
+    self->file     = NULL;
+    self->filename = NULL;
+    self->tmpname  = NULL;
+
+    size_t len = strlen(filename);
+    if( !( self->filename = malloc(len + 1) ) ) return false;
+    if( !( self->tmpname  = malloc(len + 64) ) )
+    {
+        release_names(self);
+        return false;
+    }
+    memcpy(self->filename, filename, len + 1);
+
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    for(int retry = 0; retry < 100 && handle == INVALID_HANDLE_VALUE; ++retry)
+    {
+        unsigned number = (unsigned) InterlockedIncrement(&serial);
+        snprintf(self->tmpname, len + 64, "%s.%lu.%u.tmp", filename, (unsigned long) GetCurrentProcessId(), number);
+        handle = CreateFileA(self->tmpname, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+        if( handle == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS ) break;
+    }
+
+    if( handle == INVALID_HANDLE_VALUE )
+    {
+        release_names(self);
+        return false;
+    }
+
+    int fd = _open_osfhandle((intptr_t) handle, _O_WRONLY | _O_BINARY);
+    if( fd < 0 )
+    {
+        CloseHandle(handle);
+        DeleteFileA(self->tmpname);
+        release_names(self);
+        return false;
+    }
+
+    if( !( self->file = _fdopen(fd, "wb") ) )
+    {
+        _close(fd);
+        DeleteFileA(self->tmpname);
+        release_names(self);
+        return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_atomic_file_write(void *stream, const char *data, size_t size)
+{
+    nini_atomic_file_t *self = stream;
+    return size == fwrite(data, 1, size, self->file);
+}
+//------------------------------------------------------------------------------
+void nini_atomic_sync_directory(const char *filename)
+{
+    // Directory entries are flushed by MoveFileEx with the write through flag.
+}
+//------------------------------------------------------------------------------
+bool nini_atomic_file_commit(nini_atomic_file_t *self)
+{
+    /*
+     * Flush data to the disk, and replace the target file by the temporary file.
+     * The target file is replaced in one step by MoveFileEx,
+     * and it is kept unchanged if the replacement failed.
+     */
+    bool succ = 0 == fflush(self->file);
+    succ = FlushFileBuffers((HANDLE) _get_osfhandle(_fileno(self->file))) && succ;
+    succ = 0 == fclose(self->file) && succ;
+    self->file = NULL;
+
+    if( succ )
+    {
+        succ = MoveFileExA(self->tmpname,
+                           self->filename,
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    }
+
+    if( !succ ) DeleteFileA(self->tmpname);
+    release_names(self);
+
+    return succ;
+}
+//------------------------------------------------------------------------------
+void nini_atomic_file_abort(nini_atomic_file_t *self)
+{
+    if( self->file ) fclose(self->file);
+    self->file = NULL;
+
+    if( self->tmpname ) DeleteFileA(self->tmpname);
+    release_names(self);
+}
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,38 @@
+#ifndef _NINI_ATOMIC_H_
+#define _NINI_ATOMIC_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Crash-safe file replacement.
+ * Data will be written to a temporary file in the same directory of the target,
+ * and the temporary file will be flushed to the disk and then renamed over the target,
+ * so that readers will see either the old file or the new file, but never a partial file.
+ * The target is replaced by rename on POSIX systems, and by MoveFileEx on Windows.
+ */
+
+typedef struct nini_atomic_file_t
+{
+    int   fd;       // The temporary file on POSIX systems.
+    void *file;     // The temporary file (FILE*) on other systems.
+    char *filename;
+    char *tmpname;
+} nini_atomic_file_t;
+
+bool nini_atomic_file_open  (nini_atomic_file_t *self, const char *filename);
+bool nini_atomic_file_write (void *self, const char *data, size_t size);
+bool nini_atomic_file_commit(nini_atomic_file_t *self);
+void nini_atomic_file_abort (nini_atomic_file_t *self);
+
+void nini_atomic_sync_directory(const char *filename);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
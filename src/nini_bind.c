@@ -0,0 +1,640 @@
+#include <assert.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "nini_hash.h"
+#include "nini_table.h"
+#include "nini_parser.h"
+#include "nini_bind.h"
+
+typedef struct frame_t
+{
+    bool   is_section;
+    bool   overflow;
+    size_t path_len;
+} frame_t;
+
+typedef struct bind_context_t
+{
+    const nini_binder_t *binder;
+    uint8_t             *object;
+    bool                *found;     // Entries those are found, allocated after the context.
+    nini_bind_report_t   report;
+
+    char    path[NINI_MAX_LINE_CHARS+1];
+    frame_t frames[NINI_MAX_PARSE_LEVEL];
+} bind_context_t;
+
+//------------------------------------------------------------------------------
+static
+bool match_entry(const nini_bind_entry_t *entry, const char *path)
+{
+    return 0 == strcmp(entry->path, path);
+}
+//------------------------------------------------------------------------------
+static
+bool store_integer(void *field, size_t size, long value)
+{
+    // Integers are stored by the size of the field, and values out of its range are rejected.
+    if( size == sizeof(signed char) )
+    {
+        if( value < SCHAR_MIN || SCHAR_MAX < value ) return false;
+        *(signed char*) field = value;
+    }
+    else if( size == sizeof(short) )
+    {
+        if( value < SHRT_MIN || SHRT_MAX < value ) return false;
+        *(short*) field = value;
+    }
+    else if( size == sizeof(int) )
+    {
+        if( value < INT_MIN || INT_MAX < value ) return false;
+        *(int*) field = value;
+    }
+    else if( size == sizeof(long) )
+    {
+        *(long*) field = value;
+    }
+    else if( size == sizeof(long long) )
+    {
+        *(long long*) field = value;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool store_float(void *field, size_t size, double value)
+{
+    if( size == sizeof(float) )
+    {
+        if( !isinf(value) && ( value < -FLT_MAX || FLT_MAX < value ) ) return false;
+        *(float*) field = value;
+    }
+    else if( size == sizeof(double) )
+    {
+        *(double*) field = value;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool store_bool(void *field, size_t size, bool value)
+{
+    if( size != sizeof(bool) ) return false;
+
+    *(bool*) field = value;
+    return true;
+}
+//------------------------------------------------------------------------------
+#ifndef NDEBUG
+static
+bool check_entry(const nini_bind_entry_t *entry)
+{
+    // Check if the field size of the entry can be stored by the built-in storer.
+    if( entry->on_store ) return true;
+
+    switch( entry->type )
+    {
+    case NINI_STRING:
+        return true;
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+        return entry->size == sizeof(signed char) ||
+               entry->size == sizeof(short)       ||
+               entry->size == sizeof(int)         ||
+               entry->size == sizeof(long)        ||
+               entry->size == sizeof(long long);
+
+    case NINI_FLOAT:
+        return entry->size == sizeof(float) || entry->size == sizeof(double);
+
+    case NINI_BOOL:
+        return entry->size == sizeof(bool);
+
+    default:
+        return false;
+    }
+}
+#endif
+//------------------------------------------------------------------------------
+void nini_binder_init(nini_binder_t           *self,
+                      const nini_format_t     *format,
+                      char                     deli,
+                      const nini_bind_entry_t *table,
+                      size_t                   count)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Constructor.
+     *
+     * @param self   Object instance.
+     * @param format Specify the format to be used to parse data.
+     * @param deli   The path delimiter used by paths of the binding entries.
+     * @param table  The binding entries, and it must be valid during the life of the binder.
+     * @param count  Number of the binding entries.
+     *
+     * @remarks Entries are indexed by their paths once here,
+     *          and keys will be matched by a linear search if memory allocation failed.
+     * @remarks Entries with field sizes those cannot be stored (see nini_bind_entry_t) are asserted here,
+     *          and their keys will be reported as mismatched.
+     */
+    memset(self, 0, sizeof(*self));
+
+    for(size_t i = 0; i < count; ++i)
+        assert( check_entry(&table[i]) );
+
+    assert( format );
+    self->format = *format;
+    self->deli   = deli;
+    self->table  = table;
+    self->count  = count;
+
+    if( !count || !( self->index = malloc(sizeof(*self->index)) ) ) return;
+    nini_table_init(self->index);
+
+    bool res = nini_table_reserve(self->index, count);
+    for(size_t i = 0; res && i < count; ++i)
+    {
+        // Only the first one of entries with the same path will be bound.
+        uint64_t hash = nini_hash_string(table[i].path);
+        if( !nini_table_find(self->index, hash, (nini_table_match_t) match_entry, table[i].path) )
+            nini_table_insert(self->index, (void*) &table[i], hash);
+    }
+
+    if( !res ) nini_binder_deinit(self);
+}
+//------------------------------------------------------------------------------
+void nini_binder_deinit(nini_binder_t *self)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     */
+    if( !self->index ) return;
+
+    nini_table_deinit(self->index);
+    free(self->index);
+    self->index = NULL;
+}
+//------------------------------------------------------------------------------
+void nini_binder_set_on_issue(nini_binder_t *self, void *userarg, nini_bind_on_issue_t on_issue)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Set the issue report function.
+     *
+     * @param self     Object instance.
+     * @param userarg  The user defined argument to be passed to the report function.
+     * @param on_issue The report function, and can be NULL to disable the report.
+     */
+    self->userarg  = userarg;
+    self->on_issue = on_issue;
+}
+//------------------------------------------------------------------------------
+static
+void report_issue(bind_context_t *ctx, nini_bind_issue_t issue, const char *path)
+{
+    switch( issue )
+    {
+    case NINI_BIND_MISSING:
+        ++ ctx->report.missing;
+        break;
+
+    case NINI_BIND_UNKNOWN:
+        ++ ctx->report.unknown;
+        break;
+
+    case NINI_BIND_MISMATCH:
+        ++ ctx->report.mismatch;
+        break;
+    }
+
+    const nini_binder_t *binder = ctx->binder;
+    if( binder->on_issue )
+        binder->on_issue(binder->userarg, issue, path);
+}
+//------------------------------------------------------------------------------
+static
+void store_default(uint8_t *object, const nini_bind_entry_t *entry)
+{
+    void *field = object + entry->offset;
+
+    if( entry->on_store )
+    {
+        entry->on_store(field, entry->type, &entry->defval);
+        return;
+    }
+
+    switch( entry->type )
+    {
+    case NINI_STRING:
+        if( entry->size )
+        {
+            char *str = field;
+            strncpy(str, entry->defval.string ? entry->defval.string : "", entry->size - 1);
+            str[ entry->size - 1 ] = 0;
+        }
+        break;
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+        store_integer(field, entry->size, entry->defval.integer);
+        break;
+
+    case NINI_FLOAT:
+        store_float(field, entry->size, entry->defval.floating);
+        break;
+
+    case NINI_BOOL:
+        store_bool(field, entry->size, entry->defval.boolean);
+        break;
+
+    default:
+        break;
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool store_value(uint8_t                   *object,
+                 const nini_bind_entry_t   *entry,
+                 nini_type_t                type,
+                 const nini_parser_value_t *value)
+{
+    void *field = object + entry->offset;
+
+    if( entry->on_store )
+    {
+        nini_bind_value_t bindval;
+        switch( type )
+        {
+        case NINI_STRING:
+            bindval.string = value->string;
+            break;
+
+        case NINI_DECIMAL:
+        case NINI_HEXA:
+            bindval.integer = value->integer;
+            break;
+
+        case NINI_FLOAT:
+            bindval.floating = value->floating;
+            break;
+
+        case NINI_BOOL:
+            bindval.boolean = value->boolean;
+            break;
+
+        default:
+            memset(&bindval, 0, sizeof(bindval));
+            break;
+        }
+
+        return entry->on_store(field, type, &bindval);
+    }
+
+    switch( entry->type )
+    {
+    case NINI_STRING:
+        {
+            if( type != NINI_STRING ) return false;
+
+            size_t len = strlen(value->string);
+            if( len >= entry->size ) return false;
+
+            memcpy(field, value->string, len + 1);
+        }
+        return true;
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+        if( type != NINI_DECIMAL && type != NINI_HEXA ) return false;
+        return store_integer(field, entry->size, value->integer);
+
+    case NINI_FLOAT:
+        if( type != NINI_FLOAT ) return false;
+        return store_float(field, entry->size, value->floating);
+
+    case NINI_BOOL:
+        if( type != NINI_BOOL ) return false;
+        return store_bool(field, entry->size, value->boolean);
+
+    default:
+        return false;
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool make_item_path(bind_context_t *ctx, const frame_t *parent, const char *name, size_t *len)
+{
+    // The path is truncated if it is too long, and it cannot match any entry then.
+    size_t prefix_len = parent ? parent->path_len : 0;
+    size_t name_len   = strlen(name);
+    bool   fit        = prefix_len + ( prefix_len ? 1 : 0 ) + name_len <= NINI_MAX_LINE_CHARS;
+
+    char *pos = ctx->path + prefix_len;
+    char *end = ctx->path + NINI_MAX_LINE_CHARS;
+    if( prefix_len && pos < end )
+        *pos++ = ctx->binder->deli;
+
+    if( name_len > (size_t)( end - pos ) ) name_len = end - pos;
+    memcpy(pos, name, name_len);
+    pos[name_len] = 0;
+
+    *len = pos + name_len - ctx->path;
+    return fit;
+}
+//------------------------------------------------------------------------------
+static
+const nini_bind_entry_t* find_entry(const nini_binder_t *binder, const char *path)
+{
+    if( binder->index )
+    {
+        uint64_t           hash = nini_hash_string(path);
+        nini_table_slot_t *slot = nini_table_find(binder->index, hash, (nini_table_match_t) match_entry, path);
+        return slot ? slot->item : NULL;
+    }
+
+    for(size_t i = 0; i < binder->count; ++i)
+    {
+        if( match_entry(&binder->table[i], path) ) return &binder->table[i];
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
+static
+void bind_key(bind_context_t *ctx, nini_type_t type, nini_parser_value_t *value)
+{
+    const nini_bind_entry_t *entry = find_entry(ctx->binder, ctx->path);
+    if( !entry )
+    {
+        report_issue(ctx, NINI_BIND_UNKNOWN, ctx->path);
+        return;
+    }
+
+    // Duplicated keys will be ignored, the same as the path lookup of nodes.
+    size_t index = entry - ctx->binder->table;
+    if( ctx->found[index] ) return;
+    ctx->found[index] = true;
+
+    if( !store_value(ctx->object, entry, type, value) )
+    {
+        store_default(ctx->object, entry);
+        report_issue(ctx, NINI_BIND_MISMATCH, ctx->path);
+    }
+}
+//------------------------------------------------------------------------------
+static
+frame_t* bind_on_item(bind_context_t      *ctx,
+                      frame_t             *parent,
+                      int                  level,
+                      nini_type_t          type,
+                      const char          *name,
+                      nini_parser_value_t *value)
+{
+    // Keys cannot have children, the same as the tree decoder.
+    if( parent && !parent->is_section ) return NULL;
+    if( level < 0 || NINI_MAX_PARSE_LEVEL <= level ) return NULL;
+
+    frame_t *frame = &ctx->frames[level];
+    frame->is_section = ( type == NINI_SECTION );
+
+    bool fit = make_item_path(ctx, parent, name, &frame->path_len);
+    frame->overflow = ( parent && parent->overflow ) || !fit;
+    if( type == NINI_SECTION ) return frame;
+
+    if( frame->overflow )
+    {
+        // The path is too long to match any entry.
+        report_issue(ctx, NINI_BIND_UNKNOWN, ctx->path);
+    }
+    else
+    {
+        bind_key(ctx, type, value);
+    }
+
+    return frame;
+}
+//------------------------------------------------------------------------------
+static
+bool decode_data(const nini_binder_t *self,
+                 const nini_format_t *format,
+                 void                *object,
+                 const void          *data,
+                 size_t               size,
+                 nini_bind_report_t  *report,
+                 nini_errmsg_t       *errmsg)
+{
+    bind_context_t *ctx = calloc(1, sizeof(bind_context_t) + self->count * sizeof(bool));
+    if( !ctx ) return false;
+
+    ctx->binder = self;
+    ctx->object = object;
+    ctx->found  = (bool*)( ctx + 1 );
+    memset(&ctx->report, 0, sizeof(ctx->report));
+
+    for(size_t i = 0; i < self->count; ++i)
+        store_default(ctx->object, &self->table[i]);
+
+    bool res = true;
+    if( data && size )
+    {
+        nini_parser_t parser;
+        nini_parser_init(&parser,
+                         format,
+                         ctx,
+                         (void*(*)(void*,void*,int,nini_type_t,const char*,nini_parser_value_t*)) bind_on_item);
+
+        res = nini_parser_parse(&parser, data, size);
+        if( errmsg ) nini_parser_get_errmsg(&parser, errmsg);
+    }
+    else if( errmsg )
+    {
+        memset(errmsg, 0, sizeof(*errmsg));
+    }
+
+    if( res )
+    {
+        for(size_t i = 0; i < self->count; ++i)
+        {
+            if( !ctx->found[i] )
+                report_issue(ctx, NINI_BIND_MISSING, self->table[i].path);
+        }
+    }
+
+    if( report ) *report = ctx->report;
+
+    free(ctx);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+static
+bool load_file(const nini_binder_t *self,
+               const nini_format_t *format,
+               void                *object,
+               const char          *filename,
+               nini_bind_report_t  *report,
+               nini_errmsg_t       *errmsg)
+{
+    FILE    *file = NULL;
+    uint8_t *data = NULL;
+    long     size;
+
+    bool res = false;
+    do
+    {
+        if( !filename ) break;
+        file = fopen(filename, "rb");
+        if( !file ) break;
+
+        if( fseek(file, 0, SEEK_END) ) break;
+        if( 0 > ( size = ftell(file) ) ) break;
+        rewind(file);
+
+        data = malloc(size ? size : 1);
+        if( !data ) break;
+
+        if( size != fread(data, 1, size, file) ) break;
+
+        if( !decode_data(self, format, object, data, size, report, errmsg) ) break;
+
+        res = true;
+    } while(false);
+
+    if( data ) free(data);
+    if( file ) fclose(file);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+bool nini_binder_decode(const nini_binder_t *self,
+                        void                *object,
+                        const void          *data,
+                        size_t               size,
+                        nini_bind_report_t  *report,
+                        nini_errmsg_t       *errmsg)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Decode the NINI format data to a structure.
+     *
+     * @param self   Object instance.
+     * @param object The structure to be filled,
+     *               and all fields described in the binding table will be filled with
+     *               the default values first.
+     * @param data   The NINI format data to be parsed.
+     * @param size   Size of the input data.
+     * @param report The object that will be filled with statistics of the binding issues.
+     *               This parameter can be NULL to discard the report.
+     * @param errmsg The object that will be filled with failure information if decode failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks Keys those existed in the data but not described in the binding table,
+     *          or keys those described in the table but not existed in the data,
+     *          will not cause a failure, and they will be reported as binding issues.
+     */
+    return decode_data(self, &self->format, object, data, size, report, errmsg);
+}
+//------------------------------------------------------------------------------
+bool nini_binder_decode_as(const nini_binder_t *self,
+                           const nini_format_t *format,
+                           void                *object,
+                           const void          *data,
+                           size_t               size,
+                           nini_bind_report_t  *report,
+                           nini_errmsg_t       *errmsg)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Decode the NINI format data of a specified format to a structure.
+     * @details The same as nini_binder_decode, but the data is parsed by @a format
+     *          instead of the format of the binder,
+     *          so that a binder can be shared by data of different formats.
+     *
+     * @param self   Object instance.
+     * @param format The format to be used to parse the data.
+     * @param object The structure to be filled, see nini_binder_decode for more details.
+     * @param data   The NINI format data to be parsed.
+     * @param size   Size of the input data.
+     * @param report The object that will be filled with statistics of the binding issues.
+     *               This parameter can be NULL to discard the report.
+     * @param errmsg The object that will be filled with failure information if decode failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    assert( format );
+    return decode_data(self, format, object, data, size, report, errmsg);
+}
+//------------------------------------------------------------------------------
+bool nini_binder_load_file(const nini_binder_t *self,
+                           void                *object,
+                           const char          *filename,
+                           nini_bind_report_t  *report,
+                           nini_errmsg_t       *errmsg)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Load a NINI format file to a structure.
+     *
+     * @param self     Object instance.
+     * @param object   The structure to be filled, see nini_binder_decode for more details.
+     * @param filename Name of the input file.
+     * @param report   The object that will be filled with statistics of the binding issues.
+     *                 This parameter can be NULL to discard the report.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return load_file(self, &self->format, object, filename, report, errmsg);
+}
+//------------------------------------------------------------------------------
+bool nini_binder_load_file_as(const nini_binder_t *self,
+                              const nini_format_t *format,
+                              void                *object,
+                              const char          *filename,
+                              nini_bind_report_t  *report,
+                              nini_errmsg_t       *errmsg)
+{
+    /**
+     * @memberof nini_binder_t
+     * @brief Load a NINI format file of a specified format to a structure.
+     * @details The same as nini_binder_load_file, but the file is parsed by @a format
+     *          instead of the format of the binder.
+     *
+     * @param self     Object instance.
+     * @param format   The format to be used to parse the file.
+     * @param object   The structure to be filled, see nini_binder_decode for more details.
+     * @param filename Name of the input file.
+     * @param report   The object that will be filled with statistics of the binding issues.
+     *                 This parameter can be NULL to discard the report.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    assert( format );
+    return load_file(self, format, object, filename, report, errmsg);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,529 @@
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "nini_number.h"
+#include "nini_simd.h"
+#include "nini_encoder.h"
+
+static const char ASCII_LF = 0x0A;
+
+/*
+ * Escape code of each character:
+ * ZERO for characters those can be written directly,
+ * 'x' for characters those must be written in hexadecimal,
+ * and the escape character for others.
+ */
+static const char escape_table[256] =
+{
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'a', 'b', 't', 'n', 'v', 'f', 'r', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+      0,   0, '\"',  0,   0,   0,   0, '\'',  0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, '\\',  0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+    'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x',
+};
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+//------------------------------------------------------------------------------
+bool nini_encoder_init_stream(nini_encoder_t      *self,
+                              const nini_format_t *format,
+                              void                *stream,
+                              nini_on_write_t      on_write,
+                              nini_errmsg_t       *errmsg)
+{
+    memset(self, 0, sizeof(*self));
+
+    self->format   = format;
+    self->stream   = stream;
+    self->on_write = on_write;
+    self->errmsg   = errmsg;
+
+    self->buf = malloc(NINI_ENCODER_BUFSIZE);
+    if( !self->buf )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+    self->capacity = NINI_ENCODER_BUFSIZE;
+    self->own_buf  = true;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_encoder_init_buffer(nini_encoder_t      *self,
+                              const nini_format_t *format,
+                              void                *buf,
+                              size_t               size,
+                              nini_errmsg_t       *errmsg)
+{
+    memset(self, 0, sizeof(*self));
+
+    self->format   = format;
+    self->errmsg   = errmsg;
+    self->buf      = buf;
+    self->capacity = buf ? size : 0;
+}
+//------------------------------------------------------------------------------
+void nini_encoder_deinit(nini_encoder_t *self)
+{
+    if( self->own_buf && self->buf )
+        free(self->buf);
+
+    self->buf = NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool flush(nini_encoder_t *self)
+{
+    if( !self->size || !self->on_write ) return true;
+
+    if( !self->on_write(self->stream, self->buf, self->size) )
+    {
+        self->failed = true;
+        nini_errmsg_write(self->errmsg, self->line_num, "", "Stream write failed!");
+        return false;
+    }
+
+    self->total_size += self->size;
+    self->size        = 0;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void fail_line(nini_encoder_t *self, const char *message)
+{
+    self->failed = true;
+
+    if( self->errmsg )
+    {
+        size_t len = self->pos - self->line;
+        char   text[NINI_MAX_LINE_CHARS+1];
+        if( len > NINI_MAX_LINE_CHARS ) len = NINI_MAX_LINE_CHARS;
+        memcpy(text, self->line, len);
+        text[len] = 0;
+
+        nini_errmsg_write(self->errmsg, self->line_num, text, "%s", message);
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool begin_line(nini_encoder_t *self, int level)
+{
+    if( self->failed ) return false;
+
+    // Keep enough space for a whole line, so that the line will never be split.
+    if( self->on_write && self->capacity - self->size < NINI_MAX_LINE_CHARS && !flush(self) )
+        return false;
+
+    ++ self->line_num;
+
+    self->line  = self->buf + self->size;
+    self->pos   = self->line;
+    self->limit = self->line + NINI_MAX_LINE_CHARS;
+    if( self->limit > self->buf + self->capacity )
+        self->limit = self->buf + self->capacity;
+
+    size_t indents = (size_t) self->format->indent * level;
+    if( indents > self->limit - self->pos )
+    {
+        fail_line(self, "Line too long!");
+        return false;
+    }
+
+    memset(self->pos, ' ', indents);
+    self->pos += indents;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool end_line(nini_encoder_t *self)
+{
+    if( self->pos >= self->limit )
+    {
+        fail_line(self, self->pos - self->line < NINI_MAX_LINE_CHARS ? "Buffer too small!" : "Line too long!");
+        return false;
+    }
+
+    *self->pos++ = ASCII_LF;
+    self->size = self->pos - self->buf;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool put_data(nini_encoder_t *self, const char *data, size_t size)
+{
+    if( size > (size_t)( self->limit - self->pos ) )
+    {
+        self->pos = self->limit;
+        return false;
+    }
+
+    memcpy(self->pos, data, size);
+    self->pos += size;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool put_ch(nini_encoder_t *self, char ch)
+{
+    if( self->pos >= self->limit ) return false;
+
+    *self->pos++ = ch;
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool put_quoted(nini_encoder_t *self, const char *str)
+{
+    if( !put_data(self, " \"", 2) ) return false;
+
+    const uint8_t *src = (const uint8_t*) str;
+    while( *src )
+    {
+        // Copy the run of characters those do not need to be escaped.
+        const uint8_t *run = src;
+        src = (const uint8_t*) nini_simd_find_escape((const char*) src);
+        if( src > run && !put_data(self, (const char*) run, src - run) ) return false;
+
+        if( !*src ) break;
+
+        char code = escape_table[*src];
+        if( code == 'x' )
+        {
+            char hex[4] = { '\\', 'x', hex_digits[ *src >> 4 ], hex_digits[ *src & 0x0F ] };
+            if( !put_data(self, hex, sizeof(hex)) ) return false;
+        }
+        else
+        {
+            char esc[2] = { '\\', code };
+            if( !put_data(self, esc, sizeof(esc)) ) return false;
+        }
+
+        ++src;
+    }
+
+    return put_ch(self, '\"');
+}
+//------------------------------------------------------------------------------
+static
+bool put_decimal(nini_encoder_t *self, long value)
+{
+    char buf[1+NINI_NUMBER_MAX_CHARS] = { ' ' };
+    size_t len = 1 + nini_number_format_decimal(buf + 1, value);
+
+    return put_data(self, buf, len);
+}
+//------------------------------------------------------------------------------
+static
+bool put_hexa(nini_encoder_t *self, long value)
+{
+    char buf[1+NINI_NUMBER_MAX_CHARS] = { ' ' };
+    size_t len = 1 + nini_number_format_hexa(buf + 1, value);
+
+    return put_data(self, buf, len);
+}
+//------------------------------------------------------------------------------
+static
+bool put_float(nini_encoder_t *self, double value)
+{
+    char buf[1+NINI_NUMBER_MAX_CHARS] = { ' ' };
+    size_t len = 1 + nini_number_format_float(buf + 1, value);
+
+    return put_data(self, buf, len);
+}
+//------------------------------------------------------------------------------
+static
+bool put_key_head(nini_encoder_t *self, const char *name)
+{
+    char mark[2] = { ' ', self->format->keymark };
+    return put_data(self, name, strlen(name)) && put_data(self, mark, sizeof(mark));
+}
+//------------------------------------------------------------------------------
+static
+bool finish_line(nini_encoder_t *self, bool succeed)
+{
+    if( !succeed )
+    {
+        fail_line(self, self->pos - self->line < NINI_MAX_LINE_CHARS ? "Buffer too small!" : "Line too long!");
+        return false;
+    }
+
+    return end_line(self);
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_section(nini_encoder_t *self, int level, const char *name)
+{
+    if( !self->format->sec_head )
+    {
+        if( !self->failed )
+        {
+            self->failed = true;
+            nini_errmsg_write(self->errmsg, self->line_num + 1, name, "Section is not supported by the format!");
+        }
+
+        return false;
+    }
+
+    if( !begin_line(self, level) ) return false;
+
+    bool succ = put_ch(self, self->format->sec_head) &&
+                put_data(self, name, strlen(name)) &&
+                ( !self->format->sec_tail || put_ch(self, self->format->sec_tail) );
+
+    return finish_line(self, succ);
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_string(nini_encoder_t *self, int level, const char *name, const char *value)
+{
+    if( !begin_line(self, level) ) return false;
+    return finish_line(self, put_key_head(self, name) && put_quoted(self, value ? value : ""));
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_decimal(nini_encoder_t *self, int level, const char *name, long value)
+{
+    if( !begin_line(self, level) ) return false;
+    return finish_line(self, put_key_head(self, name) && put_decimal(self, value));
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_hexa(nini_encoder_t *self, int level, const char *name, long value)
+{
+    if( !begin_line(self, level) ) return false;
+    return finish_line(self, put_key_head(self, name) && put_hexa(self, value));
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_float(nini_encoder_t *self, int level, const char *name, double value)
+{
+    if( !begin_line(self, level) ) return false;
+    return finish_line(self, put_key_head(self, name) && put_float(self, value));
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_bool(nini_encoder_t *self, int level, const char *name, bool value)
+{
+    if( !begin_line(self, level) ) return false;
+
+    bool succ = put_key_head(self, name) &&
+                ( value ? put_data(self, " true", 5) : put_data(self, " false", 6) );
+
+    return finish_line(self, succ);
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_null(nini_encoder_t *self, int level, const char *name)
+{
+    if( !begin_line(self, level) ) return false;
+    return finish_line(self, put_key_head(self, name));
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_raw(nini_encoder_t *self, const char *data, size_t size)
+{
+    // Write data of complete lines those have been formatted already.
+    if( self->failed ) return false;
+
+    for(const char *pos = data; ( pos = memchr(pos, ASCII_LF, data + size - pos) ); ++pos)
+        ++ self->line_num;
+
+    if( self->on_write && self->capacity - self->size < size )
+    {
+        if( !flush(self) ) return false;
+
+        // Large data will be written to the stream directly without being copied.
+        if( self->capacity < size )
+        {
+            if( !self->on_write(self->stream, data, size) )
+            {
+                self->failed = true;
+                nini_errmsg_write(self->errmsg, self->line_num, "", "Stream write failed!");
+                return false;
+            }
+
+            self->total_size += size;
+            return true;
+        }
+    }
+
+    if( self->capacity - self->size < size )
+    {
+        self->failed = true;
+        nini_errmsg_write(self->errmsg, self->line_num, "", "Buffer too small!");
+        return false;
+    }
+
+    memcpy(self->buf + self->size, data, size);
+    self->size += size;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_node(nini_encoder_t *self, int level, const nini_node_t *node)
+{
+    const char *name = nini_node_get_name(node);
+    switch( nini_node_get_type(node) )
+    {
+    case NINI_SECTION:
+        return nini_encoder_write_section(self, level, name);
+
+    case NINI_STRING:
+        return nini_encoder_write_string(self, level, name, nini_node_get_string(node));
+
+    case NINI_DECIMAL:
+        return nini_encoder_write_decimal(self, level, name, nini_node_get_integer(node));
+
+    case NINI_HEXA:
+        return nini_encoder_write_hexa(self, level, name, nini_node_get_integer(node));
+
+    case NINI_FLOAT:
+        return nini_encoder_write_float(self, level, name, nini_node_get_float(node));
+
+    case NINI_BOOL:
+        return nini_encoder_write_bool(self, level, name, nini_node_get_bool(node));
+
+    default:
+        return nini_encoder_write_null(self, level, name);
+    }
+}
+//------------------------------------------------------------------------------
+bool nini_encoder_write_tree(nini_encoder_t *self, int level, const nini_node_t *node)
+{
+    if( !nini_encoder_write_node(self, level, node) ) return false;
+
+    for(const nini_node_t *child = nini_node_get_first_child_c(node);
+        child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        if( !nini_encoder_write_tree(self, level + 1, child) ) return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+size_t nini_encoder_finish(nini_encoder_t *self)
+{
+    // Return size of all data be written, or ZERO if failed.
+    if( self->failed || !flush(self) ) return 0;
+
+    if( self->errmsg )
+        memset(self->errmsg, 0, sizeof(*self->errmsg));
+
+    return self->on_write ? self->total_size : self->size;
+}
+//------------------------------------------------------------------------------
+static
+size_t measure_quoted(const char *str)
+{
+    size_t size = 3;    // The leading space and quotes.
+    for(const uint8_t *pos = (const uint8_t*) str; ; ++pos)
+    {
+        const uint8_t *run = pos;
+        pos = (const uint8_t*) nini_simd_find_escape((const char*) pos);
+        size += pos - run;
+
+        if( !*pos ) break;
+        size += escape_table[*pos] == 'x' ? 4 : 2;
+    }
+
+    return size;
+}
+//------------------------------------------------------------------------------
+static
+size_t measure_decimal(long value)
+{
+    unsigned long num  = value < 0 ? 0UL - (unsigned long) value : (unsigned long) value;
+    size_t        size = value < 0 ? 3 : 2;   // The leading space, sign, and the first digit.
+    for(; num >= 10; num /= 10)
+        ++ size;
+
+    return size;
+}
+//------------------------------------------------------------------------------
+static
+size_t measure_hexa(long value)
+{
+    unsigned long num  = value;
+    size_t        size = 4;     // The leading space, "0x", and the first digit.
+    for(num >>= 4; num; num >>= 4)
+        ++ size;
+
+    return size;
+}
+//------------------------------------------------------------------------------
+static
+size_t measure_float(double value)
+{
+    char buf[NINI_NUMBER_MAX_CHARS];
+    return 1 + nini_number_format_float(buf, value);
+}
+//------------------------------------------------------------------------------
+size_t nini_encoder_measure_node(const nini_format_t *format, int level, const nini_node_t *node)
+{
+    // Return size of the line (including the line feed), or ZERO if it cannot be encoded.
+    size_t size = (size_t) format->indent * level + strlen(nini_node_get_name(node)) + 1;
+
+    switch( nini_node_get_type(node) )
+    {
+    case NINI_SECTION:
+        if( !format->sec_head ) return 0;
+        size += format->sec_tail ? 2 : 1;
+        break;
+
+    case NINI_STRING:
+        size += 2 + measure_quoted(nini_node_get_string(node));
+        break;
+
+    case NINI_DECIMAL:
+        size += 2 + measure_decimal(nini_node_get_integer(node));
+        break;
+
+    case NINI_HEXA:
+        size += 2 + measure_hexa(nini_node_get_integer(node));
+        break;
+
+    case NINI_FLOAT:
+        size += 2 + measure_float(nini_node_get_float(node));
+        break;
+
+    case NINI_BOOL:
+        size += 2 + ( nini_node_get_bool(node) ? 5 : 6 );
+        break;
+
+    default:
+        size += 2;
+        break;
+    }
+
+    return size <= NINI_MAX_LINE_CHARS ? size : 0;
+}
+//------------------------------------------------------------------------------
+size_t nini_encoder_measure_tree(const nini_format_t *format, int level, const nini_node_t *node)
+{
+    // Return size of the node and all of its children, or ZERO if any of them cannot be encoded.
+    size_t total_size = nini_encoder_measure_node(format, level, node);
+    if( !total_size ) return 0;
+
+    for(const nini_node_t *child = nini_node_get_first_child_c(node);
+        child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        size_t size = nini_encoder_measure_tree(format, level + 1, child);
+        if( !size ) return 0;
+
+        total_size += size;
+    }
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+#ifndef _NINI_ENCODER_H_
+#define _NINI_ENCODER_H_
+
+#include <stdbool.h>
+#include "nini_format.h"
+#include "nini_errmsg.h"
+#include "nini_node.h"
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The NINI format encoder core.
+ * Lines will be formatted directly into a large buffer,
+ * and the buffer will be flushed to the stream writer in blocks of complete lines.
+ */
+
+#define NINI_ENCODER_BUFSIZE ( 64 * 1024 )
+
+typedef struct nini_encoder_t
+{
+    const nini_format_t *format;
+
+    void            *stream;
+    nini_on_write_t  on_write;  // NULL if the output is a fixed buffer.
+
+    char   *buf;
+    size_t  capacity;
+    size_t  size;               // Size of data in the buffer those have not been flushed.
+    bool    own_buf;
+
+    char *line;                 // Start of the current line.
+    char *pos;                  // Write position of the current line.
+    char *limit;                // Maximum write position of the current line.
+
+    size_t total_size;          // Size of data have been flushed.
+    int    line_num;
+    bool   failed;
+
+    nini_errmsg_t *errmsg;
+
+} nini_encoder_t;
+
+bool nini_encoder_init_stream(nini_encoder_t      *self,
+                              const nini_format_t *format,
+                              void                *stream,
+                              nini_on_write_t      on_write,
+                              nini_errmsg_t       *errmsg);
+
+void nini_encoder_init_buffer(nini_encoder_t      *self,
+                              const nini_format_t *format,
+                              void                *buf,
+                              size_t               size,
+                              nini_errmsg_t       *errmsg);
+
+void nini_encoder_deinit(nini_encoder_t *self);
+
+bool nini_encoder_write_section(nini_encoder_t *self, int level, const char *name);
+bool nini_encoder_write_string (nini_encoder_t *self, int level, const char *name, const char *value);
+bool nini_encoder_write_decimal(nini_encoder_t *self, int level, const char *name, long value);
+bool nini_encoder_write_hexa   (nini_encoder_t *self, int level, const char *name, long value);
+bool nini_encoder_write_float  (nini_encoder_t *self, int level, const char *name, double value);
+bool nini_encoder_write_bool   (nini_encoder_t *self, int level, const char *name, bool value);
+bool nini_encoder_write_null   (nini_encoder_t *self, int level, const char *name);
+
+bool nini_encoder_write_raw(nini_encoder_t *self, const char *data, size_t size);
+
+bool nini_encoder_write_node(nini_encoder_t *self, int level, const nini_node_t *node);
+bool nini_encoder_write_tree(nini_encoder_t *self, int level, const nini_node_t *node);
+
+size_t nini_encoder_finish(nini_encoder_t *self);
+
+size_t nini_encoder_measure_node(const nini_format_t *format, int level, const nini_node_t *node);
+size_t nini_encoder_measure_tree(const nini_format_t *format, int level, const nini_node_t *node);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
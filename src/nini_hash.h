@@ -0,0 +1,62 @@
+#ifndef _NINI_HASH_H_
+#define _NINI_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline
+uint64_t nini_hash_mix(uint64_t value)
+{
+    // The 64-bit finaliser of MurmurHash3.
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+
+    return value;
+}
+
+static inline
+uint64_t nini_hash_bytes(uint64_t hash, const void *data, size_t size)
+{
+    // FNV-1a, and the hash value can be continued by passing the previous result.
+    const uint8_t *pos = data;
+    for(size_t i = 0; i < size; ++i)
+    {
+        hash ^= pos[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+static inline
+uint64_t nini_hash_string(const char *str)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for(; *str; ++str)
+    {
+        hash ^= (uint8_t) *str;
+        hash *= 0x100000001B3ULL;
+    }
+
+    return nini_hash_mix(hash);
+}
+
+static inline
+uint64_t nini_hash_seed(uint64_t hash, uint32_t seed)
+{
+    // Derive an other hash value from a hash value and a seed.
+    return nini_hash_mix(hash ^ ( seed * 0x9E3779B97F4A7C15ULL ));
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
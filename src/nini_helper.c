@@ -1,4 +1,5 @@
 #include <string.h>
+#include "nini_phash.h"
 #include "nini_helper.h"
 
 //------------------------------------------------------------------------------
@@ -57,9 +58,17 @@ nini_node_t* find_node_by_path(nini_root_t *root, char *path, char deli)
 }
 //------------------------------------------------------------------------------
 static
-const nini_node_t* find_node_by_path_c(const nini_root_t *root, char *path, char deli)
+const nini_node_t* find_node_by_path_c(const nini_root_t *root, const char *path, char deli)
 {
-    return find_node_by_path((nini_root_t*)root, path, deli);
+    // Frozen root with the same delimiter can find the node by the full path directly.
+    if( root->phash && root->phash->deli == deli && path[0] )
+        return nini_phash_find(root->phash, path);
+
+    char buf[strlen(path)+1];
+    strncpy(buf, path, sizeof(buf));
+    char *node_path = buf;
+
+    return find_node_by_path((nini_root_t*)root, node_path, deli);
 }
 //------------------------------------------------------------------------------
 static
@@ -83,14 +92,17 @@ nini_node_t* make_and_link_section_by_name(nini_node_t *parent, const char *name
 static
 nini_node_t* make_node_by_path(nini_root_t *root, char *path, char deli)
 {
+    if( nini_root_is_frozen(root) ) return NULL;
+
     nini_node_t *parent = &root->super;
     if( !path || !strlen(path) ) return parent;
 
+    // Shared sections in the path are copied on write.
     char *name;
     while(( name = extract_first_name(&path, deli) ))
     {
         nini_node_t *child = make_and_link_section_by_name(parent, name);
-        if( !child ) return NULL;
+        if( !child || !nini_node_unshare(child) ) return NULL;
 
         parent = child;
     }
@@ -101,14 +113,21 @@ nini_node_t* make_node_by_path(nini_root_t *root, char *path, char deli)
 static
 bool replace_child(nini_node_t *parent, nini_node_t *new_child)
 {
+    // The old child will be replaced at its position,
+    // and the new child will be released if it cannot be linked.
     nini_node_t *old_child = nini_node_find_child(parent, nini_node_get_name(new_child));
-    if( old_child )
+    bool         succ      = old_child ?
+                             nini_node_replace(old_child, new_child) :
+                             nini_node_link_child(parent, new_child);
+    if( !succ )
     {
-        nini_node_unlink(old_child);
-        nini_node_release(old_child);
+        nini_node_release(new_child);
+        return false;
     }
 
-    return nini_node_link_child(parent, new_child);
+    if( old_child ) nini_node_release(old_child);
+
+    return true;
 }
 //------------------------------------------------------------------------------
 bool nini_is_existed(const nini_root_t *root, const char *path, char deli)
@@ -121,11 +140,7 @@ bool nini_is_existed(const nini_root_t *root, const char *path, char deli)
      * @param deli The path delimiter.
      * @return TRUE if the node does existed; and FALSE if not.
      */
-    char buf[strlen(path)+1];
-    strncpy(buf, path, sizeof(buf));
-    char *node_path = buf;
-
-    return find_node_by_path_c(root, node_path, deli);
+    return find_node_by_path_c(root, path, deli);
 }
 //------------------------------------------------------------------------------
 nini_type_t nini_get_type(const nini_root_t *root, const char *path, char deli)
@@ -143,15 +158,25 @@ nini_type_t nini_get_type(const nini_root_t *root, const char *path, char deli)
      * we only guarantee that the return will not match
      * any value defined in nini_type_t in this case.
      */
-    char buf[strlen(path)+1];
-    strncpy(buf, path, sizeof(buf));
-    char *node_path = buf;
-
-    const nini_node_t *node = find_node_by_path_c(root, node_path, deli);
+    const nini_node_t *node = find_node_by_path_c(root, path, deli);
 
     return node ? nini_node_get_type(node) : -1;
 }
 //------------------------------------------------------------------------------
+const nini_node_t* nini_find_node(const nini_root_t *root, const char *path, char deli)
+{
+    /**
+     * @brief Find a key or section.
+     *
+     * @param root The root node of NINI nodes.
+     * @param path The path of the node to be found, see @ref key-path for more details,
+     *             or an empty string to get the root node.
+     * @param deli The path delimiter.
+     * @return The node if found; or NULL if not.
+     */
+    return find_node_by_path_c(root, path, deli);
+}
+//------------------------------------------------------------------------------
 const char* nini_read_string(const nini_root_t *root, const char *path, char deli, const char *failval)
 {
     /**
@@ -164,11 +189,7 @@ const char* nini_read_string(const nini_root_t *root, const char *path, char del
      * @return The value if succeed; or
      *         @a failval if the key does not existed or the key type does not match.
      */
-    char buf[strlen(path)+1];
-    strncpy(buf, path, sizeof(buf));
-    char *node_path = buf;
-
-    const nini_node_t *node = find_node_by_path_c(root, node_path, deli);
+    const nini_node_t *node = find_node_by_path_c(root, path, deli);
     if( !node ) return failval;
 
     return nini_node_get_type(node) == NINI_STRING ? nini_node_get_string(node) : failval;
@@ -186,11 +207,7 @@ long nini_read_integer(const nini_root_t *root, const char *path, char deli, lon
      * @return The value if succeed; or
      *         @a failval if the key does not existed or the key type does not match.
      */
-    char buf[strlen(path)+1];
-    strncpy(buf, path, sizeof(buf));
-    char *node_path = buf;
-
-    const nini_node_t *node = find_node_by_path_c(root, node_path, deli);
+    const nini_node_t *node = find_node_by_path_c(root, path, deli);
     if( !node ) return failval;
 
     return nini_node_get_type(node) == NINI_DECIMAL || nini_node_get_type(node) == NINI_HEXA ?
@@ -209,11 +226,7 @@ double nini_read_float(const nini_root_t *root, const char *path, char deli, dou
      * @return The value if succeed; or
      *         @a failval if the key does not existed or the key type does not match.
      */
-    char buf[strlen(path)+1];
-    strncpy(buf, path, sizeof(buf));
-    char *node_path = buf;
-
-    const nini_node_t *node = find_node_by_path_c(root, node_path, deli);
+    const nini_node_t *node = find_node_by_path_c(root, path, deli);
     if( !node ) return failval;
 
     return nini_node_get_type(node) == NINI_FLOAT ? nini_node_get_float(node) : failval;
@@ -231,11 +244,7 @@ bool nini_read_bool(const nini_root_t *root, const char *path, char deli, bool f
      * @return The value if succeed; or
      *         @a failval if the key does not existed or the key type does not match.
      */
-    char buf[strlen(path)+1];
-    strncpy(buf, path, sizeof(buf));
-    char *node_path = buf;
-
-    const nini_node_t *node = find_node_by_path_c(root, node_path, deli);
+    const nini_node_t *node = find_node_by_path_c(root, path, deli);
     if( !node ) return failval;
 
     return nini_node_get_type(node) == NINI_BOOL ? nini_node_get_bool(node) : failval;
@@ -255,6 +264,7 @@ bool nini_write_string(nini_root_t *root, const char *path, char deli, const cha
      * @remarks
      * * The path will be created if it does not existed.
      * * The key will be overwrite if it is already existed.
+     * * The write will fail if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
@@ -285,6 +295,7 @@ bool nini_write_decimal(nini_root_t *root, const char *path, char deli, long val
      * @remarks
      * * The path will be created if it does not existed.
      * * The key will be overwrite if it is already existed.
+     * * The write will fail if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
@@ -315,6 +326,7 @@ bool nini_write_hexa(nini_root_t *root, const char *path, char deli, long value)
      * @remarks
      * * The path will be created if it does not existed.
      * * The key will be overwrite if it is already existed.
+     * * The write will fail if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
@@ -345,6 +357,7 @@ bool nini_write_float(nini_root_t *root, const char *path, char deli, double val
      * @remarks
      * * The path will be created if it does not existed.
      * * The key will be overwrite if it is already existed.
+     * * The write will fail if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
@@ -375,6 +388,7 @@ bool nini_write_bool(nini_root_t *root, const char *path, char deli, bool value)
      * @remarks
      * * The path will be created if it does not existed.
      * * The key will be overwrite if it is already existed.
+     * * The write will fail if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
@@ -404,6 +418,7 @@ bool nini_write_null(nini_root_t *root, const char *path, char deli)
      * @remarks
      * * The path will be created if it does not existed.
      * * The key will be overwrite if it is already existed.
+     * * The write will fail if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
@@ -428,15 +443,26 @@ void nini_remove(nini_root_t *root, const char *path, char deli)
      * @param root The root node of NINI nodes.
      * @param path The path of the key to be operated, see @ref key-path for more details.
      * @param deli The path delimiter.
+     *
+     * @remarks Nothing will be done if the root is frozen.
      */
     char buf[strlen(path)+1];
     strncpy(buf, path, sizeof(buf));
     char *node_path = buf;
 
     nini_node_t *node = find_node_by_path(root, node_path, deli);
-    if( !node ) return;
+    if( !node || node == &root->super ) return;
+
+    // Shared sections in the path are copied on write.
+    strncpy(buf, path, sizeof(buf));
+    node_path = buf;
+    char *name = extract_last_name(&node_path, deli);
+
+    nini_node_t *parent = make_node_by_path(root, node_path, deli);
+    if( !parent ) return;
+    node = nini_node_find_child(parent, name);
 
-    nini_node_unlink(node);
+    if( !nini_node_unlink(node) ) return;
     nini_node_release(node);
 }
 //------------------------------------------------------------------------------
@@ -0,0 +1,685 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "nini_hash.h"
+#include "nini_loader.h"
+#include "nini_table.h"
+#include "nini_include.h"
+
+/*
+ * Cached files are kept in a hash table of their identities,
+ * which are devices and inodes, or paths on systems without inodes.
+ * The table is created on the first file cached.
+ * Each resolve is a new generation,
+ * and a file is checked and expanded once in a generation no matter how many times it be included.
+ */
+typedef struct nini_include_file_t
+{
+    char     *path;
+    uint64_t  device;
+    uint64_t  inode;
+    int64_t   mtime;    // Nanoseconds if the system supports.
+    int64_t   size;
+
+    bool loaded;    // The contents are loaded, and the file is not changed after that.
+    bool includes;  // The contents have include directives.
+    bool shared;    // The contents are shared in the pool.
+    bool expanding;
+
+    unsigned visited;       // The generation that the file be checked.
+    unsigned expanded_gen;  // The generation that the file be expanded.
+
+    nini_root_t  root;      // Contents of the file.
+    nini_root_t *expanded;  // Contents of the file with the included files, or NULL.
+
+} nini_include_file_t;
+
+typedef struct resolve_t
+{
+    nini_includer_t *includer;
+    nini_errmsg_t   *errmsg;
+
+    const char *filename;   // Identity of the file of the root.
+    bool        have_top;
+    uint64_t    device;
+    uint64_t    inode;
+
+    nini_include_file_t **pending;  // Files those will be loaded by the next wave.
+    size_t                count;
+    size_t                capacity;
+
+    bool load_failed;
+
+    nini_include_file_t **grafts;   // Files of directives of the root, in the order of the directives.
+    size_t                graft_count;
+    size_t                graft_capacity;
+    size_t                graft_next;
+
+} resolve_t;
+
+//------------------------------------------------------------------------------
+void nini_includer_init(nini_includer_t     *self,
+                        const nini_format_t *format,
+                        const char          *directive,
+                        unsigned             threads)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Constructor.
+     *
+     * @param self      Object instance.
+     * @param format    The format of included files, see nini_root_init for more details.
+     * @param directive The name of include directives.
+     * @param threads   Count of worker threads to load files, or ZERO to use the count of processors.
+     */
+    memset(self, 0, sizeof(*self));
+    self->format  = *format;
+    self->threads = threads;
+
+    size_t len = strlen(directive);
+    self->directive = malloc(len + 1);
+    if( self->directive ) memcpy(self->directive, directive, len + 1);
+}
+//------------------------------------------------------------------------------
+static
+void release_expanded(nini_include_file_t *file)
+{
+    if( !file->expanded ) return;
+
+    nini_root_deinit(file->expanded);
+    free(file->expanded);
+    file->expanded = NULL;
+}
+//------------------------------------------------------------------------------
+static
+void release_file(nini_include_file_t *file)
+{
+    release_expanded(file);
+    nini_root_deinit(&file->root);
+    free(file->path);
+    free(file);
+}
+//------------------------------------------------------------------------------
+void nini_includer_clear(nini_includer_t *self)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Remove all cached files.
+     *
+     * @param self Object instance.
+     *
+     * @remarks Roots those the files be grafted to are not changed.
+     */
+    nini_table_t *files = self->files;
+    if( !files ) return;
+
+    for(size_t i = 0; i < files->capacity && files->count; ++i)
+    {
+        if( files->slots[i].item )
+        {
+            release_file(files->slots[i].item);
+            files->slots[i].item = NULL;
+            -- files->count;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void nini_includer_deinit(nini_includer_t *self)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     */
+    nini_includer_clear(self);
+    if( self->files )
+    {
+        nini_table_deinit(self->files);
+        free(self->files);
+    }
+    if( self->directive ) free(self->directive);
+
+    self->files     = NULL;
+    self->directive = NULL;
+}
+//------------------------------------------------------------------------------
+void nini_includer_set_pool(nini_includer_t *self, nini_pool_t *pool)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Share contents of included files by a pool.
+     *
+     * @param self Object instance.
+     * @param pool The pool, or NULL to clone contents of included files.
+     *             It must be valid during the life of the includer.
+     *
+     * @remarks Included sections are then shared by all sections those include them,
+     *          see nini_pool_t for more details about shared sections.
+     */
+    self->pool = pool;
+}
+//------------------------------------------------------------------------------
+size_t nini_includer_get_count(const nini_includer_t *self)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Get count of cached files.
+     *
+     * @param self Object instance.
+     * @return Count of cached files.
+     */
+    return self->files ? self->files->count : 0;
+}
+//------------------------------------------------------------------------------
+static
+bool is_directive(const nini_includer_t *self, const nini_node_t *node)
+{
+    return nini_node_get_type(node) == NINI_STRING &&
+           self->directive &&
+           0 == strcmp(nini_node_get_name(node), self->directive);
+}
+//------------------------------------------------------------------------------
+static
+char* join_path(const char *base, const char *name)
+{
+    // The name is relative to the directory of the base file, unless it is an absolute path.
+    size_t dirlen = 0;
+#ifdef _WIN32
+    bool absolute = name[0] == '/' || name[0] == '\\' || ( name[0] && name[1] == ':' );
+#else
+    bool absolute = name[0] == '/';
+#endif
+    for(size_t i = 0; base && !absolute && base[i]; ++i)
+    {
+#ifdef _WIN32
+        if( base[i] == '/' || base[i] == '\\' ) dirlen = i + 1;
+#else
+        if( base[i] == '/' ) dirlen = i + 1;
+#endif
+    }
+
+    size_t namelen = strlen(name);
+    char  *path    = malloc(dirlen + namelen + 1);
+    if( !path ) return NULL;
+
+    if( dirlen ) memcpy(path, base, dirlen);
+    memcpy(path + dirlen, name, namelen + 1);
+
+    return path;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t hash_identity(uint64_t device, uint64_t inode, const char *path)
+{
+    return inode ? nini_hash_mix(nini_hash_mix(device) ^ inode) : nini_hash_string(path);
+}
+//------------------------------------------------------------------------------
+typedef struct identity_t
+{
+    uint64_t    device;
+    uint64_t    inode;
+    const char *path;
+} identity_t;
+
+//------------------------------------------------------------------------------
+static
+bool same_identity(const nini_include_file_t *file, const identity_t *identity)
+{
+    return identity->inode ?
+           file->device == identity->device && file->inode == identity->inode :
+           0 == strcmp(file->path, identity->path);
+}
+//------------------------------------------------------------------------------
+static
+int64_t get_mtime(const struct stat *info)
+{
+    // Files those are changed in the same second are told by nanoseconds of their modification times.
+#if defined(__APPLE__)
+    return (int64_t) info->st_mtimespec.tv_sec * 1000000000 + info->st_mtimespec.tv_nsec;
+#elif defined(__USE_XOPEN2K8) || ( defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200809L )
+    return (int64_t) info->st_mtim.tv_sec * 1000000000 + info->st_mtim.tv_nsec;
+#else
+    return info->st_mtime;
+#endif
+}
+//------------------------------------------------------------------------------
+static
+void* alloc_failed(resolve_t *resolve)
+{
+    nini_errmsg_write(resolve->errmsg, 0, "", "Memory allocation failed!");
+    return NULL;
+}
+//------------------------------------------------------------------------------
+static
+nini_include_file_t* get_file(resolve_t *resolve, const char *path)
+{
+    // Get the cached file, and mark it to be loaded again if it is changed.
+    nini_includer_t *self = resolve->includer;
+
+    struct stat info;
+    if( stat(path, &info) || !S_ISREG(info.st_mode) )
+    {
+        nini_errmsg_write(resolve->errmsg, 0, path, "Cannot read the file!");
+        return NULL;
+    }
+
+    if( !self->files )
+    {
+        if( !( self->files = malloc(sizeof(*self->files)) ) ) return alloc_failed(resolve);
+        nini_table_init(self->files);
+    }
+
+    identity_t identity = { info.st_dev, info.st_ino, path };
+    uint64_t   hash     = hash_identity(identity.device, identity.inode, path);
+
+    nini_table_slot_t   *slot = nini_table_find(self->files, hash, (nini_table_match_t) same_identity, &identity);
+    nini_include_file_t *file = slot ? slot->item : NULL;
+    if( !file )
+    {
+        size_t len = strlen(path);
+        if( !( file = calloc(1, sizeof(*file)) ) ) return alloc_failed(resolve);
+        if( !( file->path = malloc(len + 1) ) || !nini_table_insert(self->files, file, hash) )
+        {
+            if( file->path ) free(file->path);
+            free(file);
+            return alloc_failed(resolve);
+        }
+
+        memcpy(file->path, path, len + 1);
+        file->device = identity.device;
+        file->inode  = identity.inode;
+        nini_root_init(&file->root, &self->format);
+    }
+
+    int64_t mtime = get_mtime(&info);
+    if( file->mtime != mtime || file->size != info.st_size ) file->loaded = false;
+    file->mtime = mtime;
+    file->size  = info.st_size;
+
+    return file;
+}
+//------------------------------------------------------------------------------
+static
+bool push_file(nini_include_file_t ***files, size_t *count, size_t *capacity, nini_include_file_t *file)
+{
+    if( *count >= *capacity )
+    {
+        size_t new_capacity = *capacity ? 2 * *capacity : 16;
+        nini_include_file_t **new_files = realloc(*files, new_capacity * sizeof(new_files[0]));
+        if( !new_files ) return false;
+
+        *files    = new_files;
+        *capacity = new_capacity;
+    }
+
+    (*files)[ (*count) ++ ] = file;
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool collect(resolve_t *resolve, nini_node_t *parent, const char *base, bool *found)
+{
+    // Check files included by the section, and files those are not loaded will be loaded by the next wave.
+    for(nini_node_t *node = nini_node_get_first_child(parent);
+        node;
+        node = nini_node_get_next_sibling(node))
+    {
+        if( is_directive(resolve->includer, node) )
+        {
+            if( found ) *found = true;
+
+            char *path = join_path(base, nini_node_get_string(node));
+            if( !path )
+            {
+                nini_errmsg_write(resolve->errmsg, 0, "", "Memory allocation failed!");
+                return false;
+            }
+
+            nini_include_file_t *file = get_file(resolve, path);
+            free(path);
+            if( !file ) return false;
+
+            if( file->visited == resolve->includer->generation ) continue;
+            file->visited = resolve->includer->generation;
+
+            if( !file->loaded )
+            {
+                if( !push_file(&resolve->pending, &resolve->count, &resolve->capacity, file) )
+                {
+                    nini_errmsg_write(resolve->errmsg, 0, "", "Memory allocation failed!");
+                    return false;
+                }
+            }
+            else
+            {
+                file->includes = false;
+                if( !collect(resolve, &file->root.super, file->path, &file->includes) ) return false;
+            }
+        }
+        else if( nini_node_get_type(node) == NINI_SECTION && !nini_node_is_shared(node) )
+        {
+            if( !collect(resolve, node, base, found) ) return false;
+        }
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void on_load(resolve_t *resolve, size_t index, nini_root_t *root, const nini_errmsg_t *errmsg)
+{
+    // Report the first failure, with the name of the file if it is not a failure of a line.
+    if( root || resolve->load_failed ) return;
+    resolve->load_failed = true;
+
+    if( !resolve->errmsg ) return;
+
+    *resolve->errmsg = *errmsg;
+    if( !errmsg->line_num )
+    {
+        const char *path = resolve->pending[index]->path;
+        nini_errmsg_write(resolve->errmsg, 0, path, "%s", errmsg->message);
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool load_pending(resolve_t *resolve)
+{
+    // Load files wave by wave, and files included by a wave will be loaded by the next one.
+    while( resolve->count )
+    {
+        nini_loader_t loader;
+        nini_loader_init(&loader);
+
+        bool res = true;
+        for(size_t i = 0; res && i < resolve->count; ++i)
+        {
+            nini_include_file_t *file = resolve->pending[i];
+            release_expanded(file);
+            res = nini_loader_add_file(&loader, file->path, &file->root);
+        }
+
+        if( res )
+        {
+            nini_loader_load(&loader,
+                             resolve->includer->threads,
+                             (nini_on_load_t) on_load,
+                             resolve);
+        }
+        else
+        {
+            nini_errmsg_write(resolve->errmsg, 0, "", "Memory allocation failed!");
+        }
+
+        nini_loader_deinit(&loader);
+        if( !res || resolve->load_failed ) return false;
+
+        // Take out files of this wave, and check their contents.
+        nini_include_file_t **files = resolve->pending;
+        size_t                count = resolve->count;
+        resolve->pending  = NULL;
+        resolve->count    = 0;
+        resolve->capacity = 0;
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            files[i]->loaded = true;
+            files[i]->shared = false;
+        }
+
+        for(size_t i = 0; res && i < count; ++i)
+        {
+            files[i]->includes = false;
+            res = collect(resolve, &files[i]->root.super, files[i]->path, &files[i]->includes);
+        }
+
+        free(files);
+        if( !res ) return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool graft(resolve_t *resolve, nini_node_t *parent, const char *base, bool apply, bool top);
+//------------------------------------------------------------------------------
+static
+const nini_node_t* expand(resolve_t *resolve, nini_include_file_t *file)
+{
+    // Get contents of the file with contents of the files it included.
+    nini_includer_t *self = resolve->includer;
+
+    if( !file->includes )
+    {
+        if( self->pool && !file->shared ) file->shared = nini_pool_share(self->pool, &file->root);
+        return &file->root.super;
+    }
+
+    if( file->expanded && file->expanded_gen == self->generation ) return &file->expanded->super;
+
+    release_expanded(file);
+    file->expanded = malloc(sizeof(*file->expanded));
+    if( !file->expanded )
+    {
+        nini_errmsg_write(resolve->errmsg, 0, file->path, "Memory allocation failed!");
+        return NULL;
+    }
+    nini_root_init(file->expanded, &self->format);
+
+    bool res = true;
+    for(const nini_node_t *child = nini_root_get_first_child_c(&file->root);
+        res && child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        res = nini_node_link_child(&file->expanded->super, nini_node_clone(child));
+    }
+
+    if( !res ) nini_errmsg_write(resolve->errmsg, 0, file->path, "Memory allocation failed!");
+
+    file->expanding = true;
+    res = res && graft(resolve, &file->expanded->super, file->path, true, false);
+    file->expanding = false;
+
+    if( !res )
+    {
+        release_expanded(file);
+        return NULL;
+    }
+
+    if( self->pool ) nini_pool_share(self->pool, file->expanded);
+    file->expanded_gen = self->generation;
+
+    return &file->expanded->super;
+}
+//------------------------------------------------------------------------------
+static
+nini_include_file_t* check_file(resolve_t *resolve, nini_node_t *node, const char *base)
+{
+    char *path = join_path(base, nini_node_get_string(node));
+    if( !path )
+    {
+        nini_errmsg_write(resolve->errmsg, 0, "", "Memory allocation failed!");
+        return NULL;
+    }
+
+    nini_include_file_t *file = get_file(resolve, path);
+    free(path);
+    if( !file ) return NULL;
+
+    identity_t top = { resolve->device, resolve->inode, resolve->filename };
+    if( file->expanding || ( resolve->have_top && same_identity(file, &top) ) )
+    {
+        nini_errmsg_write(resolve->errmsg, 0, file->path, "Include cycle!");
+        return NULL;
+    }
+
+    if( !file->loaded )
+    {
+        // The file is changed after it be loaded.
+        nini_errmsg_write(resolve->errmsg, 0, file->path, "Cannot read the file!");
+        return NULL;
+    }
+
+    return expand(resolve, file) ? file : NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool graft_file(resolve_t *resolve, nini_node_t *node, const char *base, bool apply, bool top)
+{
+    /*
+     * Replace the directive by contents of the file.
+     * Files of directives of the root are checked and expanded before any of them be grafted,
+     * and they are grafted by the same records without checking them again,
+     * so that only memory allocation can fail after the root be changed.
+     */
+    nini_include_file_t *file;
+    if( top && apply )
+    {
+        file = resolve->grafts[ resolve->graft_next ++ ];
+    }
+    else
+    {
+        if( !( file = check_file(resolve, node, base) ) ) return false;
+        if( !apply )
+        {
+            if( !push_file(&resolve->grafts, &resolve->graft_count, &resolve->graft_capacity, file) )
+            {
+                nini_errmsg_write(resolve->errmsg, 0, "", "Memory allocation failed!");
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    const nini_node_t *contents = file->includes ? &file->expanded->super : &file->root.super;
+
+    nini_node_t *parent = node->parent;
+    nini_node_t *prev   = node;
+    for(const nini_node_t *child = nini_node_get_first_child_c(contents);
+        child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        nini_node_t *copy = nini_node_clone(child);
+        if( !nini_node_link_child(parent, copy) )
+        {
+            if( copy ) nini_node_release(copy);
+            nini_errmsg_write(resolve->errmsg, 0, file->path, "Memory allocation failed!");
+            return false;
+        }
+
+        nini_node_move_after(copy, prev);
+        prev = copy;
+    }
+
+    nini_node_unlink(node);
+    nini_node_release(node);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool graft(resolve_t *resolve, nini_node_t *parent, const char *base, bool apply, bool top)
+{
+    // Graft included files to the section, or only expand them if not to apply.
+    nini_node_t *next;
+    for(nini_node_t *node = nini_node_get_first_child(parent); node; node = next)
+    {
+        next = nini_node_get_next_sibling(node);
+
+        if( is_directive(resolve->includer, node) )
+        {
+            if( !graft_file(resolve, node, base, apply, top) ) return false;
+        }
+        else if( nini_node_get_type(node) == NINI_SECTION && !nini_node_is_shared(node) )
+        {
+            if( !graft(resolve, node, base, apply, top) ) return false;
+        }
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_includer_resolve(nini_includer_t *self,
+                           nini_root_t     *root,
+                           const char      *filename,
+                           nini_errmsg_t   *errmsg)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Replace include directives of a root by contents of the included files.
+     *
+     * @param self     Object instance.
+     * @param root     The root to be resolved.
+     * @param filename Name of the file of the root, which names of included files are relative to;
+     *                 or NULL if names are relative to the current directory.
+     * @param errmsg   The object that will be filled with failure information if resolve failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The root will not be changed if any file cannot be loaded or there is an include cycle,
+     *          but it may be partially resolved if memory allocation failed while grafting.
+     */
+    if( nini_root_is_frozen(root) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
+    ++ self->generation;
+
+    resolve_t resolve;
+    memset(&resolve, 0, sizeof(resolve));
+    resolve.includer = self;
+    resolve.errmsg   = errmsg;
+
+    struct stat info;
+    if( filename && !stat(filename, &info) )
+    {
+        resolve.filename = filename;
+        resolve.have_top = true;
+        resolve.device   = info.st_dev;
+        resolve.inode    = info.st_ino;
+    }
+
+    // Load files, then expand them, and then graft them to the root.
+    bool res = collect(&resolve, &root->super, filename, NULL) &&
+               load_pending(&resolve) &&
+               graft(&resolve, &root->super, filename, false, true) &&
+               graft(&resolve, &root->super, filename, true, true);
+
+    if( resolve.pending ) free(resolve.pending);
+    if( resolve.grafts  ) free(resolve.grafts);
+    if( res && errmsg ) memset(errmsg, 0, sizeof(*errmsg));
+
+    return res;
+}
+//------------------------------------------------------------------------------
+bool nini_includer_load_file(nini_includer_t *self,
+                             nini_root_t     *root,
+                             const char      *filename,
+                             nini_errmsg_t   *errmsg)
+{
+    /**
+     * @memberof nini_includer_t
+     * @brief Load a NINI format file and the files it included.
+     *
+     * @param self     Object instance.
+     * @param root     The root that the file will be loaded to.
+     * @param filename Name of the file.
+     * @param errmsg   The object that will be filled with failure information if load failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The file is loaded in the same way as nini_root_load_file,
+     *          and then include directives are resolved by nini_includer_resolve.
+     *          The root will keep contents of the file if included files cannot be grafted.
+     */
+    return nini_root_load_file(root, filename, errmsg) &&
+           nini_includer_resolve(self, root, filename, errmsg);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,732 @@
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "nini_hash.h"
+#include "nini_atomic.h"
+#include "nini_helper.h"
+#include "nini_journal.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+/*
+ * The journal file starts with a magic string, and follows by records.
+ * Each record has a head of the payload size and the payload checksum (both 32-bit little-endian),
+ * and the payload is:
+ *
+ *     operation (1 byte), delimiter (1 byte), path (null terminated), value
+ *
+ * The value is a null terminated string, a 64-bit little-endian integer,
+ * the 64-bit little-endian bits of a floating point number, one byte of boolean,
+ * or nothing, depends on the operation.
+ *
+ * A record that is broken by a crash during the commit can only be the last one,
+ * and it will be detected by the checksum and be removed when the journal be opened.
+ */
+
+static const char journal_magic[8] = { 'N', 'I', 'N', 'I', 'J', 'N', 'L', '1' };
+
+#define RECORD_HEAD_SIZE 8
+
+enum
+{
+    OP_STRING  = 'S',
+    OP_DECIMAL = 'D',
+    OP_HEXA    = 'H',
+    OP_FLOAT   = 'F',
+    OP_BOOL    = 'B',
+    OP_NULL    = 'N',
+    OP_REMOVE  = 'R',
+};
+
+#ifndef _WIN32
+
+//------------------------------------------------------------------------------
+static
+bool file_append(nini_journal_t *self, const char *data, size_t size)
+{
+    while( size )
+    {
+        ssize_t res = write(self->fd, data, size);
+        if( res < 0 )
+        {
+            if( errno == EINTR ) continue;
+            return false;
+        }
+
+        data += res;
+        size -= res;
+        self->size += res;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool file_sync(nini_journal_t *self)
+{
+#ifdef __linux__
+    return 0 == fdatasync(self->fd);
+#else
+    return 0 == fsync(self->fd);
+#endif
+}
+//------------------------------------------------------------------------------
+static
+bool file_truncate(nini_journal_t *self, long size)
+{
+    if( 0 != ftruncate(self->fd, size) || size != lseek(self->fd, size, SEEK_SET) ) return false;
+
+    self->size = size;
+    return file_sync(self);
+}
+//------------------------------------------------------------------------------
+static
+bool file_open(nini_journal_t *self, long valid_size)
+{
+    // Open the journal file to append records after the valid ones.
+    self->fd = open(self->jnlname, O_WRONLY | O_CREAT, 0666);
+    if( self->fd < 0 ) return false;
+
+    if( valid_size ) return file_truncate(self, valid_size);
+
+    if( !file_truncate(self, 0) ||
+        !file_append(self, journal_magic, sizeof(journal_magic)) ||
+        !file_sync(self) )
+    {
+        return false;
+    }
+
+    nini_atomic_sync_directory(self->jnlname);
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void file_close(nini_journal_t *self)
+{
+    if( self->fd >= 0 ) close(self->fd);
+    self->fd = -1;
+}
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+static
+bool file_append(nini_journal_t *self, const char *data, size_t size)
+{
+    size_t res = fwrite(data, 1, size, self->file);
+    self->size += res;
+
+    return res == size;
+}
+//------------------------------------------------------------------------------
+static
+bool file_sync(nini_journal_t *self)
+{
+    return 0 == fflush(self->file) && 0 == _commit(_fileno(self->file));
+}
+//------------------------------------------------------------------------------
+static
+bool file_truncate(nini_journal_t *self, long size)
+{
+    if( 0 != fflush(self->file) ||
+        0 != _chsize(_fileno(self->file), size) ||
+        0 != fseek(self->file, size, SEEK_SET) )
+    {
+        return false;
+    }
+
+    self->size = size;
+    return file_sync(self);
+}
+//------------------------------------------------------------------------------
+static
+bool file_open(nini_journal_t *self, long valid_size)
+{
+    // Open the journal file to append records after the valid ones.
+    self->file = fopen(self->jnlname, valid_size ? "r+b" : "wb");
+    if( !self->file ) return false;
+
+    if( valid_size ) return file_truncate(self, valid_size);
+
+    return file_append(self, journal_magic, sizeof(journal_magic)) && file_sync(self);
+}
+//------------------------------------------------------------------------------
+static
+void file_close(nini_journal_t *self)
+{
+    if( self->file ) fclose(self->file);
+    self->file = NULL;
+}
+//------------------------------------------------------------------------------
+#endif
+
+//------------------------------------------------------------------------------
+static
+void store_u32(uint8_t *buf, uint32_t value)
+{
+    for(int i = 0; i < 4; ++i, value >>= 8)
+        buf[i] = (uint8_t) value;
+}
+//------------------------------------------------------------------------------
+static
+void store_u64(uint8_t *buf, uint64_t value)
+{
+    for(int i = 0; i < 8; ++i, value >>= 8)
+        buf[i] = (uint8_t) value;
+}
+//------------------------------------------------------------------------------
+static
+uint32_t load_u32(const uint8_t *buf)
+{
+    uint32_t value = 0;
+    for(int i = 3; i >= 0; --i)
+        value = ( value << 8 ) | buf[i];
+
+    return value;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t load_u64(const uint8_t *buf)
+{
+    uint64_t value = 0;
+    for(int i = 7; i >= 0; --i)
+        value = ( value << 8 ) | buf[i];
+
+    return value;
+}
+//------------------------------------------------------------------------------
+static
+uint32_t checksum(const uint8_t *data, size_t size)
+{
+    return (uint32_t) nini_hash_mix(nini_hash_bytes(0xCBF29CE484222325ULL, data, size));
+}
+//------------------------------------------------------------------------------
+static
+bool put_record(nini_journal_t *self, char op, const char *path, char deli, const void *value, size_t value_size)
+{
+    size_t path_size    = strlen(path) + 1;
+    size_t payload_size = 2 + path_size + value_size;
+    size_t record_size  = RECORD_HEAD_SIZE + payload_size;
+    if( payload_size > UINT32_MAX ) return false;
+
+    if( self->buf_size + record_size > self->buf_capacity )
+    {
+        size_t capacity = self->buf_capacity ? 2 * self->buf_capacity : 4096;
+        while( capacity < self->buf_size + record_size )
+            capacity *= 2;
+
+        char *buf = realloc(self->buf, capacity);
+        if( !buf ) return false;
+
+        self->buf          = buf;
+        self->buf_capacity = capacity;
+    }
+
+    uint8_t *record  = (uint8_t*) self->buf + self->buf_size;
+    uint8_t *payload = record + RECORD_HEAD_SIZE;
+
+    payload[0] = op;
+    payload[1] = deli;
+    memcpy(payload + 2, path, path_size);
+    if( value_size ) memcpy(payload + 2 + path_size, value, value_size);
+
+    store_u32(record, payload_size);
+    store_u32(record + 4, checksum(payload, payload_size));
+
+    self->buf_size += record_size;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_record(nini_root_t *root, const uint8_t *payload, size_t size)
+{
+    // Return FALSE if the record is malformed.
+    if( size < 3 ) return false;
+
+    char        op   = payload[0];
+    char        deli = payload[1];
+    const char *path = (const char*) payload + 2;
+
+    const uint8_t *end = memchr(path, 0, size - 2);
+    if( !end ) return false;
+
+    const uint8_t *value      = end + 1;
+    size_t         value_size = payload + size - value;
+
+    /*
+     * Records those cannot be applied are ignored,
+     * because they have no effect on the root when they were recorded.
+     */
+    switch( op )
+    {
+    case OP_STRING:
+        if( !value_size || value[ value_size - 1 ] ) return false;
+        nini_write_string(root, path, deli, (const char*) value);
+        return true;
+
+    case OP_DECIMAL:
+        if( value_size != 8 ) return false;
+        nini_write_decimal(root, path, deli, (long)(int64_t) load_u64(value));
+        return true;
+
+    case OP_HEXA:
+        if( value_size != 8 ) return false;
+        nini_write_hexa(root, path, deli, (long)(int64_t) load_u64(value));
+        return true;
+
+    case OP_FLOAT:
+    {
+        if( value_size != 8 ) return false;
+
+        uint64_t bits = load_u64(value);
+        double   floating;
+        memcpy(&floating, &bits, sizeof(floating));
+
+        nini_write_float(root, path, deli, floating);
+        return true;
+    }
+
+    case OP_BOOL:
+        if( value_size != 1 ) return false;
+        nini_write_bool(root, path, deli, value[0]);
+        return true;
+
+    case OP_NULL:
+        if( value_size ) return false;
+        nini_write_null(root, path, deli);
+        return true;
+
+    case OP_REMOVE:
+        if( value_size ) return false;
+        nini_remove(root, path, deli);
+        return true;
+
+    default:
+        return false;
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool replay(nini_journal_t *self, const uint8_t *data, long size, long *valid_size, nini_errmsg_t *errmsg)
+{
+    // A journal file without the complete magic string was broken when it was being created.
+    *valid_size = 0;
+    if( size < (long) sizeof(journal_magic) ) return true;
+
+    if( memcmp(data, journal_magic, sizeof(journal_magic)) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Invalid journal file!");
+        return false;
+    }
+
+    long pos = sizeof(journal_magic);
+    while( size - pos >= RECORD_HEAD_SIZE )
+    {
+        const uint8_t *record       = data + pos;
+        uint32_t       payload_size = load_u32(record);
+        if( payload_size > (uint64_t)( size - pos - RECORD_HEAD_SIZE ) ) break;
+
+        const uint8_t *payload = record + RECORD_HEAD_SIZE;
+        if( load_u32(record + 4) != checksum(payload, payload_size) ) break;
+        if( !apply_record(self->root, payload, payload_size) ) break;
+
+        pos += RECORD_HEAD_SIZE + payload_size;
+    }
+
+    *valid_size = pos;
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool read_file(const char *filename, uint8_t **data, long *size)
+{
+    // An empty or not existed file is read as NULL with ZERO size, and other failures are reported.
+    *data = NULL;
+    *size = 0;
+
+    FILE *file = fopen(filename, "rb");
+    if( !file ) return errno == ENOENT;
+
+    bool res = false;
+    do
+    {
+        long file_size;
+        if( fseek(file, 0, SEEK_END) || 0 > ( file_size = ftell(file) ) || fseek(file, 0, SEEK_SET) ) break;
+
+        if( file_size )
+        {
+            if( !( *data = malloc(file_size) ) ) break;
+            if( (size_t) file_size != fread(*data, 1, file_size, file) ) break;
+        }
+
+        *size = file_size;
+        res = true;
+    } while(false);
+
+    if( !res && *data )
+    {
+        free(*data);
+        *data = NULL;
+    }
+
+    fclose(file);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+static
+void release_resources(nini_journal_t *self)
+{
+    file_close(self);
+
+    if( self->filename ) free(self->filename);
+    if( self->jnlname  ) free(self->jnlname);
+    if( self->buf      ) free(self->buf);
+
+    self->filename = NULL;
+    self->jnlname  = NULL;
+    self->buf      = NULL;
+}
+//------------------------------------------------------------------------------
+bool nini_journal_open(nini_journal_t *self,
+                       nini_root_t    *root,
+                       const char     *filename,
+                       size_t          compact_size,
+                       nini_errmsg_t  *errmsg)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Load a NINI format file and its journal to a root, and open the journal for changes.
+     *
+     * @param self         Object instance.
+     * @param root         The root to be loaded, and all changes will be made to it.
+     * @param filename     Name of the NINI format file.
+     *                     The file will be treated as an empty one if it is not existed.
+     * @param compact_size The journal will be compacted when it is committed
+     *                     and its size is not less than this value,
+     *                     or ZERO to compact the journal by nini_journal_compact only.
+     * @param errmsg       The object that will be filled with failure information if failed,
+     *                     and it will be cleared otherwise.
+     *                     This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks Records in the journal will be applied to the root after the file be loaded,
+     *          and the broken records of an interrupted commit will be removed.
+     * @remarks The open will fail if the file or the journal exists but cannot be read,
+     *          and the journal will not be changed then.
+     * @remarks The object does not need to be closed if this function failed.
+     */
+    memset(self, 0, sizeof(*self));
+    self->fd           = -1;
+    self->root         = root;
+    self->compact_size = compact_size;
+
+    bool res = false;
+    do
+    {
+        size_t len = strlen(filename);
+        if( !( self->filename = malloc(len + 1) ) ||
+            !( self->jnlname = malloc(len + sizeof(".journal")) ) )
+        {
+            nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+            break;
+        }
+
+        memcpy(self->filename, filename, len + 1);
+        memcpy(self->jnlname, filename, len);
+        memcpy(self->jnlname + len, ".journal", sizeof(".journal"));
+
+        // Load the base file, and only a file not existed is treated as an empty one.
+        FILE *file    = fopen(filename, "rb");
+        bool  missing = !file && errno == ENOENT;
+        if( file ) fclose(file);
+
+        if( missing ?
+            !nini_root_decode(root, NULL, 0, errmsg) :
+            !nini_root_load_file(root, filename, errmsg) )
+        {
+            break;
+        }
+
+        // Replay the journal, and the journal file is not touched if it cannot be read.
+        long     size;
+        long     valid_size;
+        uint8_t *data;
+        if( !read_file(self->jnlname, &data, &size) )
+        {
+            nini_errmsg_write(errmsg, 0, "", "Cannot read the journal file!");
+            break;
+        }
+
+        bool succ = replay(self, data, size, &valid_size, errmsg);
+        if( data ) free(data);
+        if( !succ ) break;
+
+        if( !file_open(self, valid_size) )
+        {
+            nini_errmsg_write(errmsg, 0, "", "Cannot open the journal file!");
+            break;
+        }
+
+        res = true;
+    } while(false);
+
+    if( !res )
+    {
+        release_resources(self);
+        return false;
+    }
+
+    if( errmsg )
+        memset(errmsg, 0, sizeof(*errmsg));
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_journal_close(nini_journal_t *self, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Commit the rest changes and close the journal.
+     *
+     * @param self   Object instance.
+     * @param errmsg The object that will be filled with failure information if the commit failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if the commit failed.
+     *
+     * @remarks The journal will be closed even if the commit failed.
+     */
+    bool res = nini_journal_commit(self, errmsg);
+    release_resources(self);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+static
+bool end_record(nini_journal_t *self, size_t mark, bool applied)
+{
+    // Discard the record if the change cannot be applied.
+    if( !applied ) self->buf_size = mark;
+    return applied;
+}
+//------------------------------------------------------------------------------
+bool nini_journal_write_string(nini_journal_t *self, const char *path, char deli, const char *value)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write string value to a key, see nini_write_string for more details.
+     *
+     * @param self  Object instance.
+     * @param path  The path of the key, see @ref key-path for more details.
+     * @param deli  The path delimiter.
+     * @param value The value to be write to.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    size_t mark = self->buf_size;
+    if( !put_record(self, OP_STRING, path, deli, value, strlen(value) + 1) ) return false;
+
+    return end_record(self, mark, nini_write_string(self->root, path, deli, value));
+}
+//------------------------------------------------------------------------------
+bool nini_journal_write_decimal(nini_journal_t *self, const char *path, char deli, long value)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write decimal value to a key, see nini_write_decimal for more details.
+     *
+     * @param self  Object instance.
+     * @param path  The path of the key, see @ref key-path for more details.
+     * @param deli  The path delimiter.
+     * @param value The value to be write to.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    uint8_t data[8];
+    store_u64(data, (uint64_t)(int64_t) value);
+
+    size_t mark = self->buf_size;
+    if( !put_record(self, OP_DECIMAL, path, deli, data, sizeof(data)) ) return false;
+
+    return end_record(self, mark, nini_write_decimal(self->root, path, deli, value));
+}
+//------------------------------------------------------------------------------
+bool nini_journal_write_hexa(nini_journal_t *self, const char *path, char deli, long value)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write hexadecimal value to a key, see nini_write_hexa for more details.
+     *
+     * @param self  Object instance.
+     * @param path  The path of the key, see @ref key-path for more details.
+     * @param deli  The path delimiter.
+     * @param value The value to be write to.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    uint8_t data[8];
+    store_u64(data, (uint64_t)(int64_t) value);
+
+    size_t mark = self->buf_size;
+    if( !put_record(self, OP_HEXA, path, deli, data, sizeof(data)) ) return false;
+
+    return end_record(self, mark, nini_write_hexa(self->root, path, deli, value));
+}
+//------------------------------------------------------------------------------
+bool nini_journal_write_float(nini_journal_t *self, const char *path, char deli, double value)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write floating point value to a key, see nini_write_float for more details.
+     *
+     * @param self  Object instance.
+     * @param path  The path of the key, see @ref key-path for more details.
+     * @param deli  The path delimiter.
+     * @param value The value to be write to.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint8_t data[8];
+    store_u64(data, bits);
+
+    size_t mark = self->buf_size;
+    if( !put_record(self, OP_FLOAT, path, deli, data, sizeof(data)) ) return false;
+
+    return end_record(self, mark, nini_write_float(self->root, path, deli, value));
+}
+//------------------------------------------------------------------------------
+bool nini_journal_write_bool(nini_journal_t *self, const char *path, char deli, bool value)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write boolean value to a key, see nini_write_bool for more details.
+     *
+     * @param self  Object instance.
+     * @param path  The path of the key, see @ref key-path for more details.
+     * @param deli  The path delimiter.
+     * @param value The value to be write to.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    uint8_t data = value;
+
+    size_t mark = self->buf_size;
+    if( !put_record(self, OP_BOOL, path, deli, &data, sizeof(data)) ) return false;
+
+    return end_record(self, mark, nini_write_bool(self->root, path, deli, value));
+}
+//------------------------------------------------------------------------------
+bool nini_journal_write_null(nini_journal_t *self, const char *path, char deli)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write a key without value, see nini_write_null for more details.
+     *
+     * @param self Object instance.
+     * @param path The path of the key, see @ref key-path for more details.
+     * @param deli The path delimiter.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    size_t mark = self->buf_size;
+    if( !put_record(self, OP_NULL, path, deli, NULL, 0) ) return false;
+
+    return end_record(self, mark, nini_write_null(self->root, path, deli));
+}
+//------------------------------------------------------------------------------
+bool nini_journal_remove(nini_journal_t *self, const char *path, char deli)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Remove a node, see nini_remove for more details.
+     *
+     * @param self Object instance.
+     * @param path The path of the node, see @ref key-path for more details.
+     * @param deli The path delimiter.
+     * @return TRUE if succeed or the node is not existed; and FALSE if not.
+     */
+    if( !nini_is_existed(self->root, path, deli) ) return true;
+    if( nini_root_is_frozen(self->root) ) return false;
+
+    if( !put_record(self, OP_REMOVE, path, deli, NULL, 0) ) return false;
+    nini_remove(self->root, path, deli);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_journal_commit(nini_journal_t *self, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Write all changes to the journal file and flush them to the disk.
+     *
+     * @param self   Object instance.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The journal will be compacted if its size reached the compaction size.
+     * @remarks Changes are kept to be committed again if failed.
+     */
+    if( self->buf_size )
+    {
+        long size = self->size;
+        if( !file_append(self, self->buf, self->buf_size) || !file_sync(self) )
+        {
+            // Remove the part of records those have been written.
+            file_truncate(self, size);
+
+            nini_errmsg_write(errmsg, 0, "", "Cannot write the journal file!");
+            return false;
+        }
+
+        self->buf_size = 0;
+    }
+
+    if( self->compact_size && (size_t) self->size >= self->compact_size )
+        return nini_journal_compact(self, errmsg);
+
+    if( errmsg )
+        memset(errmsg, 0, sizeof(*errmsg));
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_journal_compact(nini_journal_t *self, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_journal_t
+     * @brief Save the root to the NINI format file, and clear the journal.
+     *
+     * @param self   Object instance.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks Changes those have not been committed will also be saved to the file.
+     * @remarks The file will be replaced atomically, see nini_root_save_file_atomic.
+     *          If the journal cannot be cleared after that,
+     *          the records will be applied again when the journal be opened,
+     *          and that gets the same result because each record overwrites or removes a node.
+     * @remarks Comments and formatting of the file will be kept
+     *          if the root is in the lossless mode, see nini_root_enable_lossless.
+     */
+    if( !nini_root_save_file_atomic(self->root, self->filename, 1, errmsg) ) return false;
+
+    self->buf_size = 0;
+    if( !file_truncate(self, sizeof(journal_magic)) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Cannot clear the journal file!");
+        return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,510 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "nini_loader.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef NINI_USE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef struct nini_loader_file_t
+{
+    char        *filename;
+    nini_root_t *root;
+    bool         owned;     // The root is created by the loader.
+    bool         loaded;
+} nini_loader_file_t;
+
+//------------------------------------------------------------------------------
+void nini_loader_init(nini_loader_t *self)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Constructor.
+     *
+     * @param self Object instance.
+     */
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
+static
+void release_root(nini_root_t *root)
+{
+    nini_root_deinit(root);
+    free(root);
+}
+//------------------------------------------------------------------------------
+void nini_loader_deinit(nini_loader_t *self)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     *
+     * @remarks Roots created by nini_loader_add_directory will be released,
+     *          and roots added by nini_loader_add_file are not changed.
+     */
+    for(size_t i = 0; i < self->count; ++i)
+    {
+        free(self->files[i].filename);
+        if( self->files[i].owned ) release_root(self->files[i].root);
+    }
+
+    if( self->files ) free(self->files);
+
+    self->files    = NULL;
+    self->count    = 0;
+    self->capacity = 0;
+}
+//------------------------------------------------------------------------------
+static
+bool push_file(nini_loader_t *self, const char *filename, nini_root_t *root, bool owned)
+{
+    if( self->count >= self->capacity )
+    {
+        size_t capacity = self->capacity ? 2 * self->capacity : 16;
+        nini_loader_file_t *files = realloc(self->files, capacity * sizeof(files[0]));
+        if( !files ) return false;
+
+        self->files    = files;
+        self->capacity = capacity;
+    }
+
+    size_t len  = strlen(filename);
+    char  *copy = malloc(len + 1);
+    if( !copy ) return false;
+    memcpy(copy, filename, len + 1);
+
+    nini_loader_file_t *file = &self->files[ self->count ++ ];
+    file->filename = copy;
+    file->root     = root;
+    file->owned    = owned;
+    file->loaded   = false;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_loader_add_file(nini_loader_t *self, const char *filename, nini_root_t *root)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Add a file to be loaded.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the file.
+     * @param root     The root that the file will be loaded to,
+     *                 and it must be valid during the life of the loader.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    if( !filename || !root ) return false;
+
+    return push_file(self, filename, root, false);
+}
+//------------------------------------------------------------------------------
+static
+bool add_entry(nini_loader_t *self, const char *filename, const nini_format_t *format)
+{
+    nini_root_t *root = malloc(sizeof(*root));
+    if( !root ) return false;
+    nini_root_init(root, format);
+
+    if( push_file(self, filename, root, true) ) return true;
+
+    release_root(root);
+    return false;
+}
+//------------------------------------------------------------------------------
+static
+int compare_files(const void *a, const void *b)
+{
+    return strcmp(((const nini_loader_file_t*) a)->filename, ((const nini_loader_file_t*) b)->filename);
+}
+//------------------------------------------------------------------------------
+size_t nini_loader_add_directory(nini_loader_t       *self,
+                                 const char          *dirname,
+                                 const char          *pattern,
+                                 const nini_format_t *format)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Add files of a directory those names match a pattern.
+     *
+     * @param self    Object instance.
+     * @param dirname Name of the directory.
+     * @param pattern The wildcard pattern of file names (for example, "*.ini"),
+     *                or NULL to add all files.
+     * @param format  The format of the files, see nini_root_init for more details.
+     * @return Count of files added.
+     *
+     * @remarks A root will be created for each of the files, and it will be released with the loader.
+     * @remarks Files are added in the order of their names, and hidden files and sub-directories are skipped.
+     */
+    if( !dirname ) return 0;
+    if( !pattern ) pattern = "*";
+
+    size_t first = self->count;
+    char   path[4096];
+
+#ifdef _WIN32
+    snprintf(path, sizeof(path), "%s\\%s", dirname, pattern);
+
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(path, &data);
+    if( find == INVALID_HANDLE_VALUE ) return 0;
+
+    do
+    {
+        if( data.dwFileAttributes & ( FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_HIDDEN ) ) continue;
+
+        snprintf(path, sizeof(path), "%s\\%s", dirname, data.cFileName);
+        if( !add_entry(self, path, format) ) break;
+    } while( FindNextFileA(find, &data) );
+
+    FindClose(find);
+#else
+    DIR *dir = opendir(dirname);
+    if( !dir ) return 0;
+
+    struct dirent *entry;
+    while(( entry = readdir(dir) ))
+    {
+        if( fnmatch(pattern, entry->d_name, FNM_PERIOD) ) continue;
+
+        snprintf(path, sizeof(path), "%s/%s", dirname, entry->d_name);
+
+        struct stat info;
+        if( stat(path, &info) || !S_ISREG(info.st_mode) ) continue;
+
+        if( !add_entry(self, path, format) ) break;
+    }
+
+    closedir(dir);
+#endif
+
+    qsort(self->files + first, self->count - first, sizeof(self->files[0]), compare_files);
+
+    return self->count - first;
+}
+//------------------------------------------------------------------------------
+const char* nini_loader_get_filename(const nini_loader_t *self, size_t index)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Get name of a file.
+     *
+     * @param self  Object instance.
+     * @param index Index of the file.
+     * @return Name of the file; or NULL if the index is out of range.
+     */
+    return index < self->count ? self->files[index].filename : NULL;
+}
+//------------------------------------------------------------------------------
+nini_root_t* nini_loader_get_root(const nini_loader_t *self, size_t index)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Get the root of a file.
+     *
+     * @param self  Object instance.
+     * @param index Index of the file.
+     * @return The root of the file; or NULL if the index is out of range.
+     */
+    return index < self->count ? self->files[index].root : NULL;
+}
+//------------------------------------------------------------------------------
+bool nini_loader_is_loaded(const nini_loader_t *self, size_t index)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Check if a file be loaded by the last load.
+     *
+     * @param self  Object instance.
+     * @param index Index of the file.
+     * @return TRUE if the file be loaded; and FALSE if not.
+     */
+    return index < self->count && self->files[index].loaded;
+}
+//------------------------------------------------------------------------------
+typedef struct buffer_t
+{
+    uint8_t *data;
+    size_t   capacity;
+} buffer_t;
+
+//------------------------------------------------------------------------------
+static
+bool read_file(const char *filename, buffer_t *buffer, size_t *size)
+{
+    FILE *file = fopen(filename, "rb");
+    if( !file ) return false;
+
+    bool res = false;
+    do
+    {
+        long len;
+        if( fseek(file, 0, SEEK_END) ) break;
+        if( 0 > ( len = ftell(file) ) ) break;
+        rewind(file);
+
+        if( (size_t) len > buffer->capacity )
+        {
+            size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+            while( capacity < (size_t) len )
+                capacity *= 2;
+
+            uint8_t *data = realloc(buffer->data, capacity);
+            if( !data ) break;
+
+            buffer->data     = data;
+            buffer->capacity = capacity;
+        }
+
+        if( len && (size_t) len != fread(buffer->data, 1, len, file) ) break;
+
+        *size = len;
+        res = true;
+    } while(false);
+
+    fclose(file);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+static
+bool load_file(nini_loader_file_t *file, buffer_t *buffer, nini_errmsg_t *errmsg)
+{
+    // The same as nini_root_load_file, but the read buffer is reused.
+    if( nini_root_is_frozen(file->root) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
+    nini_root_clear(file->root);
+
+    size_t size;
+    if( !read_file(file->filename, buffer, &size) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Cannot read the file!");
+        return false;
+    }
+
+    return nini_root_decode(file->root, buffer->data, size, errmsg);
+}
+//------------------------------------------------------------------------------
+static
+size_t serial_load(nini_loader_t *self, nini_on_load_t on_load, void *arg)
+{
+    buffer_t buffer = { NULL, 0 };
+    size_t   loaded = 0;
+
+    for(size_t i = 0; i < self->count; ++i)
+    {
+        nini_loader_file_t *file = &self->files[i];
+
+        nini_errmsg_t errmsg;
+        file->loaded = load_file(file, &buffer, &errmsg);
+        if( file->loaded ) ++ loaded;
+
+        if( on_load ) on_load(arg, i, file->loaded ? file->root : NULL, &errmsg);
+    }
+
+    if( buffer.data ) free(buffer.data);
+
+    return loaded;
+}
+//------------------------------------------------------------------------------
+#ifdef NINI_USE_PTHREAD
+
+typedef struct range_t
+{
+    size_t next;
+    size_t end;
+} range_t;
+
+typedef struct job_t
+{
+    nini_loader_t  *loader;
+    nini_on_load_t  on_load;
+    void           *arg;
+
+    range_t  *ranges;   // Files those are not taken yet of each worker.
+    unsigned  count;
+    size_t    loaded;
+
+    pthread_mutex_t lock;       // Ranges of workers.
+    pthread_mutex_t report;     // Calls of the handler, and count of loaded files.
+
+} job_t;
+
+typedef struct worker_t
+{
+    job_t     *job;
+    unsigned   index;
+    pthread_t  thread;
+} worker_t;
+
+//------------------------------------------------------------------------------
+static
+bool take_file(job_t *job, unsigned index, size_t *file)
+{
+    pthread_mutex_lock(&job->lock);
+
+    range_t *range = &job->ranges[index];
+    if( range->next >= range->end )
+    {
+        // Steal the second half of the largest remaining range.
+        range_t *victim = NULL;
+        for(unsigned i = 0; i < job->count; ++i)
+        {
+            range_t *other = &job->ranges[i];
+            if( other->next < other->end &&
+                ( !victim || other->end - other->next > victim->end - victim->next ) )
+            {
+                victim = other;
+            }
+        }
+
+        if( victim )
+        {
+            size_t keep = ( victim->end - victim->next ) / 2;
+            range->next = victim->next + keep;
+            range->end  = victim->end;
+            victim->end = range->next;
+        }
+    }
+
+    bool res = range->next < range->end;
+    if( res ) *file = range->next ++;
+
+    pthread_mutex_unlock(&job->lock);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+static
+void* worker_main(void *arg)
+{
+    worker_t *worker = arg;
+    job_t    *job    = worker->job;
+
+    buffer_t buffer = { NULL, 0 };
+
+    size_t index;
+    while( take_file(job, worker->index, &index) )
+    {
+        nini_loader_file_t *file = &job->loader->files[index];
+
+        nini_errmsg_t errmsg;
+        file->loaded = load_file(file, &buffer, &errmsg);
+
+        pthread_mutex_lock(&job->report);
+        if( file->loaded ) ++ job->loaded;
+        if( job->on_load ) job->on_load(job->arg, index, file->loaded ? file->root : NULL, &errmsg);
+        pthread_mutex_unlock(&job->report);
+    }
+
+    if( buffer.data ) free(buffer.data);
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
+static
+unsigned get_thread_count(unsigned threads)
+{
+    if( threads ) return threads;
+
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+}
+//------------------------------------------------------------------------------
+size_t nini_loader_load(nini_loader_t *self, unsigned threads, nini_on_load_t on_load, void *arg)
+{
+    /**
+     * @memberof nini_loader_t
+     * @brief Load all files to their roots.
+     *
+     * @param self    Object instance.
+     * @param threads Count of worker threads, or ZERO to use the count of processors.
+     * @param on_load A function that will be called after each file be loaded,
+     *                and this parameter can be NULL if no need.
+     * @param arg     The user defined argument that will be passed to @a on_load.
+     * @return Count of files those be loaded successfully.
+     *
+     * @remarks Each file is loaded in the same way as nini_root_load_file.
+     * @remarks The handler will be called by worker threads in the order of completion,
+     *          but not at the same time.
+     */
+    threads = get_thread_count(threads);
+    if( threads > self->count ) threads = self->count;
+    if( threads < 2 ) return serial_load(self, on_load, arg);
+
+    job_t job;
+    memset(&job, 0, sizeof(job));
+    job.loader  = self;
+    job.on_load = on_load;
+    job.arg     = arg;
+
+    job.ranges  = malloc(threads * sizeof(job.ranges[0]));
+    worker_t *workers = malloc(threads * sizeof(workers[0]));
+    if( !job.ranges || !workers )
+    {
+        if( job.ranges ) free(job.ranges);
+        if( workers ) free(workers);
+        return serial_load(self, on_load, arg);
+    }
+
+    // Divide files to a range for each worker.
+    job.count = threads;
+    for(unsigned i = 0; i < threads; ++i)
+    {
+        job.ranges[i].next = self->count * i / threads;
+        job.ranges[i].end  = self->count * ( i + 1 ) / threads;
+
+        workers[i].job   = &job;
+        workers[i].index = i;
+    }
+
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_mutex_init(&job.report, NULL);
+
+    unsigned started = 0;
+    for(; started < threads; ++started)
+    {
+        if( pthread_create(&workers[started].thread, NULL, worker_main, &workers[started]) ) break;
+    }
+
+    // Load all files on this thread if no worker can be started, and ranges of the others will be stolen.
+    if( !started ) worker_main(&workers[0]);
+
+    for(unsigned i = 0; i < started; ++i)
+        pthread_join(workers[i].thread, NULL);
+
+    pthread_mutex_destroy(&job.report);
+    pthread_mutex_destroy(&job.lock);
+    free(workers);
+    free(job.ranges);
+
+    return job.loaded;
+}
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+size_t nini_loader_load(nini_loader_t *self, unsigned threads, nini_on_load_t on_load, void *arg)
+{
+    // Threads are not supported, and files will be loaded serially.
+    return serial_load(self, on_load, arg);
+}
+//------------------------------------------------------------------------------
+#endif
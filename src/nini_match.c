@@ -0,0 +1,147 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_match.h"
+
+typedef struct child_t
+{
+    const nini_node_t *node;
+    size_t             pos;     // Position in the sibling list.
+} child_t;
+
+//------------------------------------------------------------------------------
+static
+int compare_children(const void *a, const void *b)
+{
+    // Children with the same name are kept in their order.
+    const child_t *child = a, *other = b;
+
+    int res = strcmp(child->node->name, other->node->name);
+    if( res ) return res;
+
+    return child->pos < other->pos ? -1 : child->pos > other->pos;
+}
+//------------------------------------------------------------------------------
+static
+size_t count_children(const nini_node_t *parent)
+{
+    size_t count = 0;
+    for(const nini_node_t *node = nini_node_get_first_child_c(parent);
+        node;
+        node = nini_node_get_next_sibling_c(node))
+    {
+        ++ count;
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+static
+child_t* sort_children(const nini_node_t **nodes, size_t count)
+{
+    // Return children sorted by names, or NULL if memory allocation failed.
+    child_t *children = malloc(count * sizeof(children[0]));
+    if( !children ) return NULL;
+
+    for(size_t pos = 0; pos < count; ++pos)
+    {
+        children[pos].node = nodes[pos];
+        children[pos].pos  = pos;
+    }
+
+    qsort(children, count, sizeof(children[0]), compare_children);
+
+    return children;
+}
+//------------------------------------------------------------------------------
+static
+const nini_node_t** list_children(const nini_node_t *parent, size_t count)
+{
+    const nini_node_t **nodes = malloc(count * sizeof(nodes[0]));
+    if( !nodes ) return NULL;
+
+    size_t pos = 0;
+    for(const nini_node_t *node = nini_node_get_first_child_c(parent);
+        node;
+        node = nini_node_get_next_sibling_c(node))
+    {
+        nodes[ pos ++ ] = node;
+    }
+
+    return nodes;
+}
+//------------------------------------------------------------------------------
+bool nini_match_init(nini_match_t *self, const nini_node_t *old_parent, const nini_node_t *new_parent)
+{
+    // Return FALSE if memory allocation failed, and the object will be empty.
+    memset(self, 0, sizeof(*self));
+    self->old_count = count_children(old_parent);
+    self->new_count = count_children(new_parent);
+
+    child_t *olds = NULL;
+    child_t *news = NULL;
+
+    bool succ = false;
+    do
+    {
+        if( self->old_count )
+        {
+            if( !( self->olds        = list_children(old_parent, self->old_count) ) ) break;
+            if( !( self->old_matches = malloc(self->old_count * sizeof(self->old_matches[0])) ) ) break;
+            if( !( olds              = sort_children(self->olds, self->old_count) ) ) break;
+        }
+
+        if( self->new_count )
+        {
+            if( !( self->news        = list_children(new_parent, self->new_count) ) ) break;
+            if( !( self->new_matches = malloc(self->new_count * sizeof(self->new_matches[0])) ) ) break;
+            if( !( news              = sort_children(self->news, self->new_count) ) ) break;
+        }
+
+        for(size_t i = 0; i < self->old_count; ++i)
+            self->old_matches[i] = NINI_MATCH_NONE;
+        for(size_t j = 0; j < self->new_count; ++j)
+            self->new_matches[j] = NINI_MATCH_NONE;
+
+        // Match children with the same name in their order.
+        for(size_t i = 0, j = 0; i < self->old_count && j < self->new_count; )
+        {
+            int res = strcmp(olds[i].node->name, news[j].node->name);
+            if( res < 0 )
+            {
+                ++ i;
+            }
+            else if( res > 0 )
+            {
+                ++ j;
+            }
+            else
+            {
+                self->old_matches[ olds[i].pos ] = news[j].pos;
+                self->new_matches[ news[j].pos ] = olds[i].pos;
+                ++ i;
+                ++ j;
+            }
+        }
+
+        succ = true;
+    } while(false);
+
+    if( olds ) free(olds);
+    if( news ) free(news);
+
+    if( !succ )
+        nini_match_deinit(self);
+
+    return succ;
+}
+//------------------------------------------------------------------------------
+void nini_match_deinit(nini_match_t *self)
+{
+    if( self->olds        ) free(self->olds);
+    if( self->news        ) free(self->news);
+    if( self->old_matches ) free(self->old_matches);
+    if( self->new_matches ) free(self->new_matches);
+
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,39 @@
+#ifndef _NINI_MATCH_H_
+#define _NINI_MATCH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "nini_node.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Matching of children of two sections, used to compare two trees.
+ * Children are matched by names,
+ * and children with the same name are matched in their sibling order.
+ */
+
+#define NINI_MATCH_NONE ((size_t) -1)
+
+typedef struct nini_match_t
+{
+    const nini_node_t **olds;       // Old children in the sibling order.
+    const nini_node_t **news;       // New children in the sibling order.
+    size_t              old_count;
+    size_t              new_count;
+
+    size_t *old_matches;    // Position of the matched new child of each old child, or NINI_MATCH_NONE.
+    size_t *new_matches;    // Position of the matched old child of each new child, or NINI_MATCH_NONE.
+
+} nini_match_t;
+
+bool nini_match_init  (nini_match_t *self, const nini_node_t *old_parent, const nini_node_t *new_parent);
+void nini_match_deinit(nini_match_t *self);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
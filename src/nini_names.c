@@ -0,0 +1,33 @@
+#include <string.h>
+#include "nini_hash.h"
+#include "nini_names.h"
+
+typedef struct name_key_t
+{
+    const nini_node_t *parent;
+    const char        *name;
+} name_key_t;
+
+//------------------------------------------------------------------------------
+uint64_t nini_names_hash(const nini_node_t *parent, const char *name)
+{
+    return nini_hash_mix(nini_hash_string(name) + (uintptr_t) parent);
+}
+//------------------------------------------------------------------------------
+static
+bool match_name(const nini_node_t *node, const name_key_t *key)
+{
+    return node->parent == key->parent && 0 == strcmp(node->name, key->name);
+}
+//------------------------------------------------------------------------------
+nini_table_slot_t* nini_names_find(nini_names_t *self, const nini_node_t *parent, const char *name, uint64_t hash)
+{
+    name_key_t key = { parent, name };
+    return nini_table_find(self, hash, (nini_table_match_t) match_name, &key);
+}
+//------------------------------------------------------------------------------
+bool nini_names_insert(nini_names_t *self, nini_node_t *node, uint64_t hash)
+{
+    return nini_table_insert(self, node, hash);
+}
+//------------------------------------------------------------------------------
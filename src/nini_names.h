@@ -0,0 +1,42 @@
+#ifndef _NINI_NAMES_H_
+#define _NINI_NAMES_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "nini_node.h"
+#include "nini_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A hash table of children by their parents and names, used to detect duplicate names while decoding.
+ * Items of the table are the children, and they are matched by their current parents,
+ * so that a child replaced in the tree must be replaced in its slot too.
+ */
+
+typedef nini_table_t nini_names_t;
+
+static inline
+void nini_names_init(nini_names_t *self)
+{
+    nini_table_init(self);
+}
+
+static inline
+void nini_names_deinit(nini_names_t *self)
+{
+    nini_table_deinit(self);
+}
+
+uint64_t           nini_names_hash  (const nini_node_t *parent, const char *name);
+nini_table_slot_t* nini_names_find  (nini_names_t *self, const nini_node_t *parent, const char *name, uint64_t hash);
+bool               nini_names_insert(nini_names_t *self, nini_node_t *node, uint64_t hash);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -1,8 +1,23 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include "nini_hash.h"
+#include "nini_shared.h"
+#include "nini_source.h"
 #include "nini_node.h"
 
+/*
+ * The ordered children index.
+ * Children are sorted by name in byte order,
+ * and children with the same name are placed in their sibling order.
+ */
+typedef struct nini_node_index_t
+{
+    nini_node_t **items;
+    size_t        count;
+    size_t        capacity;
+} nini_node_index_t;
+
 //------------------------------------------------------------------------------
 static inline
 char* clone_string(const char *src)
@@ -22,6 +37,168 @@ char* clone_string(const char *src)
 }
 //------------------------------------------------------------------------------
 static
+size_t index_lower_bound(const nini_node_index_t *index, const char *name)
+{
+    // Find the first item that its name is not less than the specified name.
+    size_t first = 0, count = index->count;
+    while( count )
+    {
+        size_t step = count / 2;
+        if( strcmp(index->items[ first + step ]->name, name) < 0 )
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+//------------------------------------------------------------------------------
+static
+size_t index_upper_bound(const nini_node_index_t *index, const char *name)
+{
+    // Find the first item that its name is greater than the specified name.
+    size_t first = 0, count = index->count;
+    while( count )
+    {
+        size_t step = count / 2;
+        if( strcmp(index->items[ first + step ]->name, name) <= 0 )
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+//------------------------------------------------------------------------------
+static
+size_t index_prefix_end(const nini_node_index_t *index, size_t first, const char *prefix)
+{
+    // Find the first item after @first that its name is greater than all names with the prefix.
+    size_t len   = strlen(prefix);
+    size_t count = index->count - first;
+    while( count )
+    {
+        size_t step = count / 2;
+        if( strncmp(index->items[ first + step ]->name, prefix, len) <= 0 )
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+//------------------------------------------------------------------------------
+static
+bool index_insert(nini_node_index_t *index, nini_node_t *node)
+{
+    if( index->count >= index->capacity )
+    {
+        size_t capacity = index->capacity ? 2 * index->capacity : 8;
+        nini_node_t **items = realloc(index->items, capacity * sizeof(items[0]));
+        if( !items ) return false;
+
+        index->items    = items;
+        index->capacity = capacity;
+    }
+
+    // New node will be placed after the nodes with the same name to keep the sibling order.
+    size_t pos = index_upper_bound(index, node->name);
+    memmove(&index->items[pos+1], &index->items[pos], ( index->count - pos )*sizeof(index->items[0]));
+    index->items[pos] = node;
+    ++ index->count;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void index_remove(nini_node_index_t *index, nini_node_t *node)
+{
+    for(size_t pos = index_lower_bound(index, node->name);
+        pos < index->count && 0 == strcmp(index->items[pos]->name, node->name);
+        ++pos)
+    {
+        if( index->items[pos] != node ) continue;
+
+        memmove(&index->items[pos], &index->items[pos+1], ( index->count - pos - 1 )*sizeof(index->items[0]));
+        -- index->count;
+        return;
+    }
+}
+//------------------------------------------------------------------------------
+static
+void index_replace(nini_node_index_t *index, nini_node_t *node, nini_node_t *new_node)
+{
+    if( 0 != strcmp(node->name, new_node->name) )
+    {
+        // The insertion never fails, because the removed item leaves a free slot.
+        index_remove(index, node);
+        index_insert(index, new_node);
+        return;
+    }
+
+    for(size_t pos = index_lower_bound(index, node->name);
+        pos < index->count && 0 == strcmp(index->items[pos]->name, node->name);
+        ++pos)
+    {
+        if( index->items[pos] != node ) continue;
+
+        index->items[pos] = new_node;
+        return;
+    }
+}
+//------------------------------------------------------------------------------
+static
+void index_sort(nini_node_t **items, nini_node_t **temp, size_t count)
+{
+    // Stable merge sort, so that nodes with the same name can keep the sibling order.
+    if( count < 2 ) return;
+
+    size_t half = count / 2;
+    index_sort(items, temp, half);
+    index_sort(items + half, temp, count - half);
+
+    size_t i = 0, j = half, k = 0;
+    while( i < half && j < count )
+        temp[k++] = strcmp(items[j]->name, items[i]->name) < 0 ? items[j++] : items[i++];
+    while( i < half )
+        temp[k++] = items[i++];
+    while( j < count )
+        temp[k++] = items[j++];
+
+    memcpy(items, temp, count*sizeof(items[0]));
+}
+//------------------------------------------------------------------------------
+static
+void index_release(nini_node_index_t *index)
+{
+    if( index->items ) free(index->items);
+    free(index);
+}
+//------------------------------------------------------------------------------
+static
+void invalidate_hash(nini_node_t *node)
+{
+    // Ancestors of a node without hash never have hashes, so that the walk can stop at the first one.
+    for(; node && node->hashed; node = node->parent)
+        node->hashed = false;
+}
+//------------------------------------------------------------------------------
+static
 nini_node_t* nini_node_create(nini_type_t type, const char *name)
 {
     nini_node_t *node = NULL;
@@ -191,6 +368,70 @@ nini_node_t* nini_node_create_null(const char *name)
     return nini_node_create(NINI_NULL, name);
 }
 //------------------------------------------------------------------------------
+nini_node_t* nini_node_clone(const nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Create a copy of a node and all of its children.
+     *
+     * @param self Object instance.
+     * @return Instance of the new node if succeed; or
+     *         NULL if failed!
+     *
+     * @remarks The new node is not linked to any one,
+     *          and the root type of node cannot be cloned.
+     * @remarks A copy of a shared section shares the same children, see nini_node_is_shared.
+     */
+    switch( self->type )
+    {
+    case NINI_ROOT:
+        return NULL;
+
+    case NINI_SECTION:
+        break;
+
+    case NINI_STRING:
+        return nini_node_create_string(self->name, self->value.string);
+
+    case NINI_DECIMAL:
+        return nini_node_create_decimal(self->name, self->value.integer);
+
+    case NINI_HEXA:
+        return nini_node_create_hexa(self->name, self->value.integer);
+
+    case NINI_FLOAT:
+        return nini_node_create_float(self->name, self->value.floating);
+
+    case NINI_BOOL:
+        return nini_node_create_bool(self->name, self->value.boolean);
+
+    case NINI_NULL:
+        return nini_node_create_null(self->name);
+    }
+
+    nini_node_t *node = nini_node_create_section(self->name);
+    if( !node ) return NULL;
+
+    if( self->shared )
+    {
+        nini_shared_attach(self->shared, node);
+        return node;
+    }
+
+    for(const nini_node_t *child = self->childs.first; child; child = child->next)
+    {
+        nini_node_t *copy = nini_node_clone(child);
+        if( !copy || !nini_node_link_child(node, copy) )
+        {
+            nini_node_release(copy);
+            nini_node_release(node);
+            return NULL;
+        }
+    }
+
+    return node;
+}
+//------------------------------------------------------------------------------
 void nini_node_release(nini_node_t *self)
 {
     /**
@@ -204,6 +445,9 @@ void nini_node_release(nini_node_t *self)
     if( self->type == NINI_STRING && self->value.string )
         free(self->value.string);
 
+    if( self->shared )
+        nini_shared_detach(self);
+
     if( self->type == NINI_ROOT || self->type == NINI_SECTION )
     {
         nini_node_t *node = self->childs.first;
@@ -214,6 +458,9 @@ void nini_node_release(nini_node_t *self)
 
             nini_node_release(node_remove);
         }
+
+        if( self->childs.index )
+            index_release(self->childs.index);
     }
 
     if( self->name )
@@ -276,6 +523,74 @@ bool nini_node_have_child(const nini_node_t *self)
     return false;
 }
 //------------------------------------------------------------------------------
+uint64_t nini_node_get_hash(const nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Get the content hash of node.
+     * @details The hash covers name, type, and value of the node,
+     *          and hashes of all children in their order.
+     *          Nodes with the same content have the same hash,
+     *          so that two trees can be compared by their hashes,
+     *          and sections with the same hash can be skipped by a comparison.
+     *
+     * @param self Object instance.
+     * @return The content hash.
+     *
+     * @remarks Hashes are cached in nodes, and modifications only drop the caches
+     *          of the modified node and its ancestors.
+     *          Hashes of a frozen root are computed by the freeze,
+     *          so that they can be read from multiple threads.
+     */
+    if( self->hashed ) return self->hash;
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    if( self->name )
+        hash = nini_hash_bytes(hash, self->name, strlen(self->name) + 1);
+
+    uint8_t type = self->type;
+    hash = nini_hash_bytes(hash, &type, sizeof(type));
+
+    switch( self->type )
+    {
+    case NINI_ROOT:
+    case NINI_SECTION:
+        for(const nini_node_t *child = self->childs.first; child; child = child->next)
+        {
+            uint64_t child_hash = nini_node_get_hash(child);
+            hash = nini_hash_bytes(hash, &child_hash, sizeof(child_hash));
+        }
+        break;
+
+    case NINI_STRING:
+        hash = nini_hash_bytes(hash, self->value.string, strlen(self->value.string));
+        break;
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+        hash = nini_hash_bytes(hash, &self->value.integer, sizeof(self->value.integer));
+        break;
+
+    case NINI_FLOAT:
+        hash = nini_hash_bytes(hash, &self->value.floating, sizeof(self->value.floating));
+        break;
+
+    case NINI_BOOL:
+        hash = nini_hash_bytes(hash, &self->value.boolean, sizeof(self->value.boolean));
+        break;
+
+    case NINI_NULL:
+        break;
+    }
+
+    // The cache is not a part of the content.
+    nini_node_t *node = (nini_node_t*) self;
+    node->hash   = nini_hash_mix(hash);
+    node->hashed = true;
+
+    return node->hash;
+}
+//------------------------------------------------------------------------------
 nini_node_t* nini_node_find_child(nini_node_t *self, const char *name)
 {
     /**
@@ -289,6 +604,15 @@ nini_node_t* nini_node_find_child(nini_node_t *self, const char *name)
      */
     if( !nini_node_have_child(self) || !name ) return NULL;
 
+    if( self->childs.index )
+    {
+        const nini_node_index_t *index = self->childs.index;
+
+        size_t pos = index_lower_bound(index, name);
+        return pos < index->count && 0 == strcmp(index->items[pos]->name, name) ?
+               index->items[pos] : NULL;
+    }
+
     for(nini_node_t *node = self->childs.first;
         node;
         node = node->next)
@@ -328,6 +652,7 @@ bool nini_node_link_child(nini_node_t *self, nini_node_t *node)
      *         * The node is a virtual node.
      *         * Self node is not a section type or root type of node,
      *           and cannot have a child.
+     *         * Self node is frozen.
      *
      * @remarks The child node will be managed by its parent,
      *          and it will be released when its parent be destructed.
@@ -338,6 +663,9 @@ bool nini_node_link_child(nini_node_t *self, nini_node_t *node)
     if( !node ) return false;
     if( node->type == NINI_ROOT ) return false;  // Node is a virtual node.
     if( node->parent ) return false;  // Node is already linked.
+    if( self->frozen ) return false;  // Children of a frozen node cannot be changed.
+
+    if( self->childs.index && !index_insert(self->childs.index, node) ) return false;
 
     node->parent = self;
 
@@ -348,18 +676,24 @@ bool nini_node_link_child(nini_node_t *self, nini_node_t *node)
     if( !self->childs.first )
         self->childs.first = node;
 
+    invalidate_hash(self);
+    nini_source_invalidate(self);
+
     return true;
 }
 //------------------------------------------------------------------------------
-void nini_node_unlink(nini_node_t *self)
+bool nini_node_unlink(nini_node_t *self)
 {
     /**
      * @memberof nini_node_t
      * @brief Unlink node from it parent and siblings.
      *
      * @param self Object instance.
+     * @return TRUE if succeed or the node is not linked to any one;
+     *         and FALSE if the parent is frozen.
      */
-    if( !self->parent ) return;  // Not linked to any one.
+    if( !self->parent ) return true;  // Not linked to any one.
+    if( self->parent->frozen ) return false;
 
     nini_node_t *parent = self->parent;
     nini_node_t *prev   = self->prev;
@@ -375,6 +709,404 @@ void nini_node_unlink(nini_node_t *self)
     else
         parent->childs.last = prev;
 
+    if( parent->childs.index )
+        index_remove(parent->childs.index, self);
+
+    self->parent = NULL;
+    self->prev   = NULL;
+    self->next   = NULL;
+
+    invalidate_hash(parent);
+    nini_source_invalidate(parent);
+    nini_source_detach(self);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_replace(nini_node_t *self, nini_node_t *node)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Replace this node by another node at the same position.
+     *
+     * @param self Object instance.
+     * @param node The node to replace this node,
+     *             and it will be linked to the parent of this node if succeed.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * This node is not linked to any one.
+     *         * The new node is already linked to an other one.
+     *         * The new node is a virtual node.
+     *         * The parent is frozen.
+     *
+     * @remarks This node will be unlinked if succeed,
+     *          and it should be released by the caller if it is no longer needed.
+     * @remarks Comments in front of this node will be kept for the new node
+     *          if the root is in the lossless mode, see nini_root_enable_lossless.
+     */
+    nini_node_t *parent = self->parent;
+    if( !parent ) return false;  // Not linked to any one.
+
+    if( !node ) return false;
+    if( node->type == NINI_ROOT ) return false;  // Node is a virtual node.
+    if( node->parent ) return false;  // Node is already linked.
+    if( parent->frozen ) return false;  // Children of a frozen node cannot be changed.
+
+    if( parent->childs.index )
+        index_replace(parent->childs.index, self, node);
+
+    node->parent = parent;
+    node->prev   = self->prev;
+    node->next   = self->next;
+
+    if( node->prev )
+        node->prev->next = node;
+    else
+        parent->childs.first = node;
+
+    if( node->next )
+        node->next->prev = node;
+    else
+        parent->childs.last = node;
+
     self->parent = NULL;
+    self->prev   = NULL;
+    self->next   = NULL;
+
+    invalidate_hash(parent);
+
+    // The new node takes the source line of this node.
+    struct nini_span_t *span = self->span;
+    nini_source_detach(self);
+    if( span )
+    {
+        node->span = span;
+        span->modified = true;
+        nini_source_invalidate(node);
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_copy_value(nini_node_t *self, const nini_node_t *src)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Copy type and value of another key to this key.
+     *
+     * @param self Object instance.
+     * @param src  The key to be copied from.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * Either of the nodes is not a key type of node.
+     *         * The parent is frozen.
+     *         * Memory allocation failed.
+     *
+     * @remarks This node keeps its name and its position,
+     *          so that the node pointer held by others remains valid.
+     */
+    if( self->type == NINI_ROOT || self->type == NINI_SECTION ) return false;
+    if( src->type == NINI_ROOT || src->type == NINI_SECTION ) return false;
+    if( self->parent && self->parent->frozen ) return false;
+
+    if( src->type == NINI_STRING )
+    {
+        char *string = clone_string(src->value.string);
+        if( !string ) return false;
+
+        if( self->type == NINI_STRING ) free(self->value.string);
+        self->value.string = string;
+    }
+    else
+    {
+        if( self->type == NINI_STRING ) free(self->value.string);
+        self->value = src->value;
+    }
+
+    self->type = src->type;
+
+    invalidate_hash(self);
+
+    if( self->span )
+    {
+        self->span->modified = true;
+        nini_source_invalidate(self);
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_move_after(nini_node_t *self, nini_node_t *prev)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Move this node to be after one of its siblings.
+     *
+     * @param self Object instance.
+     * @param prev The sibling that this node will be after,
+     *             or NULL to move this node to be the first child.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * This node is not linked to any one.
+     *         * The specified node is not a sibling of this node.
+     *         * The parent is frozen.
+     */
+    nini_node_t *parent = self->parent;
+    if( !parent ) return false;  // Not linked to any one.
+    if( prev && prev->parent != parent ) return false;
+    if( parent->frozen ) return false;
+
+    if( prev == self || self->prev == prev ) return true;
+
+    // Take this node out of the list.
+    if( self->prev )
+        self->prev->next = self->next;
+    else
+        parent->childs.first = self->next;
+
+    if( self->next )
+        self->next->prev = self->prev;
+    else
+        parent->childs.last = self->prev;
+
+    // Put it after the specified node.
+    self->prev = prev;
+    self->next = prev ? prev->next : parent->childs.first;
+
+    if( self->prev )
+        self->prev->next = self;
+    else
+        parent->childs.first = self;
+
+    if( self->next )
+        self->next->prev = self;
+    else
+        parent->childs.last = self;
+
+    invalidate_hash(parent);
+    nini_source_invalidate(parent);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_unshare(nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Copy the children of a shared section, so that the section can be changed.
+     *
+     * @param self Object instance.
+     * @return TRUE if succeed or the node is not shared; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * The parent is frozen.
+     *         * Memory allocation failed.
+     *
+     * @remarks Only the children are copied,
+     *          and sections in the children are still shared.
+     * @remarks Nothing will be changed if failed.
+     */
+    if( !self->shared ) return true;
+    if( self->parent && self->parent->frozen ) return false;
+
+    // Copies are made in a temporary section before the shared children be detached.
+    nini_node_t *temp = nini_node_create_section("");
+    if( !temp ) return false;
+
+    for(const nini_node_t *child = self->childs.first; child; child = child->next)
+    {
+        nini_node_t *copy = nini_node_clone(child);
+        if( !copy || !nini_node_link_child(temp, copy) )
+        {
+            nini_node_release(copy);
+            nini_node_release(temp);
+            return false;
+        }
+    }
+
+    bool have_index = self->childs.index;
+    nini_shared_detach(self);
+
+    self->childs.first = temp->childs.first;
+    self->childs.last  = temp->childs.last;
+    for(nini_node_t *child = self->childs.first; child; child = child->next)
+        child->parent = self;
+
+    temp->childs.first = NULL;
+    temp->childs.last  = NULL;
+    nini_node_release(temp);
+
+    if( have_index ) nini_node_enable_index(self);
+
+    invalidate_hash(self);
+    nini_source_invalidate(self);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_enable_index(nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Enable the ordered children index.
+     * @details The index keeps children sorted by their names in byte order,
+     *          so that children can be found by a binary search,
+     *          and can be iterated in the name order by
+     *          nini_node_lower_bound, nini_node_scan_prefix, and nini_node_scan_range.
+     *
+     * @param self Object instance.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * Self node is not a section type or root type of node.
+     *         * Self node is a shared section, see nini_node_is_shared.
+     *         * Memory allocation failed.
+     *
+     * @remarks The index will be updated when children be linked or unlinked,
+     *          and it will not change the sibling order of children.
+     */
+    if( self->type != NINI_ROOT && self->type != NINI_SECTION ) return false;
+    if( self->childs.index ) return true;
+    if( self->shared ) return false;
+
+    nini_node_index_t *index = NULL;
+    nini_node_t      **temp  = NULL;
+
+    bool succ = false;
+    do
+    {
+        index = calloc(1, sizeof(nini_node_index_t));
+        if( !index ) break;
+
+        for(nini_node_t *node = self->childs.first; node; node = node->next)
+            ++ index->capacity;
+        if( index->capacity < 8 )
+            index->capacity = 8;
+
+        index->items = malloc(index->capacity * sizeof(index->items[0]));
+        if( !index->items ) break;
+        temp = malloc(index->capacity * sizeof(temp[0]));
+        if( !temp ) break;
+
+        for(nini_node_t *node = self->childs.first; node; node = node->next)
+            index->items[ index->count ++ ] = node;
+
+        index_sort(index->items, temp, index->count);
+
+        succ = true;
+    } while(false);
+
+    if( temp ) free(temp);
+
+    if( !succ )
+    {
+        if( index ) index_release(index);
+        return false;
+    }
+
+    self->childs.index = index;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_node_disable_index(nini_node_t *self)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Disable and release the ordered children index.
+     *
+     * @param self Object instance.
+     */
+    if( self->type != NINI_ROOT && self->type != NINI_SECTION ) return;
+    if( !self->childs.index ) return;
+    if( self->shared ) return;
+
+    index_release(self->childs.index);
+    self->childs.index = NULL;
+}
+//------------------------------------------------------------------------------
+bool nini_node_lower_bound(nini_node_t *self, const char *name, nini_node_iter_t *iter)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Iterate children in the name order,
+     *        start from the first child that its name is not less than the specified name.
+     *
+     * @param self Object instance.
+     * @param name The name to start from.
+     * @param iter The iterator to be initialised.
+     * @return TRUE if succeed; and FALSE if the index is not enabled.
+     *
+     * @remarks The iterator will be invalid after children be linked or unlinked.
+     */
+    if( !nini_node_have_index(self) || !name ) return false;
+
+    iter->index = self->childs.index;
+    iter->pos   = index_lower_bound(iter->index, name);
+    iter->end   = iter->index->count;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_scan_prefix(nini_node_t *self, const char *prefix, nini_node_iter_t *iter)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Iterate children those their names start with the specified prefix in the name order.
+     *
+     * @param self   Object instance.
+     * @param prefix The name prefix.
+     * @param iter   The iterator to be initialised.
+     * @return TRUE if succeed; and FALSE if the index is not enabled.
+     *
+     * @remarks The iterator will be invalid after children be linked or unlinked.
+     */
+    if( !nini_node_have_index(self) || !prefix ) return false;
+
+    iter->index = self->childs.index;
+    iter->pos   = index_lower_bound(iter->index, prefix);
+    iter->end   = index_prefix_end(iter->index, iter->pos, prefix);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_node_scan_range(nini_node_t *self, const char *first, const char *last, nini_node_iter_t *iter)
+{
+    /**
+     * @memberof nini_node_t
+     * @brief Iterate children those their names are in a range in the name order.
+     *
+     * @param self  Object instance.
+     * @param first The lower bound (inclusive) of names,
+     *              and can be NULL to start from the first child.
+     * @param last  The upper bound (exclusive) of names,
+     *              and can be NULL to iterate to the last child.
+     * @param iter  The iterator to be initialised.
+     * @return TRUE if succeed; and FALSE if the index is not enabled.
+     *
+     * @remarks The iterator will be invalid after children be linked or unlinked.
+     */
+    if( !nini_node_have_index(self) ) return false;
+
+    iter->index = self->childs.index;
+    iter->pos   = first ? index_lower_bound(iter->index, first) : 0;
+    iter->end   = last  ? index_lower_bound(iter->index, last) : iter->index->count;
+    if( iter->end < iter->pos )
+        iter->end = iter->pos;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+nini_node_t* nini_node_iter_next(nini_node_iter_t *iter)
+{
+    /**
+     * @memberof nini_node_iter_t
+     * @brief Get the next child.
+     *
+     * @param iter Object instance.
+     * @return The next child in the name order; or
+     *         NULL if there are no more children.
+     */
+    if( !iter->index || iter->pos >= iter->end ) return NULL;
+
+    return iter->index->items[ iter->pos ++ ];
 }
 //------------------------------------------------------------------------------
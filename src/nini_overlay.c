@@ -0,0 +1,332 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_hash.h"
+#include "nini_helper.h"
+#include "nini_table.h"
+#include "nini_overlay.h"
+
+/*
+ * Items of the memo are paths with their results,
+ * and a path without a node is also memoized to skip lookups of missing settings.
+ * The memo is created on the first lookup.
+ */
+typedef struct nini_overlay_memo_t
+{
+    const nini_node_t *node;
+    char               path[];
+} nini_overlay_memo_t;
+
+//------------------------------------------------------------------------------
+void nini_overlay_init(nini_overlay_t *self, char deli)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Constructor.
+     *
+     * @param self Object instance.
+     * @param deli The path delimiter, see @ref key-path for more details.
+     */
+    memset(self, 0, sizeof(*self));
+    self->deli = deli;
+}
+//------------------------------------------------------------------------------
+static
+void clear_memo(nini_overlay_t *self)
+{
+    nini_table_t *memo = self->memo;
+    if( !memo ) return;
+
+    for(size_t i = 0; i < memo->capacity && memo->count; ++i)
+    {
+        if( memo->slots[i].item )
+        {
+            free(memo->slots[i].item);
+            memo->slots[i].item = NULL;
+            -- memo->count;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void nini_overlay_deinit(nini_overlay_t *self)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     */
+    clear_memo(self);
+    if( self->memo )
+    {
+        nini_table_deinit(self->memo);
+        free(self->memo);
+    }
+
+    self->memo  = NULL;
+    self->count = 0;
+}
+//------------------------------------------------------------------------------
+bool nini_overlay_add_layer(nini_overlay_t *self, const nini_root_t *root)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Add a layer after all layers, and it will be overridden by them.
+     *
+     * @param self Object instance.
+     * @param root The root of the layer.
+     * @return TRUE if succeed; and FALSE if the count of layers reached NINI_MAX_OVERLAY_LAYERS.
+     */
+    if( self->count >= NINI_MAX_OVERLAY_LAYERS ) return false;
+
+    self->layers[ self->count ++ ] = root;
+    clear_memo(self);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void check_layers(nini_overlay_t *self)
+{
+    /*
+     * A change of a layer drops the cached hash of its root (see nini_node_get_hash),
+     * and hashes are computed again to detect the next change.
+     */
+    bool changed = false;
+    for(unsigned i = 0; i < self->count; ++i)
+        changed |= !self->layers[i]->super.hashed;
+
+    if( !changed ) return;
+
+    clear_memo(self);
+    for(unsigned i = 0; i < self->count; ++i)
+        nini_root_get_hash(self->layers[i]);
+}
+//------------------------------------------------------------------------------
+static
+bool match_memo(const nini_overlay_memo_t *memo, const char *path)
+{
+    return 0 == strcmp(memo->path, path);
+}
+//------------------------------------------------------------------------------
+static
+const nini_node_t* resolve(const nini_overlay_t *self, const char *path)
+{
+    for(unsigned i = 0; i < self->count; ++i)
+    {
+        const nini_node_t *node = nini_find_node(self->layers[i], path, self->deli);
+        if( node ) return node;
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
+const nini_node_t* nini_overlay_find(nini_overlay_t *self, const char *path)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Find a key or section.
+     *
+     * @param self Object instance.
+     * @param path The path of the node to be found, see @ref key-path for more details.
+     * @return The node of the first layer that has the path; or NULL if not found.
+     *
+     * @remarks The result will not be memoized if memory allocation failed.
+     */
+    check_layers(self);
+
+    if( !self->memo )
+    {
+        if( !( self->memo = malloc(sizeof(*self->memo)) ) ) return resolve(self, path);
+        nini_table_init(self->memo);
+    }
+
+    uint64_t           hash = nini_hash_string(path);
+    nini_table_slot_t *slot = nini_table_find(self->memo, hash, (nini_table_match_t) match_memo, path);
+    if( slot ) return ( (const nini_overlay_memo_t*) slot->item )->node;
+
+    const nini_node_t *node = resolve(self, path);
+
+    size_t               len  = strlen(path);
+    nini_overlay_memo_t *memo = malloc(sizeof(nini_overlay_memo_t) + len + 1);
+    if( !memo ) return node;
+
+    memo->node = node;
+    memcpy(memo->path, path, len + 1);
+
+    if( !nini_table_insert(self->memo, memo, hash) ) free(memo);
+
+    return node;
+}
+//------------------------------------------------------------------------------
+bool nini_overlay_is_existed(nini_overlay_t *self, const char *path)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Check if a key or section existed in any layer.
+     *
+     * @param self Object instance.
+     * @param path The path of the node, see @ref key-path for more details.
+     * @return TRUE if the node does existed; and FALSE if not.
+     */
+    return nini_overlay_find(self, path);
+}
+//------------------------------------------------------------------------------
+nini_type_t nini_overlay_get_type(nini_overlay_t *self, const char *path)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Get the type of a key or section.
+     *
+     * @param self Object instance.
+     * @param path The path of the node, see @ref key-path for more details.
+     * @return The type of the node, and the value is undefined if the node does not existed,
+     *         see nini_get_type for more details.
+     */
+    const nini_node_t *node = nini_overlay_find(self, path);
+
+    return node ? nini_node_get_type(node) : -1;
+}
+//------------------------------------------------------------------------------
+const char* nini_overlay_read_string(nini_overlay_t *self, const char *path, const char *failval)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Read string value from a key.
+     *
+     * @param self    Object instance.
+     * @param path    The path of the key, see @ref key-path for more details.
+     * @param failval The value that will be used if read failed.
+     * @return The value if succeed; or
+     *         @a failval if the key does not existed or the key type does not match.
+     *
+     * @remarks The type of the key is not checked with other layers,
+     *          and layers after the resolved one will not be read even if the type does not match.
+     */
+    const nini_node_t *node = nini_overlay_find(self, path);
+    if( !node ) return failval;
+
+    return nini_node_get_type(node) == NINI_STRING ? nini_node_get_string(node) : failval;
+}
+//------------------------------------------------------------------------------
+long nini_overlay_read_integer(nini_overlay_t *self, const char *path, long failval)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Read integer value from a key.
+     *
+     * @param self    Object instance.
+     * @param path    The path of the key, see @ref key-path for more details.
+     * @param failval The value that will be used if read failed.
+     * @return The value if succeed; or
+     *         @a failval if the key does not existed or the key type does not match.
+     */
+    const nini_node_t *node = nini_overlay_find(self, path);
+    if( !node ) return failval;
+
+    return nini_node_get_type(node) == NINI_DECIMAL || nini_node_get_type(node) == NINI_HEXA ?
+           nini_node_get_integer(node) : failval;
+}
+//------------------------------------------------------------------------------
+double nini_overlay_read_float(nini_overlay_t *self, const char *path, double failval)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Read floating point value from a key.
+     *
+     * @param self    Object instance.
+     * @param path    The path of the key, see @ref key-path for more details.
+     * @param failval The value that will be used if read failed.
+     * @return The value if succeed; or
+     *         @a failval if the key does not existed or the key type does not match.
+     */
+    const nini_node_t *node = nini_overlay_find(self, path);
+    if( !node ) return failval;
+
+    return nini_node_get_type(node) == NINI_FLOAT ? nini_node_get_float(node) : failval;
+}
+//------------------------------------------------------------------------------
+bool nini_overlay_read_bool(nini_overlay_t *self, const char *path, bool failval)
+{
+    /**
+     * @memberof nini_overlay_t
+     * @brief Read boolean value from a key.
+     *
+     * @param self    Object instance.
+     * @param path    The path of the key, see @ref key-path for more details.
+     * @param failval The value that will be used if read failed.
+     * @return The value if succeed; or
+     *         @a failval if the key does not existed or the key type does not match.
+     */
+    const nini_node_t *node = nini_overlay_find(self, path);
+    if( !node ) return failval;
+
+    return nini_node_get_type(node) == NINI_BOOL ? nini_node_get_bool(node) : failval;
+}
+//------------------------------------------------------------------------------
+void nini_overlay_iter_init(nini_overlay_iter_t *self, const nini_overlay_t *overlay, const char *path)
+{
+    /**
+     * @memberof nini_overlay_iter_t
+     * @brief Start to iterate children of a section in all layers.
+     *
+     * @param self    Object instance.
+     * @param overlay The overlay.
+     * @param path    The path of the section, see @ref key-path for more details,
+     *                or an empty string to iterate top-level nodes.
+     *
+     * @remarks Layers those the path is not a section are skipped.
+     */
+    self->count = overlay->count;
+    self->layer = 0;
+    self->next  = NULL;
+
+    for(unsigned i = 0; i < overlay->count; ++i)
+    {
+        const nini_node_t *node = nini_find_node(overlay->layers[i], path, overlay->deli);
+        bool is_section = node && ( node->type == NINI_ROOT || node->type == NINI_SECTION );
+
+        self->sections[i] = is_section ? node : NULL;
+    }
+
+    if( self->count && self->sections[0] )
+        self->next = nini_node_get_first_child_c(self->sections[0]);
+}
+//------------------------------------------------------------------------------
+static
+bool is_overridden(const nini_overlay_iter_t *self, const nini_node_t *node)
+{
+    for(unsigned i = 0; i < self->layer; ++i)
+    {
+        if( self->sections[i] && nini_node_find_child_c(self->sections[i], node->name) )
+            return true;
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+const nini_node_t* nini_overlay_iter_next(nini_overlay_iter_t *self)
+{
+    /**
+     * @memberof nini_overlay_iter_t
+     * @brief Get the next child.
+     *
+     * @param self Object instance.
+     * @return The next child; or NULL if there are no more children.
+     */
+    while( self->layer < self->count )
+    {
+        while( self->next )
+        {
+            const nini_node_t *node = self->next;
+            self->next = nini_node_get_next_sibling_c(node);
+
+            if( !is_overridden(self, node) ) return node;
+        }
+
+        if( ++ self->layer < self->count && self->sections[ self->layer ] )
+            self->next = nini_node_get_first_child_c(self->sections[ self->layer ]);
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
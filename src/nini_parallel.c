@@ -0,0 +1,336 @@
+#include <stdlib.h>
+#include <string.h>
+#include "nini_encoder.h"
+#include "nini_parallel.h"
+
+#ifdef NINI_USE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define GROUPS_PER_THREAD 4
+
+//------------------------------------------------------------------------------
+static
+size_t serial_encode(const nini_format_t *format,
+                     const nini_node_t   *first,
+                     void                *stream,
+                     nini_on_write_t      on_write,
+                     nini_errmsg_t       *errmsg)
+{
+    nini_encoder_t encoder;
+    if( !nini_encoder_init_stream(&encoder, format, stream, on_write, errmsg) ) return 0;
+
+    for(const nini_node_t *node = first; node; node = nini_node_get_next_sibling_c(node))
+    {
+        if( !nini_encoder_write_tree(&encoder, 0, node) ) break;
+    }
+
+    size_t total_size = nini_encoder_finish(&encoder);
+    nini_encoder_deinit(&encoder);
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
+#ifdef NINI_USE_PTHREAD
+
+typedef struct group_t
+{
+    const nini_node_t *first;   // The first top-level node of the group.
+    size_t             count;   // Count of top-level nodes of the group.
+    int                lines;   // Count of lines of the group, which is count of all nodes.
+
+    char   *buf;
+    size_t  size;
+    size_t  capacity;
+
+    bool          done;
+    bool          failed;
+    nini_errmsg_t errmsg;
+
+} group_t;
+
+//------------------------------------------------------------------------------
+static
+int count_lines(const nini_node_t *node)
+{
+    int count = 1;
+    for(const nini_node_t *child = nini_node_get_first_child_c(node);
+        child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        count += count_lines(child);
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+static
+bool group_on_write(void *stream, const char *data, size_t size)
+{
+    group_t *group = stream;
+
+    if( group->size + size > group->capacity )
+    {
+        size_t capacity = group->capacity ? 2 * group->capacity : NINI_ENCODER_BUFSIZE;
+        while( capacity < group->size + size )
+            capacity *= 2;
+
+        char *buf = realloc(group->buf, capacity);
+        if( !buf ) return false;
+
+        group->buf      = buf;
+        group->capacity = capacity;
+    }
+
+    memcpy(group->buf + group->size, data, size);
+    group->size += size;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void group_encode(group_t *group, const nini_format_t *format)
+{
+    nini_encoder_t encoder;
+    if( !nini_encoder_init_stream(&encoder, format, group, group_on_write, &group->errmsg) )
+    {
+        group->failed = true;
+        return;
+    }
+
+    const nini_node_t *node = group->first;
+    for(size_t i = 0; i < group->count; ++i, node = nini_node_get_next_sibling_c(node))
+    {
+        if( !nini_encoder_write_tree(&encoder, 0, node) ) break;
+    }
+
+    group->failed = !nini_encoder_finish(&encoder);
+    nini_encoder_deinit(&encoder);
+}
+//------------------------------------------------------------------------------
+static
+group_t* create_groups(const nini_node_t *first, size_t max_count, size_t *count)
+{
+    // Divide top-level nodes to groups those have similar line counts.
+    size_t nodes = 0;
+    for(const nini_node_t *node = first; node; node = nini_node_get_next_sibling_c(node))
+        ++ nodes;
+
+    int *lines = malloc(nodes * sizeof(lines[0]));
+    if( !lines ) return NULL;
+
+    long total = 0;
+    size_t i = 0;
+    for(const nini_node_t *node = first; node; node = nini_node_get_next_sibling_c(node), ++i)
+        total += lines[i] = count_lines(node);
+
+    if( max_count > nodes ) max_count = nodes;
+    group_t *groups = calloc(max_count, sizeof(groups[0]));
+    if( !groups )
+    {
+        free(lines);
+        return NULL;
+    }
+
+    long   target = ( total + max_count - 1 ) / max_count;
+    size_t ngroup = 0;
+    const nini_node_t *node = first;
+    for(i = 0; i < nodes; ++i, node = nini_node_get_next_sibling_c(node))
+    {
+        group_t *group = &groups[ngroup];
+        if( !group->count ) group->first = node;
+
+        ++ group->count;
+        group->lines += lines[i];
+
+        // Keep at least one node for each of the remaining groups.
+        if( ngroup + 1 < max_count &&
+            ( group->lines >= target || nodes - i - 1 <= max_count - ngroup - 1 ) )
+        {
+            ++ ngroup;
+        }
+    }
+
+    free(lines);
+
+    *count = ngroup + ( groups[ngroup].count ? 1 : 0 );
+    return groups;
+}
+//------------------------------------------------------------------------------
+static
+void release_groups(group_t *groups, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        if( groups[i].buf ) free(groups[i].buf);
+    }
+
+    free(groups);
+}
+//------------------------------------------------------------------------------
+typedef struct job_t
+{
+    const nini_format_t *format;
+
+    group_t *groups;
+    size_t   count;
+    size_t   next;      // The next group to be taken by workers.
+
+    pthread_mutex_t lock;
+    pthread_cond_t  done;
+
+} job_t;
+
+//------------------------------------------------------------------------------
+static
+void* worker_main(void *arg)
+{
+    job_t *job = arg;
+
+    for(;;)
+    {
+        pthread_mutex_lock(&job->lock);
+        size_t index = job->next < job->count ? job->next ++ : job->count;
+        pthread_mutex_unlock(&job->lock);
+
+        if( index >= job->count ) break;
+
+        group_t *group = &job->groups[index];
+        group_encode(group, job->format);
+
+        pthread_mutex_lock(&job->lock);
+        group->done = true;
+        pthread_cond_broadcast(&job->done);
+        pthread_mutex_unlock(&job->lock);
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
+static
+size_t write_groups(job_t *job, void *stream, nini_on_write_t on_write, nini_errmsg_t *errmsg)
+{
+    // Write groups in the document order while the others are still being encoded.
+    size_t total_size = 0;
+    int    lines      = 0;
+
+    for(size_t i = 0; i < job->count; ++i)
+    {
+        group_t *group = &job->groups[i];
+
+        pthread_mutex_lock(&job->lock);
+        while( !group->done )
+            pthread_cond_wait(&job->done, &job->lock);
+        pthread_mutex_unlock(&job->lock);
+
+        bool failed = group->failed;
+        if( failed )
+        {
+            if( errmsg )
+            {
+                *errmsg = group->errmsg;
+                if( errmsg->line_num ) errmsg->line_num += lines;
+            }
+        }
+        else if( group->size && !on_write(stream, group->buf, group->size) )
+        {
+            failed = true;
+            nini_errmsg_write(errmsg, lines + group->lines, "", "Stream write failed!");
+        }
+
+        if( failed )
+        {
+            // Stop workers from taking more groups.
+            pthread_mutex_lock(&job->lock);
+            job->next = job->count;
+            pthread_mutex_unlock(&job->lock);
+
+            return 0;
+        }
+
+        total_size += group->size;
+        lines      += group->lines;
+
+        free(group->buf);
+        group->buf = NULL;
+    }
+
+    if( errmsg ) memset(errmsg, 0, sizeof(*errmsg));
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
+static
+unsigned get_thread_count(unsigned threads)
+{
+    if( threads ) return threads;
+
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+}
+//------------------------------------------------------------------------------
+size_t nini_parallel_encode(const nini_format_t *format,
+                            const nini_node_t   *first,
+                            unsigned             threads,
+                            void                *stream,
+                            nini_on_write_t      on_write,
+                            nini_errmsg_t       *errmsg)
+{
+    /*
+     * Encode top-level nodes by the specified count of threads,
+     * or the count of processors if it is ZERO.
+     */
+    threads = get_thread_count(threads);
+    if( threads < 2 || !first || !nini_node_get_next_sibling_c(first) )
+        return serial_encode(format, first, stream, on_write, errmsg);
+
+    job_t job;
+    memset(&job, 0, sizeof(job));
+    job.format = format;
+
+    job.groups = create_groups(first, (size_t) threads * GROUPS_PER_THREAD, &job.count);
+    if( !job.groups ) return serial_encode(format, first, stream, on_write, errmsg);
+
+    if( threads > job.count ) threads = job.count;
+
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.done, NULL);
+
+    pthread_t *workers = malloc(threads * sizeof(workers[0]));
+    unsigned   started = 0;
+    for(; workers && started < threads; ++started)
+    {
+        if( pthread_create(&workers[started], NULL, worker_main, &job) ) break;
+    }
+
+    // Encode all groups on this thread if no worker can be started.
+    if( !started ) worker_main(&job);
+
+    size_t total_size = write_groups(&job, stream, on_write, errmsg);
+
+    for(unsigned i = 0; i < started; ++i)
+        pthread_join(workers[i], NULL);
+
+    if( workers ) free(workers);
+    pthread_cond_destroy(&job.done);
+    pthread_mutex_destroy(&job.lock);
+    release_groups(job.groups, job.count);
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+size_t nini_parallel_encode(const nini_format_t *format,
+                            const nini_node_t   *first,
+                            unsigned             threads,
+                            void                *stream,
+                            nini_on_write_t      on_write,
+                            nini_errmsg_t       *errmsg)
+{
+    // Threads are not supported, and nodes will be encoded serially.
+    return serial_encode(format, first, stream, on_write, errmsg);
+}
+//------------------------------------------------------------------------------
+#endif
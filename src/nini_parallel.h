@@ -0,0 +1,32 @@
+#ifndef _NINI_PARALLEL_H_
+#define _NINI_PARALLEL_H_
+
+#include "nini_format.h"
+#include "nini_errmsg.h"
+#include "nini_node.h"
+#include "nini_root.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Parallel encoder of top-level nodes.
+ * Top-level nodes will be divided into groups of balanced line counts,
+ * and groups will be encoded to their own buffers by a pool of worker threads.
+ * The buffers will then be written to the stream in the document order,
+ * so that the result is the same as the serial encoder.
+ */
+
+size_t nini_parallel_encode(const nini_format_t *format,
+                            const nini_node_t   *first,
+                            unsigned             threads,
+                            void                *stream,
+                            nini_on_write_t      on_write,
+                            nini_errmsg_t       *errmsg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include "nini_number.h"
+#include "nini_simd.h"
 #include "nini_parser.h"
 
 #define REPORT_PARSE_ERROR(parser,format, args...) \
@@ -133,7 +135,8 @@ void nini_parser_reset(nini_parser_t *self)
 {
     memset(&self->errmsg, 0, sizeof(self->errmsg));
 
-    self->line_index = 1;
+    self->line_index  = 1;
+    self->line_offset = 0;
     self->last_level = 0;
     stack_clear(&self->stack);
 
@@ -191,8 +194,8 @@ nini_type_t read_value_and_type(text_t *text, nini_parser_value_t *value)
     value->integer = strtol(text->str, &endpos, 16);
     if( *endpos == 0 ) return NINI_HEXA;
 
-    value->floating = strtod(text->str, &endpos);
-    if( *endpos == 0 ) return NINI_FLOAT;
+    if( text->str[ nini_number_parse_float(text->str, &value->floating) ] == 0 )
+        return NINI_FLOAT;
 
     if( strtobool(text->str, &value->boolean) )
         return NINI_BOOL;
@@ -265,6 +268,7 @@ bool state_to_next_line(nini_parser_t *self)
             return false;
     }
 
+    self->line_offset += self->line.len;
     nini_parser_clear_line_state(self);
     ++ self->line_index;
 
@@ -782,12 +786,44 @@ bool read_char(nini_parser_t *self, char ch)
     return false;
 }
 //------------------------------------------------------------------------------
+static
+size_t read_run_for_quoted_value(nini_parser_t *self, const char *data, size_t size)
+{
+    /*
+     * Copy the run of characters those can be read directly in a quoted value,
+     * and the other characters will be read one by one.
+     * The run will be shortened to what the line buffer can accept,
+     * so that a too long line will be reported by the next character.
+     */
+    assert( self->state == STATE_QUOTED_VALUE );
+
+    size_t len  = nini_simd_find_quoted_stop(data, size);
+    size_t room = NINI_MAX_LINE_CHARS - self->line.len;
+    if( len > room ) len = room;
+
+    memcpy(self->line.str + self->line.len, data, len);
+    self->line.len += len;
+
+    memcpy(self->value.str + self->value.len, data, len);
+    self->value.len += len;
+
+    return len;
+}
+//------------------------------------------------------------------------------
 bool nini_parser_parse(nini_parser_t *self, const void *data, size_t size)
 {
     nini_parser_reset(self);
 
     for(const uint8_t *pos = data; size; ++pos, --size)
     {
+        if( self->state == STATE_QUOTED_VALUE )
+        {
+            size_t len = read_run_for_quoted_value(self, (const char*) pos, size);
+            pos  += len;
+            size -= len;
+            if( !size ) break;
+        }
+
         if( !read_char(self, *pos) )
             return false;
     }
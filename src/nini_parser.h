@@ -45,7 +45,8 @@ typedef struct nini_parser_t
     void                  *userarg;
     nini_parser_on_item_t  on_item;
 
-    int line_index;
+    int    line_index;
+    size_t line_offset;     // Offset of the current line in the data.
 
     int state;
 
@@ -0,0 +1,850 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_hash.h"
+#include "nini_match.h"
+#include "nini_patch.h"
+
+/*
+ * The patch starts with a head of the magic string, the base hash, the target hash,
+ * and the checksum of the body (all hashes are 64-bit little-endian).
+ * The body is the operations of the root, and operations of a section are:
+ *
+ *     DELETE  index           Delete the child at the index.
+ *     MOVE    from, to        Move the child at an index to be at another index.
+ *     INSERT  index, node     Insert a node to be at the index.
+ *     UPDATE  index, value    Copy the type and the value to the key at the index.
+ *     REPLACE index, node     Replace the child at the index by a node.
+ *     ENTER   index           Start operations of the section at the index.
+ *     LEAVE                   End operations of the current section.
+ *
+ * Each operation is one byte, and indices are unsigned variable-length integers (LEB128).
+ * A value is the type (one byte) and the value data,
+ * and a node is the type, the name, and the value data or the count of children and the children.
+ * Strings are the length (LEB128) and the characters,
+ * integers are signed variable-length integers (zigzag LEB128),
+ * floating point numbers are 64-bit little-endian bits, and booleans are one byte.
+ *
+ * Operations of a section address children by their current positions,
+ * and the encoder emits deletions first, and then builds the new sibling order from the first child,
+ * so that a child at the index of an operation is found by walking forward most of the time.
+ */
+
+static const char patch_magic[8] = { 'N', 'I', 'N', 'I', 'P', 'A', 'T', '1' };
+
+#define PATCH_HEAD_SIZE 32
+
+enum
+{
+    OP_DELETE  = 'D',
+    OP_MOVE    = 'M',
+    OP_INSERT  = 'I',
+    OP_UPDATE  = 'U',
+    OP_REPLACE = 'R',
+    OP_ENTER   = 'E',
+    OP_LEAVE   = 'L',
+};
+
+typedef struct reader_t
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+    bool           broken;  // The data is malformed.
+    unsigned       level;   // Nesting level of sections, limited by NINI_MAX_PARSE_LEVEL.
+} reader_t;
+
+typedef struct cursor_t
+{
+    nini_node_t *parent;
+    nini_node_t *node;      // The child at the index, or NULL if the index is at the end.
+    size_t       index;
+} cursor_t;
+
+//------------------------------------------------------------------------------
+void nini_patch_init(nini_patch_t *self)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Constructor.
+     *
+     * @param self Object instance.
+     */
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
+void nini_patch_deinit(nini_patch_t *self)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     */
+    if( self->data ) free(self->data);
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
+static
+void store_u64(uint8_t *buf, uint64_t value)
+{
+    for(int i = 0; i < 8; ++i, value >>= 8)
+        buf[i] = (uint8_t) value;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t load_u64(const uint8_t *buf)
+{
+    uint64_t value = 0;
+    for(int i = 7; i >= 0; --i)
+        value = ( value << 8 ) | buf[i];
+
+    return value;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t checksum(const uint8_t *data, size_t size)
+{
+    return nini_hash_mix(nini_hash_bytes(0xCBF29CE484222325ULL, data, size));
+}
+//------------------------------------------------------------------------------
+static
+bool put_bytes(nini_patch_t *self, const void *data, size_t size)
+{
+    if( self->size + size > self->capacity )
+    {
+        size_t capacity = self->capacity ? 2 * self->capacity : 256;
+        while( capacity < self->size + size )
+            capacity *= 2;
+
+        uint8_t *buf = realloc(self->data, capacity);
+        if( !buf ) return false;
+
+        self->data     = buf;
+        self->capacity = capacity;
+    }
+
+    memcpy(self->data + self->size, data, size);
+    self->size += size;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool put_byte(nini_patch_t *self, uint8_t value)
+{
+    return put_bytes(self, &value, 1);
+}
+//------------------------------------------------------------------------------
+static
+bool put_varint(nini_patch_t *self, uint64_t value)
+{
+    uint8_t buf[10];
+    size_t  size = 0;
+    do
+    {
+        buf[size] = value & 0x7F;
+        value >>= 7;
+        if( value ) buf[size] |= 0x80;
+        ++ size;
+    } while( value );
+
+    return put_bytes(self, buf, size);
+}
+//------------------------------------------------------------------------------
+static
+bool put_string(nini_patch_t *self, const char *str)
+{
+    size_t len = strlen(str);
+    return put_varint(self, len) && put_bytes(self, str, len);
+}
+//------------------------------------------------------------------------------
+static
+bool put_value_data(nini_patch_t *self, const nini_node_t *node)
+{
+    switch( node->type )
+    {
+    case NINI_STRING:
+        return put_string(self, node->value.string);
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+    {
+        uint64_t value = (uint64_t)(int64_t) node->value.integer;
+        return put_varint(self, ( value << 1 ) ^ ( node->value.integer < 0 ? UINT64_MAX : 0 ));
+    }
+
+    case NINI_FLOAT:
+    {
+        uint64_t bits;
+        memcpy(&bits, &node->value.floating, sizeof(bits));
+
+        uint8_t buf[8];
+        store_u64(buf, bits);
+        return put_bytes(self, buf, sizeof(buf));
+    }
+
+    case NINI_BOOL:
+        return put_byte(self, node->value.boolean);
+
+    default:
+        return true;
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool put_node(nini_patch_t *self, const nini_node_t *node)
+{
+    if( !put_byte(self, node->type) || !put_string(self, node->name) ) return false;
+
+    if( node->type != NINI_SECTION )
+        return put_value_data(self, node);
+
+    size_t count = 0;
+    for(const nini_node_t *child = node->childs.first; child; child = child->next)
+        ++ count;
+
+    if( !put_varint(self, count) ) return false;
+
+    for(const nini_node_t *child = node->childs.first; child; child = child->next)
+    {
+        if( !put_node(self, child) ) return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool put_op(nini_patch_t *self, uint8_t op, size_t index)
+{
+    return put_byte(self, op) && put_varint(self, index);
+}
+//------------------------------------------------------------------------------
+static
+bool diff_section(nini_patch_t *self, const nini_node_t *old_parent, const nini_node_t *new_parent);
+//------------------------------------------------------------------------------
+static
+bool diff_child(nini_patch_t *self, size_t index, const nini_node_t *old_node, const nini_node_t *new_node)
+{
+    // The old node is already at the index.
+    if( nini_node_get_hash(old_node) == nini_node_get_hash(new_node) ) return true;
+
+    if( old_node->type == NINI_SECTION && new_node->type == NINI_SECTION )
+        return put_op(self, OP_ENTER, index) && diff_section(self, old_node, new_node);
+
+    if( old_node->type != NINI_SECTION && new_node->type != NINI_SECTION )
+    {
+        return put_op(self, OP_UPDATE, index) &&
+               put_byte(self, new_node->type) &&
+               put_value_data(self, new_node);
+    }
+
+    // A key becomes a section, or a section becomes a key.
+    return put_op(self, OP_REPLACE, index) && put_node(self, new_node);
+}
+//------------------------------------------------------------------------------
+static
+bool diff_section(nini_patch_t *self, const nini_node_t *old_parent, const nini_node_t *new_parent)
+{
+    nini_match_t match;
+    if( !nini_match_init(&match, old_parent, new_parent) ) return false;
+
+    // Old positions of the matched old children those have not been placed, in their current order.
+    size_t *pending = match.old_count ? malloc(match.old_count * sizeof(pending[0])) : NULL;
+
+    bool succ = false;
+    do
+    {
+        if( match.old_count && !pending ) break;
+
+        // Delete the unmatched old children.
+        size_t deleted = 0, pending_count = 0;
+        size_t i;
+        for(i = 0; i < match.old_count; ++i)
+        {
+            if( match.old_matches[i] != NINI_MATCH_NONE )
+            {
+                pending[ pending_count ++ ] = i;
+            }
+            else
+            {
+                if( !put_op(self, OP_DELETE, i - deleted) ) break;
+                ++ deleted;
+            }
+        }
+        if( i < match.old_count ) break;
+
+        // Build the new sibling order from the first child, and the pending children are after the index.
+        size_t index;
+        for(index = 0; index < match.new_count; ++index)
+        {
+            size_t old_pos = match.new_matches[index];
+            if( old_pos == NINI_MATCH_NONE )
+            {
+                if( !put_op(self, OP_INSERT, index) || !put_node(self, match.news[index]) ) break;
+                continue;
+            }
+
+            size_t k = 0;
+            while( pending[k] != old_pos ) ++ k;
+
+            if( k && !( put_op(self, OP_MOVE, index + k) && put_varint(self, index) ) ) break;
+
+            memmove(pending + k, pending + k + 1, ( pending_count - k - 1 ) * sizeof(pending[0]));
+            -- pending_count;
+
+            if( !diff_child(self, index, match.olds[old_pos], match.news[index]) ) break;
+        }
+        if( index < match.new_count ) break;
+
+        succ = put_byte(self, OP_LEAVE);
+    } while(false);
+
+    if( pending ) free(pending);
+    nini_match_deinit(&match);
+
+    return succ;
+}
+//------------------------------------------------------------------------------
+bool nini_patch_diff(nini_patch_t *self, const nini_root_t *base, const nini_root_t *target, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Compute the differences those change the base root to the target root.
+     *
+     * @param self   Object instance.
+     * @param base   The root to be changed by the patch.
+     * @param target The root to be the result of the patch.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if memory allocation failed.
+     *
+     * @remarks Children are matched by names, and children with the same name are matched in their order,
+     *          so that a renamed node is recorded as a deletion and an insertion.
+     */
+    self->size = 0;
+
+    uint8_t head[PATCH_HEAD_SIZE];
+    memcpy(head, patch_magic, sizeof(patch_magic));
+    store_u64(head + 8,  nini_root_get_hash(base));
+    store_u64(head + 16, nini_root_get_hash(target));
+    store_u64(head + 24, 0);
+
+    if( !put_bytes(self, head, sizeof(head)) ||
+        !diff_section(self, &base->super, &target->super) )
+    {
+        self->size = 0;
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+    store_u64(self->data + 24, checksum(self->data + PATCH_HEAD_SIZE, self->size - PATCH_HEAD_SIZE));
+
+    if( errmsg )
+        memset(errmsg, 0, sizeof(*errmsg));
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_patch_load(nini_patch_t *self, const void *data, size_t size, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Load the patch data, and verify its integrity.
+     *
+     * @param self   Object instance.
+     * @param data   The patch data.
+     * @param size   Size of the patch data.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The patch will be empty if failed.
+     */
+    self->size = 0;
+
+    const uint8_t *bytes = data;
+    if( size <= PATCH_HEAD_SIZE ||
+        memcmp(bytes, patch_magic, sizeof(patch_magic)) ||
+        load_u64(bytes + 24) != checksum(bytes + PATCH_HEAD_SIZE, size - PATCH_HEAD_SIZE) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Invalid patch data!");
+        return false;
+    }
+
+    if( !put_bytes(self, data, size) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+    if( errmsg )
+        memset(errmsg, 0, sizeof(*errmsg));
+
+    return true;
+}
+//------------------------------------------------------------------------------
+uint64_t nini_patch_get_base_hash(const nini_patch_t *self)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Get content hash of the root that the patch can be applied to.
+     *
+     * @param self Object instance.
+     * @return The content hash of the base root, or ZERO if the patch is empty.
+     */
+    return self->size ? load_u64(self->data + 8) : 0;
+}
+//------------------------------------------------------------------------------
+uint64_t nini_patch_get_target_hash(const nini_patch_t *self)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Get content hash of the result of the patch.
+     *
+     * @param self Object instance.
+     * @return The content hash of the target root, or ZERO if the patch is empty.
+     */
+    return self->size ? load_u64(self->data + 16) : 0;
+}
+//------------------------------------------------------------------------------
+static
+uint8_t get_byte(reader_t *reader)
+{
+    if( reader->pos >= reader->end )
+    {
+        reader->broken = true;
+        return 0;
+    }
+
+    return *reader->pos ++;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t get_varint(reader_t *reader)
+{
+    uint64_t value = 0;
+    for(int shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = get_byte(reader);
+        value |= (uint64_t)( byte & 0x7F ) << shift;
+        if( !( byte & 0x80 ) ) return value;
+    }
+
+    reader->broken = true;
+    return 0;
+}
+//------------------------------------------------------------------------------
+static
+char* get_string(reader_t *reader)
+{
+    // Return a new allocated string, or NULL if failed.
+    uint64_t len = get_varint(reader);
+    if( reader->broken ) return NULL;
+
+    if( len > (uint64_t)( reader->end - reader->pos ) || memchr(reader->pos, 0, len) )
+    {
+        reader->broken = true;
+        return NULL;
+    }
+
+    char *str = malloc(len + 1);
+    if( !str ) return NULL;
+
+    memcpy(str, reader->pos, len);
+    str[len] = 0;
+    reader->pos += len;
+
+    return str;
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* get_key(reader_t *reader, nini_type_t type, const char *name)
+{
+    // Return a new key with the value data, or NULL if failed.
+    switch( type )
+    {
+    case NINI_STRING:
+    {
+        char *value = get_string(reader);
+        if( !value ) return NULL;
+
+        nini_node_t *node = nini_node_create_string(name, value);
+        free(value);
+        return node;
+    }
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+    {
+        uint64_t value   = get_varint(reader);
+        long     integer = (long)(int64_t)( ( value >> 1 ) ^ ( value & 1 ? UINT64_MAX : 0 ) );
+        if( reader->broken ) return NULL;
+
+        return type == NINI_DECIMAL ?
+               nini_node_create_decimal(name, integer) :
+               nini_node_create_hexa(name, integer);
+    }
+
+    case NINI_FLOAT:
+    {
+        if( reader->end - reader->pos < 8 )
+        {
+            reader->broken = true;
+            return NULL;
+        }
+
+        uint64_t bits = load_u64(reader->pos);
+        reader->pos += 8;
+
+        double floating;
+        memcpy(&floating, &bits, sizeof(floating));
+        return nini_node_create_float(name, floating);
+    }
+
+    case NINI_BOOL:
+    {
+        uint8_t value = get_byte(reader);
+        if( reader->broken ) return NULL;
+
+        return nini_node_create_bool(name, value);
+    }
+
+    case NINI_NULL:
+        return nini_node_create_null(name);
+
+    default:
+        reader->broken = true;
+        return NULL;
+    }
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* get_node(reader_t *reader)
+{
+    // Return a new node with its children, or NULL if failed.
+    nini_type_t type = get_byte(reader);
+    char       *name = get_string(reader);
+    if( !name ) return NULL;
+
+    nini_node_t *node = type == NINI_SECTION ?
+                        nini_node_create_section(name) :
+                        get_key(reader, type, name);
+    free(name);
+
+    if( !node || type != NINI_SECTION ) return node;
+
+    // Malformed data may have sections nested too deep to be recursed.
+    if( ++ reader->level > NINI_MAX_PARSE_LEVEL ) reader->broken = true;
+
+    uint64_t count = get_varint(reader);
+    for(uint64_t i = 0; i < count && !reader->broken; ++i)
+    {
+        nini_node_t *child = get_node(reader);
+        if( !child )
+        {
+            -- reader->level;
+            nini_node_release(node);
+            return NULL;
+        }
+
+        nini_node_link_child(node, child);
+    }
+
+    -- reader->level;
+
+    if( reader->broken )
+    {
+        nini_node_release(node);
+        return NULL;
+    }
+
+    return node;
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* cursor_seek(cursor_t *cursor, uint64_t index)
+{
+    // Return the child at the index, or NULL if the index is out of range.
+    if( index < cursor->index || !cursor->node )
+    {
+        cursor->node  = nini_node_get_first_child(cursor->parent);
+        cursor->index = 0;
+    }
+
+    for(; cursor->node && cursor->index < index; ++ cursor->index)
+        cursor->node = cursor->node->next;
+
+    return cursor->index == index ? cursor->node : NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_section(reader_t *reader, nini_node_t *parent);
+//------------------------------------------------------------------------------
+static
+bool apply_insert(reader_t *reader, cursor_t *cursor, uint64_t index)
+{
+    nini_node_t *prev = index ? cursor_seek(cursor, index - 1) : NULL;
+    if( index && !prev )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    nini_node_t *node = get_node(reader);
+    if( !node ) return false;
+
+    if( !nini_node_link_child(cursor->parent, node) )
+    {
+        nini_node_release(node);
+        return false;
+    }
+
+    nini_node_move_after(node, prev);
+    cursor->node  = node;
+    cursor->index = index;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_move(reader_t *reader, cursor_t *cursor, uint64_t from)
+{
+    uint64_t to = get_varint(reader);
+
+    nini_node_t *node = cursor_seek(cursor, from);
+    if( !node || reader->broken || to == from )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    // The node is moved after the node at the previous index of the destination.
+    nini_node_t *prev = NULL;
+    if( to < from )
+        prev = to ? cursor_seek(cursor, to - 1) : NULL;
+    else
+        prev = cursor_seek(cursor, to);
+
+    if( ( to && !prev ) || !nini_node_move_after(node, prev) )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    cursor->node  = node;
+    cursor->index = to;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_update(reader_t *reader, cursor_t *cursor, uint64_t index)
+{
+    nini_node_t *node = cursor_seek(cursor, index);
+    if( !node || node->type == NINI_SECTION )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    nini_type_t  type  = get_byte(reader);
+    nini_node_t *value = type == NINI_SECTION ? NULL : get_key(reader, type, "");
+    if( !value )
+    {
+        reader->broken |= type == NINI_SECTION;
+        return false;
+    }
+
+    bool succ = nini_node_copy_value(node, value);
+    nini_node_release(value);
+
+    return succ;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_replace(reader_t *reader, cursor_t *cursor, uint64_t index)
+{
+    nini_node_t *node = cursor_seek(cursor, index);
+    if( !node )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    nini_node_t *new_node = get_node(reader);
+    if( !new_node ) return false;
+
+    if( !nini_node_replace(node, new_node) )
+    {
+        nini_node_release(new_node);
+        return false;
+    }
+
+    nini_node_release(node);
+    cursor->node = new_node;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_enter(reader_t *reader, cursor_t *cursor, uint64_t index)
+{
+    nini_node_t *node = cursor_seek(cursor, index);
+    if( !node || node->type != NINI_SECTION )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    return apply_section(reader, node);
+}
+//------------------------------------------------------------------------------
+static
+bool apply_children(reader_t *reader, nini_node_t *parent);
+//------------------------------------------------------------------------------
+static
+bool apply_section(reader_t *reader, nini_node_t *parent)
+{
+    // Malformed data may have sections nested too deep to be recursed.
+    if( ++ reader->level > NINI_MAX_PARSE_LEVEL )
+    {
+        reader->broken = true;
+        return false;
+    }
+
+    bool res = apply_children(reader, parent);
+    -- reader->level;
+
+    return res;
+}
+//------------------------------------------------------------------------------
+static
+bool apply_children(reader_t *reader, nini_node_t *parent)
+{
+    // Children of a shared section are copied before they be changed.
+    if( !nini_node_unshare(parent) ) return false;
+
+    cursor_t cursor;
+    cursor.parent = parent;
+    cursor.node   = nini_node_get_first_child(parent);
+    cursor.index  = 0;
+
+    while( true )
+    {
+        uint8_t op = get_byte(reader);
+        if( op == OP_LEAVE ) return !reader->broken;
+
+        uint64_t index = get_varint(reader);
+        if( reader->broken ) return false;
+
+        bool succ = false;
+        switch( op )
+        {
+        case OP_DELETE:
+        {
+            nini_node_t *node = cursor_seek(&cursor, index);
+            if( !node )
+            {
+                reader->broken = true;
+                break;
+            }
+
+            cursor.node = node->next;
+            if( ( succ = nini_node_unlink(node) ) )
+                nini_node_release(node);
+            break;
+        }
+
+        case OP_MOVE:
+            succ = apply_move(reader, &cursor, index);
+            break;
+
+        case OP_INSERT:
+            succ = apply_insert(reader, &cursor, index);
+            break;
+
+        case OP_UPDATE:
+            succ = apply_update(reader, &cursor, index);
+            break;
+
+        case OP_REPLACE:
+            succ = apply_replace(reader, &cursor, index);
+            break;
+
+        case OP_ENTER:
+            succ = apply_enter(reader, &cursor, index);
+            break;
+
+        default:
+            reader->broken = true;
+            break;
+        }
+
+        if( !succ ) return false;
+    }
+}
+//------------------------------------------------------------------------------
+bool nini_patch_apply(const nini_patch_t *self, nini_root_t *root, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_patch_t
+     * @brief Apply the patch to a root.
+     *
+     * @param self   Object instance.
+     * @param root   The root to be changed, and it must be the same as the base root of the patch.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The root will not be changed if it is not the same as the base root.
+     *          If the memory allocation failed while the patch be applied,
+     *          the root may be partially changed.
+     */
+    if( self->size <= PATCH_HEAD_SIZE )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Invalid patch data!");
+        return false;
+    }
+
+    if( nini_root_is_frozen(root) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
+    if( nini_root_get_hash(root) != nini_patch_get_base_hash(self) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is not the base of the patch!");
+        return false;
+    }
+
+    reader_t reader;
+    reader.pos    = self->data + PATCH_HEAD_SIZE;
+    reader.end    = self->data + self->size;
+    reader.broken = false;
+    reader.level  = 0;
+
+    if( !apply_children(&reader, &root->super) || reader.pos != reader.end )
+    {
+        nini_errmsg_write(errmsg,
+                          0,
+                          "",
+                          reader.broken || reader.pos != reader.end ?
+                          "Invalid patch data!" : "Memory allocation failed!");
+        return false;
+    }
+
+    if( nini_root_get_hash(root) != nini_patch_get_target_hash(self) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Result of the patch mismatched!");
+        return false;
+    }
+
+    if( errmsg )
+        memset(errmsg, 0, sizeof(*errmsg));
+
+    return true;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,323 @@
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "nini_hash.h"
+#include "nini_table.h"
+#include "nini_phash.h"
+
+#define MAX_SEED ( 1 << 24 )
+
+typedef struct build_t
+{
+    char deli;
+
+    nini_phash_slot_t *keys;
+    size_t             count;
+    size_t             capacity;
+
+    char   *paths;
+    size_t  paths_size;
+    size_t  paths_capacity;
+
+    nini_table_t set;       // Index (plus one) of keys to detect duplicated paths.
+
+} build_t;
+
+//------------------------------------------------------------------------------
+static
+void build_release(build_t *build)
+{
+    if( build->keys  ) free(build->keys);
+    if( build->paths ) free(build->paths);
+    nini_table_deinit(&build->set);
+}
+//------------------------------------------------------------------------------
+static
+bool build_reserve_paths(build_t *build, size_t size)
+{
+    if( build->paths_size + size <= build->paths_capacity ) return true;
+
+    size_t capacity = build->paths_capacity ? 2 * build->paths_capacity : 256;
+    while( capacity < build->paths_size + size )
+        capacity *= 2;
+
+    char *paths = realloc(build->paths, capacity);
+    if( !paths ) return false;
+
+    build->paths          = paths;
+    build->paths_capacity = capacity;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+typedef struct build_path_t
+{
+    const build_t *build;
+    const char    *path;
+} build_path_t;
+
+//------------------------------------------------------------------------------
+static
+bool build_match_path(const void *item, const build_path_t *key)
+{
+    const nini_phash_slot_t *slot = &key->build->keys[ (uintptr_t) item - 1 ];
+    return 0 == strcmp(key->build->paths + slot->path, key->path);
+}
+//------------------------------------------------------------------------------
+static
+bool build_set_have(const build_t *build, uint64_t hash, const char *path)
+{
+    build_path_t key = { build, path };
+    return nini_table_find(&build->set, hash, (nini_table_match_t) build_match_path, &key);
+}
+//------------------------------------------------------------------------------
+static
+bool build_add_key(build_t *build, const nini_node_t *node, size_t path, uint64_t hash)
+{
+    if( build->count >= build->capacity )
+    {
+        size_t capacity = build->capacity ? 2 * build->capacity : 64;
+        nini_phash_slot_t *keys = realloc(build->keys, capacity * sizeof(keys[0]));
+        if( !keys ) return false;
+
+        build->keys     = keys;
+        build->capacity = capacity;
+    }
+
+    if( !nini_table_insert(&build->set, (void*)(uintptr_t)( build->count + 1 ), hash) ) return false;
+
+    nini_phash_slot_t *key = &build->keys[ build->count ++ ];
+    key->node = node;
+    key->hash = hash;
+    key->path = path;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool build_collect(build_t *build, const nini_node_t *parent, size_t parent_path, size_t parent_len)
+{
+    for(const nini_node_t *node = nini_node_get_first_child_c(parent);
+        node;
+        node = nini_node_get_next_sibling_c(node))
+    {
+        // Names with the delimiter cannot be reached by paths.
+        const char *name = nini_node_get_name(node);
+        if( strchr(name, build->deli) ) continue;
+
+        size_t name_len = strlen(name);
+        size_t path_len = parent_len + ( parent_len ? 1 : 0 ) + name_len;
+        if( !build_reserve_paths(build, path_len + 1) ) return false;
+
+        size_t path = build->paths_size;
+        char  *pos  = build->paths + path;
+        if( parent_len )
+        {
+            memcpy(pos, build->paths + parent_path, parent_len);
+            pos += parent_len;
+            *pos++ = build->deli;
+        }
+        memcpy(pos, name, name_len + 1);
+
+        /*
+         * Only the first one of siblings with the same name can be reached by paths,
+         * and it is always collected before the others.
+         * So that the node and all of its children will be ignored
+         * if the path is already existed.
+         */
+        uint64_t hash = nini_hash_string(build->paths + path);
+        if( build_set_have(build, hash, build->paths + path) ) continue;
+
+        build->paths_size += path_len + 1;
+        if( !build_add_key(build, node, path, hash) ) return false;
+
+        if( nini_node_have_child(node) &&
+            !build_collect(build, node, path, path_len) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool place_buckets(nini_phash_t *self, const nini_phash_slot_t *keys)
+{
+    size_t  count  = self->count;
+    size_t  nbkts  = self->bucket_count;
+    size_t *starts = NULL;  // Start position of keys of each bucket in the member list.
+    size_t *member = NULL;  // Key indices grouped by buckets.
+    size_t *order  = NULL;  // Bucket indices sorted by their sizes in descending order.
+    size_t *slots  = NULL;  // Slots tried by the current bucket.
+    bool   *used   = NULL;
+
+    bool res = false;
+    do
+    {
+        if( !( starts = calloc(nbkts + 1, sizeof(starts[0])) ) ) break;
+        if( !( member = malloc(count * sizeof(member[0])) ) ) break;
+        if( !( order  = malloc(nbkts * sizeof(order[0])) ) ) break;
+        if( !( slots  = malloc(count * sizeof(slots[0])) ) ) break;
+        if( !( used   = calloc(count, sizeof(used[0])) ) ) break;
+
+        // Group keys by buckets.
+
+        size_t max_size = 0;
+        for(size_t i = 0; i < count; ++i)
+            ++ starts[ keys[i].hash % nbkts + 1 ];
+        for(size_t b = 0; b < nbkts; ++b)
+        {
+            if( max_size < starts[b+1] ) max_size = starts[b+1];
+            starts[b+1] += starts[b];
+        }
+
+        size_t *fill = order;   // Borrow the order list before it be used.
+        memcpy(fill, starts, nbkts * sizeof(fill[0]));
+        for(size_t i = 0; i < count; ++i)
+            member[ fill[ keys[i].hash % nbkts ] ++ ] = i;
+
+        // Sort buckets by their sizes, larger buckets will be placed first.
+
+        size_t norder = 0;
+        for(size_t size = max_size; size; --size)
+        {
+            for(size_t b = 0; b < nbkts; ++b)
+            {
+                if( starts[b+1] - starts[b] == size )
+                    order[ norder ++ ] = b;
+            }
+        }
+
+        // Find a seed for each bucket that all of its keys be placed to free slots.
+
+        size_t free_slot = 0;
+        bool   failed    = false;
+        memset(self->seeds, 0, nbkts * sizeof(self->seeds[0]));
+        for(size_t i = 0; i < norder && !failed; ++i)
+        {
+            size_t b     = order[i];
+            size_t first = starts[b];
+            size_t size  = starts[b+1] - first;
+
+            if( size == 1 )
+            {
+                // Single key can be placed to any free slot directly.
+                while( used[free_slot] ) ++ free_slot;
+                used[free_slot] = true;
+
+                self->seeds[b] = -(int32_t) free_slot - 1;
+                self->slots[free_slot] = keys[ member[first] ];
+                continue;
+            }
+
+            int32_t seed;
+            for(seed = 1; seed < MAX_SEED; ++seed)
+            {
+                size_t placed = 0;
+                for(; placed < size; ++placed)
+                {
+                    size_t slot = nini_hash_seed(keys[ member[ first + placed ] ].hash, seed) % count;
+                    if( used[slot] ) break;
+
+                    used[slot] = true;
+                    slots[placed] = slot;
+                }
+
+                if( placed == size ) break;
+
+                for(size_t k = 0; k < placed; ++k)
+                    used[ slots[k] ] = false;
+            }
+
+            if( seed >= MAX_SEED )
+            {
+                failed = true;
+                break;
+            }
+
+            self->seeds[b] = seed;
+            for(size_t k = 0; k < size; ++k)
+                self->slots[ slots[k] ] = keys[ member[ first + k ] ];
+        }
+        if( failed ) break;
+
+        res = true;
+    } while(false);
+
+    if( starts ) free(starts);
+    if( member ) free(member);
+    if( order  ) free(order);
+    if( slots  ) free(slots);
+    if( used   ) free(used);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+nini_phash_t* nini_phash_create(const nini_node_t *base, char deli)
+{
+    build_t build;
+    memset(&build, 0, sizeof(build));
+    build.deli = deli;
+
+    nini_phash_t *self = NULL;
+
+    bool succ = false;
+    do
+    {
+        if( !build_collect(&build, base, 0, 0) ) break;
+
+        if( !( self = calloc(1, sizeof(nini_phash_t)) ) ) break;
+        self->deli         = deli;
+        self->count        = build.count;
+        self->bucket_count = build.count ? build.count : 1;
+
+        if( !( self->slots = malloc(( self->count ? self->count : 1 ) * sizeof(self->slots[0])) ) ) break;
+        if( !( self->seeds = malloc(self->bucket_count * sizeof(self->seeds[0])) ) ) break;
+
+        if( self->count && !place_buckets(self, build.keys) ) break;
+
+        // Take the path buffer from the builder.
+        self->paths      = build.paths;
+        self->paths_size = build.paths_size;
+        build.paths = NULL;
+
+        succ = true;
+    } while(false);
+
+    build_release(&build);
+
+    if( !succ && self )
+    {
+        nini_phash_release(self);
+        self = NULL;
+    }
+
+    return self;
+}
+//------------------------------------------------------------------------------
+void nini_phash_release(nini_phash_t *self)
+{
+    if( !self ) return;
+
+    if( self->slots ) free(self->slots);
+    if( self->seeds ) free(self->seeds);
+    if( self->paths ) free(self->paths);
+
+    free(self);
+}
+//------------------------------------------------------------------------------
+const nini_node_t* nini_phash_find(const nini_phash_t *self, const char *path)
+{
+    if( !self->count ) return NULL;
+
+    uint64_t hash = nini_hash_string(path);
+    int32_t  seed = self->seeds[ hash % self->bucket_count ];
+    size_t   slot = seed < 0 ?
+                    (size_t)( -( seed + 1 ) ) :
+                    nini_hash_seed(hash, seed) % self->count;
+
+    const nini_phash_slot_t *item = &self->slots[slot];
+    return item->hash == hash && 0 == strcmp(self->paths + item->path, path) ? item->node : NULL;
+}
+//------------------------------------------------------------------------------
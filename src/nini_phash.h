@@ -0,0 +1,49 @@
+#ifndef _NINI_PHASH_H_
+#define _NINI_PHASH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nini_node.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Minimal perfect hash from full key paths to nodes.
+ * The hash will be built once over a tree by the hash and displace algorithm,
+ * and then a path lookup costs one hash probe and one string compare.
+ */
+
+typedef struct nini_phash_slot_t
+{
+    const nini_node_t *node;
+    uint64_t           hash;
+    size_t             path;    // Offset of the path in the path buffer.
+} nini_phash_slot_t;
+
+typedef struct nini_phash_t
+{
+    char deli;
+
+    size_t             count;
+    nini_phash_slot_t *slots;
+
+    size_t   bucket_count;
+    int32_t *seeds;         // Seed of each bucket, or -(slot+1) if the bucket have only one key.
+
+    char   *paths;
+    size_t  paths_size;
+
+} nini_phash_t;
+
+nini_phash_t* nini_phash_create (const nini_node_t *base, char deli);
+void          nini_phash_release(nini_phash_t *self);
+
+const nini_node_t* nini_phash_find(const nini_phash_t *self, const char *path);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,275 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_shared.h"
+#include "nini_table.h"
+#include "nini_pool.h"
+
+/*
+ * Items of the table are shared sections, and the pool holds one reference of each of them.
+ * The table is created on the first section added.
+ */
+
+//------------------------------------------------------------------------------
+void nini_pool_init(nini_pool_t *self)
+{
+    /**
+     * @memberof nini_pool_t
+     * @brief Constructor.
+     *
+     * @param self Object instance.
+     */
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
+void nini_pool_deinit(nini_pool_t *self)
+{
+    /**
+     * @memberof nini_pool_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     *
+     * @remarks Sections still shared by roots are kept until they are released or unshared.
+     */
+    nini_table_t *table = self->table;
+    if( !table ) return;
+
+    for(size_t i = 0; i < table->capacity; ++i)
+    {
+        if( table->slots[i].item )
+            nini_shared_unref(table->slots[i].item);
+    }
+
+    nini_table_deinit(table);
+    free(table);
+
+    self->table = NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool nodes_equal(const nini_node_t *node, const nini_node_t *other)
+{
+    if( node->type != other->type ) return false;
+    if( strcmp(nini_node_get_name(node), nini_node_get_name(other)) ) return false;
+
+    switch( node->type )
+    {
+    case NINI_STRING:
+        return 0 == strcmp(nini_node_get_string(node), nini_node_get_string(other));
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+        return nini_node_get_integer(node) == nini_node_get_integer(other);
+
+    case NINI_FLOAT:
+        {
+            // Values are compared in bits as their hashes do.
+            double value = nini_node_get_float(node), other_value = nini_node_get_float(other);
+            return 0 == memcmp(&value, &other_value, sizeof(value));
+        }
+
+    case NINI_BOOL:
+        return nini_node_get_bool(node) == nini_node_get_bool(other);
+
+    case NINI_NULL:
+        return true;
+
+    default:
+        break;
+    }
+
+    if( node->shared && node->shared == other->shared ) return true;
+
+    const nini_node_t *child       = nini_node_get_first_child_c(node);
+    const nini_node_t *other_child = nini_node_get_first_child_c(other);
+    for(; child && other_child;
+        child = nini_node_get_next_sibling_c(child), other_child = nini_node_get_next_sibling_c(other_child))
+    {
+        if( !nodes_equal(child, other_child) ) return false;
+    }
+
+    return !child && !other_child;
+}
+//------------------------------------------------------------------------------
+static
+bool match_shared(const nini_shared_t *shared, const nini_node_t *section)
+{
+    return nodes_equal(shared->section, section);
+}
+//------------------------------------------------------------------------------
+static
+nini_shared_t* find_shared(const nini_pool_t *self, const nini_node_t *section, uint64_t hash)
+{
+    if( !self->table ) return NULL;
+
+    nini_table_slot_t *slot = nini_table_find(self->table, hash, (nini_table_match_t) match_shared, section);
+    return slot ? slot->item : NULL;
+}
+//------------------------------------------------------------------------------
+static
+nini_shared_t* add_shared(nini_pool_t *self, nini_node_t *section, uint64_t hash)
+{
+    if( !self->table )
+    {
+        if( !( self->table = malloc(sizeof(*self->table)) ) ) return NULL;
+        nini_table_init(self->table);
+    }
+
+    // The table is grown first, so that the section cannot fail to be inserted.
+    if( !nini_table_reserve(self->table, self->table->count + 1) ) return NULL;
+
+    nini_node_t *copy = nini_node_create_section(nini_node_get_name(section));
+    if( !copy ) return NULL;
+
+    // The children are moved to the section in the pool.
+    nini_node_t *child;
+    while(( child = nini_node_get_first_child(section) ))
+    {
+        nini_node_unlink(child);
+        nini_node_link_child(copy, child);
+    }
+
+    if( nini_node_have_index(section) ) nini_node_enable_index(copy);
+
+    nini_shared_t *shared = nini_shared_create(copy);
+    if( !shared )
+    {
+        // Move the children back.
+        while(( child = nini_node_get_first_child(copy) ))
+        {
+            nini_node_unlink(child);
+            nini_node_link_child(section, child);
+        }
+
+        nini_node_release(copy);
+        return NULL;
+    }
+
+    nini_table_insert(self->table, shared, hash);
+
+    return shared;
+}
+//------------------------------------------------------------------------------
+static
+bool share_section(nini_pool_t *self, nini_node_t *section);
+//------------------------------------------------------------------------------
+static
+bool share_children(nini_pool_t *self, nini_node_t *parent)
+{
+    for(nini_node_t *node = nini_node_get_first_child(parent);
+        node;
+        node = nini_node_get_next_sibling(node))
+    {
+        if( nini_node_get_type(node) != NINI_SECTION ) continue;
+        if( nini_node_is_shared(node) || !nini_node_have_child(node) ) continue;
+
+        if( !share_section(self, node) ) return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool share_section(nini_pool_t *self, nini_node_t *section)
+{
+    uint64_t       hash   = nini_node_get_hash(section);
+    nini_shared_t *shared = find_shared(self, section, hash);
+    if( shared )
+    {
+        nini_node_t *child;
+        while(( child = nini_node_get_first_child(section) ))
+        {
+            nini_node_unlink(child);
+            nini_node_release(child);
+        }
+    }
+    else
+    {
+        // Subsections are shared first, so that a new section in the pool refers to them.
+        if( !share_children(self, section) ) return false;
+        if( !( shared = add_shared(self, section, hash) ) ) return false;
+    }
+
+    nini_node_disable_index(section);
+    nini_shared_attach(shared, section);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_pool_share(nini_pool_t *self, nini_root_t *root)
+{
+    /**
+     * @memberof nini_pool_t
+     * @brief Share sections of a root with the same sections of other roots.
+     * @details Each section is shared if the pool has a section with the same content;
+     *          or the section is added to the pool after its subsections are shared.
+     *          Sections are found by their content hashes (see nini_node_get_hash),
+     *          and are compared in full.
+     *
+     * @param self Object instance.
+     * @param root The root to be shared.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * The root is frozen.
+     *         * Memory allocation failed, and the root may be partially shared.
+     *
+     * @remarks The content of the root is not changed,
+     *          but nodes in shared sections are released or moved to the pool.
+     */
+    if( nini_root_is_frozen(root) ) return false;
+
+    return share_children(self, &root->super);
+}
+//------------------------------------------------------------------------------
+size_t nini_pool_purge(nini_pool_t *self)
+{
+    /**
+     * @memberof nini_pool_t
+     * @brief Remove sections not shared by any root.
+     *
+     * @param self Object instance.
+     * @return Count of sections removed.
+     */
+    size_t removed = 0;
+
+    nini_table_t *table = self->table;
+    if( !table ) return 0;
+
+    // A section removed may release the last references of its subsections.
+    bool changed = true;
+    while( changed )
+    {
+        changed = false;
+        for(size_t i = 0; i < table->capacity; )
+        {
+            nini_table_slot_t *slot   = &table->slots[i];
+            nini_shared_t     *shared = slot->item;
+            if( !shared || shared->refs > 1 )
+            {
+                ++ i;
+                continue;
+            }
+
+            // Another item may be moved to the slot, so that the slot is checked again.
+            nini_table_remove(table, slot);
+            nini_shared_unref(shared);
+            ++ removed;
+            changed = true;
+        }
+    }
+
+    return removed;
+}
+//------------------------------------------------------------------------------
+size_t nini_pool_get_count(const nini_pool_t *self)
+{
+    /**
+     * @memberof nini_pool_t
+     * @brief Get count of distinct sections in the pool.
+     *
+     * @param self Object instance.
+     * @return Count of sections.
+     */
+    return self->table ? self->table->count : 0;
+}
+//------------------------------------------------------------------------------
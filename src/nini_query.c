@@ -0,0 +1,224 @@
+#include <assert.h>
+#include <string.h>
+#include "nini_query.h"
+
+#define SEGMENT_NAME(query, i) ( (query)->pattern + (query)->segments[i].name )
+
+enum kind_t
+{
+    KIND_LITERAL,
+    KIND_ANY,         // "*"
+    KIND_ANY_LEVELS,  // "**"
+};
+
+//------------------------------------------------------------------------------
+bool nini_query_compile(nini_query_t *self, const char *pattern, char deli)
+{
+    /**
+     * @memberof nini_query_t
+     * @brief Compile a query pattern.
+     *
+     * @param self    Object instance.
+     * @param pattern The query pattern, see @ref query-pattern for more details.
+     * @param deli    The path delimiter.
+     * @return TRUE if succeed; and FALSE if the pattern is empty, too long,
+     *         have too many segments, or have empty names.
+     */
+    memset(self, 0, sizeof(*self));
+
+    if( !pattern || !pattern[0] ) return false;
+
+    size_t len = strlen(pattern);
+    if( len >= sizeof(self->pattern) ) return false;
+    memcpy(self->pattern, pattern, len + 1);
+
+    char *name = self->pattern;
+    while( name )
+    {
+        char *pos = strchr(name, deli);
+        if( pos ) *pos = 0;
+
+        if( !name[0] ) return false;
+
+        int kind;
+        if( 0 == strcmp(name, "*") )
+            kind = KIND_ANY;
+        else if( 0 == strcmp(name, "**") )
+            kind = KIND_ANY_LEVELS;
+        else
+            kind = KIND_LITERAL;
+
+        // Successive "**" are the same as one.
+        bool duplicated = kind == KIND_ANY_LEVELS &&
+                          self->count &&
+                          self->segments[ self->count - 1 ].kind == KIND_ANY_LEVELS;
+        if( !duplicated )
+        {
+            if( self->count >= NINI_MAX_QUERY_SEGMENTS ) return false;
+
+            self->segments[ self->count ].name = name - self->pattern;
+            self->segments[ self->count ].kind = kind;
+            ++ self->count;
+        }
+
+        name = pos ? pos + 1 : NULL;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t states_close(const nini_query_t *query, uint64_t states)
+{
+    // Segments of "**" can match zero level, so that the next segment will be active too.
+    for(unsigned i = 0; i < query->count; ++i)
+    {
+        if( ( states & ( 1ULL << i ) ) && query->segments[i].kind == KIND_ANY_LEVELS )
+            states |= 1ULL << ( i + 1 );
+    }
+
+    return states;
+}
+//------------------------------------------------------------------------------
+static
+uint64_t states_step(const nini_query_t *query, uint64_t states, const char *name)
+{
+    uint64_t next = 0;
+    for(unsigned i = 0; i < query->count; ++i)
+    {
+        if( !( states & ( 1ULL << i ) ) ) continue;
+
+        switch( query->segments[i].kind )
+        {
+        case KIND_LITERAL:
+            if( 0 == strcmp(SEGMENT_NAME(query, i), name) )
+                next |= 1ULL << ( i + 1 );
+            break;
+
+        case KIND_ANY:
+            next |= 1ULL << ( i + 1 );
+            break;
+
+        case KIND_ANY_LEVELS:
+            next |= 1ULL << i;
+            break;
+        }
+    }
+
+    return states_close(query, next);
+}
+//------------------------------------------------------------------------------
+static
+const char* states_get_literal(const nini_query_t *query, uint64_t states)
+{
+    // Return the name if all active segments are the same literal name,
+    // so that the child can be found by the child lookup instead of walking all children.
+    const char *literal = NULL;
+    for(unsigned i = 0; i < query->count; ++i)
+    {
+        if( !( states & ( 1ULL << i ) ) ) continue;
+
+        if( query->segments[i].kind != KIND_LITERAL ) return NULL;
+
+        if( !literal )
+            literal = SEGMENT_NAME(query, i);
+        else if( strcmp(literal, SEGMENT_NAME(query, i)) )
+            return NULL;
+    }
+
+    return literal;
+}
+//------------------------------------------------------------------------------
+static
+void push_frame(nini_query_iter_t *self, nini_node_t *parent, uint64_t states)
+{
+    if( !nini_node_have_child(parent) ) return;
+    if( self->depth >= NINI_MAX_PARSE_LEVEL )
+    {
+        // Children those are too deep are skipped, and the result is reported as truncated.
+        self->truncated = true;
+        return;
+    }
+
+    const char *literal = states_get_literal(self->query, states);
+
+    nini_query_frame_t *frame = &self->frames[ self->depth ++ ];
+    frame->states  = states;
+    frame->literal = literal;
+    frame->next    = literal ?
+                     nini_node_find_child(parent, literal) :
+                     nini_node_get_first_child(parent);
+}
+//------------------------------------------------------------------------------
+void nini_query_iter_init(nini_query_iter_t *self, const nini_query_t *query, nini_node_t *base)
+{
+    /**
+     * @memberof nini_query_iter_t
+     * @brief Start a query.
+     *
+     * @param self  Object instance.
+     * @param query The compiled query pattern,
+     *              and it must be valid during the life of the iterator.
+     * @param base  The node to start the query from,
+     *              and the query pattern is relative to this node.
+     *
+     * @remarks The iterator will not allocate any memory,
+     *          but the tree must not be modified during the iteration.
+     */
+    self->query     = query;
+    self->depth     = 0;
+    self->truncated = false;
+
+    if( query->count && base )
+        push_frame(self, base, states_close(query, 1));
+}
+//------------------------------------------------------------------------------
+nini_node_t* nini_query_iter_next(nini_query_iter_t *self)
+{
+    /**
+     * @memberof nini_query_iter_t
+     * @brief Get the next matched node.
+     *
+     * @param self Object instance.
+     * @return The next matched node in the document order; or
+     *         NULL if there are no more matched nodes.
+     */
+    const nini_query_t *query = self->query;
+    const uint64_t      final = 1ULL << query->count;
+
+    while( self->depth )
+    {
+        // Take the next candidate.
+
+        uint64_t     states;
+        nini_node_t *node;
+        {
+            nini_query_frame_t *frame = &self->frames[ self->depth - 1 ];
+
+            node = frame->next;
+            if( !node )
+            {
+                -- self->depth;
+                continue;
+            }
+
+            frame->next = frame->literal ? NULL : nini_node_get_next_sibling(node);
+            states      = frame->states;
+        }
+
+        // Match the candidate.
+
+        uint64_t next_states = states_step(query, states, nini_node_get_name(node));
+        if( !next_states ) continue;
+
+        // Only visit children those can be matched.
+        if( next_states & ~final )
+            push_frame(self, node, next_states & ~final);
+
+        if( next_states & final )
+            return node;
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,525 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_source.h"
+#include "nini_match.h"
+#include "nini_reloader.h"
+
+typedef struct nini_subscriber_t
+{
+    char             *prefix;
+    nini_on_change_t  on_change;
+    void             *arg;
+} nini_subscriber_t;
+
+typedef struct diff_t
+{
+    char deli;
+
+    nini_change_t *changes;
+    size_t         count;
+    size_t         capacity;
+
+    // Detached nodes referred by changes, and they will be released after the delivery.
+    nini_node_t **garbage;
+    size_t        garbage_count;
+    size_t        garbage_capacity;
+
+} diff_t;
+
+//------------------------------------------------------------------------------
+void nini_reloader_init(nini_reloader_t *self, nini_root_t *root, char deli)
+{
+    /**
+     * @memberof nini_reloader_t
+     * @brief Constructor.
+     *
+     * @param self Object instance.
+     * @param root The root to be reloaded.
+     * @param deli The path delimiter of changes and subscribed prefixes,
+     *             see @ref key-path for more details.
+     */
+    memset(self, 0, sizeof(*self));
+    self->root = root;
+    self->deli = deli;
+}
+//------------------------------------------------------------------------------
+void nini_reloader_deinit(nini_reloader_t *self)
+{
+    /**
+     * @memberof nini_reloader_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     */
+    for(size_t i = 0; i < self->count; ++i)
+        free(self->subscribers[i].prefix);
+
+    if( self->subscribers ) free(self->subscribers);
+
+    self->subscribers = NULL;
+    self->count       = 0;
+    self->capacity    = 0;
+}
+//------------------------------------------------------------------------------
+bool nini_reloader_subscribe(nini_reloader_t *self, const char *prefix, nini_on_change_t on_change, void *arg)
+{
+    /**
+     * @memberof nini_reloader_t
+     * @brief Subscribe changes under a path.
+     *
+     * @param self      Object instance.
+     * @param prefix    The path of the nodes to be watched,
+     *                  or an empty string to watch all nodes.
+     * @param on_change The function to be called with the matched changes of each reload.
+     * @param arg       The user defined argument to be passed to the change handler.
+     * @return TRUE if succeed; and FALSE if memory allocation failed.
+     *
+     * @remarks The prefix is matched by whole names,
+     *          for example, "video" matches "video" and "video/width", but not "videos".
+     */
+    if( self->count >= self->capacity )
+    {
+        size_t capacity = self->capacity ? 2 * self->capacity : 8;
+        nini_subscriber_t *subscribers = realloc(self->subscribers, capacity * sizeof(subscribers[0]));
+        if( !subscribers ) return false;
+
+        self->subscribers = subscribers;
+        self->capacity    = capacity;
+    }
+
+    size_t len = strlen(prefix);
+    char *copy = malloc(len + 1);
+    if( !copy ) return false;
+    memcpy(copy, prefix, len + 1);
+
+    nini_subscriber_t *subscriber = &self->subscribers[ self->count ++ ];
+    subscriber->prefix    = copy;
+    subscriber->on_change = on_change;
+    subscriber->arg       = arg;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_reloader_unsubscribe(nini_reloader_t *self, nini_on_change_t on_change, void *arg)
+{
+    /**
+     * @memberof nini_reloader_t
+     * @brief Remove all subscriptions of a change handler with the argument.
+     *
+     * @param self      Object instance.
+     * @param on_change The change handler.
+     * @param arg       The argument of the subscription.
+     */
+    size_t count = 0;
+    for(size_t i = 0; i < self->count; ++i)
+    {
+        nini_subscriber_t *subscriber = &self->subscribers[i];
+        if( subscriber->on_change == on_change && subscriber->arg == arg )
+            free(subscriber->prefix);
+        else
+            self->subscribers[ count ++ ] = *subscriber;
+    }
+
+    self->count = count;
+}
+//------------------------------------------------------------------------------
+static
+void diff_deinit(diff_t *diff)
+{
+    for(size_t i = 0; i < diff->count; ++i)
+        free((char*) diff->changes[i].path);
+
+    for(size_t i = 0; i < diff->garbage_count; ++i)
+        nini_node_release(diff->garbage[i]);
+
+    if( diff->changes ) free(diff->changes);
+    if( diff->garbage ) free(diff->garbage);
+}
+//------------------------------------------------------------------------------
+static
+char* make_path(const diff_t *diff, const char *parent_path, const char *name)
+{
+    size_t parent_len = parent_path ? strlen(parent_path) : 0;
+    size_t name_len   = strlen(name);
+
+    char *path = malloc(parent_len + 1 + name_len + 1);
+    if( !path ) return NULL;
+
+    char *pos = path;
+    if( parent_path )
+    {
+        memcpy(pos, parent_path, parent_len);
+        pos += parent_len;
+        *pos ++ = diff->deli;
+    }
+
+    memcpy(pos, name, name_len + 1);
+
+    return path;
+}
+//------------------------------------------------------------------------------
+static
+bool add_garbage(diff_t *diff, nini_node_t *node)
+{
+    if( diff->garbage_count >= diff->garbage_capacity )
+    {
+        size_t capacity = diff->garbage_capacity ? 2 * diff->garbage_capacity : 16;
+        nini_node_t **garbage = realloc(diff->garbage, capacity * sizeof(garbage[0]));
+        if( !garbage ) return false;
+
+        diff->garbage          = garbage;
+        diff->garbage_capacity = capacity;
+    }
+
+    diff->garbage[ diff->garbage_count ++ ] = node;
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool add_change(diff_t             *diff,
+                nini_change_type_t  type,
+                const char         *parent_path,
+                const char         *name,
+                nini_node_t        *old_node,
+                nini_node_t        *new_node)
+{
+    // The old node will be released after the delivery.
+    if( old_node && !add_garbage(diff, old_node) )
+    {
+        nini_node_release(old_node);
+        return false;
+    }
+
+    if( diff->count >= diff->capacity )
+    {
+        size_t capacity = diff->capacity ? 2 * diff->capacity : 16;
+        nini_change_t *changes = realloc(diff->changes, capacity * sizeof(changes[0]));
+        if( !changes ) return false;
+
+        diff->changes  = changes;
+        diff->capacity = capacity;
+    }
+
+    char *path = make_path(diff, parent_path, name);
+    if( !path ) return false;
+
+    nini_change_t *change = &diff->changes[ diff->count ++ ];
+    change->type     = type;
+    change->path     = path;
+    change->old_node = old_node;
+    change->new_node = new_node;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool is_section(const nini_node_t *node)
+{
+    return node->type == NINI_SECTION;
+}
+//------------------------------------------------------------------------------
+static
+bool same_value(const nini_node_t *node, const nini_node_t *other)
+{
+    if( node->type != other->type ) return false;
+
+    switch( node->type )
+    {
+    case NINI_STRING:
+        return 0 == strcmp(node->value.string, other->value.string);
+
+    case NINI_DECIMAL:
+    case NINI_HEXA:
+        return node->value.integer == other->value.integer;
+
+    case NINI_FLOAT:
+        return 0 == memcmp(&node->value.floating, &other->value.floating, sizeof(node->value.floating));
+
+    case NINI_BOOL:
+        return node->value.boolean == other->value.boolean;
+
+    default:
+        return true;
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool diff_section(diff_t *diff, nini_node_t *old_parent, nini_node_t *new_parent, const char *path);
+//------------------------------------------------------------------------------
+static
+nini_node_t* diff_child(diff_t      *diff,
+                        nini_node_t *old_parent,
+                        nini_node_t *old_node,
+                        nini_node_t *new_node,
+                        const char  *path)
+{
+    // Return the node in the old tree that corresponds to the new node, or NULL if failed.
+    if( !old_node )
+    {
+        nini_node_t *node = nini_node_clone(new_node);
+        if( !node || !nini_node_link_child(old_parent, node) )
+        {
+            nini_node_release(node);
+            return NULL;
+        }
+
+        return add_change(diff, NINI_INSERTED, path, node->name, NULL, node) ? node : NULL;
+    }
+
+    if( is_section(old_node) && is_section(new_node) )
+    {
+        char *child_path = make_path(diff, path, old_node->name);
+        if( !child_path ) return NULL;
+
+        bool succ = diff_section(diff, old_node, new_node, child_path);
+        free(child_path);
+
+        return succ ? old_node : NULL;
+    }
+
+    if( !is_section(old_node) && !is_section(new_node) )
+    {
+        if( same_value(old_node, new_node) ) return old_node;
+
+        nini_node_t *old_value = nini_node_clone(old_node);
+        if( !old_value ) return NULL;
+
+        if( !nini_node_copy_value(old_node, new_node) )
+        {
+            nini_node_release(old_value);
+            return NULL;
+        }
+
+        return add_change(diff, NINI_UPDATED, path, old_node->name, old_value, old_node) ? old_node : NULL;
+    }
+
+    // A key becomes a section, or a section becomes a key.
+    nini_node_t *node = nini_node_clone(new_node);
+    if( !node || !nini_node_replace(old_node, node) )
+    {
+        nini_node_release(node);
+        return NULL;
+    }
+
+    return add_change(diff, NINI_UPDATED, path, node->name, old_node, node) ? node : NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool diff_section(diff_t *diff, nini_node_t *old_parent, nini_node_t *new_parent, const char *path)
+{
+    // Sections with the same content hash have nothing to be changed.
+    if( nini_node_get_hash(old_parent) == nini_node_get_hash(new_parent) ) return true;
+
+    // Children of a shared section are copied before they be changed.
+    if( !nini_node_unshare(old_parent) ) return false;
+
+    nini_match_t match;
+    if( !nini_match_init(&match, old_parent, new_parent) ) return false;
+
+    // The result node of each new child.
+    nini_node_t **results = match.new_count ? malloc(match.new_count * sizeof(results[0])) : NULL;
+
+    bool succ = false;
+    do
+    {
+        if( match.new_count && !results ) break;
+
+        // Delete the unmatched old children in their order.
+        size_t i;
+        for(i = 0; i < match.old_count; ++i)
+        {
+            nini_node_t *node = (nini_node_t*) match.olds[i];
+            if( match.old_matches[i] != NINI_MATCH_NONE ) continue;
+
+            if( !nini_node_unlink(node) ) break;
+            if( !add_change(diff, NINI_DELETED, path, node->name, node, NULL) ) break;
+        }
+        if( i < match.old_count ) break;
+
+        // Update and insert children by the new sibling order.
+        size_t pos;
+        for(pos = 0; pos < match.new_count; ++pos)
+        {
+            size_t       old_pos  = match.new_matches[pos];
+            nini_node_t *old_node = old_pos == NINI_MATCH_NONE ? NULL : (nini_node_t*) match.olds[old_pos];
+            nini_node_t *new_node = (nini_node_t*) match.news[pos];
+
+            if( !( results[pos] = diff_child(diff, old_parent, old_node, new_node, path) ) ) break;
+        }
+        if( pos < match.new_count ) break;
+
+        // Move children to the new sibling order.
+        nini_node_t *prev = NULL;
+        for(pos = 0; pos < match.new_count; ++pos)
+        {
+            if( results[pos]->prev != prev && !nini_node_move_after(results[pos], prev) ) break;
+            prev = results[pos];
+        }
+        if( pos < match.new_count ) break;
+
+        succ = true;
+    } while(false);
+
+    if( results ) free(results);
+    nini_match_deinit(&match);
+
+    return succ;
+}
+//------------------------------------------------------------------------------
+static
+void take_spans(nini_node_t *node, const nini_node_t *new_node)
+{
+    // The trees must have the same structure.
+    node->span = new_node->span;
+
+    const nini_node_t *new_child = nini_node_get_first_child_c(new_node);
+    for(nini_node_t *child = nini_node_get_first_child(node);
+        child && new_child;
+        child = nini_node_get_next_sibling(child), new_child = nini_node_get_next_sibling_c(new_child))
+    {
+        take_spans(child, new_child);
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool match_prefix(const char *prefix, const char *path, char deli)
+{
+    // Match if one of the paths is the other one or an ancestor of the other one.
+    size_t prefix_len = strlen(prefix);
+    size_t path_len   = strlen(path);
+    if( !prefix_len ) return true;
+
+    if( prefix_len == path_len ) return 0 == strcmp(prefix, path);
+    if( prefix_len < path_len  ) return 0 == strncmp(prefix, path, prefix_len) && path[prefix_len] == deli;
+    return 0 == strncmp(prefix, path, path_len) && prefix[path_len] == deli;
+}
+//------------------------------------------------------------------------------
+static
+void deliver(const nini_reloader_t *self, const diff_t *diff)
+{
+    if( !diff->count ) return;
+
+    nini_change_t *matched = malloc(diff->count * sizeof(matched[0]));
+    if( !matched ) return;
+
+    for(size_t i = 0; i < self->count; ++i)
+    {
+        const nini_subscriber_t *subscriber = &self->subscribers[i];
+
+        size_t count = 0;
+        for(size_t k = 0; k < diff->count; ++k)
+        {
+            if( match_prefix(subscriber->prefix, diff->changes[k].path, self->deli) )
+                matched[ count ++ ] = diff->changes[k];
+        }
+
+        if( count ) subscriber->on_change(subscriber->arg, matched, count);
+    }
+
+    free(matched);
+}
+//------------------------------------------------------------------------------
+static
+bool apply(nini_reloader_t *self, nini_root_t *temp, nini_errmsg_t *errmsg)
+{
+    nini_root_t *root = self->root;
+
+    // The source of the root will be replaced by the new one.
+    nini_source_release(root->source, &root->super);
+    root->source = NULL;
+
+    diff_t diff;
+    memset(&diff, 0, sizeof(diff));
+    diff.deli = self->deli;
+
+    bool succ = diff_section(&diff, &root->super, &temp->super, NULL);
+    if( succ && temp->source )
+    {
+        take_spans(&root->super, &temp->super);
+        root->source = temp->source;
+        temp->source = NULL;
+    }
+
+    deliver(self, &diff);
+    diff_deinit(&diff);
+
+    if( !succ )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+    if( errmsg )
+        memset(errmsg, 0, sizeof(*errmsg));
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool prepare(nini_reloader_t *self, nini_root_t *temp, nini_errmsg_t *errmsg)
+{
+    if( nini_root_is_frozen(self->root) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
+    nini_root_init(temp, &self->root->format);
+    if( nini_root_is_lossless(self->root) ) nini_root_enable_lossless(temp);
+    nini_root_set_duplicates(temp, nini_root_get_duplicates(self->root));
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_reloader_decode(nini_reloader_t *self, const void *data, size_t size, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_reloader_t
+     * @brief Decode the NINI format data, and apply the differences to the root.
+     *
+     * @param self   Object instance.
+     * @param data   The NINI format data to be parsed.
+     * @param size   Size of the input data.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The root will not be changed if the decode failed.
+     *          If the memory allocation failed while the differences be applied,
+     *          the root may be partially changed, and the applied changes will still be reported.
+     */
+    nini_root_t temp;
+    if( !prepare(self, &temp, errmsg) ) return false;
+
+    bool res = nini_root_decode(&temp, data, size, errmsg) && apply(self, &temp, errmsg);
+    nini_root_deinit(&temp);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+bool nini_reloader_load_file(nini_reloader_t *self, const char *filename, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_reloader_t
+     * @brief Load the NINI format file, and apply the differences to the root.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the input file.
+     * @param errmsg   The object that will be filled with failure information if failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The root will not be changed if the file cannot be loaded,
+     *          see nini_reloader_decode for more details.
+     */
+    nini_root_t temp;
+    if( !prepare(self, &temp, errmsg) ) return false;
+
+    bool res = nini_root_load_file(&temp, filename, errmsg) && apply(self, &temp, errmsg);
+    nini_root_deinit(&temp);
+
+    return res;
+}
+//------------------------------------------------------------------------------
@@ -4,54 +4,17 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "nini_parser.h"
+#include "nini_atomic.h"
+#include "nini_encoder.h"
+#include "nini_parallel.h"
+#include "nini_names.h"
+#include "nini_phash.h"
+#include "nini_source.h"
 #include "nini_root.h"
 
-typedef struct buffer_stream_t
-{
-    uint8_t *buf;
-    size_t   rest_size;
-    size_t   write_size;
-} buffer_stream_t;
-
-//------------------------------------------------------------------------------
-static
-void buffer_stream_init(buffer_stream_t *stream, void *buf, size_t size)
-{
-    stream->buf        = buf;
-    stream->rest_size  = size;
-    stream->write_size = 0;
-}
-//------------------------------------------------------------------------------
-static
-size_t buffer_stream_get_write_size(const buffer_stream_t *stream)
-{
-    return stream->write_size;
-}
-//------------------------------------------------------------------------------
-static
-bool buffer_stream_push_data(buffer_stream_t *stream, const void *data, size_t size)
-{
-    if( stream->rest_size < size ) return false;
-
-    memcpy(stream->buf, data, size);
-    stream->buf        += size;
-    stream->rest_size  -= size;
-    stream->write_size += size;
+#define MERGE_TRACK_LEVELS  16  // Levels of parents those lookups are counted by a merge.
+#define MERGE_INDEX_LOOKUPS 8   // Lookups in a parent before a merge enables its index.
 
-    return true;
-}
-//------------------------------------------------------------------------------
-static
-bool buffer_stream_push_str(buffer_stream_t *stream, const char *str)
-{
-    return buffer_stream_push_data(stream, str, strlen(str));
-}
-//------------------------------------------------------------------------------
-static
-bool buffer_stream_push_ch(buffer_stream_t *stream, char ch)
-{
-    return buffer_stream_push_data(stream, &ch, 1);
-}
 //------------------------------------------------------------------------------
 void nini_root_init(nini_root_t *self, const nini_format_t *format)
 {
@@ -77,6 +40,7 @@ void nini_root_deinit(nini_root_t *self)
      *
      * @param self Object instance.
      */
+    nini_root_thaw(self);
     nini_root_clear(self);
 }
 //------------------------------------------------------------------------------
@@ -87,7 +51,18 @@ void nini_root_clear(nini_root_t *self)
      * @brief Remove all children it contained.
      *
      * @param self Object instance.
+     *
+     * @remarks The ordered children index will be kept enabled if it was enabled.
+     *          And nothing will be done if the root is frozen.
      */
+    if( nini_root_is_frozen(self) ) return;
+
+    nini_source_release(self->source, &self->super);
+    self->source = NULL;
+
+    bool have_index = nini_node_have_index(&self->super);
+    nini_node_disable_index(&self->super);
+
     nini_node_t *node = nini_node_get_first_child(&self->super);
     while( node )
     {
@@ -99,15 +74,80 @@ void nini_root_clear(nini_root_t *self)
 
     self->super.childs.first = NULL;
     self->super.childs.last  = NULL;
+    self->super.hashed       = false;
+
+    if( have_index )
+        nini_node_enable_index(&self->super);
 }
 //------------------------------------------------------------------------------
 static
-nini_node_t* decode_on_item(nini_root_t         *self,
-                            nini_node_t         *parent,
-                            int                  level,
-                            nini_type_t          type,
-                            const char          *name,
-                            nini_parser_value_t *value)
+void set_frozen(nini_node_t *parent, bool frozen)
+{
+    // Shared sections are always frozen.
+    if( nini_node_is_shared(parent) ) return;
+
+    parent->frozen = frozen;
+
+    for(nini_node_t *node = nini_node_get_first_child(parent);
+        node;
+        node = nini_node_get_next_sibling(node))
+    {
+        if( nini_node_have_child(node) )
+            set_frozen(node, frozen);
+    }
+}
+//------------------------------------------------------------------------------
+bool nini_root_freeze(nini_root_t *self, char deli)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Freeze the root to be read-only, and build an index of full key paths.
+     * @details After the root be frozen,
+     *          paths with the same delimiter can be found by a perfect hash lookup
+     *          instead of finding children level by level,
+     *          and all operations that modify children will fail.
+     *
+     * @param self Object instance.
+     * @param deli The path delimiter to build the index,
+     *             see @ref key-path for more details.
+     * @return TRUE if succeed; and FALSE if memory allocation failed.
+     *
+     * @remarks The index will be rebuilt if the root is already frozen with
+     *          a different delimiter.
+     */
+    if( self->phash && self->phash->deli == deli ) return true;
+
+    nini_phash_t *phash = nini_phash_create(&self->super, deli);
+    if( !phash ) return false;
+
+    nini_phash_release(self->phash);
+    self->phash = phash;
+
+    // Hashes will be read only after the root be frozen.
+    nini_node_get_hash(&self->super);
+    set_frozen(&self->super, true);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_root_thaw(nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Release the index of full key paths, and let the root be modifiable.
+     *
+     * @param self Object instance.
+     */
+    if( !nini_root_is_frozen(self) ) return;
+
+    nini_phash_release(self->phash);
+    self->phash = NULL;
+
+    set_frozen(&self->super, false);
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* create_node(nini_type_t type, const char *name, const nini_parser_value_t *value)
 {
     nini_node_t *node;
     switch( type )
@@ -145,19 +185,310 @@ nini_node_t* decode_on_item(nini_root_t         *self,
         break;
     }
 
-    if( node )
+    return node;
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* link_new_node(nini_node_t         *parent,
+                           nini_type_t          type,
+                           const char          *name,
+                           nini_parser_value_t *value)
+{
+    nini_node_t *node = create_node(type, name, value);
+    if( node && !nini_node_link_child(parent, node) )
     {
-        parent = parent ? parent : &self->super;
-        if( !nini_node_link_child(parent, node) )
-        {
-            nini_node_release(node);
-            node = NULL;
-        }
+        nini_node_release(node);
+        node = NULL;
     }
 
     return node;
 }
 //------------------------------------------------------------------------------
+typedef struct node_list_t
+{
+    nini_node_t **items;
+    size_t        count;
+    size_t        capacity;
+} node_list_t;
+//------------------------------------------------------------------------------
+static
+bool node_list_push(node_list_t *list, nini_node_t *node)
+{
+    if( list->count >= list->capacity )
+    {
+        size_t capacity = list->capacity ? 2 * list->capacity : 16;
+        nini_node_t **items = realloc(list->items, capacity * sizeof(items[0]));
+        if( !items ) return false;
+
+        list->items    = items;
+        list->capacity = capacity;
+    }
+
+    list->items[ list->count ++ ] = node;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+typedef struct decode_t
+{
+    nini_root_t       *root;
+    nini_duplicates_t  duplicates;  // The policy applied by this decode.
+    nini_names_t       names;
+    node_list_t        replaced;    // Nodes unlinked by the decode, they are released at the end.
+    nini_node_t       *discard;     // The detached holder of dropped items, NULL if nothing dropped.
+    bool               duplicated;  // The decode failed by a duplicate name.
+} decode_t;
+//------------------------------------------------------------------------------
+static
+void decode_init(decode_t *decode, nini_root_t *root, nini_duplicates_t duplicates)
+{
+    memset(decode, 0, sizeof(*decode));
+    decode->root       = root;
+    decode->duplicates = duplicates;
+    nini_names_init(&decode->names);
+}
+//------------------------------------------------------------------------------
+static
+void decode_deinit(decode_t *decode)
+{
+    for(size_t i = 0; i < decode->replaced.count; ++i)
+        nini_node_release(decode->replaced.items[i]);
+    if( decode->replaced.items ) free(decode->replaced.items);
+
+    if( decode->discard ) nini_node_release(decode->discard);
+
+    nini_names_deinit(&decode->names);
+}
+//------------------------------------------------------------------------------
+static
+void decode_get_errmsg(const decode_t *decode, const nini_parser_t *parser, nini_errmsg_t *errmsg)
+{
+    if( !errmsg ) return;
+
+    nini_parser_get_errmsg(parser, errmsg);
+    if( decode->duplicated )
+        nini_errmsg_write(errmsg, parser->errmsg.line_num, parser->errmsg.line_text, "Duplicate name!");
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* drop_item(decode_t            *decode,
+                       nini_type_t          type,
+                       const char          *name,
+                       nini_parser_value_t *value)
+{
+    /*
+     * Dropped items are created with their own types under a detached section,
+     * so that their children are parsed and checked the same as other items,
+     * for example, items under a dropped key are still reported as errors.
+     */
+    if( !decode->discard && !( decode->discard = nini_node_create_section("") ) ) return NULL;
+
+    return link_new_node(decode->discard, type, name, value);
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* replace_item(decode_t            *decode,
+                          nini_table_slot_t   *entry,
+                          nini_type_t          type,
+                          const char          *name,
+                          nini_parser_value_t *value)
+{
+    nini_node_t *old  = entry->item;
+    nini_node_t *node = create_node(type, name, value);
+    if( !node ) return NULL;
+
+    if( type != NINI_SECTION && old->type != NINI_SECTION )
+    {
+        // The key keeps its position, and its value is replaced.
+        bool res = nini_node_copy_value(old, node);
+        nini_node_release(node);
+
+        return res ? old : NULL;
+    }
+
+    // Nodes replaced are released at the end,
+    // so that the names table never refers to a released node.
+    if( !node_list_push(&decode->replaced, old) )
+    {
+        nini_node_release(node);
+        return NULL;
+    }
+
+    if( !nini_node_replace(old, node) )
+    {
+        -- decode->replaced.count;
+        nini_node_release(node);
+        return NULL;
+    }
+
+    entry->item = node;
+
+    return node;
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* decode_on_item(decode_t            *decode,
+                            nini_node_t         *parent,
+                            int                  level,
+                            nini_type_t          type,
+                            const char          *name,
+                            nini_parser_value_t *value)
+{
+    if( decode->duplicates == NINI_DUPLICATES_KEEP_ALL )
+        return link_new_node(parent ? parent : &decode->root->super, type, name, value);
+
+    parent = parent ? parent : &decode->root->super;
+
+    // Only sections are checked when keys with the same name are all kept.
+    bool is_section = ( type == NINI_SECTION );
+    if( decode->duplicates == NINI_DUPLICATES_MERGE_SECTIONS && !is_section )
+        return link_new_node(parent, type, name, value);
+
+    uint64_t           hash  = nini_names_hash(parent, name);
+    nini_table_slot_t *entry = nini_names_find(&decode->names, parent, name, hash);
+    if( !entry )
+    {
+        nini_node_t *node = link_new_node(parent, type, name, value);
+        if( !node ) return NULL;
+
+        return nini_names_insert(&decode->names, node, hash) ? node : NULL;
+    }
+
+    if( decode->duplicates == NINI_DUPLICATES_ERROR )
+    {
+        decode->duplicated = true;
+        return NULL;
+    }
+
+    nini_node_t *node = entry->item;
+    if( is_section && node->type == NINI_SECTION ) return node;
+
+    return decode->duplicates == NINI_DUPLICATES_FIRST_WINS ?
+           drop_item(decode, type, name, value) : replace_item(decode, entry, type, name, value);
+}
+//------------------------------------------------------------------------------
+typedef struct lossless_decode_t
+{
+    decode_t               decode;
+    const nini_parser_t   *parser;
+    nini_source_builder_t  builder;
+} lossless_decode_t;
+//------------------------------------------------------------------------------
+static
+nini_node_t* lossless_decode_on_item(lossless_decode_t   *lossless,
+                                     nini_node_t         *parent,
+                                     int                  level,
+                                     nini_type_t          type,
+                                     const char          *name,
+                                     nini_parser_value_t *value)
+{
+    nini_node_t *node = decode_on_item(&lossless->decode, parent, level, type, name, value);
+    if( !node ) return NULL;
+
+    // The item event is raised at the end of the line.
+    size_t line = lossless->parser->line_offset;
+    size_t tail = line + lossless->parser->line.len;
+
+    return nini_source_builder_add(&lossless->builder, node, line, tail) ? node : NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool decode_lossless(nini_root_t *self, const void *data, size_t size, nini_errmsg_t *errmsg)
+{
+    nini_parser_t parser;
+
+    // Each node keeps its own source lines, so that duplicates can only be kept or be reported.
+    lossless_decode_t lossless;
+    decode_init(&lossless.decode,
+                self,
+                self->duplicates == NINI_DUPLICATES_ERROR ? NINI_DUPLICATES_ERROR : NINI_DUPLICATES_KEEP_ALL);
+    lossless.parser = &parser;
+    nini_source_builder_init(&lossless.builder);
+
+    nini_parser_init(&parser,
+                     &self->format,
+                     &lossless,
+                     (void*(*)(void*,void*,int,nini_type_t,const char*,nini_parser_value_t*)) lossless_decode_on_item);
+
+    bool res = nini_parser_parse(&parser, data, size);
+    decode_get_errmsg(&lossless.decode, &parser, errmsg);
+
+    if( res && !( self->source = nini_source_create(&lossless.builder, &self->super, data, size) ) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        res = false;
+    }
+
+    nini_source_builder_deinit(&lossless.builder);
+    decode_deinit(&lossless.decode);
+    if( !res ) nini_root_clear(self);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+void nini_root_enable_lossless(nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Enable the lossless mode.
+     * @details In the lossless mode, the decoded data will be kept as the source of the nodes,
+     *          and the source lines of unchanged nodes will be copied verbatim when encoding,
+     *          so that comments and the original formatting will be kept,
+     *          and only the changed nodes will be formatted again.
+     *
+     * @param self Object instance.
+     *
+     * @remarks The mode takes effect from the next decode.
+     * @remarks Nodes linked or replaced by nini_node_link_child and nini_node_replace
+     *          (and the helper functions) are changes of their parent,
+     *          and a node loses its source line when it be unlinked from the root.
+     *          Comments in front of a removed node will be removed together.
+     * @remarks The data will be encoded serially even by the parallel encode functions,
+     *          because most of the data are copied from the source.
+     */
+    self->lossless = true;
+}
+//------------------------------------------------------------------------------
+void nini_root_disable_lossless(nini_root_t *self)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Disable the lossless mode, and release the source data.
+     *
+     * @param self Object instance.
+     */
+    self->lossless = false;
+
+    nini_source_release(self->source, &self->super);
+    self->source = NULL;
+}
+//------------------------------------------------------------------------------
+void nini_root_set_duplicates(nini_root_t *self, nini_duplicates_t policy)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Set the policy of items with the same name in a section.
+     * @details The policy is applied while the data is parsed,
+     *          and names are detected by a hash table, so that the decode stays linear.
+     *          A data with heavy duplication is decoded into a compact tree
+     *          by any policy other than NINI_DUPLICATES_KEEP_ALL.
+     *
+     *          A key and a section with the same name are duplicates of each other,
+     *          and a later one replaces an earlier one by NINI_DUPLICATES_LAST_WINS.
+     *          A key replaced by NINI_DUPLICATES_LAST_WINS keeps its position,
+     *          and the key has the last value.
+     *
+     * @param self   Object instance.
+     * @param policy The policy, and the default is NINI_DUPLICATES_KEEP_ALL.
+     *
+     * @remarks The policy takes effect from the next decode.
+     * @remarks In the lossless mode, each node keeps the source lines of its own (see nini_root_enable_lossless),
+     *          so that all policies keep all items except NINI_DUPLICATES_ERROR.
+     * @remarks A merge (see nini_root_merge) always merges items with the same name.
+     */
+    self->duplicates = policy;
+}
+//------------------------------------------------------------------------------
 bool nini_root_decode(nini_root_t *self, const void *data, size_t size, nini_errmsg_t *errmsg)
 {
     /**
@@ -174,206 +505,215 @@ bool nini_root_decode(nini_root_t *self, const void *data, size_t size, nini_err
      *
      * @remarks This function is not atomic,
      *          and all values it contained will be removed if decode failed.
+     *          The decode will fail without any change if the root is frozen.
      */
+    if( nini_root_is_frozen(self) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
     nini_root_clear(self);
 
     if( !data || !size ) return true;
 
+    if( self->lossless ) return decode_lossless(self, data, size, errmsg);
+
+    decode_t decode;
+    decode_init(&decode, self, self->duplicates);
+
     nini_parser_t parser;
     nini_parser_init(&parser,
                      &self->format,
-                     self,
+                     &decode,
                      (void*(*)(void*,void*,int,nini_type_t,const char*,nini_parser_value_t*)) decode_on_item);
 
     bool res = nini_parser_parse(&parser, data, size);
-    if( errmsg ) nini_parser_get_errmsg(&parser, errmsg);
+    decode_get_errmsg(&decode, &parser, errmsg);
 
+    decode_deinit(&decode);
     if( !res ) nini_root_clear(self);
 
     return res;
 }
 //------------------------------------------------------------------------------
+typedef struct merge_decode_t
+{
+    nini_root_t *root;
+    node_list_t  replaced;  // Nodes unlinked by the merge, they are released at the end.
+
+    nini_node_t *parents[MERGE_TRACK_LEVELS];   // The last parent of items of each level,
+    unsigned     lookups[MERGE_TRACK_LEVELS];   // and count of lookups in it.
+} merge_decode_t;
+//------------------------------------------------------------------------------
 static
-void encode_char_with_escapes(char *dest, size_t bufsize, char ch)
+nini_node_t* merge_find_child(merge_decode_t *merge, nini_node_t *parent, int level, const char *name)
 {
-    const char *predefined;
-    switch( ch )
+    /*
+     * A parent is indexed after a few lookups, so that each item of a wide section costs O(log n),
+     * and sections with only a few items merged are not indexed.
+     * The index is kept after the merge, so that the sort is paid once for each section.
+     */
+    if( level < MERGE_TRACK_LEVELS && !nini_node_have_index(parent) )
     {
-    case 0x07:
-        predefined = "\\a";
-        break;
-
-    case 0x08:
-        predefined = "\\b";
-        break;
-
-    case 0x0C:
-        predefined = "\\f";
-        break;
-
-    case 0x0A:
-        predefined = "\\n";
-        break;
+        if( merge->parents[level] != parent )
+        {
+            merge->parents[level] = parent;
+            merge->lookups[level] = 0;
+        }
 
-    case 0x0D:
-        predefined = "\\r";
-        break;
+        if( ++ merge->lookups[level] > MERGE_INDEX_LOOKUPS )
+            nini_node_enable_index(parent);
+    }
 
-    case 0x09:
-        predefined = "\\t";
-        break;
+    return nini_node_find_child(parent, name);
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* merge_on_item(merge_decode_t      *merge,
+                           nini_node_t         *parent,
+                           int                  level,
+                           nini_type_t          type,
+                           const char          *name,
+                           nini_parser_value_t *value)
+{
+    parent = parent ? parent : &merge->root->super;
+    if( !nini_node_unshare(parent) ) return NULL;
 
-    case 0x0B:
-        predefined = "\\v";
-        break;
+    nini_node_t *old        = merge_find_child(merge, parent, level, name);
+    bool         is_section = ( type == NINI_SECTION );
 
-    case '\'':
-        predefined = "\\\'";
-        break;
+    if( old && is_section && old->type == NINI_SECTION ) return old;
 
-    case '\"':
-        predefined = "\\\"";
-        break;
+    nini_node_t *node = create_node(type, name, value);
+    if( !node ) return NULL;
 
-    case '\\':
-        predefined = "\\\\";
-        break;
+    if( old && !is_section && old->type != NINI_SECTION )
+    {
+        // The key keeps its address, so that the node pointers held by others remain valid.
+        bool res = nini_node_copy_value(old, node);
+        nini_node_release(node);
 
-    default:
-        predefined = NULL;
-        break;
+        return res ? old : NULL;
     }
 
-    if( predefined )
-    {
-        strncpy(dest, predefined, bufsize);
-    }
-    else if( ch < 0x20 || 0x7F <= ch )
+    if( !old )
     {
-        snprintf(dest, bufsize, "\\x%02X", (unsigned)(uint8_t)ch);
+        if( nini_node_link_child(parent, node) ) return node;
+
+        nini_node_release(node);
+        return NULL;
     }
-    else
+
+    // The type of the node changed between a key and a section.
+    if( !node_list_push(&merge->replaced, old) )
     {
-        dest[0] = ch;
-        dest[1] = 0;
+        nini_node_release(node);
+        return NULL;
     }
-}
-//------------------------------------------------------------------------------
-static
-int encode_quoted_string(char *buf, size_t bufsize, const char *src)
-{
-    buffer_stream_t stream;
-    buffer_stream_init(&stream, buf, bufsize);
 
-    if( !buffer_stream_push_ch(&stream, ' ') ) return -1;
-    if( !buffer_stream_push_ch(&stream, '\"') ) return -1;
-
-    for(; *src; ++src)
+    if( !nini_node_replace(old, node) )
     {
-        char encstr[4+1];
-        encode_char_with_escapes(encstr, sizeof(encstr), *src);
-
-        if( !buffer_stream_push_str(&stream, encstr) )
-            return -1;
+        -- merge->replaced.count;
+        nini_node_release(node);
+        return NULL;
     }
 
-    if( !buffer_stream_push_ch(&stream, '\"') ) return -1;
-    if( !buffer_stream_push_ch(&stream, 0) ) return -1;
-
-    return buffer_stream_get_write_size(&stream);
+    return node;
 }
 //------------------------------------------------------------------------------
 static
-bool encode_value(char *buf, size_t bufsize, const nini_node_t *node)
+void* verify_on_item(void                *userarg,
+                     void                *parent,
+                     int                  level,
+                     nini_type_t          type,
+                     const char          *name,
+                     nini_parser_value_t *value)
 {
-    int fillsize;
-    switch( nini_node_get_type(node) )
-    {
-    case NINI_STRING:
-        fillsize = encode_quoted_string(buf, bufsize, nini_node_get_string(node));
-        break;
-
-    case NINI_DECIMAL:
-        fillsize = snprintf(buf, bufsize, " %ld", nini_node_get_integer(node));
-        break;
-
-    case NINI_HEXA:
-        fillsize = snprintf(buf, bufsize, " 0x%lX", nini_node_get_integer(node));
-        break;
-
-    case NINI_FLOAT:
-        fillsize = snprintf(buf, bufsize, " %lf", nini_node_get_float(node));
-        break;
+    // Items are tagged by their types instead of nodes,
+    // and an item under a key fails as it does in the decode.
+    enum { SECTION_TAG = 1, KEY_TAG };
+    if( parent == (void*)(uintptr_t) KEY_TAG ) return NULL;
 
-    case NINI_BOOL:
-        fillsize = snprintf(buf, bufsize, " %s", nini_node_get_bool(node) ? "true" : "false");
-        break;
-
-    default:
-        buf[0] = 0;
-        fillsize = 1;
-        break;
-    }
-
-    return 0 < fillsize && fillsize <= bufsize;
+    return (void*)(uintptr_t)( type == NINI_SECTION ? SECTION_TAG : KEY_TAG );
 }
 //------------------------------------------------------------------------------
-static
-size_t encode_node(const nini_format_t *format,
-                   void                *stream,
-                   nini_on_write_t      on_write,
-                   int                  level,
-                   const nini_node_t   *node)
+bool nini_root_merge(nini_root_t *self, const void *data, size_t size, nini_errmsg_t *errmsg)
 {
-    // Generate indents.
-    char indents[NINI_MAX_LINE_CHARS+1] = {0};
-    for(int i = 0; i < format->indent * level; ++i)
-        indents[i] = ' ';
-
-    // Generate name.
-    char name[NINI_MAX_LINE_CHARS+1];
-    if( nini_node_get_type(node) == NINI_SECTION )
+    /**
+     * @memberof nini_root_t
+     * @brief Decode the NINI format data on top of the current values.
+     * @details Items of the data override the current values as they are parsed:
+     *          * A section is merged into the section with the same name.
+     *          * A key replaces the value of the key with the same name,
+     *            and the key node keeps its position and its address.
+     *          * A node replaces the node with the same name at the same position
+     *            if one is a key and the other is a section.
+     *          * Other nodes are added after the children of their parent.
+     *
+     *          Items with the same name in the data are merged in the same way,
+     *          so that the last value wins.
+     *
+     *          Children of a section are searched linearly for the first few items merged into it,
+     *          and then the section is indexed (see nini_node_enable_index),
+     *          so that each further item costs O(log n) on the count of children of the section.
+     *          Indexing a section costs O(n log n) once, and the index is kept after the merge,
+     *          so that later merges into the same section cost O(log n) for each item.
+     *          Sections with only a few items merged are not indexed,
+     *          and each of their items costs O(n) on the count of children.
+     *
+     * @param self   Object instance.
+     * @param data   The NINI format data to be merged.
+     * @param size   Size of the input data.
+     * @param errmsg The object that will be filled with failure information if decode failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The data is verified before the merge, so that nothing will be changed if the data is invalid.
+     *          But the root may be merged partially if memory allocation failed.
+     * @remarks The merge will fail without any change if the root is frozen.
+     * @remarks Indexes enabled by merges can be released by nini_node_disable_index.
+     * @remarks In the lossless mode, merged nodes are changes of the current source (see nini_root_enable_lossless),
+     *          and comments and formatting of the merged data will not be kept.
+     */
+    if( nini_root_is_frozen(self) )
     {
-        if( !format->sec_head ) return 0;
-
-        char stx[2] = { format->sec_head };
-        char etx[2] = { format->sec_tail };
-        snprintf(name, sizeof(name), "%s%s%s", stx, nini_node_get_name(node), etx);
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
     }
-    else
+
+    if( !data || !size )
     {
-        assert( format->keymark );
-        snprintf(name, sizeof(name), "%s %c", nini_node_get_name(node), format->keymark);
+        if( errmsg ) memset(errmsg, 0, sizeof(*errmsg));
+        return true;
     }
 
-    // Generate value.
-    char value[NINI_MAX_LINE_CHARS+1];
-    if( !encode_value(value, sizeof(value), node) ) return 0;
+    nini_parser_t parser;
+    nini_parser_init(&parser, &self->format, NULL, verify_on_item);
 
-    // Generate line.
+    bool res = nini_parser_parse(&parser, data, size);
+    if( errmsg ) nini_parser_get_errmsg(&parser, errmsg);
+    if( !res ) return false;
 
-    static const char ASCII_LF = 0x0A;
+    merge_decode_t merge;
+    memset(&merge, 0, sizeof(merge));
+    merge.root = self;
 
-    char line[NINI_MAX_LINE_CHARS+1];
-    int fillsize = snprintf(line, sizeof(line), "%s%s%s%c", indents, name, value, ASCII_LF);
-    if( fillsize < 0 || sizeof(line) < fillsize ) return 0;
+    nini_parser_init(&parser,
+                     &self->format,
+                     &merge,
+                     (void*(*)(void*,void*,int,nini_type_t,const char*,nini_parser_value_t*)) merge_on_item);
 
-    // Write stream.
-    if( !on_write(stream, line, fillsize) ) return 0;
+    res = nini_parser_parse(&parser, data, size);
+    if( errmsg ) nini_parser_get_errmsg(&parser, errmsg);
 
-    // Process children.
-    size_t total_size = fillsize;
-    for(const nini_node_t *child = nini_node_get_first_child_c(node);
-        child;
-        child = nini_node_get_next_sibling_c(child))
-    {
-        size_t fillsize = encode_node(format, stream, on_write, level+1, child);
-        if( !fillsize ) return 0;
+    for(size_t i = 0; i < merge.replaced.count; ++i)
+        nini_node_release(merge.replaced.items[i]);
 
-        total_size += fillsize;
-    }
+    if( merge.replaced.items ) free(merge.replaced.items);
 
-    return total_size;
+    return res;
 }
 //------------------------------------------------------------------------------
 size_t nini_root_encode_to_stream(const nini_root_t *self,
@@ -392,22 +732,70 @@ size_t nini_root_encode_to_stream(const nini_root_t *self,
      *                 and it will be cleared otherwise.
      *                 This parameter can be NULL to discard the error report.
      * @return Size of data be filled to the stream if succeed; and ZERO if failed.
+     *
+     * @remarks The stream writer will be called with blocks of complete lines,
+     *          instead of being called once for each line.
      */
-    size_t total_size = 0;
+    nini_encoder_t encoder;
+    if( !nini_encoder_init_stream(&encoder, &self->format, stream, on_write, errmsg) ) return 0;
 
-    for(const nini_node_t *node = nini_root_get_first_child_c(self);
-        node;
-        node = nini_node_get_next_sibling_c(node))
+    if( self->source )
     {
-        size_t fillsize = encode_node(&self->format, stream, on_write, 0, node);
-        if( !fillsize ) return 0;
-
-        total_size += fillsize;
+        nini_source_encode(self->source, &encoder, &self->super);
+    }
+    else
+    {
+        for(const nini_node_t *node = nini_root_get_first_child_c(self);
+            node;
+            node = nini_node_get_next_sibling_c(node))
+        {
+            if( !nini_encoder_write_tree(&encoder, 0, node) ) break;
+        }
     }
 
+    size_t total_size = nini_encoder_finish(&encoder);
+    nini_encoder_deinit(&encoder);
+
     return total_size;
 }
 //------------------------------------------------------------------------------
+size_t nini_root_encode_to_stream_parallel(const nini_root_t *self,
+                                           void              *stream,
+                                           nini_on_write_t    on_write,
+                                           unsigned           threads,
+                                           nini_errmsg_t     *errmsg)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Encode information to the NINI format data to a stream by multiple threads.
+     *
+     * @param self     Object instance.
+     * @param stream   The user defined stream object.
+     * @param on_write The user defined stream writer.
+     * @param threads  Count of worker threads, or ZERO to use the count of processors.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return Size of data be filled to the stream if succeed; and ZERO if failed.
+     *
+     * @remarks Top-level nodes will be encoded to separated buffers by worker threads,
+     *          and the stream writer will be called on the calling thread
+     *          with buffers in the document order,
+     *          so that the data is the same as what nini_root_encode_to_stream produces.
+     * @remarks The root and its nodes must not be modified until this function returns.
+     * @remarks The nodes will be encoded serially
+     *          if there is only one top-level node, or the library is built without threads.
+     */
+    if( self->source ) return nini_root_encode_to_stream(self, stream, on_write, errmsg);
+
+    return nini_parallel_encode(&self->format,
+                                nini_root_get_first_child_c(self),
+                                threads,
+                                stream,
+                                on_write,
+                                errmsg);
+}
+//------------------------------------------------------------------------------
 size_t nini_root_encode_to_buffer(const nini_root_t *self,
                                   void              *buf,
                                   size_t             size,
@@ -425,38 +813,113 @@ size_t nini_root_encode_to_buffer(const nini_root_t *self,
      *               This parameter can be NULL to discard the error report.
      * @return Size of data be filled to the stream if succeed; and ZERO if failed.
      */
-    buffer_stream_t stream;
-    buffer_stream_init(&stream, buf, size);
+    nini_encoder_t encoder;
+    nini_encoder_init_buffer(&encoder, &self->format, buf, size, errmsg);
 
-    return nini_root_encode_to_stream(self,
-                                      &stream,
-                                      (bool(*)(void*,const char*,size_t)) buffer_stream_push_data,
-                                      errmsg);
+    if( self->source )
+    {
+        nini_source_encode(self->source, &encoder, &self->super);
+    }
+    else
+    {
+        for(const nini_node_t *node = nini_root_get_first_child_c(self);
+            node;
+            node = nini_node_get_next_sibling_c(node))
+        {
+            if( !nini_encoder_write_tree(&encoder, 0, node) ) break;
+        }
+    }
+
+    size_t total_size = nini_encoder_finish(&encoder);
+    nini_encoder_deinit(&encoder);
+
+    return total_size;
 }
 //------------------------------------------------------------------------------
-bool nini_root_load_file(nini_root_t *self, const char *filename, nini_errmsg_t *errmsg)
+size_t nini_root_encoded_size(const nini_root_t *self)
 {
     /**
      * @memberof nini_root_t
-     * @brief Load information from NINI format file.
+     * @brief Calculate the exact size of the NINI format data without encoding.
      *
-     * @param self     Object instance.
-     * @param filename Name of the input file.
-     * @param errmsg   The object that will be filled with failure information if decode failed,
-     *                 and it will be cleared otherwise.
-     *                 This parameter can be NULL to discard the error report.
-     * @return TRUE if succeed; and FALSE if not.
+     * @param self Object instance.
+     * @return Size of the encoded data; or
+     *         ZERO if the root is empty or cannot be encoded.
+     */
+    if( self->source ) return nini_source_measure(self->source, &self->format, &self->super);
+
+    size_t total_size = 0;
+
+    for(const nini_node_t *node = nini_root_get_first_child_c(self);
+        node;
+        node = nini_node_get_next_sibling_c(node))
+    {
+        size_t size = nini_encoder_measure_tree(&self->format, 0, node);
+        if( !size ) return 0;
+
+        total_size += size;
+    }
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
+static
+bool discard_on_write(void *stream, const char *line, size_t len)
+{
+    return true;
+}
+//------------------------------------------------------------------------------
+void* nini_root_encode_to_memory(const nini_root_t *self, size_t *size, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Encode information to the NINI format data to a new allocated buffer.
      *
-     * @remarks This function is not atomic,
-     *          and all values it contained will be removed if decode failed.
+     * @param self   Object instance.
+     * @param size   Return size of the encoded data.
+     * @param errmsg The object that will be filled with failure information if encode failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return The buffer of encoded data if succeed; and NULL if failed.
+     *         The buffer is terminated by a null character that is not counted in @a size,
+     *         and it must be released by free.
+     *
+     * @remarks The buffer will be allocated once with the exact size.
      */
+    size_t bufsize = nini_root_encoded_size(self);
+    if( !bufsize && nini_root_get_first_child_c(self) )
+    {
+        // Encode it again to get the detail of the failure.
+        nini_root_encode_to_stream(self, NULL, discard_on_write, errmsg);
+        return NULL;
+    }
+
+    char *buf = malloc(bufsize + 1);
+    if( !buf )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return NULL;
+    }
+
+    if( bufsize != nini_root_encode_to_buffer(self, buf, bufsize, errmsg) )
+    {
+        free(buf);
+        return NULL;
+    }
+
+    buf[bufsize] = 0;
+    if( size ) *size = bufsize;
+
+    return buf;
+}
+//------------------------------------------------------------------------------
+static
+uint8_t* read_file(const char *filename, long *size)
+{
     FILE    *file = NULL;
     uint8_t *data = NULL;
-    long     size;
-
-    nini_root_clear(self);
 
-    bool res;
+    bool res = false;
     do
     {
         if( !filename ) break;
@@ -464,22 +927,100 @@ bool nini_root_load_file(nini_root_t *self, const char *filename, nini_errmsg_t
         if( !file ) break;
 
         if( fseek(file, 0, SEEK_END) ) break;
-        if( 0 > ( size = ftell(file) ) ) break;
+        if( 0 > ( *size = ftell(file) ) ) break;
         rewind(file);
 
-        data = malloc(size);
+        data = malloc(*size ? *size : 1);
         if( !data ) break;
 
-        if( size != fread(data, 1, size, file) ) break;
-
-        if( !nini_root_decode(self, data, size, errmsg) ) break;
+        if( *size != fread(data, 1, *size, file) ) break;
 
         res = true;
     } while(false);
 
-    if( data ) free(data);
     if( file ) fclose(file);
 
+    if( !res && data )
+    {
+        free(data);
+        data = NULL;
+    }
+
+    return data;
+}
+//------------------------------------------------------------------------------
+bool nini_root_load_file(nini_root_t *self, const char *filename, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Load information from NINI format file.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the input file.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks This function is not atomic,
+     *          and all values it contained will be removed if decode failed.
+     *          The load will fail without any change if the root is frozen.
+     */
+    if( nini_root_is_frozen(self) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
+    nini_root_clear(self);
+
+    long     size;
+    uint8_t *data = read_file(filename, &size);
+    if( !data )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Cannot read the file!");
+        return false;
+    }
+
+    bool res = nini_root_decode(self, data, size, errmsg);
+    free(data);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+bool nini_root_merge_file(nini_root_t *self, const char *filename, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Load a NINI format file on top of the current values.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the input file.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks Values are merged in the same way as nini_root_merge,
+     *          and nothing will be changed if the file cannot be read.
+     */
+    if( nini_root_is_frozen(self) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Root is frozen!");
+        return false;
+    }
+
+    long     size;
+    uint8_t *data = read_file(filename, &size);
+    if( !data )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Cannot read the file!");
+        return false;
+    }
+
+    bool res = nini_root_merge(self, data, size, errmsg);
+    free(data);
+
     return res;
 }
 //------------------------------------------------------------------------------
@@ -515,3 +1056,90 @@ bool nini_root_save_file(const nini_root_t *self, const char *filename, nini_err
     return recsize;
 }
 //------------------------------------------------------------------------------
+bool nini_root_save_file_parallel(const nini_root_t *self,
+                                  const char        *filename,
+                                  unsigned           threads,
+                                  nini_errmsg_t     *errmsg)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Save information to NINI format file by multiple threads.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the output file.
+     * @param threads  Count of worker threads, or ZERO to use the count of processors.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks See nini_root_encode_to_stream_parallel for details.
+     */
+    FILE *file = fopen(filename, "wb");
+    if( !file ) return false;
+
+    size_t recsize = nini_root_encode_to_stream_parallel(self,
+                                                         file,
+                                                         (bool(*)(void*,const char*,size_t)) file_on_write,
+                                                         threads,
+                                                         errmsg);
+
+    fclose(file);
+
+    return recsize;
+}
+//------------------------------------------------------------------------------
+bool nini_root_save_file_atomic(const nini_root_t *self,
+                                const char        *filename,
+                                unsigned           threads,
+                                nini_errmsg_t     *errmsg)
+{
+    /**
+     * @memberof nini_root_t
+     * @brief Save information to NINI format file, and the file will never be partially written.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the output file.
+     * @param threads  Count of threads to encode data,
+     *                 ONE to encode serially, or ZERO to use the count of processors.
+     * @param errmsg   The object that will be filled with failure information if decode failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks Data will be written to a temporary file in the same directory,
+     *          and the temporary file will be flushed to the disk
+     *          and then be renamed to replace the target file.
+     *          So that the target file will be either the old one or the new one
+     *          even if the process or the system crashed during the save.
+     * @remarks The temporary file will be removed if failed,
+     *          and the target file will not be changed.
+     * @remarks Permissions of the target file will be kept if it is existed on POSIX systems.
+     * @remarks On Windows, the target file is replaced by MoveFileEx,
+     *          which is atomic on NTFS for files in the same volume,
+     *          but the atomicity is not guaranteed by other file systems (for example, FAT or network shares),
+     *          and the new file will not take permissions of the old one.
+     */
+    nini_atomic_file_t file;
+    if( !nini_atomic_file_open(&file, filename) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Cannot create the temporary file!");
+        return false;
+    }
+
+    if( !nini_root_encode_to_stream_parallel(self, &file, nini_atomic_file_write, threads, errmsg) &&
+        nini_root_get_first_child_c(self) )
+    {
+        nini_atomic_file_abort(&file);
+        return false;
+    }
+
+    if( !nini_atomic_file_commit(&file) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Cannot replace the target file!");
+        return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+#include <stdlib.h>
+#include "nini_shared.h"
+
+//------------------------------------------------------------------------------
+static
+void freeze(nini_node_t *parent)
+{
+    // Sections shared already are frozen.
+    if( parent->shared ) return;
+
+    parent->frozen = true;
+
+    for(nini_node_t *node = nini_node_get_first_child(parent);
+        node;
+        node = nini_node_get_next_sibling(node))
+    {
+        if( nini_node_have_child(node) )
+            freeze(node);
+    }
+}
+//------------------------------------------------------------------------------
+nini_shared_t* nini_shared_create(nini_node_t *section)
+{
+    // The section must not be linked, and it will be frozen and be owned by the shared object,
+    // and the caller has the first reference.
+    nini_shared_t *self = malloc(sizeof(nini_shared_t));
+    if( !self ) return NULL;
+
+    freeze(section);
+    self->section = section;
+    self->refs    = 1;
+
+    return self;
+}
+//------------------------------------------------------------------------------
+void nini_shared_ref(nini_shared_t *self)
+{
+    ++ self->refs;
+}
+//------------------------------------------------------------------------------
+void nini_shared_unref(nini_shared_t *self)
+{
+    if( -- self->refs ) return;
+
+    nini_node_release(self->section);
+    free(self);
+}
+//------------------------------------------------------------------------------
+void nini_shared_attach(nini_shared_t *self, nini_node_t *node)
+{
+    // The node must be a section without children and without the index.
+    node->childs.first = self->section->childs.first;
+    node->childs.last  = self->section->childs.last;
+    node->childs.index = self->section->childs.index;
+
+    node->shared = self;
+    node->frozen = true;
+    nini_shared_ref(self);
+}
+//------------------------------------------------------------------------------
+void nini_shared_detach(nini_node_t *node)
+{
+    nini_shared_t *shared = node->shared;
+
+    node->childs.first = NULL;
+    node->childs.last  = NULL;
+    node->childs.index = NULL;
+
+    node->shared = NULL;
+    node->frozen = false;
+    nini_shared_unref(shared);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,36 @@
+#ifndef _NINI_SHARED_H_
+#define _NINI_SHARED_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "nini_node.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A reference counted section shared by sections of many roots.
+ * The shared section is frozen and is not linked to any one,
+ * and a section referring to it borrows its children, and is frozen too,
+ * so that the children of the shared section have it as their parent.
+ */
+
+typedef struct nini_shared_t
+{
+    nini_node_t *section;
+    size_t       refs;
+} nini_shared_t;
+
+nini_shared_t* nini_shared_create(nini_node_t *section);
+void           nini_shared_ref   (nini_shared_t *self);
+void           nini_shared_unref (nini_shared_t *self);
+
+void nini_shared_attach(nini_shared_t *self, nini_node_t *node);
+void nini_shared_detach(nini_node_t *node);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "nini_simd.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#   define NINI_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+/*
+ * Reading beyond the null terminator within an aligned block is safe,
+ * but it will be reported by sanitizers.
+ */
+#if defined(__has_attribute)
+#   if __has_attribute(no_sanitize)
+#       define NO_SANITIZE_OVERREAD __attribute__((no_sanitize("address", "thread")))
+#   endif
+#endif
+#ifndef NO_SANITIZE_OVERREAD
+#   define NO_SANITIZE_OVERREAD
+#endif
+
+#define WORD_ONES  0x0101010101010101ULL
+#define WORD_HIGHS 0x8080808080808080ULL
+
+//------------------------------------------------------------------------------
+#ifndef NINI_SIMD_SSE2
+static
+bool need_escape(uint8_t ch)
+{
+    // Also true for the null terminator.
+    return ch < 0x20 || ch >= 0x7F || ch == '\"' || ch == '\'' || ch == '\\';
+}
+#endif
+//------------------------------------------------------------------------------
+static
+bool is_quoted_stop(uint8_t ch)
+{
+    return ch == '\"' || ch == '\\' || ch == '\n';
+}
+//------------------------------------------------------------------------------
+#ifdef NINI_SIMD_SSE2
+static
+unsigned count_trailing_zeros(unsigned mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    unsigned count = 0;
+    for(; !( mask & 1 ); mask >>= 1)
+        ++ count;
+
+    return count;
+#endif
+}
+#endif
+//------------------------------------------------------------------------------
+#ifdef NINI_SIMD_SSE2
+static
+unsigned escape_mask(__m128i block)
+{
+    // Signed comparison covers both control characters and bytes not less than 0x80.
+    __m128i res = _mm_cmplt_epi8(block, _mm_set1_epi8(0x20));
+    res = _mm_or_si128(res, _mm_cmpeq_epi8(block, _mm_set1_epi8(0x7F)));
+    res = _mm_or_si128(res, _mm_cmpeq_epi8(block, _mm_set1_epi8('\"')));
+    res = _mm_or_si128(res, _mm_cmpeq_epi8(block, _mm_set1_epi8('\'')));
+    res = _mm_or_si128(res, _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+
+    return _mm_movemask_epi8(res);
+}
+#endif
+//------------------------------------------------------------------------------
+#ifdef NINI_SIMD_SSE2
+static
+unsigned quoted_stop_mask(__m128i block)
+{
+    __m128i res = _mm_cmpeq_epi8(block, _mm_set1_epi8('\"'));
+    res = _mm_or_si128(res, _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+    res = _mm_or_si128(res, _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+
+    return _mm_movemask_epi8(res);
+}
+#endif
+//------------------------------------------------------------------------------
+#ifndef NINI_SIMD_SSE2
+static
+uint64_t word_have_byte(uint64_t word, uint8_t ch)
+{
+    uint64_t x = word ^ ( WORD_ONES * ch );
+    return ( x - WORD_ONES ) & ~x & WORD_HIGHS;
+}
+#endif
+//------------------------------------------------------------------------------
+#ifndef NINI_SIMD_SSE2
+static
+bool word_need_escape(uint64_t word)
+{
+    uint64_t res = word & WORD_HIGHS;
+    res |= ( word - WORD_ONES * 0x20 ) & ~word & WORD_HIGHS;
+    res |= word_have_byte(word, 0x7F);
+    res |= word_have_byte(word, '\"');
+    res |= word_have_byte(word, '\'');
+    res |= word_have_byte(word, '\\');
+
+    return res;
+}
+#endif
+//------------------------------------------------------------------------------
+#ifndef NINI_SIMD_SSE2
+static
+bool word_have_quoted_stop(uint64_t word)
+{
+    return word_have_byte(word, '\"') | word_have_byte(word, '\\') | word_have_byte(word, '\n');
+}
+#endif
+//------------------------------------------------------------------------------
+NO_SANITIZE_OVERREAD
+const char* nini_simd_find_escape(const char *str)
+{
+    /*
+     * Find the first character that must be escaped in a quoted value,
+     * or the null terminator.
+     *
+     * Only aligned blocks will be loaded,
+     * so that reading beyond the terminator never cross a page boundary.
+     */
+    const uint8_t *pos = (const uint8_t*) str;
+
+#ifdef NINI_SIMD_SSE2
+    size_t         off   = (uintptr_t) pos & 15;
+    const __m128i *block = (const __m128i*)( pos - off );
+
+    unsigned mask = escape_mask(_mm_load_si128(block)) & ( 0xFFFFu << off );
+    while( !mask )
+        mask = escape_mask(_mm_load_si128(++block));
+
+    return (const char*) block + count_trailing_zeros(mask);
+#else
+    while( (uintptr_t) pos & 7 )
+    {
+        if( need_escape(*pos) ) return (const char*) pos;
+        ++ pos;
+    }
+
+    for(;; pos += 8)
+    {
+        uint64_t word;
+        memcpy(&word, pos, sizeof(word));
+        if( word_need_escape(word) ) break;
+    }
+
+    while( !need_escape(*pos) )
+        ++ pos;
+
+    return (const char*) pos;
+#endif
+}
+//------------------------------------------------------------------------------
+size_t nini_simd_find_quoted_stop(const char *data, size_t size)
+{
+    /*
+     * Find the first character that stops a run of a quoted value:
+     * the quote, the escape character, or the line feed;
+     * and return the size if there is no such character.
+     */
+    const uint8_t *pos = (const uint8_t*) data;
+    size_t         idx = 0;
+
+#ifdef NINI_SIMD_SSE2
+    for(; idx + 16 <= size; idx += 16)
+    {
+        unsigned mask = quoted_stop_mask(_mm_loadu_si128((const __m128i*)( pos + idx )));
+        if( mask ) return idx + count_trailing_zeros(mask);
+    }
+#else
+    for(; idx + 8 <= size; idx += 8)
+    {
+        uint64_t word;
+        memcpy(&word, pos + idx, sizeof(word));
+        if( word_have_quoted_stop(word) ) break;
+    }
+#endif
+
+    for(; idx < size; ++idx)
+    {
+        if( is_quoted_stop(pos[idx]) ) return idx;
+    }
+
+    return size;
+}
+//------------------------------------------------------------------------------
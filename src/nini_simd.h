@@ -0,0 +1,23 @@
+#ifndef _NINI_SIMD_H_
+#define _NINI_SIMD_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Vectorised scanning kernels for quoted string values.
+ * SSE2 will be used if it is available,
+ * or the kernels fall back to scan words of 8 bytes by bit operations.
+ */
+
+const char* nini_simd_find_escape(const char *str);
+size_t      nini_simd_find_quoted_stop(const char *data, size_t size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
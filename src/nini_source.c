@@ -0,0 +1,308 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_source.h"
+
+typedef struct encode_t
+{
+    const nini_source_t *source;
+    nini_encoder_t      *encoder;
+
+    // The range of the source those will be copied,
+    // and adjacent ranges will be merged to be copied at once.
+    size_t copy_begin;
+    size_t copy_end;
+
+} encode_t;
+
+//------------------------------------------------------------------------------
+void nini_source_builder_init(nini_source_builder_t *self)
+{
+    memset(self, 0, sizeof(*self));
+    self->count = 1;    // Reserve the first one for the root.
+}
+//------------------------------------------------------------------------------
+void nini_source_builder_deinit(nini_source_builder_t *self)
+{
+    if( self->nodes ) free(self->nodes);
+    if( self->spans ) free(self->spans);
+
+    self->nodes = NULL;
+    self->spans = NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool builder_reserve(nini_source_builder_t *self)
+{
+    if( self->count < self->capacity ) return true;
+
+    size_t capacity = self->capacity ? 2 * self->capacity : 64;
+
+    nini_node_t **nodes = realloc(self->nodes, capacity * sizeof(nodes[0]));
+    if( !nodes ) return false;
+    self->nodes = nodes;
+
+    nini_span_t *spans = realloc(self->spans, capacity * sizeof(spans[0]));
+    if( !spans ) return false;
+    self->spans = spans;
+
+    self->capacity = capacity;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_source_builder_add(nini_source_builder_t *self, nini_node_t *node, size_t line, size_t tail)
+{
+    // Nodes must be added in the order of their lines.
+    if( !builder_reserve(self) ) return false;
+
+    self->nodes[ self->count ] = node;
+    self->spans[ self->count ].line = line;
+    self->spans[ self->count ].tail = tail;
+    ++ self->count;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+nini_source_t* nini_source_create(nini_source_builder_t *builder,
+                                  nini_node_t           *root,
+                                  const void            *data,
+                                  size_t                 size)
+{
+    // The builder will be cleared, and the root and nodes will be linked to the source spans.
+    nini_source_t *self = NULL;
+
+    bool succ = false;
+    do
+    {
+        if( !builder_reserve(builder) ) break;
+
+        if( !( self = calloc(1, sizeof(nini_source_t)) ) ) break;
+        if( !( self->data = malloc(size ? size : 1) ) ) break;
+
+        memcpy(self->data, data, size);
+        self->size = size;
+
+        succ = true;
+    } while(false);
+
+    if( !succ )
+    {
+        if( self ) free(self);
+        nini_source_builder_deinit(builder);
+        return NULL;
+    }
+
+    // Take spans from the builder.
+    nini_node_t **nodes = builder->nodes;
+    self->spans = builder->spans;
+    self->count = builder->count;
+    builder->spans = NULL;
+
+    nodes[0] = root;
+    memset(&self->spans[0], 0, sizeof(self->spans[0]));
+
+    size_t prev_tail = 0;
+    for(size_t i = 0; i < self->count; ++i)
+    {
+        nini_span_t *span = &self->spans[i];
+        if( i )
+        {
+            span->head = prev_tail;
+            span->end  = span->tail;
+            prev_tail  = span->tail;
+        }
+
+        span->modified = false;
+        span->intact   = true;
+
+        nodes[i]->span = span;
+    }
+
+    // Nodes are in the pre-order of the tree, so that children will be visited before their parent.
+    for(size_t i = self->count - 1; i; --i)
+    {
+        nini_span_t *parent = nodes[i]->parent->span;
+        if( parent->end < self->spans[i].end )
+            parent->end = self->spans[i].end;
+    }
+
+    nini_source_builder_deinit(builder);
+
+    return self;
+}
+//------------------------------------------------------------------------------
+void nini_source_release(nini_source_t *self, nini_node_t *root)
+{
+    if( !self ) return;
+
+    nini_source_detach(root);
+
+    free(self->data);
+    free(self->spans);
+    free(self);
+}
+//------------------------------------------------------------------------------
+void nini_source_invalidate(nini_node_t *node)
+{
+    // Ancestors of a changed node are always changed, so that the walk can stop at the first one.
+    for(; node && node->span && node->span->intact; node = node->parent)
+        node->span->intact = false;
+}
+//------------------------------------------------------------------------------
+void nini_source_detach(nini_node_t *node)
+{
+    if( !node->span ) return;
+    node->span = NULL;
+
+    for(nini_node_t *child = nini_node_get_first_child(node);
+        child;
+        child = nini_node_get_next_sibling(child))
+    {
+        nini_source_detach(child);
+    }
+}
+//------------------------------------------------------------------------------
+static
+bool encode_flush_copy(encode_t *encode)
+{
+    if( encode->copy_begin == encode->copy_end ) return true;
+
+    bool succ = nini_encoder_write_raw(encode->encoder,
+                                       encode->source->data + encode->copy_begin,
+                                       encode->copy_end - encode->copy_begin);
+
+    encode->copy_begin = encode->copy_end = 0;
+
+    return succ;
+}
+//------------------------------------------------------------------------------
+static
+bool encode_copy(encode_t *encode, size_t begin, size_t end)
+{
+    if( begin == end ) return true;
+
+    if( encode->copy_begin != encode->copy_end && encode->copy_end == begin )
+    {
+        encode->copy_end = end;
+        return true;
+    }
+
+    if( !encode_flush_copy(encode) ) return false;
+
+    encode->copy_begin = begin;
+    encode->copy_end   = end;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+bool encode_node(encode_t *encode, int level, const nini_node_t *node)
+{
+    const nini_span_t *span = node->span;
+    if( !span )
+        return encode_flush_copy(encode) && nini_encoder_write_tree(encode->encoder, level, node);
+
+    if( span->intact )
+        return encode_copy(encode, span->head, span->end);
+
+    if( !span->modified )
+    {
+        if( !encode_copy(encode, span->head, span->tail) ) return false;
+    }
+    else
+    {
+        // Keep the comments in front of the replaced line.
+        if( !encode_copy(encode, span->head, span->line) ) return false;
+        if( !encode_flush_copy(encode) ) return false;
+        if( !nini_encoder_write_node(encode->encoder, level, node) ) return false;
+    }
+
+    for(const nini_node_t *child = nini_node_get_first_child_c(node);
+        child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        if( !encode_node(encode, level + 1, child) ) return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_source_encode(const nini_source_t *self, nini_encoder_t *encoder, const nini_node_t *root)
+{
+    encode_t encode =
+    {
+        .source     = self,
+        .encoder    = encoder,
+        .copy_begin = 0,
+        .copy_end   = 0,
+    };
+
+    const nini_span_t *span = root->span;
+    if( span->intact )
+        return encode_copy(&encode, 0, self->size) && encode_flush_copy(&encode);
+
+    for(const nini_node_t *node = nini_node_get_first_child_c(root);
+        node;
+        node = nini_node_get_next_sibling_c(node))
+    {
+        if( !encode_node(&encode, 0, node) ) return false;
+    }
+
+    // The trailing comments and blank lines.
+    return encode_copy(&encode, span->end, self->size) && encode_flush_copy(&encode);
+}
+//------------------------------------------------------------------------------
+static
+size_t measure_node(const nini_format_t *format, int level, const nini_node_t *node)
+{
+    // Return size of the node and all of its children, or ZERO if any of them cannot be encoded.
+    const nini_span_t *span = node->span;
+    if( !span ) return nini_encoder_measure_tree(format, level, node);
+
+    if( span->intact ) return span->end - span->head;
+
+    size_t total_size;
+    if( !span->modified )
+    {
+        total_size = span->tail - span->head;
+    }
+    else
+    {
+        size_t size = nini_encoder_measure_node(format, level, node);
+        if( !size ) return 0;
+
+        total_size = span->line - span->head + size;
+    }
+
+    for(const nini_node_t *child = nini_node_get_first_child_c(node);
+        child;
+        child = nini_node_get_next_sibling_c(child))
+    {
+        size_t size = measure_node(format, level + 1, child);
+        if( !size ) return 0;
+
+        total_size += size;
+    }
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
+size_t nini_source_measure(const nini_source_t *self, const nini_format_t *format, const nini_node_t *root)
+{
+    const nini_span_t *span = root->span;
+    if( span->intact ) return self->size;
+
+    size_t total_size = self->size - span->end;
+    for(const nini_node_t *node = nini_node_get_first_child_c(root);
+        node;
+        node = nini_node_get_next_sibling_c(node))
+    {
+        size_t size = measure_node(format, 0, node);
+        if( !size ) return 0;
+
+        total_size += size;
+    }
+
+    return total_size;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+#ifndef _NINI_SOURCE_H_
+#define _NINI_SOURCE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "nini_node.h"
+#include "nini_encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The source data kept by the lossless mode.
+ * Each decoded node refers to a span of the source,
+ * and unchanged spans will be copied verbatim when the root be encoded,
+ * so that comments and the original formatting will be kept,
+ * and only the changed nodes will be formatted again.
+ *
+ * Nodes those have spans are always linked to the root of the source through nodes with spans:
+ * A node loses the span of its subtree when it be unlinked,
+ * and a node linked later will not have a span,
+ * except a node replaces another node that has a span.
+ */
+
+typedef struct nini_span_t
+{
+    size_t head;        // Start of the comments and blank lines in front of the line.
+    size_t line;        // Start of the line of the node.
+    size_t tail;        // End of the line of the node.
+    size_t end;         // End of the last line of the node and all its descendants.
+    bool   modified;    // The node replaced the one decoded from the line.
+    bool   intact;      // No changes have been made in the node and all its descendants.
+} nini_span_t;
+
+typedef struct nini_source_t
+{
+    char   *data;
+    size_t  size;
+
+    nini_span_t *spans;     // The first span is of the root.
+    size_t       count;
+
+} nini_source_t;
+
+typedef struct nini_source_builder_t
+{
+    nini_node_t **nodes;
+    nini_span_t  *spans;
+    size_t        count;
+    size_t        capacity;
+} nini_source_builder_t;
+
+void nini_source_builder_init  (nini_source_builder_t *self);
+void nini_source_builder_deinit(nini_source_builder_t *self);
+bool nini_source_builder_add   (nini_source_builder_t *self, nini_node_t *node, size_t line, size_t tail);
+
+nini_source_t* nini_source_create (nini_source_builder_t *builder,
+                                   nini_node_t           *root,
+                                   const void            *data,
+                                   size_t                 size);
+void           nini_source_release(nini_source_t *self, nini_node_t *root);
+
+void nini_source_invalidate(nini_node_t *node);
+void nini_source_detach    (nini_node_t *node);
+
+bool   nini_source_encode (const nini_source_t *self, nini_encoder_t *encoder, const nini_node_t *root);
+size_t nini_source_measure(const nini_source_t *self, const nini_format_t *format, const nini_node_t *root);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
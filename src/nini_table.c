@@ -0,0 +1,106 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_table.h"
+
+//------------------------------------------------------------------------------
+void nini_table_init(nini_table_t *self)
+{
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
+void nini_table_deinit(nini_table_t *self)
+{
+    if( self->slots ) free(self->slots);
+    memset(self, 0, sizeof(*self));
+}
+//------------------------------------------------------------------------------
+nini_table_slot_t* nini_table_find(const nini_table_t *self, uint64_t hash, nini_table_match_t match, const void *key)
+{
+    if( !self->capacity ) return NULL;
+
+    size_t mask = self->capacity - 1;
+    for(size_t pos = hash & mask; self->slots[pos].item; pos = ( pos + 1 ) & mask)
+    {
+        nini_table_slot_t *slot = &self->slots[pos];
+        if( slot->hash == hash && match(slot->item, key) ) return slot;
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
+static
+void put_slot(nini_table_slot_t *slots, size_t capacity, void *item, uint64_t hash)
+{
+    size_t pos = hash & ( capacity - 1 );
+    while( slots[pos].item )
+        pos = ( pos + 1 ) & ( capacity - 1 );
+
+    slots[pos].item = item;
+    slots[pos].hash = hash;
+}
+//------------------------------------------------------------------------------
+static
+bool rebuild(nini_table_t *self, size_t capacity)
+{
+    nini_table_slot_t *slots = calloc(capacity, sizeof(slots[0]));
+    if( !slots ) return false;
+
+    for(size_t i = 0; i < self->capacity; ++i)
+    {
+        if( self->slots[i].item )
+            put_slot(slots, capacity, self->slots[i].item, self->slots[i].hash);
+    }
+
+    if( self->slots ) free(self->slots);
+    self->slots    = slots;
+    self->capacity = capacity;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_table_reserve(nini_table_t *self, size_t count)
+{
+    // Keep the load factor under one half.
+    size_t capacity = self->capacity ? self->capacity : 64;
+    while( 2 * count > capacity )
+        capacity *= 2;
+
+    return capacity == self->capacity || rebuild(self, capacity);
+}
+//------------------------------------------------------------------------------
+bool nini_table_insert(nini_table_t *self, void *item, uint64_t hash)
+{
+    if( !nini_table_reserve(self, self->count + 1) ) return false;
+
+    put_slot(self->slots, self->capacity, item, hash);
+    ++ self->count;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_table_remove(nini_table_t *self, nini_table_slot_t *slot)
+{
+    size_t mask = self->capacity - 1;
+    size_t hole = slot - self->slots;
+
+    self->slots[hole].item = NULL;
+    -- self->count;
+
+    // Move items back to the hole if their home positions are not between the hole and them.
+    for(size_t pos = ( hole + 1 ) & mask; self->slots[pos].item; pos = ( pos + 1 ) & mask)
+    {
+        size_t home = self->slots[pos].hash & mask;
+        if( ( ( pos - home ) & mask ) < ( ( pos - hole ) & mask ) ) continue;
+
+        self->slots[hole] = self->slots[pos];
+        self->slots[pos].item = NULL;
+        hole = pos;
+    }
+}
+//------------------------------------------------------------------------------
+void nini_table_clear(nini_table_t *self)
+{
+    if( self->slots ) memset(self->slots, 0, self->capacity * sizeof(self->slots[0]));
+    self->count = 0;
+}
+//------------------------------------------------------------------------------
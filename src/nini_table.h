@@ -0,0 +1,48 @@
+#ifndef _NINI_TABLE_H_
+#define _NINI_TABLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * An open addressing hash table of items by their hashes, with linear probing.
+ * The capacity is a power of two, and the load factor is kept under one half.
+ * Items are compared by the matching function of users, so that the table can hold any kind of items.
+ * Inserting items reserved by nini_table_reserve never fails.
+ * Removals shift the following items of the probe chain back, so that no tombstone is needed.
+ */
+
+typedef struct nini_table_slot_t
+{
+    void     *item;     // NULL if the slot is empty.
+    uint64_t  hash;
+} nini_table_slot_t;
+
+typedef struct nini_table_t
+{
+    nini_table_slot_t *slots;
+    size_t             count;
+    size_t             capacity;
+} nini_table_t;
+
+typedef bool(*nini_table_match_t)(const void *item, const void *key);
+
+void nini_table_init  (nini_table_t *self);
+void nini_table_deinit(nini_table_t *self);
+
+bool               nini_table_reserve(nini_table_t *self, size_t count);
+nini_table_slot_t* nini_table_find   (const nini_table_t *self, uint64_t hash, nini_table_match_t match, const void *key);
+bool               nini_table_insert (nini_table_t *self, void *item, uint64_t hash);
+void               nini_table_remove (nini_table_t *self, nini_table_slot_t *slot);
+void               nini_table_clear  (nini_table_t *self);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,555 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_watcher.h"
+
+#if defined(NINI_USE_PTHREAD) && !defined(_WIN32)
+#define NINI_USE_WATCH_THREAD
+#endif
+
+#ifdef NINI_USE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef NINI_USE_WATCH_THREAD
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <stdint.h>
+#include <sys/inotify.h>
+#endif
+#endif
+
+// The minimum interval to check the file status if changes cannot be notified by the system.
+#define MIN_POLL_INTERVAL 10
+
+typedef struct snapshot_t
+{
+    nini_root_t root;   // Must be the first member, so that a root can be cast back to its snapshot.
+    unsigned    refs;   // Count of readers, and one more for being the current one.
+} snapshot_t;
+
+typedef struct nini_watch_t
+{
+    snapshot_t *current;
+
+#ifdef NINI_USE_PTHREAD
+    pthread_mutex_t lock;           // Lock of the current snapshot and counts of references.
+    pthread_mutex_t reload_lock;    // Reloads are serialised, so that the newer file always wins.
+#endif
+
+#ifdef NINI_USE_WATCH_THREAD
+    pthread_t thread;
+    bool      running;
+
+    int wake[2];    // Pipe to wake the watching thread up to exit.
+    int notify;     // The inotify instance, or -1 to check the file status periodically.
+
+    const char  *basename;  // Name of the file in its directory, to filter directory events.
+    struct stat  status;    // The last file status be checked.
+
+    nini_on_reload_t  on_reload;
+    void             *arg;
+#endif
+
+} nini_watch_t;
+
+//------------------------------------------------------------------------------
+static
+void watch_lock(nini_watch_t *watch)
+{
+#ifdef NINI_USE_PTHREAD
+    pthread_mutex_lock(&watch->lock);
+#endif
+}
+//------------------------------------------------------------------------------
+static
+void watch_unlock(nini_watch_t *watch)
+{
+#ifdef NINI_USE_PTHREAD
+    pthread_mutex_unlock(&watch->lock);
+#endif
+}
+//------------------------------------------------------------------------------
+static
+snapshot_t* snapshot_create(const nini_watcher_t *self, bool load, nini_errmsg_t *errmsg)
+{
+    // Create a frozen root with contents of the file, or an empty one.
+    snapshot_t *snap = malloc(sizeof(snapshot_t));
+    if( !snap )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return NULL;
+    }
+
+    nini_root_init(&snap->root, &self->format);
+    snap->refs = 1;
+
+    if( load && !nini_root_load_file(&snap->root, self->filename, errmsg) )
+    {
+        nini_root_deinit(&snap->root);
+        free(snap);
+        return NULL;
+    }
+
+    if( !nini_root_freeze(&snap->root, self->deli) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        nini_root_deinit(&snap->root);
+        free(snap);
+        return NULL;
+    }
+
+    return snap;
+}
+//------------------------------------------------------------------------------
+static
+void snapshot_unref(nini_watch_t *watch, snapshot_t *snap)
+{
+    watch_lock(watch);
+    bool last = !-- snap->refs;
+    watch_unlock(watch);
+
+    if( last )
+    {
+        nini_root_deinit(&snap->root);
+        free(snap);
+    }
+}
+//------------------------------------------------------------------------------
+bool nini_watcher_init(nini_watcher_t      *self,
+                       const char          *filename,
+                       const nini_format_t *format,
+                       char                 deli,
+                       unsigned             debounce,
+                       nini_errmsg_t       *errmsg)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Constructor, and the file will be loaded.
+     *
+     * @param self     Object instance.
+     * @param filename Name of the file to be watched.
+     * @param format   Specify the format to be used to decode the file.
+     * @param deli     The path delimiter to freeze roots, see nini_root_freeze.
+     * @param debounce The time in milliseconds that the file must be quiet after changes
+     *                 before it be reloaded by the watching thread.
+     * @param errmsg   The object that will be filled with failure information if failed,
+     *                 and it will be cleared otherwise.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if the file cannot be loaded or the resource allocation failed.
+     *
+     * @remarks The watcher must be de-initialised even if this function failed.
+     *          The current root will be empty if the file cannot be loaded,
+     *          and it can still be reloaded after that.
+     */
+    memset(self, 0, sizeof(*self));
+    self->format   = *format;
+    self->deli     = deli;
+    self->debounce = debounce;
+
+    size_t len = strlen(filename);
+    if( !( self->filename = malloc(len + 1) ) ||
+        !( self->watch = calloc(1, sizeof(nini_watch_t)) ) )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+    memcpy(self->filename, filename, len + 1);
+
+    nini_watch_t *watch = self->watch;
+#ifdef NINI_USE_PTHREAD
+    pthread_mutex_init(&watch->lock, NULL);
+    pthread_mutex_init(&watch->reload_lock, NULL);
+#endif
+#ifdef NINI_USE_WATCH_THREAD
+    watch->wake[0] = watch->wake[1] = -1;
+    watch->notify  = -1;
+#endif
+
+    if( !( watch->current = snapshot_create(self, false, errmsg) ) )
+    {
+#ifdef NINI_USE_PTHREAD
+        pthread_mutex_destroy(&watch->reload_lock);
+        pthread_mutex_destroy(&watch->lock);
+#endif
+        free(watch);
+        self->watch = NULL;
+        return false;
+    }
+
+    return nini_watcher_reload(self, errmsg);
+}
+//------------------------------------------------------------------------------
+void nini_watcher_deinit(nini_watcher_t *self)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     *
+     * @remarks The watching thread will be stopped,
+     *          and all roots those have been acquired must be released before this function.
+     */
+    nini_watch_t *watch = self->watch;
+    if( watch )
+    {
+        nini_watcher_stop(self);
+        snapshot_unref(watch, watch->current);
+
+#ifdef NINI_USE_PTHREAD
+        pthread_mutex_destroy(&watch->reload_lock);
+        pthread_mutex_destroy(&watch->lock);
+#endif
+
+        free(watch);
+    }
+
+    if( self->filename ) free(self->filename);
+
+    self->watch    = NULL;
+    self->filename = NULL;
+}
+//------------------------------------------------------------------------------
+bool nini_watcher_reload(nini_watcher_t *self, nini_errmsg_t *errmsg)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Load the file to a new root, and replace the current root by it.
+     *
+     * @param self   Object instance.
+     * @param errmsg The object that will be filled with failure information if failed,
+     *               and it will be cleared otherwise.
+     *               This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks The file is decoded without blocking readers,
+     *          and the current root will be kept if the decode failed.
+     */
+    nini_watch_t *watch = self->watch;
+    if( !watch )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+#ifdef NINI_USE_PTHREAD
+    pthread_mutex_lock(&watch->reload_lock);
+#endif
+
+    snapshot_t *snap = snapshot_create(self, true, errmsg);
+    if( snap )
+    {
+        watch_lock(watch);
+        snapshot_t *old = watch->current;
+        watch->current = snap;
+        watch_unlock(watch);
+
+        snapshot_unref(watch, old);
+    }
+
+#ifdef NINI_USE_PTHREAD
+    pthread_mutex_unlock(&watch->reload_lock);
+#endif
+
+    return snap;
+}
+//------------------------------------------------------------------------------
+const nini_root_t* nini_watcher_acquire(nini_watcher_t *self)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Acquire the current root for reading.
+     *
+     * @param self Object instance.
+     * @return The current root; or NULL if the watcher initialisation failed.
+     *
+     * @remarks The root will not be changed or released until it be released by the reader,
+     *          even if the file be reloaded after that.
+     * @remarks This function can be called from any thread.
+     */
+    nini_watch_t *watch = self->watch;
+    if( !watch ) return NULL;
+
+    watch_lock(watch);
+    snapshot_t *snap = watch->current;
+    ++ snap->refs;
+    watch_unlock(watch);
+
+    return &snap->root;
+}
+//------------------------------------------------------------------------------
+void nini_watcher_release(nini_watcher_t *self, const nini_root_t *root)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Release a root acquired by nini_watcher_acquire.
+     *
+     * @param self Object instance.
+     * @param root The root to be released.
+     */
+    if( root ) snapshot_unref(self->watch, (snapshot_t*) root);
+}
+//------------------------------------------------------------------------------
+#ifdef NINI_USE_WATCH_THREAD
+//------------------------------------------------------------------------------
+static
+long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+//------------------------------------------------------------------------------
+static
+bool status_changed(nini_watcher_t *self)
+{
+    nini_watch_t *watch = self->watch;
+
+    struct stat status;
+    if( stat(self->filename, &status) ) memset(&status, 0, sizeof(status));
+
+    bool changed = status.st_ino   != watch->status.st_ino  ||
+                   status.st_size  != watch->status.st_size ||
+                   status.st_mtime != watch->status.st_mtime;
+
+    watch->status = status;
+    return changed;
+}
+//------------------------------------------------------------------------------
+#ifdef __linux__
+static
+bool read_events(nini_watcher_t *self)
+{
+    // Return TRUE if any event is about the file.
+    nini_watch_t *watch = self->watch;
+
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    bool relevant = false;
+    ssize_t size;
+    while( ( size = read(watch->notify, buf, sizeof(buf)) ) > 0 )
+    {
+        for(char *pos = buf; pos < buf + size; )
+        {
+            const struct inotify_event *event = (const struct inotify_event*) pos;
+            pos += sizeof(struct inotify_event) + event->len;
+
+            if( event->mask & IN_Q_OVERFLOW )
+                relevant = true;
+            else if( event->len && 0 == strcmp(event->name, watch->basename) )
+                relevant = true;
+        }
+    }
+
+    return relevant;
+}
+#endif
+//------------------------------------------------------------------------------
+static
+bool wait_change(nini_watcher_t *self)
+{
+    // Return TRUE if the file should be reloaded; or FALSE if the watcher is stopping.
+    nini_watch_t *watch = self->watch;
+
+    bool pending  = false;
+    long deadline = 0;
+    while( true )
+    {
+        int timeout;
+        if( watch->notify < 0 )
+            timeout = self->debounce > MIN_POLL_INTERVAL ? self->debounce : MIN_POLL_INTERVAL;
+        else if( pending )
+            timeout = deadline > now_ms() ? deadline - now_ms() : 0;
+        else
+            timeout = -1;
+
+        struct pollfd fds[2] =
+        {
+            { .fd = watch->wake[0], .events = POLLIN },
+            { .fd = watch->notify,  .events = POLLIN },
+        };
+
+        int res = poll(fds, watch->notify < 0 ? 1 : 2, timeout);
+        if( res < 0 && errno != EINTR ) return false;
+        if( res > 0 && fds[0].revents ) return false;
+
+        if( watch->notify < 0 )
+        {
+            // Reload after the file status has not been changed for one interval.
+            if( status_changed(self) )
+                pending = true;
+            else if( pending )
+                return true;
+        }
+#ifdef __linux__
+        else if( res > 0 && fds[1].revents )
+        {
+            // Each event of the file restarts the quiet period.
+            if( read_events(self) )
+            {
+                pending  = true;
+                deadline = now_ms() + self->debounce;
+            }
+        }
+#endif
+        else if( pending && now_ms() >= deadline )
+        {
+            return true;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static
+void* watch_main(void *arg)
+{
+    nini_watcher_t *self  = arg;
+    nini_watch_t   *watch = self->watch;
+
+    while( wait_change(self) )
+    {
+        nini_errmsg_t errmsg;
+        bool succ = nini_watcher_reload(self, &errmsg);
+        if( !watch->on_reload ) continue;
+
+        if( succ )
+        {
+            const nini_root_t *root = nini_watcher_acquire(self);
+            watch->on_reload(watch->arg, root, NULL);
+            nini_watcher_release(self, root);
+        }
+        else
+        {
+            watch->on_reload(watch->arg, NULL, &errmsg);
+        }
+    }
+
+    return NULL;
+}
+//------------------------------------------------------------------------------
+static
+void setup_notify(nini_watcher_t *self)
+{
+    // The directory is watched instead of the file,
+    // because the file may be replaced by renaming another file to it.
+    nini_watch_t *watch = self->watch;
+
+    const char *slash = strrchr(self->filename, '/');
+    watch->basename = slash ? slash + 1 : self->filename;
+
+#ifdef __linux__
+    size_t dirlen = slash ? (size_t)( slash - self->filename ) : 0;
+    char   dirname[dirlen + 2];
+    if( slash )
+    {
+        memcpy(dirname, self->filename, dirlen ? dirlen : 1);
+        dirname[ dirlen ? dirlen : 1 ] = 0;
+    }
+    else
+    {
+        strcpy(dirname, ".");
+    }
+
+    watch->notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if( watch->notify < 0 ) return;
+
+    uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+    if( inotify_add_watch(watch->notify, dirname, mask) < 0 )
+    {
+        close(watch->notify);
+        watch->notify = -1;
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+static
+void close_descriptors(nini_watch_t *watch)
+{
+    if( watch->notify  >= 0 ) close(watch->notify);
+    if( watch->wake[0] >= 0 ) close(watch->wake[0]);
+    if( watch->wake[1] >= 0 ) close(watch->wake[1]);
+
+    watch->wake[0] = watch->wake[1] = -1;
+    watch->notify  = -1;
+}
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
+bool nini_watcher_start(nini_watcher_t *self, nini_on_reload_t on_reload, void *arg)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Start a thread to watch the file and reload it after changes.
+     *
+     * @param self      Object instance.
+     * @param on_reload The function to be called after each reload,
+     *                  and this parameter can be NULL if no need to be notified.
+     * @param arg       The user defined argument to be passed to the reload handler.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * The watching thread is already started.
+     *         * Threads are not supported on the system.
+     *         * The resource allocation failed.
+     *
+     * @remarks Changes are notified by inotify on Linux,
+     *          and the file status will be checked periodically on other systems.
+     */
+#ifdef NINI_USE_WATCH_THREAD
+    nini_watch_t *watch = self->watch;
+    if( !watch || watch->running ) return false;
+
+    watch->on_reload = on_reload;
+    watch->arg       = arg;
+
+    if( pipe(watch->wake) )
+    {
+        watch->wake[0] = watch->wake[1] = -1;
+        return false;
+    }
+
+    setup_notify(self);
+    status_changed(self);
+
+    if( pthread_create(&watch->thread, NULL, watch_main, self) )
+    {
+        close_descriptors(watch);
+        return false;
+    }
+
+    watch->running = true;
+    return true;
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+void nini_watcher_stop(nini_watcher_t *self)
+{
+    /**
+     * @memberof nini_watcher_t
+     * @brief Stop the watching thread.
+     *
+     * @param self Object instance.
+     *
+     * @remarks Do nothing if the watching thread is not started.
+     */
+#ifdef NINI_USE_WATCH_THREAD
+    nini_watch_t *watch = self->watch;
+    if( !watch || !watch->running ) return;
+
+    while( write(watch->wake[1], "", 1) < 0 && errno == EINTR )
+    {}
+
+    pthread_join(watch->thread, NULL);
+    close_descriptors(watch);
+
+    watch->running = false;
+#endif
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,248 @@
+#include <string.h>
+#include <stdlib.h>
+#include "nini_encoder.h"
+#include "nini_writer.h"
+
+//------------------------------------------------------------------------------
+bool nini_writer_init(nini_writer_t       *self,
+                      const nini_format_t *format,
+                      void                *stream,
+                      nini_on_write_t      on_write,
+                      nini_errmsg_t       *errmsg)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Constructor.
+     *
+     * @param self     Object instance.
+     * @param format   Specify the format to be used to encode data.
+     * @param stream   The user defined stream object.
+     * @param on_write The user defined stream writer.
+     * @param errmsg   The object that will be filled with failure information if any write failed,
+     *                 and it will be cleared when the writer finished successfully.
+     *                 This parameter can be NULL to discard the error report.
+     * @return TRUE if succeed; and FALSE if the resource allocation failed.
+     *
+     * @remarks The writer must be de-initialised even if this function failed,
+     *          and all write operations will fail in that case.
+     */
+    memset(self, 0, sizeof(*self));
+
+    nini_encoder_t *encoder = malloc(sizeof(nini_encoder_t));
+    if( !encoder )
+    {
+        nini_errmsg_write(errmsg, 0, "", "Memory allocation failed!");
+        return false;
+    }
+
+    if( !nini_encoder_init_stream(encoder, format, stream, on_write, errmsg) )
+    {
+        free(encoder);
+        return false;
+    }
+
+    self->encoder = encoder;
+    return true;
+}
+//------------------------------------------------------------------------------
+void nini_writer_deinit(nini_writer_t *self)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Destructor.
+     *
+     * @param self Object instance.
+     *
+     * @remarks Lines those have not been flushed will be discarded,
+     *          call nini_writer_finish before this function to flush them.
+     */
+    if( self->encoder )
+    {
+        nini_encoder_deinit(self->encoder);
+        free(self->encoder);
+    }
+
+    self->encoder = NULL;
+}
+//------------------------------------------------------------------------------
+static
+bool is_writable(const nini_writer_t *self)
+{
+    return self->encoder && !self->finished;
+}
+//------------------------------------------------------------------------------
+bool nini_writer_begin_section(nini_writer_t *self, const char *name)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a section, and the following items will be the children of it.
+     *
+     * @param self Object instance.
+     * @param name Name of the section.
+     * @return TRUE if succeed; and FALSE if not.
+     *
+     * @remarks Nested sections will be indented by the format,
+     *          and they will be flattened to the same level if the format does not have indents,
+     *          that is the same as what the node tree encoding does.
+     */
+    if( !is_writable(self) ) return false;
+    if( !nini_encoder_write_section(self->encoder, self->level, name) ) return false;
+
+    ++ self->level;
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_writer_end_section(nini_writer_t *self)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief End the current section, and the following items will be the siblings of it.
+     *
+     * @param self Object instance.
+     * @return TRUE if succeed; and FALSE if not.
+     *         The failure may be caused by one of the following reasons:
+     *         * The writer have already failed.
+     *         * There are no sections have begun.
+     *
+     * @remarks Nothing will be written to the stream for ending a section.
+     */
+    if( !is_writable(self) || self->encoder->failed ) return false;
+
+    if( !self->level )
+    {
+        self->encoder->failed = true;
+        nini_errmsg_write(self->encoder->errmsg, self->encoder->line_num, "", "No section to be ended!");
+        return false;
+    }
+
+    -- self->level;
+    return true;
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_string(nini_writer_t *self, const char *name, const char *value)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a key with string value.
+     *
+     * @param self  Object instance.
+     * @param name  Name of the key.
+     * @param value The string value, and it will be quoted and escaped.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_string(self->encoder, self->level, name, value);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_decimal(nini_writer_t *self, const char *name, long value)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a key with decimal value.
+     *
+     * @param self  Object instance.
+     * @param name  Name of the key.
+     * @param value The integer value.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_decimal(self->encoder, self->level, name, value);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_hexa(nini_writer_t *self, const char *name, long value)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a key with hexadecimal value.
+     *
+     * @param self  Object instance.
+     * @param name  Name of the key.
+     * @param value The integer value.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_hexa(self->encoder, self->level, name, value);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_float(nini_writer_t *self, const char *name, double value)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a key with floating point value.
+     *
+     * @param self  Object instance.
+     * @param name  Name of the key.
+     * @param value The floating point value.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_float(self->encoder, self->level, name, value);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_bool(nini_writer_t *self, const char *name, bool value)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a key with boolean value.
+     *
+     * @param self  Object instance.
+     * @param name  Name of the key.
+     * @param value The boolean value.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_bool(self->encoder, self->level, name, value);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_null(nini_writer_t *self, const char *name)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a key without value.
+     *
+     * @param self Object instance.
+     * @param name Name of the key.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_null(self->encoder, self->level, name);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_write_node(nini_writer_t *self, const nini_node_t *node)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Write a node and all of its children to the current level.
+     *
+     * @param self Object instance.
+     * @param node The node to be written.
+     * @return TRUE if succeed; and FALSE if not.
+     */
+    return is_writable(self) && nini_encoder_write_tree(self->encoder, self->level, node);
+}
+//------------------------------------------------------------------------------
+bool nini_writer_is_failed(const nini_writer_t *self)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Check if any failure occurred.
+     *
+     * @param self Object instance.
+     * @return TRUE if any of the initialisation or write operations failed; and FALSE if not.
+     */
+    return !self->encoder || self->encoder->failed;
+}
+//------------------------------------------------------------------------------
+size_t nini_writer_finish(nini_writer_t *self)
+{
+    /**
+     * @memberof nini_writer_t
+     * @brief Flush all lines to the stream, and no more items can be written after that.
+     *
+     * @param self Object instance.
+     * @return Size of all data be written to the stream if succeed; and ZERO if failed.
+     *
+     * @remarks Sections those have not been ended will be closed implicitly.
+     */
+    if( !self->encoder ) return 0;
+
+    self->finished = true;
+    self->level    = 0;
+
+    return nini_encoder_finish(self->encoder);
+}
+//------------------------------------------------------------------------------
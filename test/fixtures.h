@@ -0,0 +1,47 @@
+#ifndef _FIXTURES_H_
+#define _FIXTURES_H_
+
+/*
+ * Common helpers of tests, and this header must be included after cmocka.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "nini_root.h"
+#include "formats.h"
+
+static inline
+void decode_text(nini_root_t *root, const char *text)
+{
+    nini_root_init(root, &format_have_indents);
+    assert_true( nini_root_decode(root, text, strlen(text), NULL) );
+}
+
+static inline
+void assert_same_roots(const nini_root_t *root, const nini_root_t *other)
+{
+    char *data       = nini_root_encode_to_memory(root, NULL, NULL);
+    char *other_data = nini_root_encode_to_memory(other, NULL, NULL);
+    assert_non_null( data );
+    assert_non_null( other_data );
+    assert_string_equal( data, other_data );
+    free(data);
+    free(other_data);
+
+    assert_true( nini_root_get_hash(root) == nini_root_get_hash(other) );
+}
+
+static inline
+void assert_encoded(const nini_root_t *root, const char *text)
+{
+    // The text is decoded by the format of the root.
+    nini_root_t expected;
+    nini_root_init(&expected, &root->format);
+    assert_true( nini_root_decode(&expected, text, strlen(text), NULL) );
+
+    assert_same_roots(root, &expected);
+
+    nini_root_deinit(&expected);
+}
+
+#endif
@@ -2,6 +2,19 @@
 #include "test_decode.h"
 #include "test_encode.h"
 #include "test_helper.h"
+#include "test_bind.h"
+#include "test_schema.h"
+#include "test_query.h"
+#include "test_number.h"
+#include "test_writer.h"
+#include "test_journal.h"
+#include "test_watcher.h"
+#include "test_reloader.h"
+#include "test_patch.h"
+#include "test_overlay.h"
+#include "test_pool.h"
+#include "test_loader.h"
+#include "test_include.h"
 
 int main(int argc, char *argv[])
 {
@@ -11,6 +24,19 @@ int main(int argc, char *argv[])
     if(( res = test_decode() )) return res;
     if(( res = test_encode() )) return res;
     if(( res = test_helper() )) return res;
+    if(( res = test_bind() )) return res;
+    if(( res = test_schema() )) return res;
+    if(( res = test_query() )) return res;
+    if(( res = test_number() )) return res;
+    if(( res = test_writer() )) return res;
+    if(( res = test_journal() )) return res;
+    if(( res = test_watcher() )) return res;
+    if(( res = test_reloader() )) return res;
+    if(( res = test_patch() )) return res;
+    if(( res = test_overlay() )) return res;
+    if(( res = test_pool() )) return res;
+    if(( res = test_loader() )) return res;
+    if(( res = test_include() )) return res;
 
     return 0;
 }
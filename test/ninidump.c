@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include "nini_number.h"
 #include "ninidump.h"
 
 //------------------------------------------------------------------------------
@@ -26,6 +27,7 @@ const char* get_type_desc(nini_type_t type)
 static
 const char* get_value_str(char *buf, size_t size, const nini_node_t *node)
 {
+    char number[NINI_NUMBER_MAX_CHARS];
     switch( nini_node_get_type(node) )
     {
     case NINI_STRING:
@@ -33,15 +35,18 @@ const char* get_value_str(char *buf, size_t size, const nini_node_t *node)
         break;
 
     case NINI_DECIMAL:
-        snprintf(buf, size, "\"%ld\"", nini_node_get_integer(node));
+        nini_number_format_decimal(number, nini_node_get_integer(node));
+        snprintf(buf, size, "\"%s\"", number);
         break;
 
     case NINI_HEXA:
-        snprintf(buf, size, "\"0x%lX\"", nini_node_get_integer(node));
+        nini_number_format_hexa(number, nini_node_get_integer(node));
+        snprintf(buf, size, "\"%s\"", number);
         break;
 
     case NINI_FLOAT:
-        snprintf(buf, size, "\"%lf\"", nini_node_get_float(node));
+        nini_number_format_float(number, nini_node_get_float(node));
+        snprintf(buf, size, "\"%s\"", number);
         break;
 
     case NINI_BOOL:
@@ -0,0 +1,247 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <cmocka.h>
+#include "nini_bind.h"
+#include "formats.h"
+#include "test_bind.h"
+
+typedef struct value_types_t
+{
+    char   spaces[32];
+    char   quotes[8];
+    long   decimal;
+    long   hexadecimal;
+    double floating;
+    bool   yes;
+    bool   no;
+    long   missing;
+} value_types_t;
+
+typedef struct indents_t
+{
+    char child1[16];
+    char child3[16];
+    char child6[16];
+    char child7[16];
+} indents_t;
+
+//------------------------------------------------------------------------------
+static
+void bind_value_types_test(void **state)
+{
+    static const nini_bind_entry_t table[] =
+    {
+        NINI_BIND_STRING ("string/spaces"      , value_types_t, spaces     , "fail-string"),
+        NINI_BIND_STRING ("string/quotes"      , value_types_t, quotes     , "fail"),
+        NINI_BIND_INTEGER("integer/decimal"    , value_types_t, decimal    , -1),
+        NINI_BIND_INTEGER("integer/hexadecimal", value_types_t, hexadecimal, -1),
+        NINI_BIND_FLOAT  ("floating/float"     , value_types_t, floating   , -1),
+        NINI_BIND_BOOL   ("boolean/true"       , value_types_t, yes        , false),
+        NINI_BIND_BOOL   ("boolean/false"      , value_types_t, no         , true),
+        NINI_BIND_INTEGER("missing/key"        , value_types_t, missing    , 77),
+    };
+
+    nini_binder_t binder;
+    nini_binder_init(&binder, &format_no_indents, '/', table, sizeof(table)/sizeof(table[0]));
+
+    value_types_t values;
+    nini_bind_report_t report;
+    assert_true( nini_binder_load_file(&binder, &values, "samples/value-types.ini", &report, NULL) );
+
+    assert_string_equal( values.spaces, "string with spaces" );
+    assert_string_equal( values.quotes, "fail" );
+    assert_int_equal( values.decimal, 13579 );
+    assert_int_equal( values.hexadecimal, 0x1A7B );
+    assert_true( fabs(values.floating - 3.14159265) < 1e-9 );
+    assert_true( values.yes );
+    assert_false( values.no );
+    assert_int_equal( values.missing, 77 );
+
+    assert_int_equal( report.missing, 1 );
+    assert_int_equal( report.unknown, 3 );
+    assert_int_equal( report.mismatch, 1 );
+
+    nini_binder_deinit(&binder);
+}
+//------------------------------------------------------------------------------
+static
+void on_issue(unsigned *count, nini_bind_issue_t issue, const char *path)
+{
+    if( issue == NINI_BIND_UNKNOWN && 0 == strcmp(path, "base-1/sub-1/child-4") )
+        ++ *count;
+}
+//------------------------------------------------------------------------------
+static
+void bind_indents_test(void **state)
+{
+    static const nini_bind_entry_t table[] =
+    {
+        NINI_BIND_STRING("base-1/child-1"      , indents_t, child1, ""),
+        NINI_BIND_STRING("base-1/sub-1/child-3", indents_t, child3, ""),
+        NINI_BIND_STRING("base-1/sub-2/child-6", indents_t, child6, ""),
+        NINI_BIND_STRING("child-7"             , indents_t, child7, ""),
+    };
+
+    unsigned count = 0;
+
+    nini_binder_t binder;
+    nini_binder_init(&binder, &format_have_indents, '/', table, sizeof(table)/sizeof(table[0]));
+    nini_binder_set_on_issue(&binder, &count, (nini_bind_on_issue_t) on_issue);
+
+    indents_t values;
+    nini_bind_report_t report;
+    assert_true( nini_binder_load_file(&binder, &values, "samples/indents.ini", &report, NULL) );
+
+    assert_string_equal( values.child1, "value-1" );
+    assert_string_equal( values.child3, "value-3" );
+    assert_string_equal( values.child6, "value-6" );
+    assert_string_equal( values.child7, "value-7" );
+
+    assert_int_equal( report.missing, 0 );
+    assert_int_equal( report.unknown, 3 );
+    assert_int_equal( report.mismatch, 0 );
+    assert_int_equal( count, 1 );
+
+    nini_binder_deinit(&binder);
+}
+//------------------------------------------------------------------------------
+static
+void bind_error_test(void **state)
+{
+    static const nini_bind_entry_t table[] =
+    {
+        NINI_BIND_INTEGER("key", value_types_t, decimal, 0),
+    };
+
+    static const char data[] = "key = 1\n    child = 2\n";
+
+    nini_binder_t binder;
+    nini_binder_init(&binder, &format_have_indents, '/', table, sizeof(table)/sizeof(table[0]));
+
+    value_types_t values;
+    nini_errmsg_t errmsg;
+    assert_false( nini_binder_decode(&binder, &values, data, strlen(data), NULL, &errmsg) );
+    assert_int_equal( errmsg.line_num, 2 );
+
+    // The same binder parses data of another format.
+    nini_bind_report_t report;
+    assert_true( nini_binder_decode_as(&binder, &format_no_indents, &values, data, strlen(data), &report, &errmsg) );
+    assert_int_equal( values.decimal, 1 );
+    assert_int_equal( report.unknown, 1 );
+
+    nini_binder_deinit(&binder);
+}
+//------------------------------------------------------------------------------
+static
+void on_long_issue(char *last, nini_bind_issue_t issue, const char *path)
+{
+    if( issue == NINI_BIND_UNKNOWN ) strcpy(last, path);
+}
+//------------------------------------------------------------------------------
+static
+void bind_long_path_test(void **state)
+{
+    static const nini_bind_entry_t table[] =
+    {
+        NINI_BIND_INTEGER("key", value_types_t, decimal, 0),
+        NINI_BIND_INTEGER("key", value_types_t, missing, 0),
+    };
+
+    // Each line is short enough, but the path of the key is too long.
+    char data[2*NINI_MAX_LINE_CHARS];
+    char name[NINI_MAX_LINE_CHARS/2];
+    memset(name, 'n', sizeof(name) - 1);
+    name[ sizeof(name) - 1 ] = 0;
+    snprintf(data, sizeof(data), "key = 1\nkey = 2\n[%s]\n    [%s]\n        key = 3\n", name, name);
+
+    char last[NINI_MAX_LINE_CHARS+1] = "";
+
+    nini_binder_t binder;
+    nini_binder_init(&binder, &format_have_indents, '/', table, sizeof(table)/sizeof(table[0]));
+    nini_binder_set_on_issue(&binder, last, (nini_bind_on_issue_t) on_long_issue);
+
+    // Only the first one of entries and keys with the same path will be bound.
+    value_types_t values;
+    nini_bind_report_t report;
+    assert_true( nini_binder_decode(&binder, &values, data, strlen(data), &report, NULL) );
+    assert_int_equal( values.decimal, 1 );
+    assert_int_equal( values.missing, 0 );
+    assert_int_equal( report.missing, 1 );
+    assert_int_equal( report.unknown, 1 );
+
+    // The path of the unknown key is reported in full, but truncated.
+    assert_int_equal( strlen(last), NINI_MAX_LINE_CHARS );
+    assert_int_equal( 0, strncmp(last, name, strlen(name)) );
+    assert_int_equal( last[ strlen(name) ], '/' );
+
+    nini_binder_deinit(&binder);
+}
+//------------------------------------------------------------------------------
+typedef struct sizes_t
+{
+    short  small;
+    int    medium;
+    float  single;
+    bool   flag;
+    char   guard[8];
+} sizes_t;
+//------------------------------------------------------------------------------
+static
+void bind_field_sizes_test(void **state)
+{
+    static const nini_bind_entry_t table[] =
+    {
+        NINI_BIND_INTEGER("small" , sizes_t, small , 1),
+        NINI_BIND_INTEGER("medium", sizes_t, medium, 2),
+        NINI_BIND_FLOAT  ("single", sizes_t, single, 0.5),
+        NINI_BIND_BOOL   ("flag"  , sizes_t, flag  , false),
+    };
+
+    nini_binder_t binder;
+    nini_binder_init(&binder, &format_have_indents, '/', table, sizeof(table)/sizeof(table[0]));
+
+    // Fields are stored by their own sizes, and the following members are not changed.
+    sizes_t values;
+    memset(&values, 0x55, sizeof(values));
+
+    static const char data[] = "small = -7\nmedium = 100000\nsingle = 1.25\nflag = yes\n";
+    nini_bind_report_t report;
+    assert_true( nini_binder_decode(&binder, &values, data, strlen(data), &report, NULL) );
+    assert_int_equal( values.small, -7 );
+    assert_int_equal( values.medium, 100000 );
+    assert_true( values.single == 1.25f );
+    assert_true( values.flag );
+    assert_int_equal( report.mismatch, 0 );
+
+    static const char guard[sizeof(values.guard)] = { 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55 };
+    assert_memory_equal( values.guard, guard, sizeof(guard) );
+
+    // Values out of the range of fields are mismatched, and the defaults are stored.
+    static const char large_data[] = "small = 40000\nsingle = 1e300\n";
+    assert_true( nini_binder_decode(&binder, &values, large_data, strlen(large_data), &report, NULL) );
+    assert_int_equal( values.small, 1 );
+    assert_true( values.single == 0.5f );
+    assert_int_equal( report.mismatch, 2 );
+    assert_int_equal( report.missing, 2 );
+
+    nini_binder_deinit(&binder);
+}
+//------------------------------------------------------------------------------
+int test_bind(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(bind_value_types_test),
+        cmocka_unit_test(bind_indents_test),
+        cmocka_unit_test(bind_error_test),
+        cmocka_unit_test(bind_long_path_test),
+        cmocka_unit_test(bind_field_sizes_test),
+    };
+
+    return cmocka_run_group_tests_name("bind_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_BIND_H_
+#define _TEST_BIND_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_bind(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
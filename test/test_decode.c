@@ -2,9 +2,13 @@
 #include <stdarg.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
 #include <cmocka.h>
 #include "nini_root.h"
+#include "nini_helper.h"
 #include "formats.h"
+#include "fixtures.h"
 #include "ninidump.h"
 #include "test_decode.h"
 
@@ -48,6 +52,227 @@ void comments_decode_test(void **state)
     nini_root_deinit(&root);
 }
 //------------------------------------------------------------------------------
+static
+void merge_decode_test(void **state)
+{
+    static const char base_text[] =
+        "audio = 80\n"
+        "[log]\n"
+        "    level = 3\n"
+        "[video]\n"
+        "    width = 1280\n"
+        "    height = 720\n"
+        "    [codec]\n"
+        "        name = h264\n";
+    static const char override_text[] =
+        "[video]\n"
+        "    height = 1080\n"
+        "    [codec]\n"
+        "        profile = high\n"
+        "    vsync = true\n"
+        "[audio]\n"
+        "    volume = 50\n"
+        "log = off\n"
+        "[video]\n"
+        "    height = 1200\n";
+    static const char merged_text[] =
+        "[audio]\n"
+        "    volume = 50\n"
+        "log = off\n"
+        "[video]\n"
+        "    width = 1280\n"
+        "    height = 1200\n"
+        "    [codec]\n"
+        "        name = h264\n"
+        "        profile = high\n"
+        "    vsync = true\n";
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    assert_true( nini_root_decode(&root, base_text, strlen(base_text), NULL) );
+
+    nini_node_t *video  = nini_root_find_child(&root, "video");
+    nini_node_t *height = nini_node_find_child(video, "height");
+
+    nini_errmsg_t errmsg;
+    assert_true( nini_root_merge(&root, override_text, strlen(override_text), &errmsg) );
+    assert_encoded(&root, merged_text);
+
+    // Merged nodes keep their addresses, and sections with a few items merged are not indexed.
+    assert_ptr_equal( nini_root_find_child(&root, "video"), video );
+    assert_ptr_equal( nini_node_find_child(video, "height"), height );
+    assert_false( nini_node_have_index(&root.super) );
+    assert_false( nini_node_have_index(video) );
+
+    // Invalid data changes nothing.
+    static const char invalid_text[] =
+        "[video]\n"
+        "    width = 1920\n"
+        "log = on\n"
+        "    level = 4\n";
+    assert_false( nini_root_merge(&root, invalid_text, strlen(invalid_text), &errmsg) );
+    assert_encoded(&root, merged_text);
+
+    assert_true( nini_root_freeze(&root, '/') );
+    assert_false( nini_root_merge(&root, override_text, strlen(override_text), &errmsg) );
+    assert_string_equal( errmsg.message, "Root is frozen!" );
+    nini_root_thaw(&root);
+
+    // Many items of a section.
+    char wide_text[1024] = "[video]\n";
+    for(int i = 0; i < 32; ++i)
+        snprintf(wide_text + strlen(wide_text), sizeof(wide_text) - strlen(wide_text), "    key-%d = %d\n", i % 16, i);
+    assert_true( nini_root_merge(&root, wide_text, strlen(wide_text), NULL) );
+    assert_int_equal( nini_read_integer(&root, "video/key-0", '/', 0), 16 );
+    assert_int_equal( nini_read_integer(&root, "video/key-15", '/', 0), 31 );
+    assert_ptr_equal( nini_node_find_child(video, "height"), height );
+
+    // The index enabled by the merge is kept for later merges.
+    assert_true( nini_node_have_index(video) );
+    assert_false( nini_node_have_index(&root.super) );
+    nini_node_disable_index(video);
+
+    // An index enabled by the user is kept.
+    assert_true( nini_node_enable_index(video) );
+    assert_true( nini_root_merge(&root, "[video]\n    width = 1920\n", 25, NULL) );
+    assert_true( nini_node_have_index(video) );
+    assert_int_equal( nini_read_integer(&root, "video/width", '/', 0), 1920 );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void decode_with_policy(nini_root_t *root, nini_duplicates_t policy, const char *text)
+{
+    nini_root_set_duplicates(root, policy);
+    assert_int_equal( nini_root_get_duplicates(root), policy );
+
+    nini_errmsg_t errmsg;
+    assert_true( nini_root_decode(root, text, strlen(text), &errmsg) );
+}
+//------------------------------------------------------------------------------
+static
+void duplicates_decode_test(void **state)
+{
+    static const char text[] =
+        "name = a\n"
+        "[video]\n"
+        "width = 1\n"
+        "height = 2\n"
+        "width = 3\n"
+        "[audio]\n"
+        "volume = 5\n"
+        "[video]\n"
+        "width = 4\n"
+        "fps = 30\n";
+
+    nini_root_t root;
+    nini_root_init(&root, &format_no_indents);
+
+    decode_with_policy(&root, NINI_DUPLICATES_KEEP_ALL, text);
+    assert_encoded(&root, text);
+
+    decode_with_policy(&root, NINI_DUPLICATES_MERGE_SECTIONS, text);
+    assert_encoded(&root,
+                   "name = a\n"
+                   "[video]\n"
+                   "width = 1\n"
+                   "height = 2\n"
+                   "width = 3\n"
+                   "width = 4\n"
+                   "fps = 30\n"
+                   "[audio]\n"
+                   "volume = 5\n");
+
+    decode_with_policy(&root, NINI_DUPLICATES_FIRST_WINS, text);
+    assert_encoded(&root,
+                   "name = a\n"
+                   "[video]\n"
+                   "width = 1\n"
+                   "height = 2\n"
+                   "fps = 30\n"
+                   "[audio]\n"
+                   "volume = 5\n");
+
+    decode_with_policy(&root, NINI_DUPLICATES_LAST_WINS, text);
+    assert_encoded(&root,
+                   "name = a\n"
+                   "[video]\n"
+                   "width = 4\n"
+                   "height = 2\n"
+                   "fps = 30\n"
+                   "[audio]\n"
+                   "volume = 5\n");
+
+    nini_errmsg_t errmsg;
+    nini_root_set_duplicates(&root, NINI_DUPLICATES_ERROR);
+    assert_false( nini_root_decode(&root, text, strlen(text), &errmsg) );
+    assert_string_equal( errmsg.message, "Duplicate name!" );
+    assert_int_equal( errmsg.line_num, 5 );
+    assert_null( nini_root_get_first_child(&root) );
+
+    nini_root_deinit(&root);
+
+    // A key and a section with the same name, and items under a dropped section.
+    static const char nested_text[] =
+        "[a]\n"
+        "    x = 1\n"
+        "a = 2\n"
+        "d = 5\n"
+        "[d]\n"
+        "    w = 6\n"
+        "[b]\n"
+        "    y = 3\n"
+        "[a]\n"
+        "    v = 4\n";
+
+    nini_root_init(&root, &format_have_indents);
+
+    decode_with_policy(&root, NINI_DUPLICATES_FIRST_WINS, nested_text);
+    assert_encoded(&root, "[a]\n    x = 1\n    v = 4\nd = 5\n[b]\n    y = 3\n");
+
+    decode_with_policy(&root, NINI_DUPLICATES_LAST_WINS, nested_text);
+    assert_encoded(&root, "[a]\n    v = 4\n[d]\n    w = 6\n[b]\n    y = 3\n");
+
+    // The lossless mode keeps all items.
+    nini_root_enable_lossless(&root);
+    decode_with_policy(&root, NINI_DUPLICATES_LAST_WINS, nested_text);
+    assert_encoded(&root, nested_text);
+
+    nini_root_set_duplicates(&root, NINI_DUPLICATES_ERROR);
+    assert_false( nini_root_decode(&root, nested_text, strlen(nested_text), &errmsg) );
+    assert_string_equal( errmsg.message, "Duplicate name!" );
+    assert_int_equal( errmsg.line_num, 3 );
+
+    nini_root_deinit(&root);
+
+    // Items under a key are rejected by all policies, even if the key is dropped.
+    static const char key_child_text[] = "a = 1\na = 2\n    child = 3\n";
+
+    nini_root_init(&root, &format_have_indents);
+
+    static const nini_duplicates_t policies[] =
+    {
+        NINI_DUPLICATES_KEEP_ALL,
+        NINI_DUPLICATES_MERGE_SECTIONS,
+        NINI_DUPLICATES_FIRST_WINS,
+        NINI_DUPLICATES_LAST_WINS,
+    };
+    for(size_t i = 0; i < sizeof(policies)/sizeof(policies[0]); ++i)
+    {
+        nini_root_set_duplicates(&root, policies[i]);
+        assert_false( nini_root_decode(&root, key_child_text, strlen(key_child_text), &errmsg) );
+        assert_string_equal( errmsg.message, "Item event error!" );
+        assert_int_equal( errmsg.line_num, 3 );
+    }
+
+    nini_root_set_duplicates(&root, NINI_DUPLICATES_ERROR);
+    assert_false( nini_root_decode(&root, key_child_text, strlen(key_child_text), &errmsg) );
+    assert_string_equal( errmsg.message, "Duplicate name!" );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
 int test_decode(void)
 {
     struct CMUnitTest tests[] =
@@ -55,6 +280,8 @@ int test_decode(void)
         cmocka_unit_test(value_types_decode_test),
         cmocka_unit_test(indents_decode_test),
         cmocka_unit_test(comments_decode_test),
+        cmocka_unit_test(merge_decode_test),
+        cmocka_unit_test(duplicates_decode_test),
     };
 
     return cmocka_run_group_tests_name("decode_test", tests, NULL, NULL);
@@ -1,9 +1,14 @@
 #include <stddef.h>
 #include <stdarg.h>
 #include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <cmocka.h>
 #include "nini_root.h"
+#include "nini_helper.h"
 #include "formats.h"
 #include "ninidump.h"
 #include "test_encode.h"
@@ -155,12 +160,497 @@ void indents_encode_test(void **state)
     nini_root_deinit(&root);
 }
 //------------------------------------------------------------------------------
+static
+void limits_encode_test(void **state)
+{
+    nini_root_t root;
+    nini_root_init(&root, &format_no_indents);
+
+    nini_node_t *sec = nini_node_create_section("limits");
+    assert_true( nini_root_link_child(&root, sec) );
+    assert_true( nini_node_link_child(sec, nini_node_create_decimal("min", LONG_MIN)) );
+    assert_true( nini_node_link_child(sec, nini_node_create_decimal("zero", 0)) );
+    assert_true( nini_node_link_child(sec, nini_node_create_hexa("mask", 0xFF00)) );
+    assert_true( nini_node_link_child(sec, nini_node_create_string("bytes", "\x01\x7F\xFF")) );
+
+    char expected[256];
+    snprintf(expected,
+             sizeof(expected),
+             "[limits]\nmin = %ld\nzero = 0\nmask = 0xFF00\nbytes = \"\\x01\\x7F\\xFF\"\n",
+             LONG_MIN);
+
+    // Encode to a buffer.
+
+    char buf[256];
+    nini_errmsg_t errmsg;
+    size_t size = nini_root_encode_to_buffer(&root, buf, sizeof(buf), &errmsg);
+    assert_int_equal( size, strlen(expected) );
+    assert_memory_equal( buf, expected, size );
+
+    // Encode to a too small buffer.
+
+    assert_int_equal( 0, nini_root_encode_to_buffer(&root, buf, 16, &errmsg) );
+    assert_int_equal( errmsg.line_num, 2 );
+    assert_string_equal( errmsg.message, "Buffer too small!" );
+
+    // Encode a too long line.
+
+    char name[NINI_MAX_LINE_CHARS+1];
+    memset(name, 'n', sizeof(name) - 1);
+    name[ sizeof(name) - 1 ] = 0;
+    assert_true( nini_node_link_child(sec, nini_node_create_null(name)) );
+
+    assert_int_equal( 0, nini_root_encode_to_buffer(&root, buf, sizeof(buf), &errmsg) );
+    assert_int_equal( errmsg.line_num, 6 );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void memory_encode_test(void **state)
+{
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    // Empty root.
+
+    size_t size = 1;
+    char  *data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_int_equal( size, 0 );
+    assert_string_equal( data, "" );
+    free(data);
+
+    // Encode samples.
+
+    assert_true( nini_root_load_file(&root, "samples/indents.ini", NULL) );
+
+    size_t encsize = nini_root_encoded_size(&root);
+    assert_int_not_equal( encsize, 0 );
+
+    data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_int_equal( size, encsize );
+    assert_int_equal( strlen(data), size );
+
+    char buf[4096];
+    assert_int_equal( nini_root_encode_to_buffer(&root, buf, sizeof(buf), NULL), size );
+    assert_memory_equal( buf, data, size );
+    free(data);
+
+    // Nodes that cannot be encoded.
+
+    nini_root_t toolong;
+    nini_root_init(&toolong, &format_no_indents);
+
+    nini_node_t *sec = nini_node_create_section("section");
+    assert_true( nini_root_link_child(&toolong, sec) );
+    assert_true( nini_node_link_child(sec, nini_node_create_decimal("value", -1)) );
+
+    char name[NINI_MAX_LINE_CHARS];
+    memset(name, 'n', sizeof(name) - 1);
+    name[ sizeof(name) - 1 ] = 0;
+    assert_true( nini_node_link_child(sec, nini_node_create_null(name)) );
+
+    nini_errmsg_t errmsg;
+    assert_int_equal( nini_root_encoded_size(&toolong), 0 );
+    assert_null( nini_root_encode_to_memory(&toolong, &size, &errmsg) );
+    assert_int_equal( errmsg.line_num, 3 );
+
+    nini_root_deinit(&toolong);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+size_t escape_reference(char *buf, const char *str)
+{
+    // Escape characters one by one as the quoted value format defines.
+    static const char hex[] = "0123456789ABCDEF";
+
+    char *pos = buf;
+    for(const uint8_t *src = (const uint8_t*) str; *src; ++src)
+    {
+        switch( *src )
+        {
+        case 0x07: *pos++ = '\\'; *pos++ = 'a';  break;
+        case 0x08: *pos++ = '\\'; *pos++ = 'b';  break;
+        case 0x09: *pos++ = '\\'; *pos++ = 't';  break;
+        case 0x0A: *pos++ = '\\'; *pos++ = 'n';  break;
+        case 0x0B: *pos++ = '\\'; *pos++ = 'v';  break;
+        case 0x0C: *pos++ = '\\'; *pos++ = 'f';  break;
+        case 0x0D: *pos++ = '\\'; *pos++ = 'r';  break;
+        case '\"': *pos++ = '\\'; *pos++ = '\"'; break;
+        case '\'': *pos++ = '\\'; *pos++ = '\''; break;
+        case '\\': *pos++ = '\\'; *pos++ = '\\'; break;
+        default:
+            if( *src < 0x20 || *src >= 0x7F )
+            {
+                *pos++ = '\\';
+                *pos++ = 'x';
+                *pos++ = hex[ *src >> 4 ];
+                *pos++ = hex[ *src & 0x0F ];
+            }
+            else
+            {
+                *pos++ = *src;
+            }
+        }
+    }
+
+    *pos = 0;
+    return pos - buf;
+}
+//------------------------------------------------------------------------------
+static
+void escape_encode_test(void **state)
+{
+    static const char specials[] = "\"\'\\\n\t\x01\x1F\x7F\x80\xFF";
+
+    // Long base64-like values with a special character at every position,
+    // and the values start at different alignments.
+
+    char storage[256 + 16];
+    char expected[1024];
+    char encoded[1024];
+    char line[ sizeof(expected) + 16 ];
+
+    for(size_t len = 1; len <= 200; len += ( len < 40 ? 1 : 23 ))
+    {
+        for(size_t align = 0; align < 16; align += 5)
+        {
+            char *value = storage + align;
+            for(size_t i = 0; i < len; ++i)
+                value[i] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[ ( i * 7 ) % 64 ];
+            value[len] = 0;
+
+            for(size_t at = 0; at <= len; ++at)
+            {
+                char saved = value[at];
+                if( at < len ) value[at] = specials[ ( at + align ) % ( sizeof(specials) - 1 ) ];
+
+                nini_root_t root;
+                nini_root_init(&root, &format_no_indents);
+                assert_true( nini_write_string(&root, "value", '/', value) );
+
+                escape_reference(expected, value);
+                snprintf(line, sizeof(line), "value = \"%s\"\n", expected);
+
+                size_t size = nini_root_encode_to_buffer(&root, encoded, sizeof(encoded), NULL);
+                assert_int_equal( size, strlen(line) );
+                assert_memory_equal( encoded, line, size );
+                assert_int_equal( nini_root_encoded_size(&root), size );
+
+                assert_true( nini_root_decode(&root, encoded, size, NULL) );
+                assert_string_equal( nini_read_string(&root, "value", '/', NULL), value );
+
+                nini_root_deinit(&root);
+
+                value[at] = saved;
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+typedef struct sink_t
+{
+    char   *data;
+    size_t  size;
+    int     writes;
+    int     max_writes;     // Writes those are allowed to succeed, or negative for no limit.
+} sink_t;
+//------------------------------------------------------------------------------
+static
+bool sink_on_write(void *stream, const char *line, size_t len)
+{
+    sink_t *sink = stream;
+    if( sink->max_writes >= 0 && sink->writes >= sink->max_writes ) return false;
+
+    sink->data = realloc(sink->data, sink->size + len);
+    memcpy(sink->data + sink->size, line, len);
+    sink->size += len;
+    ++ sink->writes;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void parallel_encode_test(void **state)
+{
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    // Top-level nodes with very different sizes.
+
+    assert_true( nini_write_decimal(&root, "top-value", '/', 1) );
+    for(int s = 0; s < 60; ++s)
+    {
+        for(int k = 0; k < ( s % 7 ) * ( s % 5 ) + 1; ++k)
+        {
+            char path[64];
+            snprintf(path, sizeof(path), "section-%d/child-%d/value-%d", s, k % 3, k);
+            assert_true( nini_write_float(&root, path, '/', s + k / 8.0) );
+
+            snprintf(path, sizeof(path), "section-%d/string-%d", s, k);
+            assert_true( nini_write_string(&root, path, '/', "text \"quoted\"") );
+        }
+    }
+
+    size_t size;
+    char *expected = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( expected );
+
+    static const unsigned threads[] = { 0, 1, 2, 3, 8, 64 };
+    for(size_t i = 0; i < sizeof(threads)/sizeof(threads[0]); ++i)
+    {
+        sink_t sink = { NULL, 0, 0, -1 };
+        nini_errmsg_t errmsg;
+        assert_int_equal( nini_root_encode_to_stream_parallel(&root, &sink, sink_on_write, threads[i], &errmsg), size );
+        assert_int_equal( sink.size, size );
+        assert_memory_equal( sink.data, expected, size );
+        assert_int_equal( errmsg.line_num, 0 );
+        free(sink.data);
+    }
+
+    // Failures must be reported at the same line as the serial encoder.
+
+    char name[NINI_MAX_LINE_CHARS];
+    memset(name, 'n', sizeof(name) - 1);
+    name[ sizeof(name) - 1 ] = 0;
+
+    nini_node_t *sec = nini_root_find_child(&root, "section-41");
+    assert_non_null( sec );
+    assert_true( nini_node_link_child(sec, nini_node_create_null(name)) );
+
+    nini_errmsg_t errmsg_serial;
+    sink_t sink = { NULL, 0, 0, -1 };
+    assert_int_equal( nini_root_encode_to_stream(&root, &sink, sink_on_write, &errmsg_serial), 0 );
+    free(sink.data);
+
+    for(size_t i = 0; i < sizeof(threads)/sizeof(threads[0]); ++i)
+    {
+        nini_errmsg_t errmsg;
+        sink_t sink = { NULL, 0, 0, -1 };
+        assert_int_equal( nini_root_encode_to_stream_parallel(&root, &sink, sink_on_write, threads[i], &errmsg), 0 );
+        assert_int_equal( errmsg.line_num, errmsg_serial.line_num );
+        assert_string_equal( errmsg.message, errmsg_serial.message );
+        free(sink.data);
+    }
+
+    // Stream failure.
+
+    nini_root_clear(&root);
+    assert_true( nini_write_decimal(&root, "a/value", '/', 1) );
+    assert_true( nini_write_decimal(&root, "b/value", '/', 2) );
+    assert_true( nini_write_decimal(&root, "c/value", '/', 3) );
+
+    nini_errmsg_t errmsg;
+    sink = (sink_t){ NULL, 0, 0, 1 };
+    assert_int_equal( nini_root_encode_to_stream_parallel(&root, &sink, sink_on_write, 4, &errmsg), 0 );
+    assert_string_equal( errmsg.message, "Stream write failed!" );
+    free(sink.data);
+
+    free(expected);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+char* read_whole_file(const char *filename, size_t *size)
+{
+    FILE *file = fopen(filename, "rb");
+    if( !file ) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    rewind(file);
+
+    char *data = malloc(len + 1);
+    *size = fread(data, 1, len, file);
+    data[*size] = 0;
+    fclose(file);
+
+    return data;
+}
+//------------------------------------------------------------------------------
+static
+void atomic_save_encode_test(void **state)
+{
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    assert_true( nini_root_load_file(&root, "samples/indents.ini", NULL) );
+
+    size_t expected_size;
+    char *expected = nini_root_encode_to_memory(&root, &expected_size, NULL);
+    assert_non_null( expected );
+
+    // Replace an existing file, and its permissions must be kept.
+
+    assert_int_equal( 0, system("echo old content > atomic.ini && chmod 640 atomic.ini") );
+
+    nini_errmsg_t errmsg;
+    assert_true( nini_root_save_file_atomic(&root, "atomic.ini", 1, &errmsg) );
+    assert_int_equal( errmsg.line_num, 0 );
+
+    size_t size;
+    char *data = read_whole_file("atomic.ini", &size);
+    assert_non_null( data );
+    assert_int_equal( size, expected_size );
+    assert_memory_equal( data, expected, size );
+    free(data);
+
+    assert_int_equal( 0, system("test \"$(stat -c %a atomic.ini)\" = 640") );
+
+    assert_true( nini_root_save_file_atomic(&root, "atomic.ini", 0, NULL) );
+    data = read_whole_file("atomic.ini", &size);
+    assert_non_null( data );
+    assert_int_equal( size, expected_size );
+    assert_memory_equal( data, expected, size );
+    free(data);
+
+    // The old file must be kept if the root cannot be encoded.
+
+    char name[NINI_MAX_LINE_CHARS];
+    memset(name, 'n', sizeof(name) - 1);
+    name[ sizeof(name) - 1 ] = 0;
+    assert_true( nini_root_link_child(&root, nini_node_create_null(name)) );
+
+    assert_false( nini_root_save_file_atomic(&root, "atomic.ini", 1, &errmsg) );
+    assert_string_equal( errmsg.message, "Line too long!" );
+
+    data = read_whole_file("atomic.ini", &size);
+    assert_non_null( data );
+    assert_int_equal( size, expected_size );
+    assert_memory_equal( data, expected, size );
+    free(data);
+
+    // No temporary file is left.
+
+    assert_int_not_equal( 0, system("ls atomic.ini.*.tmp > /dev/null 2>&1") );
+
+    // Directory that does not exist.
+
+    assert_false( nini_root_save_file_atomic(&root, "no-such-dir/atomic.ini", 1, &errmsg) );
+    assert_string_equal( errmsg.message, "Cannot create the temporary file!" );
+
+    // Empty root.
+
+    nini_root_clear(&root);
+    assert_true( nini_root_save_file_atomic(&root, "atomic.ini", 1, NULL) );
+    data = read_whole_file("atomic.ini", &size);
+    assert_non_null( data );
+    assert_int_equal( size, 0 );
+    free(data);
+
+    free(expected);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void lossless_encode_test(void **state)
+{
+    static const char source[] =
+        "; Video settings\n"
+        "[video]\n"
+        "    width  = 1920   ; pixels\n"
+        "    height = 1080\n"
+        "    [codec]\n"
+        "        name = h264\n"
+        "\n"
+        "    ; Frame rate\n"
+        "    fps = 29.97\n"
+        "[audio]\n"
+        "    channels = 2\n"
+        "\n"
+        "; End of file\n";
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    nini_root_enable_lossless(&root);
+    assert_true( nini_root_is_lossless(&root) );
+    assert_true( nini_root_decode(&root, source, strlen(source), NULL) );
+
+    // Unchanged data will be encoded as the source.
+
+    size_t size;
+    char  *data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_string_equal( data, source );
+    free(data);
+
+    // Only changed nodes will be formatted.
+
+    static const char expected[] =
+        "; Video settings\n"
+        "[video]\n"
+        "    width  = 1920   ; pixels\n"
+        "    height = 720\n"
+        "    [codec]\n"
+        "        name = h264\n"
+        "        profile = \"high\"\n"
+        "[audio]\n"
+        "    channels = 2\n"
+        "[extra]\n"
+        "    enabled = true\n"
+        "\n"
+        "; End of file\n";
+
+    assert_true( nini_write_decimal(&root, "video/height", '/', 720) );
+    assert_true( nini_write_string(&root, "video/codec/profile", '/', "high") );
+    assert_true( nini_write_bool(&root, "extra/enabled", '/', true) );
+    nini_remove(&root, "video/fps", '/');
+
+    assert_int_equal( nini_root_encoded_size(&root), strlen(expected) );
+
+    data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_string_equal( data, expected );
+    free(data);
+
+    sink_t sink = { .max_writes = -1 };
+    assert_int_equal( nini_root_encode_to_stream(&root, &sink, sink_on_write, NULL), strlen(expected) );
+    assert_memory_equal( sink.data, expected, strlen(expected) );
+    free(sink.data);
+
+    // Moved nodes will be formatted at their new level.
+
+    nini_node_t *audio = nini_root_find_child(&root, "audio");
+    assert_non_null( audio );
+    assert_true( nini_node_unlink(audio) );
+    assert_true( nini_node_link_child(nini_root_find_child(&root, "video"), audio) );
+
+    data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_non_null( strstr(data, "        profile = \"high\"\n"
+                                  "    [audio]\n"
+                                  "        channels = 2\n"
+                                  "[extra]\n") );
+    free(data);
+
+    // The source will be released if the mode is disabled.
+
+    nini_root_disable_lossless(&root);
+    assert_false( nini_root_is_lossless(&root) );
+
+    data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_null( strstr(data, "; End of file") );
+    assert_null( strstr(data, "; pixels") );
+    free(data);
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
 int test_encode(void)
 {
     struct CMUnitTest tests[] =
     {
         cmocka_unit_test(value_types_encode_test),
         cmocka_unit_test(indents_encode_test),
+        cmocka_unit_test(limits_encode_test),
+        cmocka_unit_test(memory_encode_test),
+        cmocka_unit_test(escape_encode_test),
+        cmocka_unit_test(parallel_encode_test),
+        cmocka_unit_test(atomic_save_encode_test),
+        cmocka_unit_test(lossless_encode_test),
     };
 
     return cmocka_run_group_tests_name("encode_test", tests, NULL, NULL);
@@ -117,6 +117,74 @@ void helper_remove_test(void **state)
     nini_root_deinit(&root);
 }
 //------------------------------------------------------------------------------
+static
+void helper_frozen_test(void **state)
+{
+    nini_root_t root;
+    nini_root_init(&root, &format_no_indents);
+
+    assert_true( nini_root_load_file(&root, "samples/value-types.ini", NULL) );
+
+    // Add duplicated sections, only the first one can be reached by paths.
+
+    assert_true( nini_write_decimal(&root, "dup/value", '/', 1) );
+    nini_node_t *dup = nini_node_create_section("dup");
+    nini_node_t *val = nini_node_create_decimal("other", 2);
+    assert_true( nini_node_link_child(dup, val) );
+    assert_true( nini_root_link_child(&root, dup) );
+
+    assert_true( nini_root_freeze(&root, '/') );
+    assert_true( nini_root_is_frozen(&root) );
+
+    // Read by the full path index.
+
+    assert_string_equal( nini_read_string(&root, "string/spaces", '/', "fail-string"), "string with spaces" );
+    assert_string_equal( nini_read_string(&root, "string-fail/spaces", '/', "fail-string"), "fail-string" );
+    assert_int_equal( nini_read_integer(&root, "integer/hexadecimal", '/', -1), 0x1A7B );
+    assert_true( nini_read_bool(&root, "boolean/true", '/', false) );
+    assert_true( nini_is_existed(&root, "", '/') );
+    assert_true( nini_is_existed(&root, "integer", '/') );
+    assert_int_equal( nini_get_type(&root, "null/null", '/'), NINI_NULL );
+
+    assert_int_equal( nini_read_integer(&root, "dup/value", '/', -1), 1 );
+    assert_false( nini_is_existed(&root, "dup/other", '/') );
+
+    // Read by an other delimiter.
+
+    assert_int_equal( nini_read_integer(&root, "integer.decimal", '.', -1), 13579 );
+
+    // Modifications will fail.
+
+    assert_false( nini_write_decimal(&root, "integer/decimal", '/', 0) );
+    assert_false( nini_write_decimal(&root, "integer/new", '/', 0) );
+    nini_remove(&root, "integer/decimal", '/');
+    assert_int_equal( nini_read_integer(&root, "integer/decimal", '/', -1), 13579 );
+
+    nini_node_t *node = nini_node_create_null("null");
+    assert_false( nini_root_link_child(&root, node) );
+    nini_node_release(node);
+
+    assert_false( nini_node_unlink(nini_root_find_child(&root, "integer")) );
+    assert_false( nini_root_load_file(&root, "samples/value-types.ini", NULL) );
+    assert_true( nini_is_existed(&root, "integer/decimal", '/') );
+
+    // Thaw the root.
+
+    nini_root_thaw(&root);
+    assert_false( nini_root_is_frozen(&root) );
+
+    assert_true( nini_write_decimal(&root, "integer/decimal", '/', 0) );
+    assert_int_equal( nini_read_integer(&root, "integer/decimal", '/', -1), 0 );
+
+    // Freeze an empty root.
+
+    nini_root_clear(&root);
+    assert_true( nini_root_freeze(&root, '/') );
+    assert_false( nini_is_existed(&root, "integer", '/') );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
 int test_helper(void)
 {
     struct CMUnitTest tests[] =
@@ -125,6 +193,7 @@ int test_helper(void)
         cmocka_unit_test(helper_read_test),
         cmocka_unit_test(helper_write_test),
         cmocka_unit_test(helper_remove_test),
+        cmocka_unit_test(helper_frozen_test),
     };
 
     return cmocka_run_group_tests_name("helper_test", tests, NULL, NULL);
@@ -0,0 +1,227 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_include.h"
+#include "formats.h"
+#include "fixtures.h"
+#include "test_include.h"
+
+static const char main_text[] =
+    "name = \"main\"\n"
+    "[video]\n"
+    "    include = \"parts/video.ini\"\n"
+    "    fps = 30\n"
+    "[audio]\n"
+    "    include = \"parts/codec.ini\"\n";
+
+static const char video_text[] =
+    "width = 1920\n"
+    "[codec]\n"
+    "    include = \"codec.ini\"\n"
+    "height = 1080\n";
+
+static const char codec_text[] =
+    "name = h264\n"
+    "profile = high\n";
+
+static const char resolved_text[] =
+    "name = \"main\"\n"
+    "[video]\n"
+    "    width = 1920\n"
+    "    [codec]\n"
+    "        name = h264\n"
+    "        profile = high\n"
+    "    height = 1080\n"
+    "    fps = 30\n"
+    "[audio]\n"
+    "    name = h264\n"
+    "    profile = high\n";
+
+//------------------------------------------------------------------------------
+static
+void write_text(const char *filename, const char *text)
+{
+    FILE *file = fopen(filename, "wb");
+    assert_non_null( file );
+    assert_int_equal( fputs(text, file) >= 0, true );
+    fclose(file);
+}
+//------------------------------------------------------------------------------
+static
+void write_files(void)
+{
+    assert_int_equal( 0, system("rm -rf include-files && mkdir -p include-files/parts") );
+    write_text("include-files/main.ini", main_text);
+    write_text("include-files/parts/video.ini", video_text);
+    write_text("include-files/parts/codec.ini", codec_text);
+}
+//------------------------------------------------------------------------------
+static
+void resolve_include_test(void **state)
+{
+    write_files();
+
+    nini_includer_t includer;
+    nini_includer_init(&includer, &format_have_indents, "include", 4);
+
+    // Files included at any level are grafted in place, and a file included twice is loaded once.
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    nini_errmsg_t errmsg;
+    assert_true( nini_includer_load_file(&includer, &root, "include-files/main.ini", &errmsg) );
+    assert_string_equal( errmsg.message, "" );
+    assert_encoded(&root, resolved_text);
+    assert_int_equal( nini_includer_get_count(&includer), 2 );
+
+    // Roots those are not loaded from files resolve names by the current directory.
+    nini_root_t other;
+    nini_root_init(&other, &format_have_indents);
+    static const char other_text[] = "[codec]\n    include = \"include-files/parts/codec.ini\"\n";
+    assert_true( nini_root_decode(&other, other_text, strlen(other_text), NULL) );
+    assert_true( nini_includer_resolve(&includer, &other, NULL, &errmsg) );
+    assert_string_equal( nini_read_string(&other, "codec/profile", '/', ""), "high" );
+    assert_int_equal( nini_includer_get_count(&includer), 2 );
+
+    // Changed files are loaded again.
+    write_text("include-files/parts/codec.ini", "name = h265\n");
+    assert_true( nini_includer_load_file(&includer, &other, "include-files/main.ini", &errmsg) );
+    assert_string_equal( nini_read_string(&other, "video/codec/name", '/', ""), "h265" );
+    assert_string_equal( nini_read_string(&other, "audio/name", '/', ""), "h265" );
+    assert_false( nini_is_existed(&other, "audio/profile", '/') );
+    assert_string_equal( nini_read_string(&root, "video/codec/name", '/', ""), "h264" );
+
+    // Files changed in the same second with the same size are loaded again too.
+    write_text("include-files/parts/codec.ini", "name = h266\n");
+    assert_true( nini_includer_load_file(&includer, &other, "include-files/main.ini", &errmsg) );
+    assert_string_equal( nini_read_string(&other, "audio/name", '/', ""), "h266" );
+
+    // Directives of a resolved root are all replaced.
+    assert_true( nini_includer_resolve(&includer, &root, "include-files/main.ini", &errmsg) );
+    assert_encoded(&root, resolved_text);
+
+    nini_includer_clear(&includer);
+    assert_int_equal( nini_includer_get_count(&includer), 0 );
+
+    nini_root_deinit(&other);
+    nini_root_deinit(&root);
+    nini_includer_deinit(&includer);
+
+    assert_int_equal( 0, system("rm -rf include-files") );
+}
+//------------------------------------------------------------------------------
+static
+void fail_include_test(void **state)
+{
+    write_files();
+    write_text("include-files/loop-a.ini", "[a]\n    include = \"loop-b.ini\"\n");
+    write_text("include-files/loop-b.ini", "[b]\n    include = \"loop-a.ini\"\n");
+    write_text("include-files/self.ini", "include = \"self.ini\"\n");
+    write_text("include-files/broken.ini", "key = 1\n[]\n");
+
+    nini_includer_t includer;
+    nini_includer_init(&includer, &format_have_indents, "include", 4);
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    nini_errmsg_t errmsg;
+
+    // Include cycles are detected, and the root is not changed.
+    static const char loop_text[] = "key = 1\ninclude = \"include-files/loop-a.ini\"\n";
+    assert_true( nini_root_decode(&root, loop_text, strlen(loop_text), NULL) );
+    assert_false( nini_includer_resolve(&includer, &root, NULL, &errmsg) );
+    assert_string_equal( errmsg.message, "Include cycle!" );
+    assert_encoded(&root, loop_text);
+
+    assert_false( nini_includer_load_file(&includer, &root, "include-files/loop-a.ini", &errmsg) );
+    assert_string_equal( errmsg.message, "Include cycle!" );
+    assert_false( nini_includer_load_file(&includer, &root, "include-files/self.ini", &errmsg) );
+    assert_string_equal( errmsg.message, "Include cycle!" );
+
+    // Files those cannot be read or decoded.
+    static const char missing_text[] = "[a]\n    include = \"include-files/missing.ini\"\n";
+    assert_true( nini_root_decode(&root, missing_text, strlen(missing_text), NULL) );
+    assert_false( nini_includer_resolve(&includer, &root, NULL, &errmsg) );
+    assert_string_equal( errmsg.message, "Cannot read the file!" );
+    assert_string_equal( errmsg.line_text, "include-files/missing.ini" );
+    assert_encoded(&root, missing_text);
+
+    static const char broken_text[] = "include = \"include-files/broken.ini\"\n";
+    assert_true( nini_root_decode(&root, broken_text, strlen(broken_text), NULL) );
+    assert_false( nini_includer_resolve(&includer, &root, NULL, &errmsg) );
+    assert_string_equal( errmsg.message, "Section name empty!" );
+    assert_int_equal( errmsg.line_num, 2 );
+
+    // The file is loaded again after it be fixed.
+    write_text("include-files/broken.ini", "key = 1\n[section]\n");
+    assert_true( nini_includer_resolve(&includer, &root, NULL, &errmsg) );
+    assert_int_equal( nini_read_integer(&root, "key", '/', 0), 1 );
+
+    assert_true( nini_root_freeze(&root, '/') );
+    assert_false( nini_includer_resolve(&includer, &root, NULL, &errmsg) );
+    assert_string_equal( errmsg.message, "Root is frozen!" );
+
+    nini_root_deinit(&root);
+    nini_includer_deinit(&includer);
+
+    assert_int_equal( 0, system("rm -rf include-files") );
+}
+//------------------------------------------------------------------------------
+static
+void share_include_test(void **state)
+{
+    write_files();
+
+    nini_pool_t pool;
+    nini_pool_init(&pool);
+
+    nini_includer_t includer;
+    nini_includer_init(&includer, &format_have_indents, "include", 0);
+    nini_includer_set_pool(&includer, &pool);
+
+    // Included sections are shared by roots.
+    nini_root_t first, second;
+    nini_root_init(&first, &format_have_indents);
+    nini_root_init(&second, &format_have_indents);
+    assert_true( nini_includer_load_file(&includer, &first, "include-files/main.ini", NULL) );
+    assert_true( nini_includer_load_file(&includer, &second, "include-files/main.ini", NULL) );
+    assert_encoded(&first, resolved_text);
+    assert_encoded(&second, resolved_text);
+
+    nini_node_t *codec = nini_node_find_child(nini_root_find_child(&first, "video"), "codec");
+    assert_true( nini_node_is_shared(codec) );
+    assert_ptr_equal( nini_node_get_first_child(codec),
+                      nini_node_get_first_child(nini_node_find_child(nini_root_find_child(&second, "video"), "codec")) );
+
+    assert_true( nini_write_string(&first, "video/codec/name", '/', "h265") );
+    assert_string_equal( nini_read_string(&second, "video/codec/name", '/', ""), "h264" );
+
+    nini_includer_deinit(&includer);
+    nini_pool_deinit(&pool);
+    assert_encoded(&second, resolved_text);
+
+    nini_root_deinit(&first);
+    nini_root_deinit(&second);
+
+    assert_int_equal( 0, system("rm -rf include-files") );
+}
+//------------------------------------------------------------------------------
+int test_include(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(resolve_include_test),
+        cmocka_unit_test(fail_include_test),
+        cmocka_unit_test(share_include_test),
+    };
+
+    return cmocka_run_group_tests_name("include_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
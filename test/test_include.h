@@ -0,0 +1,14 @@
+#ifndef _TEST_INCLUDE_H_
+#define _TEST_INCLUDE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_include(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,218 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_journal.h"
+#include "formats.h"
+#include "test_journal.h"
+
+//------------------------------------------------------------------------------
+static
+long file_size(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if( !file ) return -1;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    return size;
+}
+//------------------------------------------------------------------------------
+static
+void check_values(const nini_root_t *root)
+{
+    assert_string_equal( nini_read_string(root, "path/to/string", '/', "fail"), "string value" );
+    assert_int_equal( nini_read_integer(root, "path/to/decimal", '/', 0), -123 );
+    assert_int_equal( nini_read_integer(root, "path/to/hexa", '/', 0), 0xABCD );
+    assert_true( nini_read_float(root, "path/to/float", '/', 0) == 0.125 );
+    assert_true( nini_read_bool(root, "path/to/bool", '/', false) );
+    assert_true( nini_is_existed(root, "path/to/null", '/') );
+    assert_false( nini_is_existed(root, "path/to/removed", '/') );
+}
+//------------------------------------------------------------------------------
+static
+void make_changes(nini_journal_t *journal)
+{
+    assert_true( nini_journal_write_string(journal, "path/to/string", '/', "string value") );
+    assert_true( nini_journal_write_decimal(journal, "path/to/decimal", '/', -123) );
+    assert_true( nini_journal_write_hexa(journal, "path/to/hexa", '/', 0xABCD) );
+    assert_true( nini_journal_write_float(journal, "path/to/float", '/', 0.125) );
+    assert_true( nini_journal_write_bool(journal, "path/to/bool", '/', true) );
+    assert_true( nini_journal_write_null(journal, "path/to/null", '/') );
+    assert_true( nini_journal_write_decimal(journal, "path/to/removed", '/', 1) );
+    assert_true( nini_journal_remove(journal, "path/to/removed", '/') );
+}
+//------------------------------------------------------------------------------
+static
+void replay_journal_test(void **state)
+{
+    assert_int_equal( 0, system("rm -f journal.ini journal.ini.journal") );
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    nini_journal_t journal;
+    nini_errmsg_t  errmsg;
+    assert_true( nini_journal_open(&journal, &root, "journal.ini", 0, &errmsg) );
+    long empty_size = nini_journal_get_size(&journal);
+    assert_true( empty_size > 0 );
+
+    make_changes(&journal);
+    check_values(&root);
+
+    // Changes those cannot be applied must not be recorded.
+    assert_false( nini_journal_write_decimal(&journal, "path/to/string/value", '/', 1) );
+
+    // Nothing is written to the file before the commit.
+    assert_int_equal( file_size("journal.ini.journal"), empty_size );
+
+    assert_true( nini_journal_commit(&journal, &errmsg) );
+    long size = nini_journal_get_size(&journal);
+    assert_true( size > empty_size );
+    assert_int_equal( file_size("journal.ini.journal"), size );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    // The base file is not written without compaction.
+    assert_int_equal( file_size("journal.ini"), -1 );
+
+    // Load the base file and replay the journal.
+    nini_root_t loaded;
+    nini_root_init(&loaded, &format_have_indents);
+    assert_true( nini_journal_open(&journal, &loaded, "journal.ini", 0, &errmsg) );
+    assert_int_equal( nini_journal_get_size(&journal), size );
+    check_values(&loaded);
+
+    // Uncommitted changes are committed by close.
+    assert_true( nini_journal_write_decimal(&journal, "path/to/decimal", '/', 456) );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    assert_true( nini_journal_open(&journal, &loaded, "journal.ini", 0, NULL) );
+    assert_int_equal( nini_read_integer(&loaded, "path/to/decimal", '/', 0), 456 );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    nini_root_deinit(&loaded);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void broken_journal_test(void **state)
+{
+    assert_int_equal( 0, system("rm -f journal.ini journal.ini.journal") );
+    assert_int_equal( 0, system("printf '[base]\\n    value = 1\\n' > journal.ini") );
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    nini_journal_t journal;
+    assert_true( nini_journal_open(&journal, &root, "journal.ini", 0, NULL) );
+    assert_int_equal( nini_read_integer(&root, "base/value", '/', 0), 1 );
+
+    make_changes(&journal);
+    assert_true( nini_journal_close(&journal, NULL) );
+    long size = file_size("journal.ini.journal");
+
+    // A torn record left by an interrupted commit will be removed.
+    assert_int_equal( 0, system("printf '\\040\\000\\000\\000\\001\\002\\003\\004SD' >> journal.ini.journal") );
+    assert_int_equal( file_size("journal.ini.journal"), size + 10 );
+
+    nini_root_t loaded;
+    nini_root_init(&loaded, &format_have_indents);
+    assert_true( nini_journal_open(&journal, &loaded, "journal.ini", 0, NULL) );
+    assert_int_equal( nini_journal_get_size(&journal), size );
+    assert_int_equal( file_size("journal.ini.journal"), size );
+    assert_int_equal( nini_read_integer(&loaded, "base/value", '/', 0), 1 );
+    check_values(&loaded);
+
+    // New records are appended after the valid ones.
+    assert_true( nini_journal_write_bool(&journal, "path/to/bool", '/', false) );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    assert_true( nini_journal_open(&journal, &loaded, "journal.ini", 0, NULL) );
+    assert_false( nini_read_bool(&loaded, "path/to/bool", '/', true) );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    // A file that is not a journal.
+    assert_int_equal( 0, system("echo not a journal > journal.ini.journal") );
+
+    nini_errmsg_t errmsg;
+    assert_false( nini_journal_open(&journal, &loaded, "journal.ini", 0, &errmsg) );
+    assert_string_equal( errmsg.message, "Invalid journal file!" );
+
+    // A journal that cannot be read is not treated as an empty one.
+    assert_int_equal( 0, system("rm -f journal.ini.journal && ln -s journal.ini.journal journal.ini.journal") );
+    assert_false( nini_journal_open(&journal, &loaded, "journal.ini", 0, &errmsg) );
+    assert_string_equal( errmsg.message, "Cannot read the journal file!" );
+    assert_int_equal( 0, system("test -L journal.ini.journal && rm journal.ini.journal") );
+
+    nini_root_deinit(&loaded);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void compact_journal_test(void **state)
+{
+    assert_int_equal( 0, system("rm -f journal.ini journal.ini.journal") );
+    assert_int_equal( 0, system("printf '; Comment\\n[base]\\n    value = 1\\n' > journal.ini") );
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    nini_root_enable_lossless(&root);
+
+    nini_journal_t journal;
+    assert_true( nini_journal_open(&journal, &root, "journal.ini", 128, NULL) );
+    long empty_size = nini_journal_get_size(&journal);
+
+    // The journal is compacted after the commit which makes it large enough.
+    assert_true( nini_journal_write_decimal(&journal, "base/value", '/', 2) );
+    assert_true( nini_journal_commit(&journal, NULL) );
+    assert_true( nini_journal_get_size(&journal) > empty_size );
+
+    make_changes(&journal);
+    nini_errmsg_t errmsg;
+    assert_true( nini_journal_commit(&journal, &errmsg) );
+    assert_int_equal( nini_journal_get_size(&journal), empty_size );
+    assert_int_equal( file_size("journal.ini.journal"), empty_size );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    // The base file contains all changes, and the comment is kept.
+    nini_root_t loaded;
+    nini_root_init(&loaded, &format_have_indents);
+    assert_true( nini_root_load_file(&loaded, "journal.ini", NULL) );
+    assert_int_equal( nini_read_integer(&loaded, "base/value", '/', 0), 2 );
+    check_values(&loaded);
+    assert_int_equal( 0, system("head -n 1 journal.ini | grep -q '^; Comment$'") );
+
+    // Compact by request.
+    assert_true( nini_journal_open(&journal, &loaded, "journal.ini", 0, NULL) );
+    assert_true( nini_journal_write_decimal(&journal, "base/value", '/', 3) );
+    assert_true( nini_journal_compact(&journal, NULL) );
+    assert_int_equal( nini_journal_get_size(&journal), empty_size );
+    assert_true( nini_journal_close(&journal, NULL) );
+
+    assert_true( nini_root_load_file(&loaded, "journal.ini", NULL) );
+    assert_int_equal( nini_read_integer(&loaded, "base/value", '/', 0), 3 );
+
+    nini_root_deinit(&loaded);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+int test_journal(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(replay_journal_test),
+        cmocka_unit_test(broken_journal_test),
+        cmocka_unit_test(compact_journal_test),
+    };
+
+    return cmocka_run_group_tests_name("journal_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
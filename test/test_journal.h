@@ -0,0 +1,14 @@
+#ifndef _TEST_JOURNAL_H_
+#define _TEST_JOURNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_journal(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
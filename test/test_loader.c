@@ -0,0 +1,170 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_loader.h"
+#include "formats.h"
+#include "test_loader.h"
+
+#define FILE_COUNT 100
+
+typedef struct loads_t
+{
+    int  succeed;
+    int  failed;
+    char message[NINI_MAX_LINE_CHARS+1];
+    bool reported[FILE_COUNT+2];
+} loads_t;
+
+//------------------------------------------------------------------------------
+static
+void on_load(void *arg, size_t index, nini_root_t *root, const nini_errmsg_t *errmsg)
+{
+    loads_t *loads = arg;
+    if( root )
+    {
+        ++ loads->succeed;
+    }
+    else
+    {
+        ++ loads->failed;
+        strcpy(loads->message, errmsg->message);
+    }
+
+    if( index < FILE_COUNT + 2 ) loads->reported[index] = true;
+}
+//------------------------------------------------------------------------------
+static
+void write_files(void)
+{
+    assert_int_equal( 0, system("rm -rf loader-files && mkdir loader-files") );
+
+    for(int i = 0; i < FILE_COUNT; ++i)
+    {
+        nini_root_t root;
+        nini_root_init(&root, &format_have_indents);
+        nini_write_decimal(&root, "tenant/id", '/', i);
+
+        // Sizes of files are very different.
+        for(int k = 0; k < ( i % 10 ) * 20; ++k)
+        {
+            char path[32];
+            snprintf(path, sizeof(path), "tenant/key-%d", k);
+            nini_write_decimal(&root, path, '/', k);
+        }
+
+        char filename[64];
+        snprintf(filename, sizeof(filename), "loader-files/tenant-%03d.ini", i);
+        assert_true( nini_root_save_file(&root, filename, NULL) );
+
+        nini_root_deinit(&root);
+    }
+
+    assert_int_equal( 0, system("printf '[]\\n' > loader-files/broken.ini && "
+                                "printf 'id = 0\\n' > loader-files/notes.txt && "
+                                "printf 'id = 0\\n' > loader-files/.hidden.ini && "
+                                "mkdir loader-files/sub.ini") );
+}
+//------------------------------------------------------------------------------
+static
+void load_loader_test(void **state)
+{
+    write_files();
+
+    for(unsigned threads = 1; threads <= 8; threads *= 2)
+    {
+        nini_loader_t loader;
+        nini_loader_init(&loader);
+
+        // Files are added in the order of names.
+        assert_int_equal( nini_loader_add_directory(&loader, "loader-files", "*.ini", &format_have_indents),
+                          FILE_COUNT + 1 );
+        assert_string_equal( nini_loader_get_filename(&loader, 0), "loader-files/broken.ini" );
+        assert_string_equal( nini_loader_get_filename(&loader, 1), "loader-files/tenant-000.ini" );
+        assert_null( nini_loader_get_filename(&loader, FILE_COUNT + 1) );
+
+        nini_root_t root;
+        nini_root_init(&root, &format_have_indents);
+        assert_true( nini_loader_add_file(&loader, "loader-files/missing.ini", &root) );
+        assert_ptr_equal( nini_loader_get_root(&loader, FILE_COUNT + 1), &root );
+
+        loads_t loads;
+        memset(&loads, 0, sizeof(loads));
+        assert_int_equal( nini_loader_load(&loader, threads, on_load, &loads), FILE_COUNT );
+
+        // Each file is reported once.
+        assert_int_equal( loads.succeed, FILE_COUNT );
+        assert_int_equal( loads.failed, 2 );
+        for(int i = 0; i < FILE_COUNT + 2; ++i)
+            assert_true( loads.reported[i] );
+
+        assert_false( nini_loader_is_loaded(&loader, 0) );
+        assert_false( nini_loader_is_loaded(&loader, FILE_COUNT + 1) );
+        assert_false( nini_loader_is_loaded(&loader, FILE_COUNT + 2) );
+        for(int i = 0; i < FILE_COUNT; ++i)
+        {
+            assert_true( nini_loader_is_loaded(&loader, i + 1) );
+            nini_root_t *tenant = nini_loader_get_root(&loader, i + 1);
+            assert_int_equal( nini_read_integer(tenant, "tenant/id", '/', -1), i );
+            assert_int_equal( nini_is_existed(tenant, "tenant/key-0", '/'), i % 10 != 0 );
+        }
+
+        nini_loader_deinit(&loader);
+        nini_root_deinit(&root);
+    }
+
+    assert_int_equal( 0, system("rm -rf loader-files") );
+}
+//------------------------------------------------------------------------------
+static
+void reload_loader_test(void **state)
+{
+    assert_int_equal( 0, system("rm -f loader.ini && printf '[section]\\n    value = 1\\n' > loader.ini") );
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    nini_write_decimal(&root, "old", '/', 0);
+
+    nini_loader_t loader;
+    nini_loader_init(&loader);
+    assert_int_equal( nini_loader_load(&loader, 4, on_load, NULL), 0 );
+    assert_false( nini_loader_add_file(&loader, NULL, &root) );
+    assert_true( nini_loader_add_file(&loader, "loader.ini", &root) );
+
+    // A loaded root is replaced by the file.
+    assert_int_equal( nini_loader_load(&loader, 4, NULL, NULL), 1 );
+    assert_int_equal( nini_read_integer(&root, "section/value", '/', 0), 1 );
+    assert_false( nini_is_existed(&root, "old", '/') );
+
+    // Frozen roots cannot be loaded.
+    loads_t loads;
+    memset(&loads, 0, sizeof(loads));
+    assert_true( nini_root_freeze(&root, '/') );
+    assert_int_equal( nini_loader_load(&loader, 4, on_load, &loads), 0 );
+    assert_string_equal( loads.message, "Root is frozen!" );
+    assert_false( nini_loader_is_loaded(&loader, 0) );
+    assert_int_equal( nini_read_integer(&root, "section/value", '/', 0), 1 );
+
+    nini_loader_deinit(&loader);
+    nini_root_deinit(&root);
+
+    remove("loader.ini");
+}
+//------------------------------------------------------------------------------
+int test_loader(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(load_loader_test),
+        cmocka_unit_test(reload_loader_test),
+    };
+
+    return cmocka_run_group_tests_name("loader_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_LOADER_H_
+#define _TEST_LOADER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_loader(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -223,6 +223,271 @@ void node_unlink_test(void **state)
     nini_node_release(section);
 }
 //------------------------------------------------------------------------------
+static
+void node_replace_test(void **state)
+{
+    nini_node_t *section = nini_node_create_section("section");
+    assert_non_null( section );
+    assert_true( nini_node_enable_index(section) );
+
+    nini_node_t *child1 = nini_node_create_decimal("child1", 1);
+    nini_node_t *child2 = nini_node_create_decimal("child2", 2);
+    nini_node_t *child3 = nini_node_create_decimal("child3", 3);
+    assert_true( nini_node_link_child(section, child1) );
+    assert_true( nini_node_link_child(section, child2) );
+    assert_true( nini_node_link_child(section, child3) );
+
+    // Replace by a node with the same name.
+
+    nini_node_t *new2 = nini_node_create_string("child2", "two");
+    assert_non_null( new2 );
+    assert_true( nini_node_replace(child2, new2) );
+    assert_false( nini_node_replace(child2, new2) );
+    nini_node_release(child2);
+
+    assert_ptr_equal( nini_node_get_next_sibling(child1), new2 );
+    assert_ptr_equal( nini_node_get_next_sibling(new2), child3 );
+    assert_ptr_equal( nini_node_get_prev_sibling(child3), new2 );
+    assert_ptr_equal( nini_node_find_child(section, "child2"), new2 );
+
+    // Replace the first child by a node with a different name.
+
+    nini_node_t *child0 = nini_node_create_null("child0");
+    assert_non_null( child0 );
+    assert_true( nini_node_replace(child1, child0) );
+    nini_node_release(child1);
+
+    assert_ptr_equal( nini_node_get_first_child(section), child0 );
+    assert_ptr_equal( nini_node_get_prev_sibling(new2), child0 );
+    assert_ptr_equal( nini_node_find_child(section, "child0"), child0 );
+    assert_null( nini_node_find_child(section, "child1") );
+
+    nini_node_iter_t iter;
+    assert_true( nini_node_scan_prefix(section, "child", &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), child0 );
+    assert_ptr_equal( nini_node_iter_next(&iter), new2 );
+    assert_ptr_equal( nini_node_iter_next(&iter), child3 );
+    assert_null( nini_node_iter_next(&iter) );
+
+    nini_node_release(section);
+}
+//------------------------------------------------------------------------------
+static
+void node_copy_test(void **state)
+{
+    nini_node_t *section = nini_node_create_section("section");
+    nini_node_t *child1  = nini_node_create_decimal("child1", 1);
+    nini_node_t *child2  = nini_node_create_string("child2", "two");
+    nini_node_t *child3  = nini_node_create_section("child3");
+    assert_true( nini_node_link_child(section, child1) );
+    assert_true( nini_node_link_child(section, child2) );
+    assert_true( nini_node_link_child(section, child3) );
+    assert_true( nini_node_link_child(child3, nini_node_create_bool("flag", true)) );
+
+    // Clone the whole tree.
+
+    nini_node_t *copy = nini_node_clone(section);
+    assert_non_null( copy );
+    assert_string_equal( nini_node_get_name(copy), "section" );
+    assert_int_equal( nini_node_get_integer(nini_node_find_child(copy, "child1")), 1 );
+    assert_string_equal( nini_node_get_string(nini_node_find_child(copy, "child2")), "two" );
+    assert_true( nini_node_get_bool(nini_node_find_child(nini_node_find_child(copy, "child3"), "flag")) );
+    assert_ptr_not_equal( nini_node_find_child(copy, "child1"), child1 );
+
+    // Copy values between keys, and keys keep their names.
+
+    assert_true( nini_node_copy_value(child1, nini_node_find_child(copy, "child2")) );
+    assert_int_equal( nini_node_get_type(child1), NINI_STRING );
+    assert_string_equal( nini_node_get_name(child1), "child1" );
+    assert_string_equal( nini_node_get_string(child1), "two" );
+
+    nini_node_t *hexa = nini_node_create_hexa("hexa", 0x10);
+    assert_true( nini_node_copy_value(child2, hexa) );
+    assert_int_equal( nini_node_get_type(child2), NINI_HEXA );
+    assert_int_equal( nini_node_get_integer(child2), 0x10 );
+    assert_false( nini_node_copy_value(child3, hexa) );
+    assert_false( nini_node_copy_value(child2, child3) );
+    nini_node_release(hexa);
+
+    // Move siblings.
+
+    assert_true( nini_node_move_after(child1, child3) );
+    assert_ptr_equal( nini_node_get_first_child(section), child2 );
+    assert_ptr_equal( nini_node_get_next_sibling(child3), child1 );
+    assert_ptr_equal( nini_node_get_last_child(section), child1 );
+
+    assert_true( nini_node_move_after(child3, NULL) );
+    assert_ptr_equal( nini_node_get_first_child(section), child3 );
+    assert_ptr_equal( nini_node_get_next_sibling(child3), child2 );
+    assert_ptr_equal( nini_node_get_prev_sibling(child2), child3 );
+
+    assert_false( nini_node_move_after(child1, nini_node_find_child(copy, "child1")) );
+    assert_false( nini_node_move_after(section, NULL) );
+
+    nini_node_release(copy);
+    nini_node_release(section);
+}
+//------------------------------------------------------------------------------
+static
+nini_node_t* create_hash_tree(void)
+{
+    nini_node_t *section = nini_node_create_section("section");
+    nini_node_t *child   = nini_node_create_section("child");
+    assert_true( nini_node_link_child(section, nini_node_create_decimal("decimal", 10)) );
+    assert_true( nini_node_link_child(section, nini_node_create_string("string", "text")) );
+    assert_true( nini_node_link_child(section, child) );
+    assert_true( nini_node_link_child(child, nini_node_create_float("float", 1.5)) );
+
+    return section;
+}
+//------------------------------------------------------------------------------
+static
+void node_hash_test(void **state)
+{
+    nini_node_t *tree1 = create_hash_tree();
+    nini_node_t *tree2 = create_hash_tree();
+
+    // Trees with the same content have the same hash.
+    uint64_t hash = nini_node_get_hash(tree1);
+    assert_true( nini_node_get_hash(tree2) == hash );
+
+    nini_node_t *copy = nini_node_clone(tree1);
+    assert_true( nini_node_get_hash(copy) == hash );
+    nini_node_release(copy);
+
+    // Types, values, names, and orders are all parts of the content.
+    nini_node_t *decimal = nini_node_find_child(tree2, "decimal");
+    nini_node_t *hexa    = nini_node_create_hexa("decimal", 10);
+    assert_true( nini_node_copy_value(decimal, hexa) );
+    assert_true( nini_node_get_hash(tree2) != hash );
+
+    nini_node_t *other = nini_node_create_decimal("decimal", 10);
+    assert_true( nini_node_copy_value(decimal, other) );
+    assert_true( nini_node_get_hash(tree2) == hash );
+
+    nini_node_t *child      = nini_node_find_child(tree2, "child");
+    uint64_t     child_hash = nini_node_get_hash(child);
+    assert_true( nini_node_move_after(child, NULL) );
+    assert_true( nini_node_get_hash(tree2) != hash );
+    assert_true( nini_node_get_hash(child) == child_hash );
+    assert_true( nini_node_move_after(child, nini_node_get_last_child(tree2)) );
+    assert_true( nini_node_get_hash(tree2) == hash );
+
+    // Changes of a descendant are propagated to ancestors.
+    nini_node_t *floating = nini_node_find_child(child, "float");
+    nini_node_t *changed  = nini_node_create_float("float", 2.5);
+    assert_true( nini_node_replace(floating, changed) );
+    assert_true( nini_node_get_hash(child) != child_hash );
+    assert_true( nini_node_get_hash(tree2) != hash );
+
+    assert_true( nini_node_replace(changed, floating) );
+    assert_true( nini_node_get_hash(tree2) == hash );
+
+    nini_node_release(changed);
+    nini_node_release(hexa);
+    nini_node_release(other);
+    nini_node_release(tree1);
+    nini_node_release(tree2);
+}
+//------------------------------------------------------------------------------
+static
+void node_index_test(void **state)
+{
+    // Create section with some children before the index enabled.
+
+    nini_node_t *section = nini_node_create_section("section");
+    assert_non_null( section );
+
+    nini_node_t *beta = nini_node_create_null("beta");
+    assert_true( nini_node_link_child(section, beta) );
+    nini_node_t *alpha1 = nini_node_create_null("alpha");
+    assert_true( nini_node_link_child(section, alpha1) );
+
+    assert_true( nini_node_enable_index(section) );
+    assert_true( nini_node_have_index(section) );
+
+    // Add more children after the index enabled.
+
+    nini_node_t *alpha2 = nini_node_create_null("alpha");
+    assert_true( nini_node_link_child(section, alpha2) );
+    nini_node_t *alp = nini_node_create_null("alp");
+    assert_true( nini_node_link_child(section, alp) );
+    nini_node_t *gamma = nini_node_create_null("gamma");
+    assert_true( nini_node_link_child(section, gamma) );
+
+    // The sibling order is not changed.
+
+    assert_ptr_equal( nini_node_get_first_child(section), beta );
+    assert_ptr_equal( nini_node_get_last_child(section), gamma );
+
+    // Find child by the index, and the first one of duplicated names will be found.
+
+    assert_ptr_equal( nini_node_find_child(section, "alpha"), alpha1 );
+    assert_ptr_equal( nini_node_find_child(section, "gamma"), gamma );
+    assert_ptr_equal( nini_node_find_child(section, "delta"), NULL );
+
+    // Scan all in the name order.
+
+    nini_node_iter_t iter;
+    assert_true( nini_node_scan_range(section, NULL, NULL, &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), alp );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha1 );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha2 );
+    assert_ptr_equal( nini_node_iter_next(&iter), beta );
+    assert_ptr_equal( nini_node_iter_next(&iter), gamma );
+    assert_ptr_equal( nini_node_iter_next(&iter), NULL );
+
+    // Scan by prefix.
+
+    assert_true( nini_node_scan_prefix(section, "alp", &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), alp );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha1 );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha2 );
+    assert_ptr_equal( nini_node_iter_next(&iter), NULL );
+
+    assert_true( nini_node_scan_prefix(section, "x", &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), NULL );
+
+    // Scan by range.
+
+    assert_true( nini_node_scan_range(section, "alpha", "gamma", &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha1 );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha2 );
+    assert_ptr_equal( nini_node_iter_next(&iter), beta );
+    assert_ptr_equal( nini_node_iter_next(&iter), NULL );
+
+    assert_true( nini_node_lower_bound(section, "b", &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), beta );
+    assert_ptr_equal( nini_node_iter_next(&iter), gamma );
+    assert_ptr_equal( nini_node_iter_next(&iter), NULL );
+
+    // Remove children.
+
+    nini_node_unlink(alpha1);
+    nini_node_release(alpha1);
+
+    assert_ptr_equal( nini_node_find_child(section, "alpha"), alpha2 );
+
+    assert_true( nini_node_scan_prefix(section, "alpha", &iter) );
+    assert_ptr_equal( nini_node_iter_next(&iter), alpha2 );
+    assert_ptr_equal( nini_node_iter_next(&iter), NULL );
+
+    // Disable the index.
+
+    nini_node_disable_index(section);
+    assert_false( nini_node_have_index(section) );
+    assert_false( nini_node_scan_prefix(section, "alpha", &iter) );
+    assert_ptr_equal( nini_node_find_child(section, "alpha"), alpha2 );
+
+    // Nodes without children cannot have the index.
+
+    assert_false( nini_node_enable_index(gamma) );
+
+    // Clean up.
+
+    nini_node_release(section);
+}
+//------------------------------------------------------------------------------
 int test_node(void)
 {
     struct CMUnitTest tests[] =
@@ -235,6 +500,10 @@ int test_node(void)
         cmocka_unit_test(node_string_test),
         cmocka_unit_test(node_section_test),
         cmocka_unit_test(node_unlink_test),
+        cmocka_unit_test(node_replace_test),
+        cmocka_unit_test(node_copy_test),
+        cmocka_unit_test(node_hash_test),
+        cmocka_unit_test(node_index_test),
     };
 
     return cmocka_run_group_tests_name("node test", tests, NULL, NULL);
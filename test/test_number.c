@@ -0,0 +1,332 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <cmocka.h>
+#include "nini_helper.h"
+#include "nini_number.h"
+#include "formats.h"
+#include "test_number.h"
+
+//------------------------------------------------------------------------------
+static
+uint64_t random_next(uint64_t *state)
+{
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+//------------------------------------------------------------------------------
+static
+double double_from_bits(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+//------------------------------------------------------------------------------
+static
+void check_round_trip(double value)
+{
+    char buf[NINI_NUMBER_MAX_CHARS];
+    size_t len = nini_number_format_float(buf, value);
+    assert_int_equal( len, strlen(buf) );
+    assert_non_null( strchr(buf, '.') );
+
+    double res = strtod(buf, NULL);
+    if( memcmp(&res, &value, sizeof(value)) )
+        fail_msg("%s does not round-trip to %.17g", buf, value);
+
+    // Significant digits must not be more than 17.
+    const char *first = buf + strspn(buf, "-0.");
+    const char *last  = first + strcspn(first, "e");
+    while( last > first && ( last[-1] == '0' || last[-1] == '.' ) )
+        --last;
+    int digits = 0;
+    for(const char *pos = first; pos < last; ++pos)
+    {
+        if( *pos != '.' ) ++digits;
+    }
+    assert_true( digits <= 17 );
+}
+//------------------------------------------------------------------------------
+static
+void integer_format_test(void **state)
+{
+    static const long values[] = { 0, 1, -1, 9, 10, 99, 100, 12345, -67890, LONG_MAX, LONG_MIN };
+
+    for(size_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i)
+    {
+        char buf[NINI_NUMBER_MAX_CHARS], ref[NINI_NUMBER_MAX_CHARS];
+
+        snprintf(ref, sizeof(ref), "%ld", values[i]);
+        assert_int_equal( nini_number_format_decimal(buf, values[i]), strlen(ref) );
+        assert_string_equal( buf, ref );
+
+        snprintf(ref, sizeof(ref), "0x%lX", values[i]);
+        assert_int_equal( nini_number_format_hexa(buf, values[i]), strlen(ref) );
+        assert_string_equal( buf, ref );
+    }
+
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    for(int i = 0; i < 100000; ++i)
+    {
+        long value = (long) random_next(&seed) >> ( i % 64 );
+
+        char buf[NINI_NUMBER_MAX_CHARS], ref[NINI_NUMBER_MAX_CHARS];
+
+        snprintf(ref, sizeof(ref), "%ld", value);
+        nini_number_format_decimal(buf, value);
+        assert_string_equal( buf, ref );
+
+        snprintf(ref, sizeof(ref), "0x%lX", value);
+        nini_number_format_hexa(buf, value);
+        assert_string_equal( buf, ref );
+    }
+}
+//------------------------------------------------------------------------------
+static
+void float_format_test(void **state)
+{
+    static const struct
+    {
+        double      value;
+        const char *text;
+    } cases[] =
+    {
+        { 0.0,                      "0.0" },
+        { -0.0,                     "-0.0" },
+        { 1.0,                      "1.0" },
+        { -2.5,                     "-2.5" },
+        { 0.1,                      "0.1" },
+        { 0.1 + 0.2,                "0.30000000000000004" },
+        { 3.14159265,               "3.14159265" },
+        { 59.50,                    "59.5" },
+        { 1234567.0,                "1234567.0" },
+        { 1e20,                     "100000000000000000000.0" },
+        { 1e21,                     "1.0e+21" },
+        { 1.5e300,                  "1.5e+300" },
+        { 0.000001,                 "0.000001" },
+        { 1.5e-7,                   "1.5e-7" },
+        { DBL_MAX,                  "1.7976931348623157e+308" },
+        { DBL_MIN,                  "2.2250738585072014e-308" },
+        { 5e-324,                   "5.0e-324" },
+        { INFINITY,                 "inf" },
+        { -INFINITY,                "-inf" },
+    };
+
+    for(size_t i = 0; i < sizeof(cases)/sizeof(cases[0]); ++i)
+    {
+        char buf[NINI_NUMBER_MAX_CHARS];
+        assert_int_equal( nini_number_format_float(buf, cases[i].value), strlen(cases[i].text) );
+        assert_string_equal( buf, cases[i].text );
+    }
+
+    char buf[NINI_NUMBER_MAX_CHARS];
+    nini_number_format_float(buf, NAN);
+    assert_string_equal( buf, "nan" );
+}
+//------------------------------------------------------------------------------
+static
+void float_round_trip_test(void **state)
+{
+    // Random bit patterns over the whole range, excluding infinities and NaN.
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for(int i = 0; i < 1000000; ++i)
+    {
+        uint64_t bits = random_next(&seed);
+        if( ( bits & 0x7FF0000000000000ULL ) == 0x7FF0000000000000ULL ) continue;
+
+        check_round_trip(double_from_bits(bits));
+    }
+
+    // Boundaries of all binary exponents, including subnormal numbers.
+
+    for(uint64_t exp = 0; exp < 0x7FF; ++exp)
+    {
+        check_round_trip(double_from_bits(exp << 52));
+        check_round_trip(double_from_bits(( exp << 52 ) | 1));
+        check_round_trip(double_from_bits(( exp << 52 ) | 0x000FFFFFFFFFFFFFULL));
+    }
+
+    // Short decimal numbers which are common in configurations.
+
+    for(int num = 0; num < 100000; ++num)
+    {
+        check_round_trip(num / 10.0);
+        check_round_trip(num / 100.0);
+        check_round_trip(num / 1000.0);
+        check_round_trip(num * 1e-9);
+    }
+
+    for(int exp = -324; exp <= 308; ++exp)
+    {
+        char text[16];
+        snprintf(text, sizeof(text), "1e%d", exp);
+        check_round_trip(strtod(text, NULL));
+    }
+}
+//------------------------------------------------------------------------------
+static
+void check_parse(const char *text)
+{
+    char  *endpos;
+    double ref = strtod(text, &endpos);
+
+    double value = -1;
+    size_t len   = nini_number_parse_float(text, &value);
+    if( len != (size_t)( endpos - text ) )
+        fail_msg("\"%s\" is parsed %u characters, but %u by strtod", text, (unsigned) len, (unsigned)( endpos - text ));
+
+    if( !len ) return;
+    if( isnan(ref) && isnan(value) ) return;
+    if( memcmp(&ref, &value, sizeof(value)) )
+        fail_msg("\"%s\" is parsed to %.17g, but %.17g by strtod", text, value, ref);
+}
+//------------------------------------------------------------------------------
+static
+void float_parse_test(void **state)
+{
+    static const char *texts[] =
+    {
+        // Syntax.
+        "0", "-0", "+5", "1.", ".5", "-.5e1", "1e", "1e+", "1e5x", "--5", "1,5", "e5", ".",
+        " \t 3.25", "inf", "-Infinity", "infin", "nan", "-nan", "nan(123)", "nan(",
+        "0x", "0x1p3", "0x1.8p-1", "0X.8P1", "0xp1", "0x1p", "0x1A",
+
+        // Boundaries.
+        "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308", "1e309",
+        "2.2250738585072011e-308", "2.2250738585072012e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+        "0x1.fffffffffffff8p1023", "0x1.fffffffffffff7ffp1023",
+        "0x0.00000000000008p-1022", "0x0.000000000000081p-1022", "0x1p-1075", "0x1.0000000000001p-1075",
+
+        // Halfway and long mantissas.
+        "9007199254740993", "9007199254740992.5", "9007199254740993.0000000000000000000001",
+        "123456789012345678901234567890", "0.000000000000000000000000000000000001",
+        "7.3177701707893310e+15", "1e-342", "1e-343", "1e22", "1e23",
+        "2.47032822920623272088284396434110686182529901307162382212792841250337753635104375932649918180817996189898282347722858865463328355177969898199387398005390939063150356595155702263922908583924491051844359318028499365361525003193704576782492193656236698636584807570382890e-324",
+    };
+
+    for(size_t i = 0; i < sizeof(texts)/sizeof(texts[0]); ++i)
+        check_parse(texts[i]);
+
+    double value;
+    assert_int_equal( nini_number_parse_float("59.50", &value), 5 );
+    assert_true( value == 59.5 );
+    assert_int_equal( nini_number_parse_float("0.1", &value), 3 );
+    assert_true( value == 0.1 );
+
+    value = 7;
+    assert_int_equal( nini_number_parse_float("", &value), 0 );
+    assert_int_equal( nini_number_parse_float("abc", &value), 0 );
+    assert_true( value == 7 );
+}
+//------------------------------------------------------------------------------
+static
+void float_parse_strtod_test(void **state)
+{
+    char text[64];
+
+    uint64_t seed = 0x0F1E2D3C4B5A6978ULL;
+    for(int i = 0; i < 300000; ++i)
+    {
+        uint64_t bits  = random_next(&seed);
+        double   value = double_from_bits(bits);
+        if( ( bits & 0x7FF0000000000000ULL ) == 0x7FF0000000000000ULL ) continue;
+
+        // Texts of the same value in different precisions, which are mostly not the shortest.
+        snprintf(text, sizeof(text), "%.*g", (int)( random_next(&seed) % 20 ) + 1, value);
+        check_parse(text);
+        snprintf(text, sizeof(text), "%.*e", (int)( random_next(&seed) % 25 ), value);
+        check_parse(text);
+        snprintf(text, sizeof(text), "%a", value);
+        check_parse(text);
+
+        // Random digits.
+        char *pos = text;
+        if( random_next(&seed) & 1 ) *pos++ = '-';
+        int len = random_next(&seed) % 40 + 1;
+        int dot = random_next(&seed) % ( len + 1 );
+        for(int k = 0; k < len; ++k)
+        {
+            if( k == dot ) *pos++ = '.';
+            *pos++ = '0' + random_next(&seed) % 10;
+        }
+        if( random_next(&seed) & 1 )
+            pos += sprintf(pos, "e%d", (int)( random_next(&seed) % 700 ) - 350);
+        *pos = 0;
+        check_parse(text);
+    }
+
+    // Midpoints of adjacent doubles, which are the hardest cases of rounding,
+    // and they can be represented exactly if long double is wider than double.
+
+    for(int i = 0; i < 100000; ++i)
+    {
+        uint64_t bits  = random_next(&seed) & 0x7FEFFFFFFFFFFFFFULL;
+        double   lower = double_from_bits(bits);
+        double   upper = nextafter(lower, INFINITY);
+        snprintf(text, sizeof(text), "%.40Le", ( (long double) lower + upper ) / 2);
+        check_parse(text);
+    }
+}
+//------------------------------------------------------------------------------
+static
+void float_decode_test(void **state)
+{
+    // Encoded floating point values must be decoded as floating point values.
+
+    static const double values[] = { 0.0, 1.0, -7.0, 0.5, 1e21, 1e-7, 123456789.0, 6.02214076e23 };
+
+    nini_root_t root;
+    nini_root_init(&root, &format_no_indents);
+
+    for(size_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), "float-%u", (unsigned) i);
+        assert_true( nini_write_float(&root, path, '/', values[i]) );
+    }
+
+    size_t size;
+    char *data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_true( nini_root_decode(&root, data, size, NULL) );
+    free(data);
+
+    for(size_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), "float-%u", (unsigned) i);
+        assert_int_equal( nini_get_type(&root, path, '/'), NINI_FLOAT );
+        assert_true( nini_read_float(&root, path, '/', -1) == values[i] );
+    }
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+int test_number(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(integer_format_test),
+        cmocka_unit_test(float_format_test),
+        cmocka_unit_test(float_round_trip_test),
+        cmocka_unit_test(float_parse_test),
+        cmocka_unit_test(float_parse_strtod_test),
+        cmocka_unit_test(float_decode_test),
+    };
+
+    return cmocka_run_group_tests_name("number_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_NUMBER_H_
+#define _TEST_NUMBER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_number(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
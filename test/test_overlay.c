@@ -0,0 +1,169 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_overlay.h"
+#include "formats.h"
+#include "fixtures.h"
+#include "test_overlay.h"
+
+static const char defaults_text[] =
+    "[video]\n"
+    "    width = 1280\n"
+    "    height = 720\n"
+    "    fps = 30\n"
+    "[audio]\n"
+    "    volume = 80\n"
+    "name = \"default\"\n";
+
+static const char host_text[] =
+    "[video]\n"
+    "    width = 1920\n"
+    "    vsync = true\n"
+    "[network]\n"
+    "    port = 80\n";
+
+static const char runtime_text[] =
+    "[video]\n"
+    "    fps = 60\n"
+    "audio = \"muted\"\n";
+
+//------------------------------------------------------------------------------
+static
+void read_overlay_test(void **state)
+{
+    nini_root_t defaults, host, runtime;
+    decode_text(&defaults, defaults_text);
+    decode_text(&host, host_text);
+    decode_text(&runtime, runtime_text);
+    assert_true( nini_root_freeze(&defaults, '/') );
+
+    nini_overlay_t overlay;
+    nini_overlay_init(&overlay, '/');
+    assert_true( nini_overlay_add_layer(&overlay, &runtime) );
+    assert_true( nini_overlay_add_layer(&overlay, &host) );
+    assert_true( nini_overlay_add_layer(&overlay, &defaults) );
+    assert_int_equal( nini_overlay_get_layer_count(&overlay), 3 );
+
+    // The first layer that has the path wins.
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/width", 0), 1920 );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/height", 0), 720 );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/fps", 0), 60 );
+    assert_true( nini_overlay_read_bool(&overlay, "video/vsync", false) );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "network/port", 0), 80 );
+    assert_string_equal( nini_overlay_read_string(&overlay, "name", ""), "default" );
+
+    // The resolved node is used even if its type does not match.
+    assert_int_equal( nini_overlay_get_type(&overlay, "audio"), NINI_STRING );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "audio", -1), -1 );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "audio/volume", 0), 80 );
+
+    assert_false( nini_overlay_is_existed(&overlay, "video/depth") );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/depth", 24), 24 );
+
+    // Results are memoized, and a change of any layer drops them.
+    const nini_node_t *fps = nini_overlay_find(&overlay, "video/fps");
+    assert_ptr_equal( nini_overlay_find(&overlay, "video/fps"), fps );
+
+    nini_remove(&runtime, "video/fps", '/');
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/fps", 0), 30 );
+
+    assert_true( nini_write_decimal(&host, "video/depth", '/', 30) );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/depth", 24), 30 );
+
+    assert_true( nini_write_decimal(&host, "video/width", '/', 2560) );
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/width", 0), 2560 );
+
+    nini_root_clear(&host);
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/width", 0), 1280 );
+    assert_false( nini_overlay_is_existed(&overlay, "network/port") );
+
+    // Many paths.
+    for(int i = 0; i < 1000; ++i)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), "missing/key-%d", i);
+        assert_false( nini_overlay_is_existed(&overlay, path) );
+    }
+    assert_int_equal( nini_overlay_read_integer(&overlay, "video/height", 0), 720 );
+
+    nini_overlay_deinit(&overlay);
+    nini_root_deinit(&runtime);
+    nini_root_deinit(&host);
+    nini_root_deinit(&defaults);
+}
+//------------------------------------------------------------------------------
+static
+void iterate(nini_overlay_t *overlay, const char *path, char *names, size_t size)
+{
+    names[0] = 0;
+
+    nini_overlay_iter_t iter;
+    nini_overlay_iter_init(&iter, overlay, path);
+
+    const nini_node_t *node;
+    while(( node = nini_overlay_iter_next(&iter) ))
+    {
+        // The iterated node is the one that its path resolves to.
+        char child_path[64];
+        snprintf(child_path, sizeof(child_path), "%s%s%s", path, path[0] ? "/" : "", nini_node_get_name(node));
+        assert_ptr_equal( nini_overlay_find(overlay, child_path), node );
+
+        size_t len = strlen(names);
+        snprintf(names + len, size - len, "%s%s", len ? " " : "", nini_node_get_name(node));
+    }
+}
+//------------------------------------------------------------------------------
+static
+void iter_overlay_test(void **state)
+{
+    nini_root_t defaults, host, runtime;
+    decode_text(&defaults, defaults_text);
+    decode_text(&host, host_text);
+    decode_text(&runtime, runtime_text);
+
+    nini_overlay_t overlay;
+    nini_overlay_init(&overlay, '/');
+    assert_true( nini_overlay_add_layer(&overlay, &runtime) );
+    assert_true( nini_overlay_add_layer(&overlay, &host) );
+    assert_true( nini_overlay_add_layer(&overlay, &defaults) );
+
+    char names[256];
+    iterate(&overlay, "", names, sizeof(names));
+    assert_string_equal( names, "video audio network name" );
+
+    iterate(&overlay, "video", names, sizeof(names));
+    assert_string_equal( names, "fps width vsync height" );
+
+    // Sections are merged under a key of a layer before.
+    iterate(&overlay, "audio", names, sizeof(names));
+    assert_string_equal( names, "volume" );
+
+    iterate(&overlay, "name", names, sizeof(names));
+    assert_string_equal( names, "" );
+    iterate(&overlay, "missing", names, sizeof(names));
+    assert_string_equal( names, "" );
+
+    nini_overlay_deinit(&overlay);
+    nini_root_deinit(&runtime);
+    nini_root_deinit(&host);
+    nini_root_deinit(&defaults);
+}
+//------------------------------------------------------------------------------
+int test_overlay(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(read_overlay_test),
+        cmocka_unit_test(iter_overlay_test),
+    };
+
+    return cmocka_run_group_tests_name("overlay_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
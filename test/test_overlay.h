@@ -0,0 +1,14 @@
+#ifndef _TEST_OVERLAY_H_
+#define _TEST_OVERLAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_overlay(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
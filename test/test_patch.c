@@ -0,0 +1,236 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_patch.h"
+#include "formats.h"
+#include "fixtures.h"
+#include "test_patch.h"
+
+static const char base_text[] =
+    "[video]\n"
+    "    width = 1920\n"
+    "    height = 1080\n"
+    "    [codec]\n"
+    "        name = h264\n"
+    "        profile = high\n"
+    "    fps = 30\n"
+    "[audio]\n"
+    "    channels = 2\n"
+    "    volume = 80\n"
+    "[log]\n"
+    "    level = 3\n";
+
+static const char target_text[] =
+    "[audio]\n"
+    "    volume = 50\n"
+    "    channels = 2\n"
+    "[video]\n"
+    "    width = 1920\n"
+    "    height = 0x438\n"
+    "    [fps]\n"
+    "        max = 60\n"
+    "    [codec]\n"
+    "        name = h265\n"
+    "        profile = high\n"
+    "    vsync = true\n"
+    "    gamma = 2.2\n"
+    "[network]\n"
+    "    port = 80\n"
+    "    host = \"example.com\"\n";
+
+//------------------------------------------------------------------------------
+static
+void diff_patch_test(void **state)
+{
+    nini_root_t base, target, root;
+    decode_text(&base, base_text);
+    decode_text(&target, target_text);
+    decode_text(&root, base_text);
+
+    nini_patch_t patch;
+    nini_patch_init(&patch);
+
+    nini_errmsg_t errmsg;
+    assert_true( nini_patch_diff(&patch, &base, &target, &errmsg) );
+    assert_true( nini_patch_get_base_hash(&patch) == nini_root_get_hash(&base) );
+    assert_true( nini_patch_get_target_hash(&patch) == nini_root_get_hash(&target) );
+
+    // Unchanged nodes are kept.
+    nini_node_t *width = nini_node_find_child(nini_root_find_child(&root, "video"), "width");
+
+    // Ship the patch data and apply it.
+    nini_patch_t received;
+    nini_patch_init(&received);
+    assert_true( nini_patch_load(&received, nini_patch_get_data(&patch), nini_patch_get_size(&patch), &errmsg) );
+    assert_true( nini_patch_apply(&received, &root, &errmsg) );
+    assert_same_roots(&root, &target);
+    assert_ptr_equal( nini_node_find_child(nini_root_find_child(&root, "video"), "width"), width );
+
+    // The patch cannot be applied again, and the root is not changed.
+    assert_false( nini_patch_apply(&received, &root, &errmsg) );
+    assert_string_equal( errmsg.message, "Root is not the base of the patch!" );
+    assert_same_roots(&root, &target);
+
+    // The patch of a small change is small.
+    nini_write_decimal(&target, "video/codec/level", '/', 51);
+    assert_true( nini_patch_diff(&patch, &root, &target, NULL) );
+    assert_true( nini_patch_get_size(&patch) < 64 );
+    assert_true( nini_patch_apply(&patch, &root, NULL) );
+    assert_same_roots(&root, &target);
+
+    // A patch between the same roots changes nothing.
+    assert_true( nini_patch_diff(&patch, &root, &target, NULL) );
+    assert_true( nini_patch_apply(&patch, &root, NULL) );
+    assert_same_roots(&root, &target);
+
+    // Patch back to the base.
+    assert_true( nini_patch_diff(&patch, &target, &base, NULL) );
+    assert_true( nini_patch_apply(&patch, &root, NULL) );
+    assert_same_roots(&root, &base);
+
+    nini_patch_deinit(&received);
+    nini_patch_deinit(&patch);
+    nini_root_deinit(&root);
+    nini_root_deinit(&target);
+    nini_root_deinit(&base);
+}
+//------------------------------------------------------------------------------
+static
+void order_patch_test(void **state)
+{
+    static const char * const texts[] =
+    {
+        "a = 1\nb = 2\nc = 3\nd = 4\ne = 5\n",
+        "e = 5\nd = 4\nc = 3\nb = 2\na = 1\n",
+        "c = 3\na = 1\nx = 0\nc = 4\ne = 5\nb = 2\n",
+        "[a]\n    x = 1\nx = 2\n[b]\n    x = 3\na = 4\n",
+        "a = 4\n[b]\n    y = 3\n[a]\n    x = 1\n",
+        "",
+        "a = 1\nb = 2\nc = 3\nd = 4\ne = 5\n",
+    };
+    static const size_t count = sizeof(texts)/sizeof(texts[0]);
+
+    // Patch between each pair of texts, including duplicate names, type changes, and moves.
+    for(size_t i = 0; i < count; ++i)
+    {
+        for(size_t j = 0; j < count; ++j)
+        {
+            nini_root_t base, target;
+            decode_text(&base, texts[i]);
+            decode_text(&target, texts[j]);
+
+            nini_patch_t patch;
+            nini_patch_init(&patch);
+            assert_true( nini_patch_diff(&patch, &base, &target, NULL) );
+            assert_true( nini_patch_apply(&patch, &base, NULL) );
+            assert_same_roots(&base, &target);
+
+            nini_patch_deinit(&patch);
+            nini_root_deinit(&target);
+            nini_root_deinit(&base);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static
+void verify_patch_test(void **state)
+{
+    nini_root_t base, target, root;
+    decode_text(&base, base_text);
+    decode_text(&target, target_text);
+    decode_text(&root, base_text);
+
+    nini_patch_t patch;
+    nini_patch_init(&patch);
+    assert_true( nini_patch_diff(&patch, &base, &target, NULL) );
+
+    size_t   size = nini_patch_get_size(&patch);
+    uint8_t *data = malloc(size);
+    assert_non_null( data );
+    memcpy(data, nini_patch_get_data(&patch), size);
+
+    // Broken data is detected by the checksum.
+    nini_patch_t received;
+    nini_patch_init(&received);
+
+    nini_errmsg_t errmsg;
+    data[size - 2] ^= 1;
+    assert_false( nini_patch_load(&received, data, size, &errmsg) );
+    assert_string_equal( errmsg.message, "Invalid patch data!" );
+    data[size - 2] ^= 1;
+
+    assert_false( nini_patch_load(&received, data, size - 1, &errmsg) );
+    assert_false( nini_patch_load(&received, "NINIPAT1", 8, &errmsg) );
+    assert_false( nini_patch_apply(&received, &root, &errmsg) );
+    assert_string_equal( errmsg.message, "Invalid patch data!" );
+
+    // The patch can be applied to the base only.
+    assert_true( nini_patch_load(&received, data, size, NULL) );
+
+    nini_write_decimal(&root, "log/level", '/', 4);
+    assert_false( nini_patch_apply(&received, &root, &errmsg) );
+    assert_string_equal( errmsg.message, "Root is not the base of the patch!" );
+    assert_int_equal( nini_read_integer(&root, "video/height", '/', 0), 1080 );
+
+    nini_write_decimal(&root, "log/level", '/', 3);
+    assert_true( nini_root_freeze(&root, '/') );
+    assert_false( nini_patch_apply(&received, &root, &errmsg) );
+    assert_string_equal( errmsg.message, "Root is frozen!" );
+
+    nini_root_thaw(&root);
+    assert_true( nini_patch_apply(&received, &root, &errmsg) );
+    assert_same_roots(&root, &target);
+
+    // Sections nested deeper than the parser accepts are rejected.
+    nini_root_t deep;
+    nini_root_init(&deep, &format_have_indents);
+    nini_node_t *parent = &deep.super;
+    for(int i = 0; i < NINI_MAX_PARSE_LEVEL + 1; ++i)
+    {
+        nini_node_t *section = nini_node_create_section("deep");
+        assert_true( nini_node_link_child(parent, section) );
+        parent = section;
+    }
+
+    assert_true( nini_patch_diff(&patch, &target, &deep, NULL) );
+    assert_false( nini_patch_apply(&patch, &root, &errmsg) );
+    assert_string_equal( errmsg.message, "Invalid patch data!" );
+
+    // Sections nested in the limit are accepted.
+    assert_true( nini_node_unlink(parent) );
+    nini_node_release(parent);
+    nini_root_t shallow;
+    decode_text(&shallow, target_text);
+    assert_true( nini_patch_diff(&patch, &target, &deep, NULL) );
+    assert_true( nini_patch_apply(&patch, &shallow, &errmsg) );
+    assert_true( nini_root_get_hash(&shallow) == nini_root_get_hash(&deep) );
+    nini_root_deinit(&shallow);
+    nini_root_deinit(&deep);
+
+    free(data);
+    nini_patch_deinit(&received);
+    nini_patch_deinit(&patch);
+    nini_root_deinit(&root);
+    nini_root_deinit(&target);
+    nini_root_deinit(&base);
+}
+//------------------------------------------------------------------------------
+int test_patch(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(diff_patch_test),
+        cmocka_unit_test(order_patch_test),
+        cmocka_unit_test(verify_patch_test),
+    };
+
+    return cmocka_run_group_tests_name("patch_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_PATCH_H_
+#define _TEST_PATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_patch(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,201 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_pool.h"
+#include "nini_reloader.h"
+#include "nini_patch.h"
+#include "formats.h"
+#include "fixtures.h"
+#include "test_pool.h"
+
+static const char template_text[] =
+    "[video]\n"
+    "    [codec]\n"
+    "        name = h264\n"
+    "    width = 1920\n"
+    "    height = 1080\n"
+    "[audio]\n"
+    "    [codec]\n"
+    "        name = opus\n"
+    "    volume = 80\n";
+
+static const char tenant_text[] =
+    "[video]\n"
+    "    [codec]\n"
+    "        name = h264\n"
+    "    width = 1280\n"
+    "    height = 1080\n"
+    "[audio]\n"
+    "    [codec]\n"
+    "        name = opus\n"
+    "    volume = 80\n"
+    "name = \"tenant\"\n";
+
+//------------------------------------------------------------------------------
+static
+void share_pool_test(void **state)
+{
+    nini_root_t first, second, tenant;
+    decode_text(&first, template_text);
+    decode_text(&second, template_text);
+    decode_text(&tenant, tenant_text);
+
+    nini_pool_t pool;
+    nini_pool_init(&pool);
+    assert_true( nini_pool_share(&pool, &first) );
+    assert_true( nini_pool_share(&pool, &second) );
+    assert_true( nini_pool_share(&pool, &tenant) );
+
+    // Sections of the templates, the video codec of the tenant, and the video of the tenant.
+    assert_int_equal( nini_pool_get_count(&pool), 5 );
+
+    // Contents are not changed, and identical sections share their children.
+    assert_encoded(&first, template_text);
+    assert_encoded(&second, template_text);
+    assert_encoded(&tenant, tenant_text);
+
+    nini_node_t *video  = nini_root_find_child(&first, "video");
+    nini_node_t *audio  = nini_root_find_child(&first, "audio");
+    nini_node_t *tvideo = nini_root_find_child(&tenant, "video");
+    assert_true( nini_node_is_shared(video) );
+    assert_true( nini_node_is_shared(nini_root_find_child(&tenant, "audio")) );
+    assert_ptr_equal( nini_node_get_first_child(video), nini_node_get_first_child(nini_root_find_child(&second, "video")) );
+    assert_ptr_equal( nini_node_get_first_child(nini_node_find_child(video, "codec")),
+                      nini_node_get_first_child(nini_node_find_child(tvideo, "codec")) );
+    assert_int_equal( nini_read_integer(&tenant, "video/width", '/', 0), 1280 );
+    assert_string_equal( nini_read_string(&tenant, "audio/codec/name", '/', ""), "opus" );
+
+    // Shared sections are frozen, and are copied on write.
+    nini_node_t *key = nini_node_create_decimal("depth", 24);
+    assert_false( nini_node_link_child(audio, key) );
+    assert_false( nini_node_unlink(nini_node_find_child(audio, "volume")) );
+    assert_true( nini_node_unshare(audio) );
+    assert_false( nini_node_is_shared(audio) );
+    assert_true( nini_node_link_child(audio, key) );
+    assert_true( nini_node_is_shared(nini_node_find_child(audio, "codec")) );
+
+    assert_true( nini_write_string(&first, "video/codec/name", '/', "h265") );
+    assert_false( nini_node_is_shared(video) );
+    assert_string_equal( nini_read_string(&first, "video/codec/name", '/', ""), "h265" );
+    assert_string_equal( nini_read_string(&second, "video/codec/name", '/', ""), "h264" );
+    assert_string_equal( nini_read_string(&tenant, "video/codec/name", '/', ""), "h264" );
+
+    nini_remove(&second, "audio/codec/name", '/');
+    assert_false( nini_is_existed(&second, "audio/codec/name", '/') );
+    assert_true( nini_is_existed(&tenant, "audio/codec/name", '/') );
+
+    static const char override_text[] = "[video]\n    height = 720\n";
+    assert_true( nini_root_merge(&tenant, override_text, strlen(override_text), NULL) );
+    assert_int_equal( nini_read_integer(&tenant, "video/height", '/', 0), 720 );
+    assert_int_equal( nini_read_integer(&second, "video/height", '/', 0), 1080 );
+
+    // Frozen and thawed roots keep shared sections frozen.
+    assert_true( nini_root_freeze(&second, '/') );
+    assert_false( nini_pool_share(&pool, &second) );
+    nini_root_thaw(&second);
+    assert_true( nini_node_is_shared(nini_root_find_child(&second, "video")) );
+    nini_node_t *null_key = nini_node_create_null("key");
+    assert_false( nini_node_link_child(nini_root_find_child(&second, "video"), null_key) );
+    nini_node_release(null_key);
+
+    // Copies of shared sections are shared too.
+    nini_node_t *copy = nini_node_clone(nini_root_find_child(&second, "video"));
+    assert_true( nini_node_is_shared(copy) );
+    nini_node_release(copy);
+
+    nini_pool_deinit(&pool);
+    nini_root_deinit(&first);
+    nini_root_deinit(&second);
+    nini_root_deinit(&tenant);
+}
+//------------------------------------------------------------------------------
+static
+void purge_pool_test(void **state)
+{
+    nini_root_t first, second;
+    decode_text(&first, template_text);
+    decode_text(&second, tenant_text);
+
+    nini_pool_t pool;
+    nini_pool_init(&pool);
+    assert_true( nini_pool_share(&pool, &first) );
+    assert_true( nini_pool_share(&pool, &second) );
+    assert_int_equal( nini_pool_get_count(&pool), 5 );
+
+    assert_int_equal( nini_pool_purge(&pool), 0 );
+
+    // Sections used by the released root only are removed, including the subsections.
+    nini_root_deinit(&first);
+    assert_int_equal( nini_pool_purge(&pool), 1 );
+    assert_int_equal( nini_pool_get_count(&pool), 4 );
+
+    // The root is still valid after the pool be released.
+    nini_pool_deinit(&pool);
+    assert_encoded(&second, tenant_text);
+    assert_true( nini_write_decimal(&second, "audio/codec/rate", '/', 48000) );
+    assert_int_equal( nini_read_integer(&second, "audio/codec/rate", '/', 0), 48000 );
+
+    nini_root_deinit(&second);
+}
+//------------------------------------------------------------------------------
+static
+void change_pool_test(void **state)
+{
+    nini_root_t first, second, third;
+    decode_text(&first, template_text);
+    decode_text(&second, template_text);
+    decode_text(&third, template_text);
+
+    nini_pool_t pool;
+    nini_pool_init(&pool);
+    assert_true( nini_pool_share(&pool, &first) );
+    assert_true( nini_pool_share(&pool, &second) );
+    assert_true( nini_pool_share(&pool, &third) );
+
+    // Shared sections are copied by reloads.
+    nini_reloader_t reloader;
+    nini_reloader_init(&reloader, &second, '/');
+    nini_errmsg_t errmsg;
+    assert_true( nini_reloader_decode(&reloader, tenant_text, strlen(tenant_text), &errmsg) );
+    assert_encoded(&second, tenant_text);
+    nini_reloader_deinit(&reloader);
+
+    // Shared sections are copied by patches.
+    nini_patch_t patch;
+    nini_patch_init(&patch);
+    assert_true( nini_patch_diff(&patch, &first, &second, NULL) );
+    assert_true( nini_patch_apply(&patch, &third, &errmsg) );
+    assert_encoded(&third, tenant_text);
+    nini_patch_deinit(&patch);
+
+    // Sections not changed are still shared.
+    assert_encoded(&first, template_text);
+    assert_true( nini_node_is_shared(nini_root_find_child(&first, "audio")) );
+    assert_true( nini_node_is_shared(nini_root_find_child(&third, "audio")) );
+    assert_true( nini_node_is_shared(nini_node_find_child(nini_root_find_child(&third, "video"), "codec")) );
+
+    nini_root_deinit(&first);
+    nini_root_deinit(&second);
+    nini_root_deinit(&third);
+    nini_pool_deinit(&pool);
+}
+//------------------------------------------------------------------------------
+int test_pool(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(share_pool_test),
+        cmocka_unit_test(purge_pool_test),
+        cmocka_unit_test(change_pool_test),
+    };
+
+    return cmocka_run_group_tests_name("pool_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_POOL_H_
+#define _TEST_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_pool(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "nini_helper.h"
+#include "nini_query.h"
+#include "formats.h"
+#include "test_query.h"
+
+//------------------------------------------------------------------------------
+static
+void setup_tree(nini_root_t *root)
+{
+    nini_root_init(root, &format_have_indents);
+
+    assert_true( nini_write_decimal(root, "servers/alpha/port", '/', 80) );
+    assert_true( nini_write_string (root, "servers/alpha/host", '/', "alpha.local") );
+    assert_true( nini_write_decimal(root, "servers/beta/port", '/', 8080) );
+    assert_true( nini_write_string (root, "servers/beta/host", '/', "beta.local") );
+    assert_true( nini_write_decimal(root, "servers/gamma/sub/port", '/', 443) );
+    assert_true( nini_write_bool   (root, "record/enabled", '/', true) );
+    assert_true( nini_write_bool   (root, "record/video/enabled", '/', false) );
+    assert_true( nini_write_bool   (root, "record/audio/codec/enabled", '/', true) );
+    assert_true( nini_write_decimal(root, "port", '/', 1) );
+}
+//------------------------------------------------------------------------------
+static
+void query_any_test(void **state)
+{
+    nini_root_t root;
+    setup_tree(&root);
+
+    nini_query_t query;
+    assert_true( nini_query_compile(&query, "servers/*/port", '/') );
+
+    nini_query_iter_t iter;
+    nini_query_iter_init_root(&iter, &query, &root);
+
+    nini_node_t *node;
+    assert_non_null(( node = nini_query_iter_next(&iter) ));
+    assert_int_equal( nini_node_get_integer(node), 80 );
+    assert_non_null(( node = nini_query_iter_next(&iter) ));
+    assert_int_equal( nini_node_get_integer(node), 8080 );
+    assert_null( nini_query_iter_next(&iter) );
+    assert_null( nini_query_iter_next(&iter) );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void query_any_levels_test(void **state)
+{
+    nini_root_t root;
+    setup_tree(&root);
+
+    nini_query_t query;
+    assert_true( nini_query_compile(&query, "record/**/enabled", '/') );
+
+    nini_query_iter_t iter;
+    nini_query_iter_init_root(&iter, &query, &root);
+
+    nini_node_t *node;
+    assert_non_null(( node = nini_query_iter_next(&iter) ));
+    assert_true( nini_node_get_bool(node) );
+    assert_ptr_equal( node, nini_node_find_child(nini_root_find_child(&root, "record"), "enabled") );
+    assert_non_null(( node = nini_query_iter_next(&iter) ));
+    assert_false( nini_node_get_bool(node) );
+    assert_non_null(( node = nini_query_iter_next(&iter) ));
+    assert_true( nini_node_get_bool(node) );
+    assert_null( nini_query_iter_next(&iter) );
+
+    // Nodes will be matched only once.
+    assert_true( nini_query_compile(&query, "**/**/port", '/') );
+    nini_query_iter_init_root(&iter, &query, &root);
+
+    int count = 0;
+    while( nini_query_iter_next(&iter) ) ++count;
+    assert_int_equal( count, 4 );
+
+    assert_true( nini_query_compile(&query, "**/*/**/port", '/') );
+    nini_query_iter_init_root(&iter, &query, &root);
+
+    count = 0;
+    while( nini_query_iter_next(&iter) ) ++count;
+    assert_int_equal( count, 3 );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void query_literal_test(void **state)
+{
+    nini_root_t root;
+    setup_tree(&root);
+
+    nini_query_t query;
+    assert_true( nini_query_compile(&query, "servers.beta.host", '.') );
+
+    nini_query_iter_t iter;
+    nini_query_iter_init_root(&iter, &query, &root);
+
+    nini_node_t *node;
+    assert_non_null(( node = nini_query_iter_next(&iter) ));
+    assert_string_equal( nini_node_get_string(node), "beta.local" );
+    assert_null( nini_query_iter_next(&iter) );
+
+    assert_true( nini_query_compile(&query, "servers/none", '/') );
+    nini_query_iter_init_root(&iter, &query, &root);
+    assert_null( nini_query_iter_next(&iter) );
+
+    assert_false( nini_query_compile(&query, "", '/') );
+    assert_false( nini_query_compile(&query, "servers//port", '/') );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void query_deep_test(void **state)
+{
+    nini_root_t root;
+    setup_tree(&root);
+
+    nini_query_t query;
+    assert_true( nini_query_compile(&query, "**/port", '/') );
+
+    nini_query_iter_t iter;
+    nini_query_iter_init_root(&iter, &query, &root);
+    while( nini_query_iter_next(&iter) );
+    assert_false( nini_query_iter_is_truncated(&iter) );
+
+    // Nodes nested deeper than the limit are skipped, and the iteration is reported as truncated.
+    nini_node_t *parent = &root.super;
+    for(int i = 0; i < NINI_MAX_PARSE_LEVEL + 1; ++i)
+    {
+        nini_node_t *section = nini_node_create_section("deep");
+        assert_true( nini_node_link_child(parent, section) );
+        parent = section;
+    }
+
+    assert_true( nini_query_compile(&query, "**/deep", '/') );
+    nini_query_iter_init_root(&iter, &query, &root);
+
+    int count = 0;
+    while( nini_query_iter_next(&iter) ) ++count;
+    assert_int_equal( count, NINI_MAX_PARSE_LEVEL );
+    assert_true( nini_query_iter_is_truncated(&iter) );
+
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+int test_query(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(query_any_test),
+        cmocka_unit_test(query_any_levels_test),
+        cmocka_unit_test(query_literal_test),
+        cmocka_unit_test(query_deep_test),
+    };
+
+    return cmocka_run_group_tests_name("query_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_QUERY_H_
+#define _TEST_QUERY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_query(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
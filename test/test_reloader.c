@@ -0,0 +1,237 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_reloader.h"
+#include "formats.h"
+#include "test_reloader.h"
+
+typedef struct record_t
+{
+    int  calls;
+    int  count;
+    char summary[512];
+} record_t;
+
+//------------------------------------------------------------------------------
+static
+void on_change(void *arg, const nini_change_t *changes, size_t count)
+{
+    // Summarise changes as "<type><path>" separated by spaces, the type is one of '+', '-', and '*'.
+    record_t *record = arg;
+    ++ record->calls;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const nini_change_t *change = &changes[i];
+        char type = change->type == NINI_INSERTED ? '+' : change->type == NINI_DELETED ? '-' : '*';
+
+        assert_true( ( change->type == NINI_INSERTED ) == !change->old_node );
+        assert_true( ( change->type == NINI_DELETED  ) == !change->new_node );
+
+        size_t len = strlen(record->summary);
+        snprintf(record->summary + len, sizeof(record->summary) - len, "%s%c%s", len ? " " : "", type, change->path);
+        ++ record->count;
+    }
+}
+//------------------------------------------------------------------------------
+static
+char* encode_text(const char *text, size_t *size)
+{
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    assert_true( nini_root_decode(&root, text, strlen(text), NULL) );
+
+    char *data = nini_root_encode_to_memory(&root, size, NULL);
+    nini_root_deinit(&root);
+
+    return data;
+}
+//------------------------------------------------------------------------------
+static
+void diff_reloader_test(void **state)
+{
+    static const char old_text[] =
+        "[video]\n"
+        "    width = 1920\n"
+        "    height = 1080\n"
+        "    [codec]\n"
+        "        name = h264\n"
+        "    fps = 30\n"
+        "[audio]\n"
+        "    channels = 2\n"
+        "    volume = 80\n";
+
+    static const char new_text[] =
+        "[audio]\n"
+        "    volume = 50\n"
+        "    channels = 2\n"
+        "[video]\n"
+        "    width = 1920\n"
+        "    height = 0x438\n"
+        "    [fps]\n"
+        "        max = 60\n"
+        "    [codec]\n"
+        "        name = h264\n"
+        "    vsync = true\n"
+        "[network]\n"
+        "    port = 80\n";
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    nini_reloader_t reloader;
+    nini_reloader_init(&reloader, &root, '/');
+
+    record_t all    = { 0 };
+    record_t video  = { 0 };
+    record_t codec  = { 0 };
+    record_t videos = { 0 };
+    assert_true( nini_reloader_subscribe(&reloader, "", on_change, &all) );
+    assert_true( nini_reloader_subscribe(&reloader, "video", on_change, &video) );
+    assert_true( nini_reloader_subscribe(&reloader, "video/codec/name", on_change, &codec) );
+    assert_true( nini_reloader_subscribe(&reloader, "videos", on_change, &videos) );
+
+    // The first load inserts all top-level nodes.
+    nini_errmsg_t errmsg;
+    assert_true( nini_reloader_decode(&reloader, old_text, strlen(old_text), &errmsg) );
+    assert_string_equal( all.summary, "+video +audio" );
+    assert_string_equal( video.summary, "+video" );
+    assert_string_equal( codec.summary, "+video" );
+
+    nini_node_t *video_node    = nini_node_find_child(&root.super, "video");
+    nini_node_t *width_node    = nini_node_find_child(video_node, "width");
+    nini_node_t *height_node   = nini_node_find_child(video_node, "height");
+    nini_node_t *codec_node    = nini_node_find_child(video_node, "codec");
+    nini_node_t *channels_node = nini_node_find_child(nini_node_find_child(&root.super, "audio"), "channels");
+
+    // Apply only the differences.
+    all   = (record_t){ 0 };
+    video = (record_t){ 0 };
+    codec = (record_t){ 0 };
+    assert_true( nini_reloader_decode(&reloader, new_text, strlen(new_text), &errmsg) );
+    assert_string_equal( all.summary,
+                         "*audio/volume *video/height *video/fps +video/vsync +network" );
+    assert_int_equal( all.calls, 1 );
+    assert_string_equal( video.summary, "*video/height *video/fps +video/vsync" );
+    assert_int_equal( codec.calls, 0 );
+    assert_int_equal( videos.calls, 0 );
+
+    // Unchanged and updated nodes keep their addresses.
+    assert_ptr_equal( nini_node_find_child(&root.super, "video"), video_node );
+    assert_ptr_equal( nini_node_find_child(video_node, "width"), width_node );
+    assert_ptr_equal( nini_node_find_child(video_node, "height"), height_node );
+    assert_ptr_equal( nini_node_find_child(video_node, "codec"), codec_node );
+    assert_ptr_equal( nini_node_find_child(nini_node_find_child(&root.super, "audio"), "channels"), channels_node );
+    assert_int_equal( nini_node_get_type(height_node), NINI_HEXA );
+    assert_int_equal( nini_node_get_integer(height_node), 1080 );
+
+    // The root is the same as the new data, including the order of nodes.
+    size_t expected_size;
+    char  *expected = encode_text(new_text, &expected_size);
+    size_t size;
+    char  *data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_string_equal( data, expected );
+    free(data);
+    free(expected);
+
+    // Nothing to be reported if there are no changes.
+    all = (record_t){ 0 };
+    assert_true( nini_reloader_decode(&reloader, new_text, strlen(new_text), NULL) );
+    assert_int_equal( all.calls, 0 );
+
+    // Deletions and unsubscription.
+    nini_reloader_unsubscribe(&reloader, on_change, &video);
+    video = (record_t){ 0 };
+    assert_true( nini_reloader_decode(&reloader, "[audio]\n    channels = 2\n", 25, NULL) );
+    assert_string_equal( all.summary, "-video -network -audio/volume" );
+    assert_int_equal( video.calls, 0 );
+    assert_ptr_equal( nini_node_find_child(nini_node_find_child(&root.super, "audio"), "channels"), channels_node );
+
+    // The root is not changed if the decode failed.
+    all = (record_t){ 0 };
+    assert_false( nini_reloader_decode(&reloader, "[]\n", 3, &errmsg) );
+    assert_string_equal( errmsg.message, "Section name empty!" );
+    assert_int_equal( all.calls, 0 );
+    assert_int_equal( nini_read_integer(&root, "audio/channels", '/', 0), 2 );
+
+    assert_false( nini_reloader_load_file(&reloader, "no-such-file.ini", &errmsg) );
+    assert_string_equal( errmsg.message, "Cannot read the file!" );
+    assert_int_equal( nini_read_integer(&root, "audio/channels", '/', 0), 2 );
+
+    nini_reloader_deinit(&reloader);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void lossless_reloader_test(void **state)
+{
+    static const char old_text[] =
+        "; Video settings\n"
+        "[video]\n"
+        "    width  = 1920   ; pixels\n"
+        "    height = 1080\n"
+        "[audio]\n"
+        "    channels = 2\n";
+
+    static const char new_text[] =
+        "; Video settings of the new file\n"
+        "[video]\n"
+        "    width  = 1920   ; pixels\n"
+        "    height = 720    ; changed\n"
+        "\n"
+        "; Trailing comment\n";
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+    nini_root_enable_lossless(&root);
+    assert_true( nini_root_decode(&root, old_text, strlen(old_text), NULL) );
+
+    nini_node_t *width_node = nini_node_find_child(nini_node_find_child(&root.super, "video"), "width");
+
+    nini_reloader_t reloader;
+    nini_reloader_init(&reloader, &root, '/');
+
+    record_t all = { 0 };
+    assert_true( nini_reloader_subscribe(&reloader, "", on_change, &all) );
+    assert_true( nini_reloader_decode(&reloader, new_text, strlen(new_text), NULL) );
+    assert_string_equal( all.summary, "-audio *video/height" );
+    assert_ptr_equal( nini_node_find_child(nini_node_find_child(&root.super, "video"), "width"), width_node );
+
+    // Comments and formatting of the new data are kept.
+    size_t size;
+    char  *data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_string_equal( data, new_text );
+    free(data);
+
+    // Later changes are formatted as usual.
+    assert_true( nini_write_decimal(&root, "video/height", '/', 480) );
+    data = nini_root_encode_to_memory(&root, &size, NULL);
+    assert_non_null( data );
+    assert_non_null( strstr(data, "; Video settings of the new file\n") );
+    assert_non_null( strstr(data, "    height = 480\n") );
+    free(data);
+
+    nini_reloader_deinit(&reloader);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+int test_reloader(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(diff_reloader_test),
+        cmocka_unit_test(lossless_reloader_test),
+    };
+
+    return cmocka_run_group_tests_name("reloader_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_RELOADER_H_
+#define _TEST_RELOADER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_reloader(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "nini_helper.h"
+#include "nini_schema.h"
+#include "formats.h"
+#include "test_schema.h"
+
+using namespace nini;
+
+struct TVideo
+{
+    long width;
+    long height;
+    long flags;
+    bool interlaced;
+
+    template<class TVisitor>
+    void Schema(TVisitor &visitor)
+    {
+        visitor.Field("width", width);
+        visitor.Field("height", height);
+        visitor.Hexa("flags", flags);
+        visitor.Field("interlaced", interlaced);
+    }
+};
+
+struct TRecord
+{
+    std::string desc;
+    double      duration;
+    TVideo      video;
+
+    template<class TVisitor>
+    void Schema(TVisitor &visitor)
+    {
+        visitor.Field("desc", desc);
+        visitor.Field("duration", duration);
+        visitor.Section("video", video);
+    }
+};
+
+struct TDocument
+{
+    TRecord record;
+    bool    verbose;
+
+    template<class TVisitor>
+    void Schema(TVisitor &visitor)
+    {
+        visitor.Field("verbose", verbose);
+        visitor.Section("record", record);
+    }
+};
+
+//------------------------------------------------------------------------------
+static
+void schema_encode_test(void **state)
+{
+    TDocument doc;
+    doc.verbose                 = true;
+    doc.record.desc             = "The \"test\" record.";
+    doc.record.duration         = 59.5;
+    doc.record.video.width      = 1024;
+    doc.record.video.height     = 768;
+    doc.record.video.flags      = 0x1A7B;
+    doc.record.video.interlaced = false;
+
+    std::string text;
+    assert_true( EncodeSchema(doc, &format_have_indents, text) );
+    assert_string_equal( text.c_str(),
+                         "verbose = true\n"
+                         "[record]\n"
+                         "    desc = \"The \\\"test\\\" record.\"\n"
+                         "    duration = 59.5\n"
+                         "    [video]\n"
+                         "        width = 1024\n"
+                         "        height = 768\n"
+                         "        flags = 0x1A7B\n"
+                         "        interlaced = false\n" );
+
+    // The same data can be decoded by the tree decoder.
+    TNini ini(&format_have_indents, '/');
+    assert_true( ini.Decode(text.data(), text.size()) );
+    std::string desc = ini.ReadString("record/desc");
+    assert_string_equal( desc.c_str(), doc.record.desc.c_str() );
+    assert_int_equal( ini.ReadInteger("record/video/flags"), 0x1A7B );
+}
+//------------------------------------------------------------------------------
+static
+void schema_decode_test(void **state)
+{
+    static const char text[] =
+        "verbose = yes\n"
+        "unknown = 1\n"
+        "[record]\n"
+        "    desc = \"Decoded record.\"\n"
+        "    duration = 30.25\n"
+        "    [video]\n"
+        "        width = 640\n"
+        "        height = \"tall\"\n"
+        "        flags = 0x10\n"
+        "        interlaced = true\n";
+
+    TDocument doc;
+    doc.verbose                 = false;
+    doc.record.desc             = "default";
+    doc.record.duration         = 0;
+    doc.record.video.width      = 0;
+    doc.record.video.height     = 480;
+    doc.record.video.flags      = 0;
+    doc.record.video.interlaced = false;
+
+    TBindReport report;
+    assert_true( DecodeSchema(doc, &format_have_indents, text, sizeof(text)-1, &report) );
+
+    assert_true( doc.verbose );
+    assert_string_equal( doc.record.desc.c_str(), "Decoded record." );
+    assert_true( doc.record.duration == 30.25 );
+    assert_int_equal( doc.record.video.width, 640 );
+    assert_int_equal( doc.record.video.height, 480 );
+    assert_int_equal( doc.record.video.flags, 0x10 );
+    assert_true( doc.record.video.interlaced );
+
+    // The mismatched field keeps its original value.
+    assert_int_equal( report.missing, 0 );
+    assert_int_equal( report.unknown, 1 );
+    assert_int_equal( report.mismatch, 1 );
+
+    // Encode and decode again.
+    std::string encoded;
+    assert_true( EncodeSchema(doc, &format_have_indents, encoded) );
+
+    TDocument copy;
+    copy.verbose = false;
+    assert_true( DecodeSchema(copy, &format_have_indents, encoded.data(), encoded.size()) );
+    assert_true( copy.verbose );
+    assert_string_equal( copy.record.desc.c_str(), doc.record.desc.c_str() );
+    assert_int_equal( copy.record.video.height, 480 );
+}
+//------------------------------------------------------------------------------
+int test_schema(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(schema_encode_test),
+        cmocka_unit_test(schema_decode_test),
+    };
+
+    return cmocka_run_group_tests_name("schema_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
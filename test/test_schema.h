@@ -0,0 +1,14 @@
+#ifndef _TEST_SCHEMA_H_
+#define _TEST_SCHEMA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_schema(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
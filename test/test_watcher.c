@@ -0,0 +1,140 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_helper.h"
+#include "nini_watcher.h"
+#include "formats.h"
+#include "test_watcher.h"
+
+typedef struct reloads_t
+{
+    int succeed;
+    int failed;
+} reloads_t;
+
+//------------------------------------------------------------------------------
+static
+void on_reload(void *arg, const nini_root_t *root, const nini_errmsg_t *errmsg)
+{
+    reloads_t *reloads = arg;
+    if( root )
+        __sync_fetch_and_add(&reloads->succeed, 1);
+    else
+        __sync_fetch_and_add(&reloads->failed, 1);
+}
+//------------------------------------------------------------------------------
+static
+long read_value(nini_watcher_t *watcher)
+{
+    const nini_root_t *root = nini_watcher_acquire(watcher);
+    long value = nini_read_integer(root, "section/value", '/', 0);
+    nini_watcher_release(watcher, root);
+
+    return value;
+}
+//------------------------------------------------------------------------------
+static
+bool wait_value(nini_watcher_t *watcher, long value)
+{
+    for(int i = 0; i < 300; ++i)
+    {
+        if( read_value(watcher) == value ) return true;
+        usleep(10 * 1000);
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+static
+void reload_watcher_test(void **state)
+{
+    assert_int_equal( 0, system("rm -f watcher.ini") );
+
+    nini_watcher_t watcher;
+    nini_errmsg_t  errmsg;
+
+    // The root is empty if the file cannot be loaded.
+    assert_false( nini_watcher_init(&watcher, "watcher.ini", &format_have_indents, '/', 50, &errmsg) );
+    const nini_root_t *root = nini_watcher_acquire(&watcher);
+    assert_non_null( root );
+    assert_null( nini_root_get_first_child_c(root) );
+    nini_watcher_release(&watcher, root);
+
+    assert_int_equal( 0, system("printf '[section]\\n    value = 1\\n' > watcher.ini") );
+    assert_true( nini_watcher_reload(&watcher, &errmsg) );
+    assert_int_equal( read_value(&watcher), 1 );
+
+    // An acquired root is kept after the reload.
+    const nini_root_t *old = nini_watcher_acquire(&watcher);
+    assert_true( nini_root_is_frozen(old) );
+
+    assert_int_equal( 0, system("printf '[section]\\n    value = 2\\n' > watcher.ini") );
+    assert_true( nini_watcher_reload(&watcher, &errmsg) );
+    assert_int_equal( read_value(&watcher), 2 );
+    assert_int_equal( nini_read_integer(old, "section/value", '/', 0), 1 );
+    nini_watcher_release(&watcher, old);
+
+    // The current root is kept if the file cannot be decoded.
+    assert_int_equal( 0, system("printf '[]\\n' > watcher.ini") );
+    assert_false( nini_watcher_reload(&watcher, &errmsg) );
+    assert_string_equal( errmsg.message, "Section name empty!" );
+    assert_int_equal( read_value(&watcher), 2 );
+
+    nini_watcher_deinit(&watcher);
+}
+//------------------------------------------------------------------------------
+static
+void watch_watcher_test(void **state)
+{
+    assert_int_equal( 0, system("printf '[section]\\n    value = 1\\n' > watcher.ini") );
+
+    nini_watcher_t watcher;
+    assert_true( nini_watcher_init(&watcher, "watcher.ini", &format_have_indents, '/', 50, NULL) );
+
+    reloads_t reloads = { 0, 0 };
+    assert_true( nini_watcher_start(&watcher, on_reload, &reloads) );
+    assert_false( nini_watcher_start(&watcher, on_reload, &reloads) );
+
+    // Write the file in place.
+    assert_int_equal( 0, system("printf '[section]\\n    value = 2\\n' > watcher.ini") );
+    assert_true( wait_value(&watcher, 2) );
+
+    // Replace the file by renaming, and a burst of writes causes one reload.
+    int count = __sync_fetch_and_add(&reloads.succeed, 0);
+    assert_int_equal( 0, system("for i in 1 2 3 4 5; do printf '[section]\\n    value = 3\\n' >> watcher.tmp; done;"
+                                "printf '[section]\\n    value = 3\\n' > watcher.tmp && mv watcher.tmp watcher.ini") );
+    assert_true( wait_value(&watcher, 3) );
+    usleep(200 * 1000);
+    assert_int_equal( __sync_fetch_and_add(&reloads.succeed, 0), count + 1 );
+
+    // Decode failures are reported, and the current root is kept.
+    assert_int_equal( 0, system("printf '[]\\n' > watcher.ini") );
+    for(int i = 0; i < 300 && !__sync_fetch_and_add(&reloads.failed, 0); ++i)
+        usleep(10 * 1000);
+    assert_int_equal( __sync_fetch_and_add(&reloads.failed, 0), 1 );
+    assert_int_equal( read_value(&watcher), 3 );
+
+    nini_watcher_stop(&watcher);
+    nini_watcher_deinit(&watcher);
+
+    remove("watcher.ini");
+}
+//------------------------------------------------------------------------------
+int test_watcher(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(reload_watcher_test),
+        cmocka_unit_test(watch_watcher_test),
+    };
+
+    return cmocka_run_group_tests_name("watcher_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_WATCHER_H_
+#define _TEST_WATCHER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_watcher(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
@@ -0,0 +1,195 @@
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+#include <cmocka.h>
+#include "nini_root.h"
+#include "nini_writer.h"
+#include "formats.h"
+#include "test_writer.h"
+
+typedef struct sink_t
+{
+    char   *data;
+    size_t  size;
+    size_t  max_block;
+    int     writes;
+    bool    keep_data;
+} sink_t;
+//------------------------------------------------------------------------------
+static
+bool sink_on_write(void *stream, const char *line, size_t len)
+{
+    sink_t *sink = stream;
+
+    if( sink->keep_data )
+    {
+        sink->data = realloc(sink->data, sink->size + len);
+        memcpy(sink->data + sink->size, line, len);
+    }
+
+    sink->size += len;
+    if( sink->max_block < len ) sink->max_block = len;
+    ++ sink->writes;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+static
+void same_as_tree_writer_test(void **state)
+{
+    // Build a tree and encode it as the reference.
+
+    nini_root_t root;
+    nini_root_init(&root, &format_have_indents);
+
+    nini_node_t *video = nini_node_create_section("video");
+    assert_non_null( video );
+    assert_true( nini_root_link_child(&root, video) );
+    assert_true( nini_node_link_child(video, nini_node_create_decimal("width", 1920)) );
+    assert_true( nini_node_link_child(video, nini_node_create_hexa("format", 0x3231564E)) );
+    assert_true( nini_node_link_child(video, nini_node_create_float("fps", 29.97)) );
+
+    nini_node_t *codec = nini_node_create_section("codec");
+    assert_non_null( codec );
+    assert_true( nini_node_link_child(video, codec) );
+    assert_true( nini_node_link_child(codec, nini_node_create_string("name", "h.264 \"high\"\n")) );
+    assert_true( nini_node_link_child(codec, nini_node_create_bool("interlaced", false)) );
+
+    assert_true( nini_root_link_child(&root, nini_node_create_null("empty")) );
+
+    nini_node_t *audio = nini_node_create_section("audio");
+    assert_non_null( audio );
+    assert_true( nini_root_link_child(&root, audio) );
+    assert_true( nini_node_link_child(audio, nini_node_create_decimal("channels", -2)) );
+
+    size_t  expected_size;
+    char   *expected = nini_root_encode_to_memory(&root, &expected_size, NULL);
+    assert_non_null( expected );
+
+    // Write the same items by the writer.
+
+    sink_t sink = { .keep_data = true };
+    nini_writer_t writer;
+    assert_true( nini_writer_init(&writer, &format_have_indents, &sink, sink_on_write, NULL) );
+
+    assert_true( nini_writer_begin_section(&writer, "video") );
+    assert_true( nini_writer_write_decimal(&writer, "width", 1920) );
+    assert_true( nini_writer_write_hexa(&writer, "format", 0x3231564E) );
+    assert_true( nini_writer_write_float(&writer, "fps", 29.97) );
+    assert_true( nini_writer_begin_section(&writer, "codec") );
+    assert_int_equal( nini_writer_get_level(&writer), 2 );
+    assert_true( nini_writer_write_string(&writer, "name", "h.264 \"high\"\n") );
+    assert_true( nini_writer_write_bool(&writer, "interlaced", false) );
+    assert_true( nini_writer_end_section(&writer) );
+    assert_true( nini_writer_end_section(&writer) );
+    assert_true( nini_writer_write_null(&writer, "empty") );
+    assert_true( nini_writer_write_node(&writer, audio) );
+
+    assert_int_equal( nini_writer_finish(&writer), expected_size );
+    assert_false( nini_writer_is_failed(&writer) );
+    nini_writer_deinit(&writer);
+
+    assert_int_equal( sink.size, expected_size );
+    assert_memory_equal( sink.data, expected, expected_size );
+
+    free(sink.data);
+    free(expected);
+    nini_root_deinit(&root);
+}
+//------------------------------------------------------------------------------
+static
+void failures_writer_test(void **state)
+{
+    sink_t        sink = { .keep_data = false };
+    nini_writer_t writer;
+    nini_errmsg_t errmsg;
+
+    // Unbalanced section end.
+    assert_true( nini_writer_init(&writer, &format_have_indents, &sink, sink_on_write, &errmsg) );
+    assert_true( nini_writer_write_decimal(&writer, "key", 1) );
+    assert_false( nini_writer_end_section(&writer) );
+    assert_true( nini_writer_is_failed(&writer) );
+    assert_int_equal( errmsg.line_num, 1 );
+    assert_false( nini_writer_write_decimal(&writer, "key", 2) );
+    assert_int_equal( nini_writer_finish(&writer), 0 );
+    nini_writer_deinit(&writer);
+    assert_int_equal( sink.writes, 0 );
+
+    // Sections are not supported by the format.
+    static const nini_format_t format_no_sections =
+    {
+        .sec_head = 0,
+        .sec_tail = 0,
+        .keymark  = '=',
+        .comment  = ';',
+        .indent   = 0,
+    };
+    assert_true( nini_writer_init(&writer, &format_no_sections, &sink, sink_on_write, &errmsg) );
+    assert_false( nini_writer_begin_section(&writer, "section") );
+    assert_int_equal( nini_writer_get_level(&writer), 0 );
+    assert_int_equal( nini_writer_finish(&writer), 0 );
+    nini_writer_deinit(&writer);
+
+    // No more items after finished.
+    assert_true( nini_writer_init(&writer, &format_have_indents, &sink, sink_on_write, &errmsg) );
+    assert_true( nini_writer_begin_section(&writer, "section") );
+    assert_int_equal( nini_writer_finish(&writer), strlen("[section]\n") );
+    assert_int_equal( errmsg.line_num, 0 );
+    assert_false( nini_writer_write_bool(&writer, "key", true) );
+    nini_writer_deinit(&writer);
+}
+//------------------------------------------------------------------------------
+static
+void large_output_writer_test(void **state)
+{
+    static const int count = 100000;
+
+    sink_t        sink = { .keep_data = false };
+    nini_writer_t writer;
+    assert_true( nini_writer_init(&writer, &format_have_indents, &sink, sink_on_write, NULL) );
+
+    size_t expected_size = 0;
+    char   name[32];
+    char   line[64];
+    for(int i = 0; i < count; ++i)
+    {
+        if( i % 100 == 0 )
+        {
+            if( i ) assert_true( nini_writer_end_section(&writer) );
+            snprintf(name, sizeof(name), "section-%d", i / 100);
+            assert_true( nini_writer_begin_section(&writer, name) );
+            expected_size += 1 + strlen(name) + 1 + 1;
+        }
+
+        snprintf(name, sizeof(name), "key-%d", i);
+        assert_true( nini_writer_write_decimal(&writer, name, i) );
+        snprintf(line, sizeof(line), "    key-%d = %d\n", i, i);
+        expected_size += strlen(line);
+    }
+
+    assert_int_equal( nini_writer_finish(&writer), expected_size );
+    nini_writer_deinit(&writer);
+
+    // Lines should be flushed in blocks while writing, instead of being kept in memory.
+    assert_int_equal( sink.size, expected_size );
+    assert_true( sink.writes > 1 );
+    assert_true( sink.max_block <= 64 * 1024 );
+}
+//------------------------------------------------------------------------------
+int test_writer(void)
+{
+    struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(same_as_tree_writer_test),
+        cmocka_unit_test(failures_writer_test),
+        cmocka_unit_test(large_output_writer_test),
+    };
+
+    return cmocka_run_group_tests_name("writer_test", tests, NULL, NULL);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,14 @@
+#ifndef _TEST_WRITER_H_
+#define _TEST_WRITER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int test_writer(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif